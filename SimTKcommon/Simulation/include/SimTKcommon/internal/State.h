@@ -288,6 +288,10 @@ State();
 /// source %State, copying only state variables and not the cache. If the source
 /// state hasn't been realized to at least Stage::Model, then we don't copy its
 /// state variables either, except those associated with the Topology stage.
+/// Discrete variables and cache entries that belong to Instance stage or
+/// earlier are not actually copied until either %State writes to them; until
+/// then the two States share them. Those are typically the bulk of a large
+/// model's %State and rarely change, so copying is cheap.
 State(const State&);
 
 /// The move constructor is very fast. The source object is left empty.
@@ -299,6 +303,8 @@ State(State&& source);
 /// copying only state variables and not the cache. If the source state hasn't
 /// been realized to at least Stage::Model, then we don't copy its state
 /// variables either, except those associated with the Topology stage.
+/// As for the copy constructor, Instance-stage and earlier discrete variables
+/// and cache entries are shared with the source until written.
 State& operator=(const State&);
 
 /// Move assignment is very fast. The source object is left in a valid but
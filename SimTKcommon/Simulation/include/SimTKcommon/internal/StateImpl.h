@@ -164,10 +164,13 @@ public:
     // Default copy constructor, copy assignment, destructor are shallow.
 
     // Use this to make this entry contain a *copy* of the source value.
-    // If the destination already has a value, the new value must be
-    // assignment compatible.
+    // The value of a variable that invalidates Instance stage or earlier is 
+    // shared with the source until one of them writes to it, since those 
+    // rarely change once set; others are copied now.
     DiscreteVarInfo& deepAssign(const DiscreteVarInfo& src) {
         *this = src; // copy assignment forgets dependents
+        if (m_invalidatedStage > Stage::Instance)
+            m_value.detach();
         return *this;
     }
 
@@ -179,20 +182,22 @@ public:
     const Stage& getAllocationStage()  const {return m_allocationStage;}
 
     // Exchange value pointers (should be from this dv's update cache entry).
-    void swapValue(Real updTime, ClonePtr<AbstractValue>& other) 
+    void swapValue(Real updTime, CloneOnWritePtr<AbstractValue>& other) 
     {   m_value.swap(other); m_timeLastUpdated=updTime; }
 
-    const AbstractValue& getValue() const {assert(m_value); return *m_value;}
+    const AbstractValue& getValue() const 
+    {   assert(m_value); return m_value.getRef(); }
 
     // Whenever we hand out this variables value for write access we update
     // the value version, note the update time, and notify any dependents that
-    // they are now invalid with respect to this variable's value.
+    // they are now invalid with respect to this variable's value. If the 
+    // value is shared with another State we get our own copy first.
     AbstractValue& updValue(const StateImpl& stateImpl, Real updTime) {
        assert(m_value); 
        ++m_valueVersion;
        m_timeLastUpdated=updTime; 
        m_dependents.notePrerequisiteChange(stateImpl);
-       return *m_value; 
+       return m_value.updRef(); 
     }
     ValueVersion getValueVersion() const {return m_valueVersion;}
     Real getTimeLastUpdated() const 
@@ -218,7 +223,7 @@ private:
     ResetOnCopy<ListOfDependents>   m_dependents;
 
     // These change at run time.
-    ClonePtr<AbstractValue>         m_value;
+    CloneOnWritePtr<AbstractValue>  m_value;
     ValueVersion                    m_valueVersion{1};
     Real                            m_timeLastUpdated{NaN};
 
@@ -332,8 +337,13 @@ public:
     }
 
     // Use this to make this entry contain a *copy* of the source value.
+    // As for discrete variables, the value of an entry that depends on 
+    // Instance stage or earlier is shared with the source until one of them
+    // writes to it; others are copied now.
     CacheEntryInfo& deepAssign(const CacheEntryInfo& src) {
         *this = src; // copy assignment forgets dependents
+        if (m_dependsOnStage > Stage::Instance)
+            m_value.detach();
         return *this;
     }
 
@@ -351,17 +361,19 @@ public:
     void swapValue(Real updTime, DiscreteVarInfo& dv) 
     {   dv.swapValue(updTime, m_value); }
 
-    const AbstractValue& getValue() const {assert(m_value); return *m_value;}
+    const AbstractValue& getValue() const 
+    {   assert(m_value); return m_value.getRef(); }
 
     // Merely handing out the cache entry's value with write access does not
     // trigger invalidation of dependents. (Maybe it should, but currently it
     // gets done often with no intent to modify, esp. by SBStateDigest.)
     // So be sure that the cache entry gets invalidated first either by an
     // explicit prerequisite change notification, or because the depends-on
-    // stage got invalidated.
+    // stage got invalidated. A value shared with another State is copied
+    // first.
     AbstractValue& updValue(const StateImpl& stateImpl) {
        assert(m_value); 
-       return *m_value; 
+       return m_value.updRef(); 
     }
     ValueVersion getValueVersion() const {return m_valueVersion;}
 
@@ -424,7 +436,7 @@ private:
     // prerequisites so we are up to date with respect to them. We'll change
     // the initial value to false in registerWithPrerequisites() if there
     // are some.
-    ClonePtr<AbstractValue>     m_value;
+    CloneOnWritePtr<AbstractValue> m_value;
     ValueVersion                m_valueVersion{1};
     StageVersion                m_dependsOnVersionWhenLastComputed{0};
     bool                        m_isUpToDateWithPrerequisites{true};
@@ -281,6 +281,55 @@ requested stage or higher, nothing happens here. Otherwise, the state is
 realized one stage at a time until it reaches the requested stage. 
 @see realizeTopology(), realizeModel() **/
 void realize(const State& state, Stage stage = Stage::HighestRuntime) const;
+
+/** Realize each of a batch of States to the indicated \a stage, spreading
+the States over multiple threads. This is a convenience: it is just realize()
+called for each State in a parallel loop, and no work is shared between the
+States. It is meant for ensemble and sampling workloads where many States of
+the same %System must be brought up to the same stage, such as Monte Carlo
+sampling or evaluating a population of candidate configurations. The result
+for each State is identical to what realize() would produce for it.
+
+Each State must have been initialized to work with this %System and realized
+through Stage::Model, just as for realize(); all the States are checked before
+any work begins so that a bad one doesn't leave the batch half done.
+The States must all be distinct objects, since they are written (in their
+cache) concurrently. Any code invoked during realization (force elements,
+constraints, event handlers and so on) must be safe to run concurrently on
+different States. The built-in Simbody elements are, except for two that keep
+scratch data in shared geometry objects: contact with a
+ContactGeometry::SmoothHeightMap, and cables (CableTrackerSubsystem) wrapping
+over obstacle surfaces.
+
+@param[in]      states
+    The States to be realized. May be empty. Null pointers or duplicate
+    entries are not allowed.
+@param[in]      stage
+    The stage to which every State is to be realized. States already at or
+    beyond this stage are left alone.
+@param[out]     results
+    If supplied, filled in with the number of States, the number of threads
+    used, the elapsed (wall clock) time, and from those the throughput in
+    realizations per second.
+
+If realization of any State throws an exception, the remaining States are
+still realized and then the exception for the lowest-numbered failing State is
+rethrown here.
+@see realize(), setNumBatchRealizeThreads() **/
+void realizeBatch(const Array_<State*>& states, 
+                  Stage stage = Stage::HighestRuntime) const;
+/** This signature also returns timing information; see the other signature
+for details. **/
+void realizeBatch(const Array_<State*>& states, Stage stage, 
+                  RealizeResults& results) const;
+
+/** Set the maximum number of threads realizeBatch() may use. The default is
+the number of processors on this machine. Setting this to 1 makes
+realizeBatch() realize the States one at a time on the calling thread. **/
+System& setNumBatchRealizeThreads(int numThreads);
+/** Return the maximum number of threads realizeBatch() may use.
+@see setNumBatchRealizeThreads() **/
+int getNumBatchRealizeThreads() const;
 /**@}**/
 
 
@@ -695,6 +744,20 @@ void multiplyByNPInvTranspose(const State& state, const Vector& fu,
                               Vector& fq) const;
 /**@}**/
 
+/** Calculate the ny X ny matrix J=d ydot/d y of partial derivatives of the 
+continuous state derivatives with respect to the continuous state variables 
+y=(q,u,z), if this %System knows a cheaper way to do that than numerical
+differentiation. This is for implicit integrators, which need J only to form 
+the iteration matrix of their Newton iterations, so an approximation that
+leaves out small terms is acceptable; see the concrete %System for what it 
+provides. Returns false if the %System doesn't support this, in which case
+\a dYDotdY is not touched and the caller should fall back to numerical
+differentiation. The default implementation just returns false.
+
+@param[in]  state    A State realized through Stage::Acceleration.
+@param[out] dYDotdY  The Jacobian, resized if necessary. **/
+bool calcYDotJacobian(const State& state, Matrix& dYDotdY) const;
+
 
 //------------------------------------------------------------------------------
 /**@name                         Statistics
@@ -1167,8 +1230,40 @@ public:
     RealizeOptions& operator-=(Option opt) {clearOption(opt); return *this;}
 };
 
-/** (NOT USED YET) Results for advanced users of realize() methods. **/
+/** Results for advanced users of realize() methods. Currently only
+System::realizeBatch() fills these in. **/
 class RealizeResults {
+public:
+    RealizeResults() {clear();}
+
+    /** Restore this object to its default-constructed state. **/
+    RealizeResults& clear() {
+        m_numStates = m_numThreads = 0;
+        m_elapsedTime = 0;
+        return *this;
+    }
+
+    /** The number of States that were realized. **/
+    int    getNumStates()    const {return m_numStates;}
+    /** The number of threads that were used. **/
+    int    getNumThreads()   const {return m_numThreads;}
+    /** Elapsed wall clock time in seconds. **/
+    double getElapsedTime()  const {return m_elapsedTime;}
+    /** Throughput: the number of States realized per second of elapsed time.
+    Returns zero if no time was recorded. **/
+    double getRealizationsPerSecond() const 
+    {   return m_elapsedTime > 0 ? m_numStates/m_elapsedTime : 0; }
+
+    RealizeResults& setNumStates(int numStates) 
+    {   m_numStates=numStates; return *this; }
+    RealizeResults& setNumThreads(int numThreads) 
+    {   m_numThreads=numThreads; return *this; }
+    RealizeResults& setElapsedTime(double seconds) 
+    {   m_elapsedTime=seconds; return *this; }
+private:
+    int     m_numStates;
+    int     m_numThreads;
+    double  m_elapsedTime;
 };
 
 
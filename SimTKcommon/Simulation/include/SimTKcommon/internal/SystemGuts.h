@@ -147,6 +147,7 @@ public:
                          Vector& u) const;
     void multiplyByNPInvTranspose(const State& state, const Vector& fu, 
                                   Vector& fq) const;
+    bool calcYDotJacobian(const State& state, Matrix& dYDotdY) const;
 
     bool prescribeQ(State&) const;
     bool prescribeU(State&) const;
@@ -206,6 +207,10 @@ protected:
     virtual void multiplyByNPInvTransposeImpl(const State& state, const Vector& fu, 
                                               Vector& fq) const;
 
+    // Default is that the System can't supply its own Jacobian.
+    virtual bool calcYDotJacobianImpl(const State& state, 
+                                      Matrix& dYDotdY) const {return false;}
+
     // Defaults assume no prescribed motion; hence, no change made.
     virtual bool prescribeQImpl(State&) const {return false;}
     virtual bool prescribeUImpl(State&) const {return false;}
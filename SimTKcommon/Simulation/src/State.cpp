@@ -173,6 +173,7 @@ bool State::isConsistent(const SimTK::State& otherState) const {
 // of the same template. The template value must be a type that supports
 // three methods (the template analog to virtual functions):
 //      deepAssign()            a non-shallow assignment, i.e. clone the value
+//                              (possibly deferred until it is written)
 //      deepDestruct()          destroy any owned heap space
 //      getAllocationStage()    return the stage being worked on when this was 
 //                              allocated
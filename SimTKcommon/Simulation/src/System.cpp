@@ -36,10 +36,13 @@
 #include "SimTKcommon/internal/SystemGuts.h"
 #include "SimTKcommon/internal/EventHandler.h"
 #include "SimTKcommon/internal/EventReporter.h"
+#include "SimTKcommon/internal/Timing.h"
 
 #include "SystemGutsRep.h"
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
 #include <map>
 #include <set>
 
@@ -169,6 +172,21 @@ void System::invalidateSystemTopologyCache() const
 const State& System::realizeTopology() const {return getSystemGuts().realizeTopology();}
 void System::realizeModel(State& s) const {getSystemGuts().realizeModel(s);}
 void System::realize(const State& s, Stage g) const {getSystemGuts().realize(s,g);}
+
+void System::realizeBatch(const Array_<State*>& states, Stage g) const
+{   RealizeResults results; realizeBatch(states, g, results); }
+
+System& System::setNumBatchRealizeThreads(int numThreads) {
+    SimTK_APIARGCHECK1_ALWAYS(numThreads > 0, "System", 
+        "setNumBatchRealizeThreads", 
+        "The number of threads must be positive but was %d.", numThreads);
+    auto& rep = updSystemGuts().updRep();
+    if (numThreads != rep.numBatchRealizeThreads)
+        rep.setNumBatchRealizeThreads(numThreads);
+    return *this;
+}
+int System::getNumBatchRealizeThreads() const
+{   return getSystemGuts().getRep().numBatchRealizeThreads; }
 void System::calcDecorativeGeometryAndAppend
    (const State& s, Stage g, Array_<DecorativeGeometry>& geom) const 
 {   getSystemGuts().calcDecorativeGeometryAndAppend(s,g,geom); }
@@ -181,6 +199,8 @@ void System::multiplyByNPInv(const State& s, const Vector& dq, Vector& u) const
 {   getSystemGuts().multiplyByNPInv(s,dq,u); }
 void System::multiplyByNPInvTranspose(const State& s, const Vector& fu, Vector& fq) const
 {   getSystemGuts().multiplyByNPInvTranspose(s,fu,fq); }
+bool System::calcYDotJacobian(const State& s, Matrix& dYDotdY) const
+{   return getSystemGuts().calcYDotJacobian(s,dYDotdY); }
 
 bool System::prescribeQ(State& s) const
 {   return getSystemGuts().prescribeQ(s); }
@@ -591,6 +611,17 @@ void System::Guts::multiplyByNPInvTranspose(const State& s, const Vector& fu,
 
 
 
+//------------------------------------------------------------------------------
+//                            CALC YDOT JACOBIAN
+//------------------------------------------------------------------------------
+bool System::Guts::calcYDotJacobian(const State& s, Matrix& dYDotdY) const {
+    SimTK_STAGECHECK_GE_ALWAYS(s.getSystemStage(), Stage::Acceleration,
+        "System::Guts::calcYDotJacobian()");
+    return calcYDotJacobianImpl(s,dYDotdY);
+}
+
+
+
 //------------------------------------------------------------------------------
 //                              PRESCRIBE Q
 //------------------------------------------------------------------------------
@@ -791,6 +822,63 @@ void System::Guts::realize(const State& s, Stage g) const {
     }
 }
 
+//------------------------------------------------------------------------------
+//                              REALIZE BATCH
+//------------------------------------------------------------------------------
+void System::realizeBatch(const Array_<State*>& states, Stage g,
+                          RealizeResults& results) const 
+{
+    const System::Guts& guts = getSystemGuts();
+    const auto& rep = guts.getRep();
+    const char* methodName = "System::realizeBatch()";
+    const int nStates = (int)states.size();
+
+    results.clear();
+
+    // Do all the checks realize() would have done on entry, once per State,
+    // before any work starts.
+    SimTK_STAGECHECK_TOPOLOGY_REALIZED_ALWAYS(systemTopologyHasBeenRealized(),
+        "System", getName(), methodName);
+    const StageVersion topoVersion = getSystemTopologyCacheVersion();
+    for (int i=0; i < nStates; ++i) {
+        SimTK_APIARGCHECK1_ALWAYS(states[i] != nullptr, "System",
+            "realizeBatch", "State pointer %d was null.", i);
+        SimTK_STAGECHECK_TOPOLOGY_VERSION_ALWAYS(topoVersion, 
+            states[i]->getSystemTopologyStageVersion(), 
+            "System", getName(), methodName);
+        SimTK_STAGECHECK_GE_ALWAYS(states[i]->getSystemStage(), Stage::Model, 
+            methodName);
+    }
+    Array_<const State*> sorted(states.begin(), states.end());
+    std::sort(sorted.begin(), sorted.end());
+    SimTK_APIARGCHECK_ALWAYS(
+        std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end(),
+        "System", "realizeBatch", 
+        "The same State appeared more than once in the batch.");
+
+    // The System's executor falls back to realizing the States one at a time
+    // on this thread if another batch is using it or if we're already on a
+    // worker thread; in that case none of them are realized on a worker.
+    const double startTime = realTime();
+    std::atomic<bool> usedWorkers(false);
+    const auto realizeOne = [&](int i) {
+        if (ParallelExecutor::isWorkerThread())
+            usedWorkers.store(true, std::memory_order_relaxed);
+        guts.realize(*states[i], g);
+    };
+    std::exception_ptr failure;
+    try {rep.batchExecutor->forEach(nStates, realizeOne);}
+    catch (...) {failure = std::current_exception();}
+
+    results.setNumStates(nStates)
+           .setNumThreads(usedWorkers ? std::min(rep.numBatchRealizeThreads,
+                                                 nStates) : 1)
+           .setElapsedTime(realTime() - startTime);
+    if (failure) std::rethrow_exception(failure);
+}
+
+
+
 //------------------------------------------------------------------------------
 //                   CALC DECORATIVE GEOMETRY AND APPEND
 //------------------------------------------------------------------------------
@@ -37,6 +37,9 @@
 
 #include "SimTKcommon/internal/System.h"
 #include "SimTKcommon/internal/SystemGuts.h"
+#include "SimTKcommon/internal/ParallelExecutor.h"
+
+#include <atomic>
 
 namespace SimTK {
 
@@ -53,10 +56,11 @@ public:
         useUniformBackground(false),
         hasTimeAdvancedEventsFlag(false),
         systemTopologyRealized(false), 
-        topologyCacheVersion(1) // not zero
-
+        topologyCacheVersion(1), // not zero
+        numBatchRealizeThreads(0)
     {
         resetAllCounters();
+        setNumBatchRealizeThreads(ParallelExecutor::getNumProcessors());
     }
 
     // Default constructor invokes the one above.
@@ -74,7 +78,9 @@ public:
         useUniformBackground(src.useUniformBackground),
         hasTimeAdvancedEventsFlag(src.hasTimeAdvancedEventsFlag),
         systemTopologyRealized(false),
-        topologyCacheVersion(src.topologyCacheVersion)
+        topologyCacheVersion(src.topologyCacheVersion),
+        numBatchRealizeThreads(src.numBatchRealizeThreads),
+        batchExecutor(src.batchExecutor)
     {
         resetAllCounters();
     }
@@ -85,6 +91,11 @@ public:
         invalidateSystemTopologyCache();
     }
 
+    void setNumBatchRealizeThreads(int numThreads) {
+        numBatchRealizeThreads = numThreads;
+        batchExecutor = new ParallelExecutor(numThreads);
+    }
+
     const String& getName()    const {return systemName;}
     const String& getVersion() const {return systemVersion;}
 
@@ -199,8 +210,19 @@ private:
     // Topology version cannot be used with this Subsystem.
     mutable State           defaultState;
 
+        // BATCH REALIZATION //
+
+    // Number of threads realizeBatch() may use, and the executor that runs
+    // them. The executor doesn't start any threads until it is first used.
+    // A batch that finds it busy with another batch runs serially.
+    int                                 numBatchRealizeThreads;
+    mutable ClonePtr<ParallelExecutor>  batchExecutor;
+
         // STATISTICS //
-    mutable int nRealizationsOfStage[Stage::NValid];
+
+    // Realization counters are atomic since realizeBatch() realizes
+    // different States concurrently.
+    mutable std::atomic<int> nRealizationsOfStage[Stage::NValid];
     mutable int nRealizeCalls; // counts realizeTopology(), realizeModel(), realize()
 
     mutable int nPrescribeQCalls, nPrescribeUCalls;
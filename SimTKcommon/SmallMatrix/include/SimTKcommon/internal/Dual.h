@@ -0,0 +1,563 @@
+#ifndef SimTK_SIMMATRIX_DUAL_H_
+#define SimTK_SIMMATRIX_DUAL_H_
+
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/**@file
+ * This file defines the dual number scalar Dual_<P> used for forward mode
+ * automatic differentiation, the NTraits and CNT specializations that let it
+ * be the element type of the small matrix classes Vec, Row, Mat and SymMat
+ * (and therefore of SpatialVec and SpatialMat), and the global operators
+ * combining those with a dual scalar.
+ */
+
+#include <cmath>
+#include <iostream>
+
+namespace SimTK {
+
+/** Dual_<P> is a number a + b*e where e*e is zero; a is the value and b the
+derivative. Evaluating a function built from the arithmetic operators and
+the elementary functions below on Dual_ arguments whose derivatives are set
+to a direction dx gives the function value together with its exact
+directional derivative (df/dx)*dx, in one pass and without the truncation
+and cancellation errors of finite differencing. This is forward mode
+automatic differentiation.
+
+Dual_ may be the element type of Vec, Row, Mat and SymMat, so code written in
+terms of those, for example spatial algebra on SpatialVec and SpatialMat, can
+be differentiated by instantiating it on Dual_ rather than Real:
+@code
+    Dual x(2, 1);                       // value 2, seed dx/dx = 1
+    Vec<3,Dual> v(x, x*x, sin(x));
+    Dual f = v.norm();                  // f.derivative() is d|v|/dx
+    Vec<2,Vec<3,Dual>> V(v, x*v);       // a SpatialVec
+@endcode
+Use getValue() and getDerivative() to split results back into Real
+quantities.
+
+Comparisons look only at the value, so branches in differentiated code take
+the same path they would take with Real arguments. At points where a function
+is not differentiable, such as abs(0) or sqrt(0), the result has the
+one-sided derivative or an infinite one. **/
+template <class P>
+class Dual_ {
+public:
+    /** The underlying real type. **/
+    typedef P Precision;
+
+    /** Zero value and derivative. **/
+    Dual_() : val(0), der(0) {}
+    /** A constant: value \a v and zero derivative. This is an implicit
+    conversion so that constants mix freely with Dual_ numbers. **/
+    Dual_(const P& v) : val(v), der(0) {}
+    /** Convert an int constant. **/
+    Dual_(int v) : val(P(v)), der(0) {}
+    /** Value \a v with derivative \a d. **/
+    Dual_(const P& v, const P& d) : val(v), der(d) {}
+
+    /** The value part. **/
+    const P& value() const {return val;}
+    /** The derivative part. **/
+    const P& derivative() const {return der;}
+    P& updValue() {return val;}
+    P& updDerivative() {return der;}
+
+    Dual_ operator-() const {return Dual_(-val, -der);}
+    Dual_ operator+() const {return *this;}
+
+    Dual_& operator+=(const Dual_& r) {val += r.val; der += r.der; return *this;}
+    Dual_& operator-=(const Dual_& r) {val -= r.val; der -= r.der; return *this;}
+    Dual_& operator*=(const Dual_& r)
+    {   der = der*r.val + val*r.der; val *= r.val; return *this; }
+    Dual_& operator/=(const Dual_& r)
+    {   const P oor = P(1)/r.val;
+        val *= oor; der = (der - val*r.der)*oor; return *this; }
+
+    Dual_& operator+=(const P& r) {val += r; return *this;}
+    Dual_& operator-=(const P& r) {val -= r; return *this;}
+    Dual_& operator*=(const P& r) {val *= r; der *= r; return *this;}
+    Dual_& operator/=(const P& r) {val /= r; der /= r; return *this;}
+
+    /** @name Elementary functions
+    Each returns f(a) + f'(a)*b*e for argument a + b*e. These are found by
+    argument-dependent lookup only, so they don't hide the standard functions
+    of real arguments from unqualified calls made inside namespace SimTK. **/
+    /**@{**/
+    friend Dual_ sqrt(const Dual_& x)
+    {   const P s = std::sqrt(x.val); return Dual_(s, x.der/(2*s)); }
+    friend Dual_ exp(const Dual_& x)
+    {   const P e = std::exp(x.val); return Dual_(e, e*x.der); }
+    friend Dual_ log(const Dual_& x)
+    {   return Dual_(std::log(x.val), x.der/x.val); }
+    friend Dual_ sin(const Dual_& x)
+    {   return Dual_(std::sin(x.val), std::cos(x.val)*x.der); }
+    friend Dual_ cos(const Dual_& x)
+    {   return Dual_(std::cos(x.val), -std::sin(x.val)*x.der); }
+    friend Dual_ tan(const Dual_& x)
+    {   const P t = std::tan(x.val); return Dual_(t, (1+t*t)*x.der); }
+    friend Dual_ asin(const Dual_& x)
+    {   return Dual_(std::asin(x.val), x.der/std::sqrt(1-x.val*x.val)); }
+    friend Dual_ acos(const Dual_& x)
+    {   return Dual_(std::acos(x.val), -x.der/std::sqrt(1-x.val*x.val)); }
+    friend Dual_ atan(const Dual_& x)
+    {   return Dual_(std::atan(x.val), x.der/(1+x.val*x.val)); }
+    friend Dual_ atan2(const Dual_& y, const Dual_& x)
+    {   const P r2 = x.val*x.val + y.val*y.val;
+        return Dual_(std::atan2(y.val, x.val), (x.val*y.der - y.val*x.der)/r2); }
+    /** Raise to a constant power. **/
+    friend Dual_ pow(const Dual_& x, const P& a)
+    {   const P p = std::pow(x.val, a-1); return Dual_(p*x.val, a*p*x.der); }
+    /** Raise to a dual power; the base must be positive. **/
+    friend Dual_ pow(const Dual_& x, const Dual_& a)
+    {   return exp(a*log(x)); }
+    /**@}**/
+
+private:
+    P val, der;
+};
+
+/** %Dual number in the default precision. **/
+typedef Dual_<Real> Dual;
+
+// The mixed operators below use Dual_<P>::Precision for the plain operand so
+// that it is not used for template argument deduction; that allows an int or
+// a constant of the other precision to be converted.
+
+/// @name Dual_ arithmetic
+//@{
+template <class P> inline Dual_<P>
+operator+(const Dual_<P>& l, const Dual_<P>& r)
+{   return Dual_<P>(l.value()+r.value(), l.derivative()+r.derivative()); }
+template <class P> inline Dual_<P>
+operator+(const Dual_<P>& l, const typename Dual_<P>::Precision& r)
+{   return Dual_<P>(l.value()+r, l.derivative()); }
+template <class P> inline Dual_<P>
+operator+(const typename Dual_<P>::Precision& l, const Dual_<P>& r)
+{   return Dual_<P>(l+r.value(), r.derivative()); }
+
+template <class P> inline Dual_<P>
+operator-(const Dual_<P>& l, const Dual_<P>& r)
+{   return Dual_<P>(l.value()-r.value(), l.derivative()-r.derivative()); }
+template <class P> inline Dual_<P>
+operator-(const Dual_<P>& l, const typename Dual_<P>::Precision& r)
+{   return Dual_<P>(l.value()-r, l.derivative()); }
+template <class P> inline Dual_<P>
+operator-(const typename Dual_<P>::Precision& l, const Dual_<P>& r)
+{   return Dual_<P>(l-r.value(), -r.derivative()); }
+
+template <class P> inline Dual_<P>
+operator*(const Dual_<P>& l, const Dual_<P>& r)
+{   return Dual_<P>(l.value()*r.value(),
+                    l.derivative()*r.value() + l.value()*r.derivative()); }
+template <class P> inline Dual_<P>
+operator*(const Dual_<P>& l, const typename Dual_<P>::Precision& r)
+{   return Dual_<P>(l.value()*r, l.derivative()*r); }
+template <class P> inline Dual_<P>
+operator*(const typename Dual_<P>::Precision& l, const Dual_<P>& r)
+{   return Dual_<P>(l*r.value(), l*r.derivative()); }
+
+template <class P> inline Dual_<P>
+operator/(const Dual_<P>& l, const Dual_<P>& r)
+{   const P oor = P(1)/r.value(), q = l.value()*oor;
+    return Dual_<P>(q, (l.derivative() - q*r.derivative())*oor); }
+template <class P> inline Dual_<P>
+operator/(const Dual_<P>& l, const typename Dual_<P>::Precision& r)
+{   return Dual_<P>(l.value()/r, l.derivative()/r); }
+template <class P> inline Dual_<P>
+operator/(const typename Dual_<P>::Precision& l, const Dual_<P>& r)
+{   const P oor = P(1)/r.value(), q = l*oor;
+    return Dual_<P>(q, -q*r.derivative()*oor); }
+//@}
+
+/// @name Dual_ comparisons
+/// These compare values only; derivatives are ignored.
+//@{
+#define SimTK_DUAL_COMPARISON(OP)                                              \
+template <class P> inline bool                                                 \
+operator OP(const Dual_<P>& l, const Dual_<P>& r)                              \
+{   return l.value() OP r.value(); }                                           \
+template <class P> inline bool                                                 \
+operator OP(const Dual_<P>& l, const typename Dual_<P>::Precision& r)          \
+{   return l.value() OP r; }                                                   \
+template <class P> inline bool                                                 \
+operator OP(const typename Dual_<P>::Precision& l, const Dual_<P>& r)          \
+{   return l OP r.value(); }
+SimTK_DUAL_COMPARISON(==)
+SimTK_DUAL_COMPARISON(!=)
+SimTK_DUAL_COMPARISON(<)
+SimTK_DUAL_COMPARISON(<=)
+SimTK_DUAL_COMPARISON(>)
+SimTK_DUAL_COMPARISON(>=)
+#undef SimTK_DUAL_COMPARISON
+//@}
+
+/// @name Dual_ overloads of SimTK scalar functions
+/// These join the overloads SimTK already provides for the real types.
+//@{
+template <class P> inline Dual_<P> abs(const Dual_<P>& x)
+{   return x.value() < 0 ? -x : x; }
+template <class P> inline Dual_<P> square(const Dual_<P>& x) {return x*x;}
+template <class P> inline Dual_<P> cube(const Dual_<P>& x) {return x*x*x;}
+template <class P> inline Dual_<P> recip(const Dual_<P>& x) {return P(1)/x;}
+//@}
+
+/// @name Dual_ classification
+/// These look at both the value and the derivative.
+//@{
+template <class P> inline bool isNaN(const Dual_<P>& x)
+{   return isNaN(x.value()) || isNaN(x.derivative()); }
+template <class P> inline bool isInf(const Dual_<P>& x)
+{   return !isNaN(x) && (isInf(x.value()) || isInf(x.derivative())); }
+template <class P> inline bool isFinite(const Dual_<P>& x)
+{   return isFinite(x.value()) && isFinite(x.derivative()); }
+template <class P> inline bool isNaN(const negator< Dual_<P> >& x)
+{   return isNaN(-x); }
+template <class P> inline bool isInf(const negator< Dual_<P> >& x)
+{   return isInf(-x); }
+template <class P> inline bool isFinite(const negator< Dual_<P> >& x)
+{   return isFinite(-x); }
+//@}
+
+/// Write a Dual_ as "value+derivative*e".
+template <class P> inline std::ostream&
+operator<<(std::ostream& o, const Dual_<P>& x)
+{   return o << x.value() << (x.derivative() < 0 ? "" : "+")
+             << x.derivative() << "e"; }
+
+/** Partial specialization for dual numbers. A Dual_ behaves like a real
+number for the purposes of the composite numerical types: it is its own
+transpose, real part, standard form and so on. Operations combining it with
+any other scalar produce a Dual_. **/
+template <class P> class NTraits< Dual_<P> > {
+public:
+    typedef Dual_<P>         T;
+    typedef negator<T>       TNeg;
+    typedef T                TWithoutNegator;
+    typedef T                TReal;
+    typedef T                TImag;
+    typedef T                TComplex;
+    typedef T                THerm;
+    typedef T                TPosTrans;
+    typedef T                TSqHermT;
+    typedef T                TSqTHerm;
+    typedef T                TElement;
+    typedef T                TRow;
+    typedef T                TCol;
+    typedef T                TSqrt;
+    typedef T                TAbs;
+    typedef T                TStandard;
+    typedef T                TInvert;
+    typedef T                TNormalize;
+    typedef T                Scalar;
+    typedef T                ULessScalar;
+    typedef T                Number;
+    typedef T                StdNumber;
+    typedef P                Precision;
+    typedef T                ScalarNormSq;
+
+private:
+    // A scalar of any kind combines with a Dual_ to give a Dual_; for
+    // composite types the answer is that of the commuted operation, as
+    // for the other numbers.
+    template <class Q, bool QIsScalar> struct ResultHelper {
+        typedef T Mul; typedef T Dvd; typedef T Add; typedef T Sub;
+    };
+    template <class Q> struct ResultHelper<Q,false> {
+        typedef typename CNT<Q>::template Result<T>::Mul Mul;
+        typedef typename CNT< typename CNT<Q>::THerm >
+                    ::template Result<T>::Mul Dvd;
+        typedef typename CNT<Q>::template Result<T>::Add Add;
+        typedef typename CNT< typename CNT<Q>::TNeg >
+                    ::template Result<T>::Add Sub;
+    };
+public:
+    template <class Q> struct Result {
+        typedef ResultHelper<Q, static_cast<int>(CNT<Q>::IsScalar) != 0> H;
+        typedef typename H::Mul Mul;
+        typedef typename H::Dvd Dvd;
+        typedef typename H::Add Add;
+        typedef typename H::Sub Sub;
+    };
+
+    // Shape-preserving element substitution (easy for scalars!)
+    template <class Q> struct Substitute {
+        typedef Q Type;
+    };
+
+    enum {
+        NRows               = 1,
+        NCols               = 1,
+        RowSpacing          = 1,
+        ColSpacing          = 1,
+        NPackedElements     = 1,
+        NActualElements     = 1,
+        NActualScalars      = 1,
+        ImagOffset          = 0,
+        RealStrideFactor    = 1,
+        ArgDepth            = SCALAR_DEPTH,
+        IsScalar            = 1,
+        IsULessScalar       = 1,
+        IsNumber            = 1,
+        IsStdNumber         = 1,
+        IsPrecision         = 0,
+        SignInterpretation  = 1
+    };
+
+    static const T* getData(const T& t) { return &t; }
+    static T*       updData(T& t)       { return &t; }
+    static const T& real(const T& t) { return t; }
+    static T&       real(T& t)       { return t; }
+    static const T& imag(const T&)   { return getZero(); }
+
+    static const TNeg& negate(const T& t) {return reinterpret_cast<const TNeg&>(t);}
+    static       TNeg& negate(T& t)       {return reinterpret_cast<TNeg&>(t);}
+
+    static const THerm& transpose(const T& t) {return t;}
+    static       THerm& transpose(T& t)       {return t;}
+
+    static const TPosTrans& positionalTranspose(const T& t) {return t;}
+    static       TPosTrans& positionalTranspose(T& t)       {return t;}
+
+    static const TWithoutNegator& castAwayNegatorIfAny(const T& t) {return t;}
+    static       TWithoutNegator& updCastAwayNegatorIfAny(T& t)    {return t;}
+
+    static ScalarNormSq scalarNormSqr(const T& t) {return t*t;}
+    static TSqrt        sqrt(const T& t)
+    {   const P s = std::sqrt(t.value()); return T(s, t.derivative()/(2*s)); }
+    static TAbs         abs(const T& t) {return SimTK::abs(t);}
+    static const TStandard& standardize(const T& t) {return t;}
+    static TNormalize normalize(const T& t)
+    {   return T(NTraits<P>::normalize(t.value())); }
+    static TInvert invert(const T& t) {return P(1)/t;}
+
+    static const T& getNaN() {
+        static const T c(NTraits<P>::getNaN(), NTraits<P>::getNaN());
+        return c;
+    }
+    static const T& getInfinity() {
+        static const T c(NTraits<P>::getInfinity(), 0);
+        return c;
+    }
+
+    static bool isFinite(const T& t) {return SimTK::isFinite(t);}
+    static bool isNaN(const T& t) {return SimTK::isNaN(t);}
+    static bool isInf(const T& t) {return SimTK::isInf(t);}
+
+    static double getDefaultTolerance()
+    {   return RTraits<P>::getDefaultTolerance(); }
+
+    // Numerical equality requires both the values and the derivatives to
+    // match.
+    static bool isNumericallyEqual(const T& a, const T& b, double tol)
+    {   return SimTK::isNumericallyEqual(a.value(), b.value(), tol)
+            && SimTK::isNumericallyEqual(a.derivative(), b.derivative(), tol); }
+    static bool isNumericallyEqual(const T& a, const T& b)
+    {   return isNumericallyEqual(a, b, getDefaultTolerance()); }
+    static bool isNumericallyEqual(const T& a, const P& b, double tol)
+    {   return isNumericallyEqual(a, T(b), tol); }
+    static bool isNumericallyEqual(const T& a, const P& b)
+    {   return isNumericallyEqual(a, T(b)); }
+    static bool isNumericallyEqual(const T& a, int b, double tol)
+    {   return isNumericallyEqual(a, T(b), tol); }
+    static bool isNumericallyEqual(const T& a, int b)
+    {   return isNumericallyEqual(a, T(b)); }
+
+    static const T& getZero()     {static const T c(NTraits<P>::getZero());     return c;}
+    static const T& getOne()      {static const T c(NTraits<P>::getOne());      return c;}
+    static const T& getMinusOne() {static const T c(NTraits<P>::getMinusOne()); return c;}
+    static const T& getTwo()      {static const T c(NTraits<P>::getTwo());      return c;}
+    static const T& getThree()    {static const T c(NTraits<P>::getThree());    return c;}
+    static const T& getOneHalf()  {static const T c(NTraits<P>::getOneHalf());  return c;}
+    static const T& getPi()       {static const T c(NTraits<P>::getPi());       return c;}
+};
+
+template <class P> class CNT< Dual_<P> > : public NTraits< Dual_<P> > { };
+
+// A real combined with a Dual_ is a Dual_. These have to be given explicitly
+// since the generic answer for reals is defined in terms of the commuted
+// operation, which would lead back here.
+template <class P> struct NTraits<float>::Result< Dual_<P> >
+  {typedef Dual_<P> Mul; typedef Mul Dvd; typedef Mul Add; typedef Mul Sub;};
+template <class P> struct NTraits<double>::Result< Dual_<P> >
+  {typedef Dual_<P> Mul; typedef Mul Dvd; typedef Mul Add; typedef Mul Sub;};
+
+/// @name Dual_ numerical equality
+//@{
+template <class P> inline bool
+isNumericallyEqual(const Dual_<P>& a, const Dual_<P>& b)
+{   return NTraits< Dual_<P> >::isNumericallyEqual(a, b); }
+template <class P> inline bool
+isNumericallyEqual(const Dual_<P>& a, const Dual_<P>& b, double tol)
+{   return NTraits< Dual_<P> >::isNumericallyEqual(a, b, tol); }
+//@}
+
+/// @name Small matrices scaled by a Dual_
+/// These match the operators the small matrix classes provide for the
+/// built-in scalars. The result has Dual_ elements.
+//@{
+template <int M, class E, int S, class P> inline
+typename Vec<M,E,S>::template Result< Dual_<P> >::Mul
+operator*(const Vec<M,E,S>& l, const Dual_<P>& r)
+{   return Vec<M,E,S>::template Result< Dual_<P> >::MulOp::perform(l,r); }
+template <int M, class E, int S, class P> inline
+typename Vec<M,E,S>::template Result< Dual_<P> >::Mul
+operator*(const Dual_<P>& l, const Vec<M,E,S>& r) {return r*l;}
+template <int M, class E, int S, class P> inline
+typename Vec<M,E,S>::template Result< Dual_<P> >::Dvd
+operator/(const Vec<M,E,S>& l, const Dual_<P>& r)
+{   return Vec<M,E,S>::template Result< Dual_<P> >::DvdOp::perform(l,r); }
+
+template <int N, class E, int S, class P> inline
+typename Row<N,E,S>::template Result< Dual_<P> >::Mul
+operator*(const Row<N,E,S>& l, const Dual_<P>& r)
+{   return Row<N,E,S>::template Result< Dual_<P> >::MulOp::perform(l,r); }
+template <int N, class E, int S, class P> inline
+typename Row<N,E,S>::template Result< Dual_<P> >::Mul
+operator*(const Dual_<P>& l, const Row<N,E,S>& r) {return r*l;}
+template <int N, class E, int S, class P> inline
+typename Row<N,E,S>::template Result< Dual_<P> >::Dvd
+operator/(const Row<N,E,S>& l, const Dual_<P>& r)
+{   return Row<N,E,S>::template Result< Dual_<P> >::DvdOp::perform(l,r); }
+
+template <int M, int N, class E, int CS, int RS, class P> inline
+typename Mat<M,N,E,CS,RS>::template Result< Dual_<P> >::Mul
+operator*(const Mat<M,N,E,CS,RS>& l, const Dual_<P>& r)
+{   return Mat<M,N,E,CS,RS>::template Result< Dual_<P> >::MulOp::perform(l,r); }
+template <int M, int N, class E, int CS, int RS, class P> inline
+typename Mat<M,N,E,CS,RS>::template Result< Dual_<P> >::Mul
+operator*(const Dual_<P>& l, const Mat<M,N,E,CS,RS>& r) {return r*l;}
+template <int M, int N, class E, int CS, int RS, class P> inline
+typename Mat<M,N,E,CS,RS>::template Result< Dual_<P> >::Dvd
+operator/(const Mat<M,N,E,CS,RS>& l, const Dual_<P>& r)
+{   return Mat<M,N,E,CS,RS>::template Result< Dual_<P> >::DvdOp::perform(l,r); }
+
+template <int M, class E, int S, class P> inline
+typename SymMat<M,E,S>::template Result< Dual_<P> >::Mul
+operator*(const SymMat<M,E,S>& l, const Dual_<P>& r)
+{   return SymMat<M,E,S>::template Result< Dual_<P> >::MulOp::perform(l,r); }
+template <int M, class E, int S, class P> inline
+typename SymMat<M,E,S>::template Result< Dual_<P> >::Mul
+operator*(const Dual_<P>& l, const SymMat<M,E,S>& r) {return r*l;}
+template <int M, class E, int S, class P> inline
+typename SymMat<M,E,S>::template Result< Dual_<P> >::Dvd
+operator/(const SymMat<M,E,S>& l, const Dual_<P>& r)
+{   return SymMat<M,E,S>::template Result< Dual_<P> >::DvdOp::perform(l,r); }
+//@}
+
+/// @name Splitting and seeding Dual_ small matrices
+/// Helpers for moving between Real quantities and their Dual_ counterparts.
+/// makeDual() pairs a value with a derivative (seed direction); getValue()
+/// and getDerivative() take a Dual_ result apart again. Overloads handle
+/// scalars, Vec, Row, Mat, and Vec of Vec such as SpatialVec.
+//@{
+inline Dual_<float> makeDual(float value, float derivative)
+{   return Dual_<float>(value, derivative); }
+inline Dual_<double> makeDual(double value, double derivative)
+{   return Dual_<double>(value, derivative); }
+template <class P> inline const P& getValue(const Dual_<P>& x)
+{   return x.value(); }
+template <class P> inline const P& getDerivative(const Dual_<P>& x)
+{   return x.derivative(); }
+template <class P> inline P getValue(const negator< Dual_<P> >& x)
+{   return -(-x).value(); }
+template <class P> inline P getDerivative(const negator< Dual_<P> >& x)
+{   return -(-x).derivative(); }
+
+template <int M, class E, int S1, int S2> inline
+Vec<M, typename CNT<E>::template Substitute<
+           Dual_<typename CNT<E>::Precision> >::Type>
+makeDual(const Vec<M,E,S1>& value, const Vec<M,E,S2>& derivative) {
+    Vec<M, typename CNT<E>::template Substitute<
+               Dual_<typename CNT<E>::Precision> >::Type> result;
+    for (int i=0; i < M; ++i) result[i] = makeDual(value[i], derivative[i]);
+    return result;
+}
+template <int M, class E, int S> inline
+Vec<M, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getValue(const Vec<M,E,S>& x) {
+    Vec<M, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type> result;
+    for (int i=0; i < M; ++i) result[i] = getValue(x[i]);
+    return result;
+}
+template <int M, class E, int S> inline
+Vec<M, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getDerivative(const Vec<M,E,S>& x) {
+    Vec<M, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type> result;
+    for (int i=0; i < M; ++i) result[i] = getDerivative(x[i]);
+    return result;
+}
+
+template <int N, class E, int S> inline
+Row<N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getValue(const Row<N,E,S>& x) {return ~getValue(~x);}
+template <int N, class E, int S> inline
+Row<N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getDerivative(const Row<N,E,S>& x) {return ~getDerivative(~x);}
+
+template <int M, int N, class E, int CS1, int RS1, int CS2, int RS2> inline
+Mat<M,N, typename CNT<E>::template Substitute<
+             Dual_<typename CNT<E>::Precision> >::Type>
+makeDual(const Mat<M,N,E,CS1,RS1>& value,
+         const Mat<M,N,E,CS2,RS2>& derivative) {
+    Mat<M,N, typename CNT<E>::template Substitute<
+                 Dual_<typename CNT<E>::Precision> >::Type> result;
+    for (int i=0; i < M; ++i)
+        for (int j=0; j < N; ++j)
+            result(i,j) = makeDual(value(i,j), derivative(i,j));
+    return result;
+}
+template <int M, int N, class E, int CS, int RS> inline
+Mat<M,N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getValue(const Mat<M,N,E,CS,RS>& x) {
+    Mat<M,N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type> result;
+    for (int i=0; i < M; ++i)
+        for (int j=0; j < N; ++j)
+            result(i,j) = getValue(x(i,j));
+    return result;
+}
+template <int M, int N, class E, int CS, int RS> inline
+Mat<M,N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type>
+getDerivative(const Mat<M,N,E,CS,RS>& x) {
+    Mat<M,N, typename CNT<E>::template Substitute<
+           typename CNT<E>::Precision>::Type> result;
+    for (int i=0; i < M; ++i)
+        for (int j=0; j < N; ++j)
+            result(i,j) = getDerivative(x(i,j));
+    return result;
+}
+//@}
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATRIX_DUAL_H_
@@ -251,6 +251,11 @@ public:
             && numericallyEqual(v1.imag(), v2.imag(), n, tol);
     }
     template <class P>
+    static bool numericallyEqual(const Dual_<P>& v1, const Dual_<P>& v2, int n, double tol=defTol<P>()) {
+        return numericallyEqual(v1.value(), v2.value(), n, tol)
+            && numericallyEqual(v1.derivative(), v2.derivative(), n, tol);
+    }
+    template <class P>
     static bool numericallyEqual(const negator<P>& v1, const negator<P>& v2, int n, double tol=defTol<P>()) {
         return numericallyEqual(-v1, -v2, n, tol);  // P, P
     }
@@ -91,6 +91,60 @@ public:
     T calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
 
+    /**
+     * Calculate the value of a function of a single argument; 
+     * getArgumentSize() must return 1. This gives the same result as 
+     * calcValue(const Vector&) with a one-element Vector, but the predefined
+     * subclasses and Spline_ override it so that no Vector need be built.
+     * The default implementation passes a Vector that refers to \a x in 
+     * place.
+     */
+    virtual T calcValue(Real x) const {
+        return calcValue(Vector(1, &x, true));
+    }
+    /**
+     * Calculate a derivative of a function of a single argument; 
+     * getArgumentSize() must return 1. This gives the same result as 
+     * calcDerivative(const Array_<int>&, const Vector&) with \a derivOrder
+     * zeros for the derivative components, but without building an Array_
+     * or a Vector in the predefined subclasses and Spline_.
+     * 
+     * @param       derivOrder
+     *      Which derivative to take: 1 for the first derivative, 2 for the 
+     *      second, and so on. It must be no larger than the value returned
+     *      by getMaxDerivativeOrder().
+     * @param       x
+     *      The value of the single input argument.
+     */
+    virtual T calcDerivative(int derivOrder, Real x) const {
+        assert(derivOrder >= 0);
+        const int MaxCheapOrder = 8;
+        int zeros[MaxCheapOrder] = {0};
+        const Vector xv(1, &x, true);
+        if (derivOrder <= MaxCheapOrder) // refer to the stack buffer
+            return calcDerivative
+               (Array_<int>(zeros, zeros+derivOrder, DontCopy()), xv);
+        return calcDerivative(Array_<int>(derivOrder, 0), xv);
+    }
+
+    /** Calculate the value of this function at a point given as a 
+    fixed-size Vec, whose length must equal getArgumentSize(). This uses
+    calcValue(Real) when N is 1; otherwise the Vec's data is passed in place 
+    to calcValue(const Vector&) rather than being copied. **/
+    template <int N>
+    T calcValue(const Vec<N>& x) const {
+        if (N == 1) return calcValue(x[0]);
+        return calcValue(Vector(N, &x[0], true));
+    }
+    /** Calculate a partial derivative of this function at a point given as 
+    a fixed-size Vec; see calcValue(const Vec<N>&). **/
+    template <int N>
+    T calcDerivative(const Array_<int>& derivComponents, 
+                     const Vec<N>&      x) const {
+        if (N == 1) return calcDerivative((int)derivComponents.size(), x[0]);
+        return calcDerivative(derivComponents, Vector(N, &x[0], true));
+    }
+
     /**
      * Get the number of components expected in the input vector.
      */
@@ -143,6 +197,13 @@ public:
                      const Vector& x) const override {
         return static_cast<T>(0);
     }
+    T calcValue(Real x) const override {
+        assert(argumentSize == 1);
+        return value;
+    }
+    T calcDerivative(int derivOrder, Real x) const override {
+        return static_cast<T>(0);
+    }
     int getArgumentSize() const override {
         return argumentSize;
     }
@@ -156,6 +217,10 @@ public:
     copying. **/
     T calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
+    /** Make the single-argument and fixed-size signatures from the base 
+    class visible here too. **/
+    using Function_<T>::calcValue;
+    using Function_<T>::calcDerivative;
 
 private:
     int argumentSize;
@@ -197,6 +262,17 @@ public:
             return coefficients(derivComponents[0]);
         return static_cast<T>(0);
     }
+    T calcValue(Real x) const override {
+        assert(coefficients.size() == 2);
+        return x*coefficients[0] + coefficients[1];
+    }
+    T calcDerivative(int derivOrder, Real x) const override {
+        assert(coefficients.size() == 2);
+        assert(derivOrder > 0);
+        if (derivOrder == 1)
+            return coefficients[0];
+        return static_cast<T>(0);
+    }
     int getArgumentSize() const override {
         return coefficients.size()-1;
     }
@@ -210,6 +286,10 @@ public:
     copying. **/
     T calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
+    /** Make the single-argument and fixed-size signatures from the base 
+    class visible here too. **/
+    using Function_<T>::calcValue;
+    using Function_<T>::calcDerivative;
 private:
     Vector_<T> coefficients;
 };
@@ -232,19 +312,22 @@ public:
     }
     T calcValue(const Vector& x) const override {
         assert(x.size() == 1);
-        Real arg = x[0];
+        return calcValue(x[0]);
+    }
+    T calcDerivative(const Array_<int>& derivComponents, 
+                     const Vector& x) const override {
+        assert(x.size() == 1);
+        return calcDerivative((int)derivComponents.size(), x[0]);
+    }
+    T calcValue(Real arg) const override {
         T value = static_cast<T>(0);
         for (int i = 0; i < coefficients.size(); ++i)
             value = value*arg + coefficients[i];
         return value;
     }
-    T calcDerivative(const Array_<int>& derivComponents, 
-                     const Vector& x) const override {
-        assert(x.size() == 1);
-        assert(derivComponents.size() > 0);
-        Real arg = x[0];
+    T calcDerivative(int derivOrder, Real arg) const override {
+        assert(derivOrder > 0);
         T value = static_cast<T>(0);
-        const int derivOrder = (int)derivComponents.size();
         const int polyOrder = coefficients.size()-1;
         for (int i = 0; i <= polyOrder-derivOrder; ++i) {
             T coeff = coefficients[i];
@@ -267,6 +350,10 @@ public:
     copying. **/
     T calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
+    /** Make the single-argument and fixed-size signatures from the base 
+    class visible here too. **/
+    using Function_<T>::calcValue;
+    using Function_<T>::calcDerivative;
 private:
     Vector_<T> coefficients;
 };
@@ -303,14 +390,19 @@ public:
     // Implementation of Function_<T> virtuals.
 
     virtual Real calcValue(const Vector& x) const override {
-        const Real t = x[0]; // we expect just one argument
-        return a*std::sin(w*t + p);
+        return calcValue(x[0]); // we expect just one argument
     }
 
     virtual Real calcDerivative(const Array_<int>& derivComponents,
                                 const Vector&      x) const override {
-        const Real t = x[0]; // time is the only argument
-        const int order = derivComponents.size();
+        return calcDerivative((int)derivComponents.size(), x[0]);
+    }
+
+    Real calcValue(Real t) const override {
+        return a*std::sin(w*t + p);
+    }
+
+    Real calcDerivative(int order, Real t) const override {
         // The n'th derivative is
         //    sign * a * w^n * sc
         // where sign is -1 if floor(order/2) is odd, else 1
@@ -340,6 +432,10 @@ public:
     Real calcDerivative(const std::vector<int>& derivComponents, 
                         const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
+    /** Make the single-argument and fixed-size signatures from the base 
+    class visible here too. **/
+    using Function_<Real>::calcValue;
+    using Function_<Real>::calcDerivative;
 private:
     Real a, w, p;
 };
@@ -388,12 +484,7 @@ public:
             "Function_<T>::Step::calcValue()", 
             "Expected just one input argument but got %d.", xin.size());
 
-        const Real x = xin[0];
-        if ((x-m_x0)*m_sign <= 0) return m_y0;
-        if ((x-m_x1)*m_sign >= 0) return m_y1;
-        // f goes from 0 to 1 as x goes from x0 to x1.
-        const Real f = stepAny(0,1,m_x0,m_ooxr, x);
-        return m_y0 + f*m_yr;
+        return calcValue(xin[0]);
     }
 
     T calcDerivative(const Array_<int>& derivComponents, 
@@ -402,12 +493,22 @@ public:
             "Function_<T>::Step::calcDerivative()", 
             "Expected just one input argument but got %d.", xin.size());
 
-        const int derivOrder = (int)derivComponents.size();
+        return calcDerivative((int)derivComponents.size(), xin[0]);
+    }
+
+    T calcValue(Real x) const override {
+        if ((x-m_x0)*m_sign <= 0) return m_y0;
+        if ((x-m_x1)*m_sign >= 0) return m_y1;
+        // f goes from 0 to 1 as x goes from x0 to x1.
+        const Real f = stepAny(0,1,m_x0,m_ooxr, x);
+        return m_y0 + f*m_yr;
+    }
+
+    T calcDerivative(int derivOrder, Real x) const override {
         SimTK_ERRCHK1_ALWAYS(1 <= derivOrder && derivOrder <= 3,
             "Function_<T>::Step::calcDerivative()",
             "Only 1st, 2nd, and 3rd derivatives of the step are available,"
             " but derivative %d was requested.", derivOrder);
-        const Real x = xin[0];
         if ((x-m_x0)*m_sign <= 0) return m_zero;
         if ((x-m_x1)*m_sign >= 0) return m_zero;
         switch(derivOrder) {
@@ -428,6 +529,10 @@ public:
     copying. **/
     T calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const 
     {   return calcDerivative(ArrayViewConst_<int>(derivComponents),x); }
+    /** Make the single-argument and fixed-size signatures from the base 
+    class visible here too. **/
+    using Function_<T>::calcValue;
+    using Function_<T>::calcDerivative;
 private:
     T    m_y0, m_y1, m_yr;   // precalculate yr=(y1-y0)
     T    m_zero;             // precalculate T(0)
@@ -27,6 +27,8 @@
 #include "PrivateImplementation.h"
 #include <thread>
 #include <iostream>
+#include <exception>
+#include <mutex>
  
 namespace SimTK {
 
@@ -123,6 +125,27 @@ public:
      * @param times   the number of times the Task should be executed
      */
     void execute(Task& task, int times);
+    /**
+     * Execute a parallel task unless this ParallelExecutor is already busy
+     * with another caller's task, or the calling thread is itself a worker
+     * thread. In those cases nothing is executed and false is returned, so
+     * the caller can do the work serially instead of waiting.
+     *
+     * @param task    the Task to execute
+     * @param times   the number of times the Task should be executed
+     * @return        true if the Task was executed
+     */
+    bool tryExecute(Task& task, int times);
+    /**
+     * Call body(i) for i = 0..n-1, concurrently if tryExecute() succeeds and
+     * otherwise serially on the calling thread. @p body may be any callable
+     * taking an int; it is not copied.
+     *
+     * If any calls throw, the rest are still made and then the exception from
+     * the lowest i is rethrown, so that the outcome doesn't depend on
+     * scheduling.
+     */
+    template <class Body> void forEach(int n, const Body& body);
     /**
      * Get the total number of available processor cores (physical cores and
      * hyperthreads on Intel architecture). If the number of threads is not
@@ -169,6 +192,35 @@ public:
     }
 };
 
+template <class Body>
+void ParallelExecutor::forEach(int n, const Body& body) {
+    class ForEachTask : public Task {
+    public:
+        explicit ForEachTask(const Body& body) : body(body), errorIndex(-1) {}
+        void execute(int index) override {
+            try {body(index);}
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (errorIndex < 0 || index < errorIndex) {
+                    errorIndex = index;
+                    error = std::current_exception();
+                }
+            }
+        }
+        const Body&         body;
+        int                 errorIndex; // lowest index that threw, or -1
+        std::exception_ptr  error;
+        std::mutex          errorMutex;
+    };
+
+    ForEachTask task(body);
+    if (n < 2 || !tryExecute(task, n))
+        for (int i = 0; i < n; ++i)
+            task.execute(i);
+    if (task.error)
+        std::rethrow_exception(task.error);
+}
+
 } // namespace SimTK
 
 #endif // SimTK_SimTKCOMMON_PARALLEL_EXECUTOR_H_
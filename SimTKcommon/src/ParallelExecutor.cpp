@@ -35,7 +35,14 @@ namespace SimTK {
 
 static void threadBody(ThreadInfo& info);
 
-ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
+// How many times an idle thread polls for a state change (yielding between
+// polls) before it parks on a condition variable. This covers the gap between
+// back-to-back execute() calls in a typical time-stepping loop.
+static const int SpinCount = 1000;
+
+ParallelExecutorImpl::ParallelExecutorImpl()
+:   finished(false), generation(0), activeWorkerCount(0), parkedWorkerCount(0),
+    currentTask(nullptr), currentTaskCount(0), chunkSize(1) {
 
     //By default, we use the total number of processors available of the
     //computer (including hyperthreads)
@@ -43,7 +50,9 @@ ParallelExecutorImpl::ParallelExecutorImpl() : finished(false) {
     if(numMaxThreads <= 0)
       numMaxThreads = 1;
 }
-ParallelExecutorImpl::ParallelExecutorImpl(int numThreads) : finished(false) {
+ParallelExecutorImpl::ParallelExecutorImpl(int numThreads)
+:   finished(false), generation(0), activeWorkerCount(0), parkedWorkerCount(0),
+    currentTask(nullptr), currentTaskCount(0), chunkSize(1) {
 
     // Set the maximum number of threads that we can use
     SimTK_APIARGCHECK_ALWAYS(numThreads > 0, "ParallelExecutorImpl",
@@ -55,9 +64,8 @@ ParallelExecutorImpl::~ParallelExecutorImpl() {
     // Notify the threads that they should exit.
     
     std::unique_lock<std::mutex> lock(runMutex);
-    finished = true;
-    for (int i = 0; i < (int) threads.size(); ++i)
-        threadInfo[i].running = true;
+    finished.store(true, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
     runCondition.notify_all();
     lock.unlock();
     
@@ -70,6 +78,19 @@ ParallelExecutorImpl* ParallelExecutorImpl::clone() const {
     return new ParallelExecutorImpl(numMaxThreads);
 }
 void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
+    std::lock_guard<std::mutex> lock(executeMutex);
+    run(task, times);
+}
+bool ParallelExecutorImpl::tryExecute(ParallelExecutor::Task& task, int times) {
+    if (isWorker)
+        return false;
+    std::unique_lock<std::mutex> lock(executeMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return false;
+    run(task, times);
+    return true;
+}
+void ParallelExecutorImpl::run(ParallelExecutor::Task& task, int times) {
   if (numMaxThreads < 2) {
       //(1) NON-PARALLEL CASE:
       // Nothing is actually going to get done in parallel, so we might as well
@@ -88,6 +109,7 @@ void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
       // We do not support numMaxThreads changing for a given instance of
       // ParallelExecutor.
       assert(threads.size() == 0);
+      ranges.reset(new WorkRange[numMaxThreads]);
       threadInfo.reserve(numMaxThreads);
       threads.resize(numMaxThreads);
       for (int i = 0; i < numMaxThreads; ++i) {
@@ -96,26 +118,124 @@ void ParallelExecutorImpl::execute(ParallelExecutor::Task& task, int times) {
       }
     }
    
-    // Initialize fields to execute the new task.
-    std::unique_lock<std::mutex> lock(runMutex);
+    // Give each thread a contiguous block of indices. Threads take their own
+    // block in chunks small enough that there is something left to steal
+    // when the per-index cost is uneven.
+    const int numThreads = (int)threads.size();
     currentTask = &task;
     currentTaskCount = times;
-    waitingThreadCount = 0;
-    for (int i = 0; i < (int)threadInfo.size(); ++i) {
-        threadInfo[i].running = true;
+    chunkSize = std::max(1, times / (8*numThreads));
+    for (int i = 0; i < numThreads; ++i) {
+        const int begin = (int)((long long)times*i / numThreads);
+        const int end   = (int)((long long)times*(i+1) / numThreads);
+        ranges[i].bounds.store(WorkRange::pack(begin, end),
+                               std::memory_order_relaxed);
     }
+    activeWorkerCount.store(numThreads, std::memory_order_relaxed);
 
-    // Wake up the worker threads and wait until they finish.
-    runCondition.notify_all();
-    waitCondition.wait(lock,
-        [&] { return waitingThreadCount == (int)threads.size(); });
+    // Publish the new task. Only threads that have already parked need an
+    // explicit notification; spinning threads will see the new generation.
+    std::unique_lock<std::mutex> lock(runMutex);
+    generation.fetch_add(1, std::memory_order_release);
+    const bool anyParked = parkedWorkerCount > 0;
     lock.unlock();
+    if (anyParked)
+        runCondition.notify_all();
+
+    // Wait until every worker has called finish().
+    for (int spin = 0; spin < SpinCount; ++spin) {
+        if (activeWorkerCount.load(std::memory_order_acquire) == 0)
+            return;
+        std::this_thread::yield();
+    }
+    lock.lock();
+    waitCondition.wait(lock, [&]
+        { return activeWorkerCount.load(std::memory_order_acquire) == 0; });
+}
+unsigned ParallelExecutorImpl::waitForWork(unsigned lastGeneration) {
+    for (int spin = 0; spin < SpinCount; ++spin) {
+        const unsigned current = generation.load(std::memory_order_acquire);
+        if (current != lastGeneration)
+            return current;
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(runMutex);
+    ++parkedWorkerCount;
+    runCondition.wait(lock, [&]
+        { return generation.load(std::memory_order_acquire) != lastGeneration; });
+    --parkedWorkerCount;
+    return generation.load(std::memory_order_acquire);
+}
+bool ParallelExecutorImpl::claimOwnChunk(int index, int& begin, int& end) {
+    std::atomic<std::uint64_t>& bounds = ranges[index].bounds;
+    std::uint64_t current = bounds.load(std::memory_order_acquire);
+    while (true) {
+        const int b = WorkRange::begin(current), e = WorkRange::end(current);
+        if (b >= e)
+            return false;
+        const int mid = std::min(e, b + chunkSize);
+        if (bounds.compare_exchange_weak(current, WorkRange::pack(mid, e),
+                                         std::memory_order_acq_rel)) {
+            begin = b;
+            end = mid;
+            return true;
+        }
+    }
+}
+bool ParallelExecutorImpl::stealChunk(int index, int& begin, int& end) {
+    // Visit the other workers starting with our neighbor, and take the back
+    // half of the first nonempty range found. The stolen indices become our
+    // own range so that other idle threads can steal from us in turn. Nobody
+    // else writes our range while it is empty, so a plain store is safe.
+    const int numThreads = (int)threads.size();
+    for (int k = 1; k < numThreads; ++k) {
+        std::atomic<std::uint64_t>& victim =
+            ranges[(index + k) % numThreads].bounds;
+        std::uint64_t current = victim.load(std::memory_order_acquire);
+        while (true) {
+            const int b = WorkRange::begin(current), e = WorkRange::end(current);
+            if (b >= e)
+                break;
+            const int mid = b + (e-b)/2;
+            if (victim.compare_exchange_weak(current, WorkRange::pack(b, mid),
+                                             std::memory_order_acq_rel)) {
+                ranges[index].bounds.store(WorkRange::pack(mid, e),
+                                           std::memory_order_release);
+                return claimOwnChunk(index, begin, end);
+            }
+        }
+    }
+    return false;
+}
+void ParallelExecutorImpl::runCurrentTask(int index) {
+    ParallelExecutor::Task& task = getCurrentTask();
+    task.initialize();
+    try {
+        int begin, end;
+        while (claimOwnChunk(index, begin, end) 
+               || stealChunk(index, begin, end)) {
+            for (int i = begin; i < end; ++i)
+                task.execute(i);
+        }
+    }
+    catch (const std::exception& ex) {
+        std::cerr <<"The parallel task threw an unhandled exception:"<< std::endl;
+        std::cerr <<ex.what()<< std::endl;
+    }
+    catch (...) {
+        std::cerr <<"The parallel task threw an error."<< std::endl;
+    }
+    {
+        std::lock_guard<std::mutex> lock(finishMutex);
+        task.finish();
+    }
+    markWorkerDone();
 }
-void ParallelExecutorImpl::incrementWaitingThreads() {
-    std::lock_guard<std::mutex> lock(runMutex);
-    getCurrentTask().finish();
-    waitingThreadCount++;
-    if (waitingThreadCount == (int)threads.size()) {
+void ParallelExecutorImpl::markWorkerDone() {
+    if (activeWorkerCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Taking the lock ensures the caller is either still spinning or
+        // already waiting on the condition, so the notification isn't lost.
+        std::lock_guard<std::mutex> lock(runMutex);
         waitCondition.notify_one();
     }
 }
@@ -129,39 +249,18 @@ thread_local bool ParallelExecutorImpl::isWorker(false);
 void threadBody(ThreadInfo& info) {
     ParallelExecutorImpl::isWorker = true;
     ParallelExecutorImpl& executor = *info.executor;
-    int threadCount = executor.getThreadCount();
-    while (!executor.isFinished()) {
+    unsigned lastGeneration = 0;
+    while (true) {
         
         // Wait for a Task to come in.
         
-        std::unique_lock<std::mutex> lock(executor.getMutex());
-        executor.getCondition().wait(lock, [&] { return info.running; });
-        lock.unlock();
-        if (!executor.isFinished()) {
+        lastGeneration = executor.waitForWork(lastGeneration);
+        if (executor.isFinished())
+            break;
             
-            // Execute the task for all the indices belonging to this thread.
+        // Execute the task for our own indices, then help the others.
             
-            int count = executor.getCurrentTaskCount();
-            ParallelExecutor::Task& task = executor.getCurrentTask();
-            task.initialize();
-            int index = info.index;
-                        
-            try {
-                while (index < count) {
-                    task.execute(index);
-                    index += threadCount;
-                }
-            }
-            catch (const std::exception& ex) {
-                std::cerr <<"The parallel task threw an unhandled exception:"<< std::endl;
-                std::cerr <<ex.what()<< std::endl;
-            }
-            catch (...) {
-                std::cerr <<"The parallel task threw an error."<< std::endl;
-            }
-            info.running = false;
-            executor.incrementWaitingThreads();
-        }
+        executor.runCurrentTask(info.index);
     }
 }
 
@@ -179,6 +278,10 @@ void ParallelExecutor::execute(Task& task, int times) {
     updImpl().execute(task, times);
 }
 
+bool ParallelExecutor::tryExecute(Task& task, int times) {
+    return updImpl().tryExecute(task, times);
+}
+
 #ifdef __APPLE__
    #include <sys/sysctl.h>
    #include <dlfcn.h>
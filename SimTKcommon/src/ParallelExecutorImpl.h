@@ -27,7 +27,10 @@
 #include "SimTKcommon/internal/ParallelExecutor.h"
 #include "SimTKcommon/internal/Array.h"
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -42,15 +45,38 @@ class ParallelExecutorImpl;
 
 class ThreadInfo {
 public:
-    ThreadInfo(int index, ParallelExecutorImpl* executor) : index(index), executor(executor), running(false) {
+    ThreadInfo(int index, ParallelExecutorImpl* executor) : index(index), executor(executor) {
     }
     const int index;
     ParallelExecutorImpl* const executor;
-    bool running;
+};
+
+/**
+ * The half-open range of task indices [begin, end) that a worker thread still
+ * has to execute. Both ends are packed into a single 64 bit word so that the
+ * owning thread can claim chunks from the front while other threads steal
+ * from the back, all without locking. Each range lives on its own cache line.
+ */
+
+struct alignas(64) WorkRange {
+    static std::uint64_t pack(int begin, int end) {
+        return (std::uint64_t(std::uint32_t(end)) << 32) | std::uint32_t(begin);
+    }
+    static int begin(std::uint64_t bounds) {return int(std::uint32_t(bounds));}
+    static int end(std::uint64_t bounds)   {return int(std::uint32_t(bounds >> 32));}
+
+    std::atomic<std::uint64_t> bounds{0};
 };
 
 /**
  * This is the internal implementation class for ParallelExecutor.
+ *
+ * Each call to execute() splits the indices into one contiguous block per
+ * worker. Workers take their own block a chunk at a time, and when they run
+ * out they steal half of whatever remains in another worker's block, so an
+ * unusually expensive index delays only the thread running it. Idle workers
+ * spin briefly before parking on a condition variable, which keeps the
+ * wake-up cost low when tasks are issued at a high rate.
  */
 
 class ParallelExecutorImpl : public PIMPLImplementation<ParallelExecutor, ParallelExecutorImpl> {
@@ -59,7 +85,10 @@ public:
     ParallelExecutorImpl(int numThreads);
     ~ParallelExecutorImpl();
     ParallelExecutorImpl* clone() const;
+    // Concurrent callers take turns; tryExecute() gives up instead of
+    // waiting, and also when called from a worker thread.
     void execute(ParallelExecutor::Task& task, int times);
+    bool tryExecute(ParallelExecutor::Task& task, int times);
     int getThreadCount() {
         return threads.size();
     }
@@ -70,28 +99,37 @@ public:
         return currentTaskCount;
     }
     bool isFinished() {
-        return finished;
-    }
-    std::mutex& getMutex() {
-        return runMutex;
-    }
-    std::condition_variable& getCondition() {
-        return runCondition;
+        return finished.load(std::memory_order_acquire);
     }
     int getMaxThreads() const{
       return numMaxThreads;
     }
-    void incrementWaitingThreads();
+    /** Block the calling worker until the generation differs from
+    @p lastGeneration (a new task has been posted, or the executor is being
+    destroyed). Returns the new generation. **/
+    unsigned waitForWork(unsigned lastGeneration);
+    /** Execute the current task's indices on behalf of worker @p index,
+    stealing from the other workers once its own range is exhausted. **/
+    void runCurrentTask(int index);
     static thread_local bool isWorker;
 private:
-    bool finished;
-    std::mutex runMutex;
+    void run(ParallelExecutor::Task& task, int times);
+    bool claimOwnChunk(int index, int& begin, int& end);
+    bool stealChunk(int index, int& begin, int& end);
+    void markWorkerDone();
+
+    std::atomic<bool> finished;
+    std::atomic<unsigned> generation;
+    std::atomic<int> activeWorkerCount;
+    int parkedWorkerCount;
+    std::mutex executeMutex, runMutex, finishMutex;
     std::condition_variable runCondition, waitCondition;
     Array_<std::thread> threads;
     Array_<ThreadInfo> threadInfo;
+    std::unique_ptr<WorkRange[]> ranges;
     ParallelExecutor::Task* currentTask;
     int currentTaskCount;
-    int waitingThreadCount;
+    int chunkSize;
     int numMaxThreads;
 };
 
@@ -411,6 +411,58 @@ void testMisc() {
     //cout << "after clear(), State s=" << s;
 }
 
+// Discrete variables and cache entries of Instance stage and earlier are
+// shared by a State copy until one of the States writes to them; later ones
+// are copied right away.
+void testCopyOnWrite() {
+    const SubsystemIndex Sub0(0);
+    State s;
+    s.setNumSubsystems(1);
+
+    const DiscreteVariableIndex dvModel = 
+        s.allocateDiscreteVariable(Sub0, Stage::Model, new Value<int>(1));
+    const DiscreteVariableIndex dvPos = 
+        s.allocateDiscreteVariable(Sub0, Stage::Position, new Value<int>(2));
+    const CacheEntryIndex cxInstance = 
+        s.allocateCacheEntry(Sub0, Stage::Instance, new Value<int>(3));
+    const CacheEntryIndex cxTime = 
+        s.allocateCacheEntry(Sub0, Stage::Time, new Value<int>(4));
+    advanceStage(s, Stage::Topology);
+    advanceStage(s, Stage::Model);
+    advanceStage(s, Stage::Instance);
+    Value<int>::updDowncast(s.updCacheEntry(Sub0, cxInstance)) = 30;
+
+    State c(s);
+    SimTK_TEST(&c.getDiscreteVariable(Sub0, dvModel) 
+               == &s.getDiscreteVariable(Sub0, dvModel));
+    SimTK_TEST(&c.getDiscreteVariable(Sub0, dvPos) 
+               != &s.getDiscreteVariable(Sub0, dvPos));
+    SimTK_TEST(&c.getCacheEntry(Sub0, cxInstance) 
+               == &s.getCacheEntry(Sub0, cxInstance));
+    SimTK_TEST(Value<int>::downcast(c.getCacheEntry(Sub0, cxInstance)) == 30);
+    SimTK_TEST(&c.updCacheEntry(Sub0, cxTime) 
+               != &s.updCacheEntry(Sub0, cxTime));
+
+    // Writing to the copy leaves the source alone, and vice versa.
+    Value<int>::updDowncast(c.updDiscreteVariable(Sub0, dvModel)) = 10;
+    SimTK_TEST(&c.getDiscreteVariable(Sub0, dvModel) 
+               != &s.getDiscreteVariable(Sub0, dvModel));
+    SimTK_TEST(Value<int>::downcast(s.getDiscreteVariable(Sub0, dvModel))==1);
+    SimTK_TEST(Value<int>::downcast(c.getDiscreteVariable(Sub0, dvModel))==10);
+
+    // That invalidated Model stage in the copy only.
+    SimTK_TEST(c.getSystemStage() == Stage::Topology);
+    SimTK_TEST(s.getSystemStage() == Stage::Instance);
+
+    State c2(s), c3; c3 = s;
+    Value<int>::updDowncast(s.updCacheEntry(Sub0, cxInstance)) = 31;
+    SimTK_TEST(Value<int>::downcast(s.getCacheEntry(Sub0, cxInstance)) == 31);
+    SimTK_TEST(Value<int>::downcast(c2.getCacheEntry(Sub0, cxInstance)) == 30);
+    SimTK_TEST(Value<int>::downcast(c3.getCacheEntry(Sub0, cxInstance)) == 30);
+    SimTK_TEST(&c2.getCacheEntry(Sub0, cxInstance) 
+               == &c3.getCacheEntry(Sub0, cxInstance));
+}
+
 // Helper functions for testConsistent().
 // Allocate some part of the state, and alter the stage accordingly.
 // For Q, U, Z.
@@ -536,6 +588,7 @@ int main() {
         //SimTK_SUBTEST(testLowestModified);
         SimTK_SUBTEST(testCacheValidity);
         SimTK_SUBTEST(testMisc);
+        SimTK_SUBTEST(testCopyOnWrite);
         SimTK_SUBTEST(testConsistent);
     SimTK_END_TEST();
 }
@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- *
+ *                       Simbody(tm): SimTKcommon                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that derivatives computed with the Dual scalar, alone and as the
+element type of the small matrix classes, agree with the analytic ones and
+with central differences. */
+
+#include "SimTKcommon.h"
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+void testArithmetic() {
+    const Dual x(1.5, 1), y(-0.5, 2);
+
+    SimTK_TEST_EQ(x+y, Dual(1, 3));
+    SimTK_TEST_EQ(x-y, Dual(2, -1));
+    SimTK_TEST_EQ(x*y, Dual(-0.75, -0.5 + 3));
+    SimTK_TEST_EQ(x/y, Dual(-3, (1*-0.5 - 1.5*2)/0.25));
+    SimTK_TEST_EQ(2*x + 1, Dual(4, 2));
+    SimTK_TEST_EQ(x/2 - 1., Dual(-0.25, 0.5));
+    SimTK_TEST_EQ(3/x, Dual(2, -3/(1.5*1.5)));
+    SimTK_TEST_EQ(-x, Dual(-1.5, -1));
+
+    Dual z(x);
+    z *= y; z += 1; z /= x;
+    SimTK_TEST_EQ(z, (x*y + 1)/x);
+
+    // Comparisons ignore the derivative.
+    SimTK_TEST(Dual(1, 2) == Dual(1, 3));
+    SimTK_TEST(x > y && y < 0 && 2 > x && x <= 1.5);
+}
+
+// Each function's derivative is compared with its known derivative.
+void testFunctions() {
+    const Real a = 0.3; const Dual x(a, 1);
+    SimTK_TEST_EQ(sqrt(x).derivative(), 0.5/std::sqrt(a));
+    SimTK_TEST_EQ(exp(x).derivative(),  std::exp(a));
+    SimTK_TEST_EQ(log(x).derivative(),  1/a);
+    SimTK_TEST_EQ(sin(x).derivative(),  std::cos(a));
+    SimTK_TEST_EQ(cos(x).derivative(),  -std::sin(a));
+    SimTK_TEST_EQ(tan(x).derivative(),  1/square(std::cos(a)));
+    SimTK_TEST_EQ(asin(x).derivative(), 1/std::sqrt(1-a*a));
+    SimTK_TEST_EQ(acos(x).derivative(), -1/std::sqrt(1-a*a));
+    SimTK_TEST_EQ(atan(x).derivative(), 1/(1+a*a));
+    SimTK_TEST_EQ(abs(-x).derivative(), 1);
+    SimTK_TEST_EQ(pow(x, 2.5).derivative(), 2.5*std::pow(a, 1.5));
+    SimTK_TEST_EQ(pow(x, x).derivative(), std::pow(a,a)*(std::log(a)+1));
+    SimTK_TEST_EQ(square(x).derivative(), 2*a);
+    SimTK_TEST_EQ(cube(x).derivative(), 3*a*a);
+
+    // d/dt atan2(sin t, cos t) = 1
+    const Dual t(2.5, 1);
+    SimTK_TEST_EQ(atan2(sin(t), cos(t)).derivative(), 1);
+
+    SimTK_TEST(isNaN(Dual(1, NaN)) && !isFinite(Dual(1, NaN)));
+    SimTK_TEST(isInf(Dual(Infinity, 0)) && isFinite(x));
+}
+
+// A function of several vector operations, on Real or Dual elements.
+template <class T>
+T vectorFunction(const Vec<3,T>& a, const Vec<3,T>& b, const Mat<3,3,T>& M) {
+    const Vec<3,T> c = cross(a, M*b) + a*dot(a, b) - b/T(3);
+    return c.norm() + (~a*M*b) + sin(c[1])*exp(-c.normSqr());
+}
+
+void testSmallMatrix() {
+    const Vec3 a(.1, -.2, .3), b(1, 2, -1);
+    const Vec3 da(.5, .25, -1), db(0, -1, 2);
+    const Mat33 M(1, 2, 3, -.5, .2, .3, 0, .7, -.4);
+    const Mat33 dM(0, 1, 0, 0, 0, 2, 3, 0, 0);
+
+    const Dual f = vectorFunction(makeDual(a, da), makeDual(b, db),
+                                  makeDual(M, dM));
+    SimTK_TEST_EQ(f.value(), vectorFunction(a, b, M));
+
+    const Real h = 1e-5;
+    const Real fd = (vectorFunction(Vec3(a+h*da), Vec3(b+h*db), Mat33(M+h*dM))
+                   - vectorFunction(Vec3(a-h*da), Vec3(b-h*db), Mat33(M-h*dM)))
+                    / (2*h);
+    SimTK_TEST_EQ_TOL(f.derivative(), fd, 1e-8);
+
+    // Splitting a Dual Vec or Mat gives back the pieces.
+    SimTK_TEST_EQ(getValue(makeDual(a, da)), a);
+    SimTK_TEST_EQ(getDerivative(makeDual(a, da)), da);
+    SimTK_TEST_EQ(getDerivative(makeDual(M, dM)), dM);
+
+    // Real and Dual mixed in one expression.
+    const Vec<3,Dual> ad = makeDual(a, da);
+    SimTK_TEST_EQ(getDerivative(M*ad), M*da);
+    SimTK_TEST_EQ(getDerivative(ad*Dual(2, 1)), 2*da + a);
+    SimTK_TEST_EQ(getDerivative(Dual(2, 1)*~ad), ~(2*da + a));
+    SimTK_TEST_EQ(getDerivative(-ad), -da);
+}
+
+// The spatial force needed to give a free rigid body spatial acceleration A,
+// when it has spatial velocity V, all in a body frame at the center of mass.
+template <class T> Vec<2,Vec<3,T> >
+newtonEuler(const T& m, const Mat<3,3,T>& I,
+            const Vec<2,Vec<3,T> >& V, const Vec<2,Vec<3,T> >& A) {
+    const Vec<3,T>& w = V[0];
+    return Vec<2,Vec<3,T> >(I*A[0] + cross(w, I*w), m*(A[1] + cross(w, V[1])));
+}
+
+// Spatial vectors are Vec<2,Vec3> so Dual flows through them; get the
+// derivative of a Newton-Euler force with respect to the body velocity
+// and mass in one evaluation.
+void testSpatialVec() {
+    const Real m = 2.5;
+    const Mat33 I(1, .1, .2, .1, 2, .3, .2, .3, 3);
+    const SpatialVec V(Vec3(.5, -1, 2), Vec3(1, 2, 3)),
+                     A(Vec3(-1, 0, 1), Vec3(0, 9.8, 0));
+    const SpatialVec dV(Vec3(1, 0, 0), Vec3(0, 0, -1));
+    const Real dm = 1;
+
+    typedef Vec<2,Vec<3,Dual> > SpatialVecD;
+    const SpatialVecD F = newtonEuler(Dual(m, dm), makeDual(I, Mat33(0)),
+                                      makeDual(V, dV), makeDual(A, SpatialVec(0)));
+    SimTK_TEST_EQ(getValue(F), newtonEuler(m, I, V, A));
+
+    const Real h = 1e-5;
+    const SpatialVec fd =
+        (newtonEuler(m+h*dm, I, SpatialVec(V+h*dV), A)
+         - newtonEuler(m-h*dm, I, SpatialVec(V-h*dV), A)) / (2*h);
+    SimTK_TEST_EQ_TOL(getDerivative(F), fd, 1e-8);
+
+    const SpatialVecD Fs = F*Dual(2, 0);
+    SimTK_TEST_EQ(getDerivative(Fs), 2*getDerivative(F));
+}
+
+int main() {
+    SimTK_START_TEST("TestDual");
+        SimTK_SUBTEST(testArithmetic);
+        SimTK_SUBTEST(testFunctions);
+        SimTK_SUBTEST(testSmallMatrix);
+        SimTK_SUBTEST(testSpatialVec);
+    SimTK_END_TEST();
+}
@@ -196,6 +196,84 @@ void testStep() {
     SimTK_TEST(sv.calcDerivative(derivOrder2, Vector(1, -29.3)) == Vec3(0));
 }
 
+// A Function that implements only the required Vector signatures, so the 
+// scalar and fixed-size signatures use the base class implementations.
+class Cubic : public Function {
+public:
+    Real calcValue(const Vector& x) const override {
+        SimTK_TEST(x.size() == 1);
+        return x[0]*x[0]*x[0];
+    }
+    Real calcDerivative(const Array_<int>& derivComponents, 
+                        const Vector& x) const override {
+        SimTK_TEST(x.size() == 1);
+        for (int c : derivComponents) SimTK_TEST(c == 0);
+        switch (derivComponents.size()) {
+          case 0: return x[0]*x[0]*x[0];
+          case 1: return 3*x[0]*x[0];
+          case 2: return 6*x[0];
+          case 3: return 6;
+          default: return 0;
+        }
+    }
+    int getArgumentSize() const override {return 1;}
+    int getMaxDerivativeOrder() const override 
+    {   return std::numeric_limits<int>::max(); }
+};
+
+// Check that calcValue(Real), calcDerivative(int,Real) and the Vec<N> 
+// signatures agree with the Vector ones, called through the base class.
+template <class T>
+void checkScalarSignatures(const Function_<T>& f, Real x, int maxOrder) {
+    const Vector xv(1, x);
+    SimTK_TEST_EQ(f.calcValue(x), f.calcValue(xv));
+    SimTK_TEST_EQ(f.calcValue(Vec1(x)), f.calcValue(xv));
+    for (int order = 1; order <= maxOrder; ++order) {
+        const Array_<int> derivComponents(order, 0);
+        const T d = f.calcDerivative(derivComponents, xv);
+        SimTK_TEST_EQ(f.calcDerivative(order, x), d);
+        SimTK_TEST_EQ(f.calcDerivative(derivComponents, Vec1(x)), d);
+    }
+}
+
+void testScalarSignatures() {
+    const Real xs[] = {-2.5, -0.3, 0, 0.25, 0.7, 1, 3.1};
+    Function_<Vec3>::Constant c(Vec3(1,2,3));
+    Function::Linear lin(Vector(Vec2(-3, 0.5)));
+    Vector_<Vec3> coeff(3);
+    coeff[0] = Vec3(1, 2, 3); coeff[1] = Vec3(4, 3, 2); coeff[2] = Vec3(-1);
+    Function_<Vec3>::Polynomial poly(coeff);
+    Function::Sinusoid sine(1.5, 2, 0.1);
+    Function::Step step(-1, 1, 0, 1);
+    Function_<Vec3>::Step stepv(Vec3(1,2,3), Vec3(4,5,6), 1, 0);
+    Cubic cubic;
+    for (Real x : xs) {
+        checkScalarSignatures(c, x, 3);
+        checkScalarSignatures(lin, x, 3);
+        checkScalarSignatures(poly, x, 4);
+        checkScalarSignatures(sine, x, 10); // past the stack buffer
+        checkScalarSignatures(step, x, 3);
+        checkScalarSignatures(stepv, x, 3);
+        checkScalarSignatures(cubic, x, 12);
+    }
+
+    // The concrete classes see the base class signatures too.
+    SimTK_TEST_EQ(lin.calcValue(2.), -5.5);
+    SimTK_TEST_EQ(poly.calcDerivative(2, 1.), Vec3(2, 4, 6));
+    SimTK_TEST_EQ(sine.calcValue(Vec1(0.4)), 1.5*std::sin(0.9));
+    SimTK_TEST_EQ(step.calcValue(0.5), 0);
+    const Function& cubicf = cubic; // Cubic hides them
+    SimTK_TEST_EQ(cubicf.calcDerivative(1, 2.), 12);
+
+    // A fixed-size argument with more than one element.
+    Function::Linear lin2(Vector(Vec3(1, 4, -1)));
+    SimTK_TEST_EQ(lin2.calcValue(Vec2(0.5, -0.5)), -2.5);
+    SimTK_TEST_EQ(lin2.calcDerivative(Array_<int>(1, 1), Vec2(1, 0)), 4);
+
+    // Errors are still caught with the scalar signatures.
+    SimTK_TEST_MUST_THROW(step.calcDerivative(4, 0.5));
+}
+
 int main () {
     SimTK_START_TEST("TestFunction");
 
@@ -205,6 +283,7 @@ int main () {
         SimTK_SUBTEST(testSinusoid);
         SimTK_SUBTEST(testRealFunction);
         SimTK_SUBTEST(testStep);
+        SimTK_SUBTEST(testScalarSignatures);
 
     SimTK_END_TEST();
 }
@@ -24,6 +24,9 @@
 #include "SimTKcommon.h"
 
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
 
 #define ASSERT(cond) {SimTK_ASSERT_ALWAYS(cond, "Assertion failed");}
 
@@ -93,6 +96,38 @@ void testSingleThreadedExecution() {
         ASSERT(flags[j] == (j < numFlags-10 ? 1 : 0));
 }
 
+// Some indices are far more expensive than others; every index must still be
+// executed exactly once no matter which thread ends up running it.
+class UnevenTask : public ParallelExecutor::Task {
+public:
+    explicit UnevenTask(Array_<int>& flags) : flags(flags) {
+    }
+    void execute(int index) override {
+        volatile double sum = 0;
+        const int work = (index % 17 == 0 ? 20000 : 10);
+        for (int i = 0; i < work; ++i)
+            sum = sum + std::sqrt(double(i));
+        flags[index]++;
+    }
+private:
+    Array_<int>& flags;
+};
+
+void testUnevenWorkload() {
+    for (int numThreads = 2; numThreads <= 5; ++numThreads) {
+        ParallelExecutor executor(numThreads);
+        for (int times : {0, 1, 3, 7, 64, 1001}) {
+            for (int rep = 0; rep < 20; ++rep) {
+                Array_<int> flags(times, 0);
+                UnevenTask task(flags);
+                executor.execute(task, times);
+                for (int j = 0; j < times; ++j)
+                    ASSERT(flags[j] == 1);
+            }
+        }
+    }
+}
+
 void testResizeThreads() {
     for(int x = 1; x < 100; ++x)
     {
@@ -100,11 +135,70 @@ void testResizeThreads() {
         SimTK_TEST(executor.getMaxThreads() == x);
     }
 }
+// forEach() rethrows the exception from the lowest index. It runs serially,
+// stopping at the first exception, while another caller is using the
+// executor.
+void testForEach() {
+    class Wait : public ParallelExecutor::Task {
+    public:
+        Wait(std::atomic<bool>& started, std::atomic<bool>& release)
+        :   started(started), release(release) {}
+        void execute(int) override {
+            started = true;
+            while (!release) std::this_thread::yield();
+        }
+    private:
+        std::atomic<bool> &started, &release;
+    };
+
+    ParallelExecutor executor(3);
+    for (bool busy : {false, true}) {
+        std::atomic<bool> started(false), release(false);
+        std::thread other;
+        if (busy) {
+            other = std::thread([&] {
+                Wait wait(started, release);
+                executor.execute(wait, 1);
+            });
+            while (!started) std::this_thread::yield();
+        }
+
+        Array_<int> flags(50, 0);
+        executor.forEach(50, [&](int i) {flags[i]++;});
+        for (int j = 0; j < 50; ++j)
+            ASSERT(flags[j] == 1);
+
+        flags.fill(0);
+        try {
+            executor.forEach(50, [&](int i) {
+                flags[i]++;
+                if (i % 10 == 7) throw std::runtime_error(std::to_string(i));
+            });
+            ASSERT(!"forEach() should have thrown");
+        } catch (const std::runtime_error& e) {
+            ASSERT(std::string(e.what()) == "7");
+        }
+        for (int j = 0; j < 50; ++j)
+            ASSERT(flags[j] == 1);
+
+        if (busy) {
+            int nWorkers = 0;
+            executor.forEach(10, [&](int)
+            {   if (ParallelExecutor::isWorkerThread()) ++nWorkers; });
+            ASSERT(nWorkers == 0);
+            release = true;
+            other.join();
+        }
+    }
+}
+
 int main() {
     SimTK_START_TEST("TestParallelExecutor");
         SimTK_SUBTEST(testParallelExecution);
         SimTK_SUBTEST(testSingleThreadedExecution);
+        SimTK_SUBTEST(testUnevenWorkload);
         SimTK_SUBTEST(testResizeThreads);
+        SimTK_SUBTEST(testForEach);
     SimTK_END_TEST();
     return 0;
 }
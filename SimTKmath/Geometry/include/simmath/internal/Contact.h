@@ -493,6 +493,14 @@ public:
                         const Transform&        X_S1S2,
                         const std::set<int>&    faces1, 
                         const std::set<int>&    faces2);
+    /** Create a TriangleMeshContact object from face indices held in arrays,
+    which must be in ascending order with no duplicates. The arguments are 
+    otherwise the same as for the constructor that takes sets. **/
+    TriangleMeshContact(ContactSurfaceIndex     surf1, 
+                        ContactSurfaceIndex     surf2,
+                        const Transform&        X_S1S2,
+                        const Array_<int>&      faces1, 
+                        const Array_<int>&      faces2);
 
     /** Get the indices of all faces of surface1 that are partly or completely 
     inside surface2. If surface1 is not a TriangleMesh, this will return an 
@@ -502,6 +510,13 @@ public:
     inside surface1. If surface2 is not a TriangleMesh, this will return an 
     empty set. **/
     const std::set<int>& getSurface2Faces() const;
+    /** Get the same faces as getSurface1Faces(), in ascending order but held
+    in contiguous storage. Prefer this when visiting every face, or when the
+    faces are to be divided into batches. **/
+    const Array_<int>& getSurface1FaceArray() const;
+    /** Get the same faces as getSurface2Faces(), in ascending order but held
+    in contiguous storage. @see getSurface1FaceArray() **/
+    const Array_<int>& getSurface2FaceArray() const;
 
     /** Determine whether a Contact object is a TriangleMeshContact. **/
     static bool isInstance(const Contact& contact);
@@ -100,6 +100,29 @@ virtual bool trackContact
     Real                   cutoff,
     Contact&               currentStatus) const = 0;
 
+class PairCache;
+
+/** Same as trackContact() but with a PairCache belonging to this pair of
+surfaces, in which the tracker may leave information that makes the next call
+for the same pair cheaper, such as a separating direction. The
+ContactTrackerSubsystem keeps one of these for each surface pair that survives
+the broad phase. The result must be the same as trackContact() would produce
+for the same \a priorStatus, to within the tracker's accuracy, so anything
+that could change it (a previous contact point to start from, say) must come
+from \a priorStatus rather than the cache. The default implementation ignores
+the cache and calls trackContact(). **/
+virtual bool trackContactUsingCache
+   (const Contact&         priorStatus,
+    const Transform& X_GS1,
+    const ContactGeometry& surface1,
+    const Transform& X_GS2,
+    const ContactGeometry& surface2,
+    Real                   cutoff,
+    PairCache&             cache,
+    Contact&               currentStatus) const
+{   return trackContact(priorStatus, X_GS1, surface1, X_GS2, surface2,
+                        cutoff, currentStatus); }
+
 /** Given two shapes for which implicit functions are known, and a rough-guess
 contact point for each shape (each measured and expressed in its own surface's
 frame), refine those contact points to obtain the nearest
@@ -173,6 +196,38 @@ std::pair<ContactGeometryTypeId,ContactGeometryTypeId> m_surfaceTypes;
 
 
 
+//==============================================================================
+//                          CONTACT TRACKER PAIR CACHE
+//==============================================================================
+/** Information that a ContactTracker carries from one evaluation of a pair of
+contact surfaces to the next; see ContactTracker::trackContactUsingCache().
+What is stored here is only a hint: a tracker must check that it still
+applies before relying on it, and must produce a correct result from an empty
+cache. Points and directions are in the frames of the surfaces, in the order
+required by the tracker. **/
+class ContactTracker::PairCache {
+public:
+    PairCache() {clear();}
+
+    /** Forget everything. **/
+    void clear() {
+        hasSeparatingDirection = false;
+        feature1 = feature2 = -1;
+    }
+
+    /** If set, a direction in surface1's frame along which the two surfaces
+    were last seen to be separated: surface1 lies entirely behind a plane
+    with this normal and surface2 entirely in front of it. **/
+    bool        hasSeparatingDirection;
+    UnitVec3    separatingDirection;
+
+    /** Tracker-specific indices of the features (faces or vertices, for
+    example) that were involved last time, or -1. **/
+    int         feature1, feature2;
+};
+
+
+
 //==============================================================================
 //                     HALFSPACE-SPHERE CONTACT TRACKER
 //==============================================================================
@@ -354,25 +409,26 @@ bool trackContact
     Contact&               currentStatus) const override;
 
 private:
+// Fill insideFaces1 and insideFaces2 with the faces of each mesh that 
+// intersect a face of the other mesh, in ascending order.
 void findIntersectingFaces
    (const ContactGeometry::TriangleMesh&                mesh1, 
     const ContactGeometry::TriangleMesh&                mesh2,
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node1, 
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node2, 
-    const OrientedBoundingBox&                          node2Bounds_M1,
     const Transform&                                    X_M1M2, 
-    std::set<int>&                                      insideFaces1, 
-    std::set<int>&                                      insideFaces2) const; 
+    Array_<int>&                                        insideFaces1, 
+    Array_<int>&                                        insideFaces2) const; 
 
+// Add to the sorted insideFaces the faces that are completely inside the
+// other mesh, keeping it sorted.
 void findBuriedFaces
    (const ContactGeometry::TriangleMesh&    mesh,
     const ContactGeometry::TriangleMesh&    otherMesh,
     const Transform&                        X_OM, 
-    std::set<int>&                          insideFaces) const;
+    Array_<int>&                            insideFaces) const;
 
 void tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
               Array_<int>&                           faceType,
-              std::set<int>&                         triangles, 
+              Array_<int>&                           triangles, 
               int                                    index,
               int                                    depth) const;
 };
@@ -418,6 +474,11 @@ public:
 ConvexImplicitPair(ContactGeometryTypeId type1, ContactGeometryTypeId type2) 
 :   ContactTracker(type1, type2) {}
 
+/** If \a priorStatus is an EllipticalPointContact, the Newton refinement
+starts from its contact points rather than from a Minkowski Portal Refinement
+estimate. For deep penetration the contact conditions may have more than one
+solution; then this follows the one in \a priorStatus, which need not be the
+one found from scratch. **/
 bool trackContact
    (const Contact&         priorStatus,
     const Transform& X_GS1, 
@@ -426,6 +487,20 @@ bool trackContact
     const ContactGeometry& surface2,
     Real                   cutoff,
     Contact&               currentStatus) const override;
+
+/** Separated surfaces are first tested against the cached separating
+direction, which takes one support point evaluation per surface; only if that
+fails is Minkowski Portal Refinement used. The result is the same as
+trackContact() gives. **/
+bool trackContactUsingCache
+   (const Contact&         priorStatus,
+    const Transform& X_GS1,
+    const ContactGeometry& surface1,
+    const Transform& X_GS2,
+    const ContactGeometry& surface2,
+    Real                   cutoff,
+    PairCache&             cache,
+    Contact&               currentStatus) const override;
 };
 
 
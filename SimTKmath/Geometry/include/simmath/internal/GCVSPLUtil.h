@@ -49,6 +49,15 @@ public:
     static Real splder(int derivOrder, int degree, Real t, const Vector& x, const Vector& coeff);
     template <int K>
     static Vec<K> splder(int derivOrder, int degree, Real t, const Vector& x, const Vector_<Vec<K> >& coeff);
+    /**
+     * These are the same as above, except that the caller supplies a guess for the interval of x
+     * containing t, typically the one returned by the previous call. The search starts there, so
+     * evaluations at nearby values of t don't require a full binary search. On return, interval
+     * holds the interval that actually contains t.
+     */
+    static Real splder(int derivOrder, int degree, Real t, const Vector& x, const Vector& coeff, int& interval);
+    template <int K>
+    static Vec<K> splder(int derivOrder, int degree, Real t, const Vector& x, const Vector_<Vec<K> >& coeff, int& interval);
 };
 
 template <int K>
@@ -91,6 +100,13 @@ void GCVSPLUtil::gcvspl(const Vector& x, const Vector_<Vec<K> >& y, const Vector
 
 template <int K>
 Vec<K> GCVSPLUtil::splder(int derivOrder, int degree, Real t, const Vector& x, const Vector_<Vec<K> >& coeff) {
+    const int n = x.size();
+    int interval = (int) ceil(n*(t-x[0])/(x[n-1]-x[0]));
+    return splder(derivOrder, degree, t, x, coeff, interval);
+}
+
+template <int K>
+Vec<K> GCVSPLUtil::splder(int derivOrder, int degree, Real t, const Vector& x, const Vector_<Vec<K> >& coeff, int& interval) {
     assert(derivOrder >= 0);
     assert(t >= x[0] && t <= x[x.size()-1]);
     assert(x.size() == coeff.size());
@@ -103,7 +119,6 @@ Vec<K> GCVSPLUtil::splder(int derivOrder, int degree, Real t, const Vector& x, c
     Vec<K> result;
     int m = (degree+1)/2;
     int n = x.size();
-    int interval = (int) ceil(n*(t-x[0])/(x[n-1]-x[0]));
 
     const int MaxCheapM = 32;
     Real qbuf[2*MaxCheapM];
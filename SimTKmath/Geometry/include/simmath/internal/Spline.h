@@ -28,6 +28,7 @@
 #include "simmath/internal/common.h"
 #include "simmath/internal/GCVSPLUtil.h"
 
+#include <atomic>
 #include <limits>
 
 namespace SimTK {
@@ -100,7 +101,7 @@ public:
     of the independent variable.
     @param[in]  x    The value of the independent variable.
     @returns         The corresponding values of the dependent variables. **/
-    T calcValue(Real x) const {
+    T calcValue(Real x) const override {
         assert(impl);
         return impl->getValue(x);
     }
@@ -115,7 +116,7 @@ public:
         taken.
     @returns
         The \a order'th derivative of the dependent variables at \a x. **/
-    T calcDerivative(int order, Real x) const {
+    T calcDerivative(int order, Real x) const override {
         assert(impl);
         assert(order > 0);
         return impl->getDerivative(order, x);
@@ -171,6 +172,10 @@ public:
     /** Required by the Function_ interface. **/
     Spline_* clone() const override {return new Spline_(*this);}
 
+    /** Make the fixed-size Function_ signatures visible here too. **/
+    using Function_<T>::calcValue;
+    using Function_<T>::calcDerivative;
+
 private:
     class SplineImpl;
     SplineImpl* impl;
@@ -184,20 +189,30 @@ template <class T>
 class Spline_<T>::SplineImpl {
 public:
     SplineImpl(int degree, const Vector& x, const Vector_<T>& y) 
-    :   referenceCount(1), degree(degree), x(x), y(y) {}
+    :   referenceCount(1), degree(degree), x(x), y(y), lastInterval(0) {}
     ~SplineImpl() {
         assert(referenceCount == 0);
     }
     T getValue(Real t) const {
-        return GCVSPLUtil::splder(0, degree, t, x, y);
+        return getDerivative(0, t);
     }
+    // Successive evaluations are usually at nearby values of t, so the 
+    // interval search starts from the one found last time and only falls 
+    // back to bisection if t isn't in or next to that interval. The
+    // hint is shared by all handles to this spline, so it is atomic; a 
+    // stale hint only costs a longer search.
     T getDerivative(int derivOrder, Real t) const {
-        return GCVSPLUtil::splder(derivOrder, degree, t, x, y);
+        int interval = lastInterval.load(std::memory_order_relaxed);
+        const T result = 
+            GCVSPLUtil::splder(derivOrder, degree, t, x, y, interval);
+        lastInterval.store(interval, std::memory_order_relaxed);
+        return result;
     }
     int         referenceCount;
     int         degree;
     Vector      x;
     Vector_<T>  y;
+    mutable std::atomic<int> lastInterval;
 };
 
 } // namespace SimTK
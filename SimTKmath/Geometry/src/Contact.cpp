@@ -27,6 +27,7 @@
 
 #include "ContactImpl.h"
 
+#include <algorithm>
 #include <set>
 
 using namespace SimTK;
@@ -233,10 +234,21 @@ TriangleMeshContact::TriangleMeshContact
 :   Contact(new TriangleMeshContactImpl(surf1, surf2, X_S1S2, 
                                         faces1, faces2)) {}
 
+TriangleMeshContact::TriangleMeshContact
+   (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
+    const Transform& X_S1S2,
+    const Array_<int>& faces1, const Array_<int>& faces2) 
+:   Contact(new TriangleMeshContactImpl(surf1, surf2, X_S1S2, 
+                                        faces1, faces2)) {}
+
 const set<int>& TriangleMeshContact::getSurface1Faces() const 
 {   return getImpl().faces1; }
 const set<int>& TriangleMeshContact::getSurface2Faces() const 
 {   return getImpl().faces2; }
+const Array_<int>& TriangleMeshContact::getSurface1FaceArray() const 
+{   return getImpl().faceArray1; }
+const Array_<int>& TriangleMeshContact::getSurface2FaceArray() const 
+{   return getImpl().faceArray2; }
 
 /*static*/ bool TriangleMeshContact::isInstance(const Contact& contact) 
 {   return (dynamic_cast<const TriangleMeshContactImpl*>(&contact.getImpl())
@@ -249,7 +261,22 @@ TriangleMeshContactImpl::TriangleMeshContactImpl
    (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
     const Transform& X_S1S2,
     const set<int>& faces1, const set<int>& faces2) 
-:   ContactImpl(surf1, surf2, X_S1S2), faces1(faces1), faces2(faces2) {}
+:   ContactImpl(surf1, surf2, X_S1S2), faces1(faces1), faces2(faces2),
+    faceArray1(faces1.begin(), faces1.end()), 
+    faceArray2(faces2.begin(), faces2.end()) {}
+
+// The sets are built from sorted input, so each insertion is at the end.
+TriangleMeshContactImpl::TriangleMeshContactImpl
+   (ContactSurfaceIndex surf1, ContactSurfaceIndex surf2,
+    const Transform& X_S1S2,
+    const Array_<int>& faces1, const Array_<int>& faces2) 
+:   ContactImpl(surf1, surf2, X_S1S2), 
+    faces1(faces1.begin(), faces1.end()), faces2(faces2.begin(), faces2.end()),
+    faceArray1(faces1), faceArray2(faces2) 
+{
+    assert(std::is_sorted(faceArray1.begin(), faceArray1.end()));
+    assert(std::is_sorted(faceArray2.begin(), faceArray2.end()));
+}
 
 
 
@@ -54,7 +54,6 @@ using std::set;
 using std::string;
 using std::cout; using std::endl;
 
-#define USE_NEW_INTEGRATOR
 
 //==============================================================================
 //                            CONTACT GEOMETRY
@@ -819,14 +818,16 @@ void ContactGeometry::
 shootGeodesicInDirectionUntilLengthReached(const Vec3& xP, const UnitVec3& tP,
         const Real& terminatingLength, const GeodesicOptions& options,
         Geodesic& geod) const {
-    getImpl().shootGeodesicInDirection(xP, tP, terminatingLength, options, geod);
+    getImpl().shootGeodesicInDirectionUntilLengthReached(xP, tP, 
+            terminatingLength, options, geod);
 }
 
 void ContactGeometry::
 calcGeodesicReverseSensitivity(Geodesic& geodesic, const Vec2& initSensitivity)
     const
 {
-    getImpl().calcGeodesicReverseSensitivity(geodesic, initSensitivity);
+    getImpl().calcGeodesicReverseSensitivity(geodesic, initSensitivity, 
+                                             Vec2(1,0));
 }
 
 
@@ -855,13 +856,14 @@ calcGeodesicAnalytical(const Vec3& xP, const Vec3& xQ,
 Vec2 ContactGeometry::calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
         const UnitVec3& tP, const UnitVec3& tQ,
         Geodesic* geod) const {
-    return getImpl().calcSplitGeodError(xP, xQ, tP, tQ, geod);
+    return getImpl().calcSplitGeodError(xP, xQ, tP, tQ, getPlane(), geod);
 }
 
 Vec2 ContactGeometry::calcSplitGeodErrorAnalytical(const Vec3& xP, const Vec3& xQ,
         const UnitVec3& tP, const UnitVec3& tQ,
         Geodesic* geod) const {
-    return getImpl().calcSplitGeodErrorAnalytical(xP, xQ, tP, tQ, geod);
+    return getImpl().calcSplitGeodErrorAnalytical(xP, xQ, tP, tQ, getPlane(),
+                                                  geod);
 }
 
 const Plane& ContactGeometry::getPlane() const  { return getImpl().getPlane(); }
@@ -1128,7 +1130,7 @@ public:
         UnitVec3 tP = calcUnitTangentVec(x[0], R_SP);
         UnitVec3 tQ = calcUnitTangentVec(x[1], R_SQ);
 
-        Vec2 geodErr = geom.calcSplitGeodError(P, Q, tP, tQ);
+        Vec2 geodErr = geom.calcSplitGeodError(P, Q, tP, tQ, geom.getPlane());
 
         // error between geodesic end points at plane
         fx[0] = geodErr[0];
@@ -1212,8 +1214,6 @@ continueGeodesic(const Vec3& xP, const Vec3& xQ, const Geodesic& prevGeod,
     if (prevGeod.getNumPoints() 
         && prevGeod.getPointP()==P && prevGeod.getPointQ()==Q) {
             geod = prevGeod;
-            cout << "REUSING OLD GEODESIC of length=" 
-                << prevGeod.getLength() << "\n";
             return;
     }
    
@@ -1221,7 +1221,6 @@ continueGeodesic(const Vec3& xP, const Vec3& xQ, const Geodesic& prevGeod,
     const Real PQlength = PQ.norm();
     const UnitVec3 PQdir =
         PQlength == 0 ? UnitVec3(XAxis) : UnitVec3(PQ/PQlength, true);
-    cout << "  PQlen=" << PQlength << " PQdir=" << PQdir << "\n";
 
     // If the length is less than this fraction of the maximum radius of
     // curvature (1/kdP) then the geodesic is indistinguishable from a 
@@ -1231,7 +1230,6 @@ continueGeodesic(const Vec3& xP, const Vec3& xQ, const Geodesic& prevGeod,
     // that matter?
     const Real kdP = std::abs(calcSurfaceCurvatureInDirection(P,PQdir));
     if (PQlength*kdP <= StraightLineGeoFrac) {
-        cout << "STRAIGHT LINE GEO length=" << PQlength << "\n";
         makeStraightLineGeodesic(P, Q, PQdir, options, geod);
         return;
     }
@@ -1279,8 +1277,6 @@ continueGeodesic(const Vec3& xP, const Vec3& xQ, const Geodesic& prevGeod,
             tPhint = PQdir;
             tQhint = PQdir;
             sHint = PQlength;
-            cout << "GEODESIC FLIPPED. Prev len was " 
-                 << prevGeod.getLength() << endl;
         }
     }
 
@@ -1361,129 +1357,72 @@ makeStraightLineGeodesic(const Vec3& xP, const Vec3& xQ,
 //------------------------------------------------------------------------------
 // Utility method used by shootGeodesicInDirectionUntilPlaneHit
 // and shootGeodesicInDirectionUntilLengthReached.
-// P is not necessarily on the surface and tP is not necessarily tangent
-// to the surface, so the first thing we do is project P to the nearest
-// surface point P', calculate the outward unit normal n' at P', then
-// project tP to tP' by removing any component it has in the n' direction,
-// then renormalizing.
+// The geodesic equations are solved by a GeodesicIntegrator, which works
+// entirely in fixed-size Vecs; there is no System or State involved, and the
+// only heap storage used is the Geodesic's knot point arrays, which keep their
+// capacity when the Geodesic is cleared and reused.
+//
+// If terminatingPlane is supplied, the geodesic ends where it first crosses
+// that plane (in either direction), or at finalArcLength if it never does.
 static const Real IntegratorAccuracy = Real(1e-6); // TODO: how to choose?
 static const Real IntegratorConstraintTol = Real(1e-10);
-void ContactGeometryImpl::
-shootGeodesicInDirection(const Vec3& P, const UnitVec3& tP,
-        const Real& finalTime, const GeodesicOptions& options,
-        Geodesic& geod) const {
-
-    // integrator settings
-    const Real startTime = 0;
-
-    ++numGeodesicsShot;
-
-    // Initialize state
-    State sysState = ptOnSurfSys->getDefaultState();
-    sysState.setTime(startTime);
-    Vector& q = sysState.updQ();
-    Vector& u = sysState.updU();
-    q[0] = P[0]; q[1] = P[1]; q[2] = P[2];
-    u[0] = tP[0]; u[1] = tP[1]; u[2] = tP[2];
-
-    // Jacobi field states
-    q[3] = 0; 
-    u[3] = 1;
-
-    // Setup integrator to integrate until terminatingLength
-    //RungeKutta3Integrator integ(*ptOnSurfSys);
-    RungeKuttaMersonIntegrator integ(*ptOnSurfSys);
-    //RungeKuttaFeldbergIntegrator integ(*ptOnSurfSys);
-    integ.setAccuracy(IntegratorAccuracy);
-    integ.setConstraintTolerance(IntegratorConstraintTol);
-    integ.setFinalTime(finalTime);
-    integ.setReturnEveryInternalStep(true); // save geodesic knot points
-
-    // Setup timestepper in order to handle event when geodesic hits the plane
-    TimeStepper ts(*ptOnSurfSys, integ);
-    ts.setReportAllSignificantStates(true);
-    ts.initialize(sysState);
-
-    // Simulate it, and record geodesic knot points after each step
-    // Terminate when geodesic hits the plane
-    Integrator::SuccessfulStepStatus status;
-    int stepcnt = 0;
-    geod.setIsConvex(true); // Set false if we see negative curvature anywhere.
-    while (true) {
-        // Final time is already reported by the time we see end of simulation;
-        // don't duplicate the last step.
-        if ((status=ts.stepTo(Infinity)) == Integrator::EndOfSimulation)
-            break;
-
-        // If we stopped just for a report, don't add that to the geodesic;
-        // that may happen if a visualization reporter has been hung on this
-        // system for watching the geodesic grow.
-        if (status == Integrator::ReachedReportTime)
-            continue;
-
-        // Careful -- integrator has its own internal copies of the state and
-        // the one returned won't always be the same one so you need to get a
-        // fresh reference each time.
-        const State& state = integ.getState();
-        const Real s = state.getTime();
-        geod.addArcLength(s);
-
-        const Vec3& pt = Vec3::getAs(&state.getQ()[0]);
-        const UnitVec3 n = calcSurfaceUnitNormal(pt);
-        const Vec3& tangent = Vec3::getAs(&state.getU()[0]);
-        // Rotation will orthogonalize so x direction we get may not be
-        // exactly the same as what we supply here.
-        const Transform frenetFrame(Rotation(n, ZAxis, tangent, YAxis), pt);
-        geod.addFrenetFrame(frenetFrame);
-        geod.addDirectionalSensitivityPtoQ(Vec2(state.getQ()[3],
-                                                state.getU()[3]));
-        geod.addPositionalSensitivityPtoQ(Vec2(NaN,NaN)); // XXX
-        const Real kappa = calcSurfaceCurvatureInDirection(pt, frenetFrame.y());
-        geod.addCurvature(kappa);
-        if (kappa < 0) 
-            geod.setIsConvex(false);
-
-        ++stepcnt;
+// How close to the terminating plane the end point of a geodesic must be.
+static const Real PlaneHitTol = IntegratorAccuracy/100;
+static const int  MaxPlaneHitIterations = 30;
+
+typedef GeodesicIntegrator<GeodesicOnImplicitSurface> GeodIntegrator;
+
+// The integrator has just taken a step from (s0,y0), where the geodesic was
+// at signed distance dist0 from the plane, to a point where the distance dist1
+// has the opposite sign. Move the integrator back to the arc length at which
+// the geodesic meets the plane, using the Illinois variant of regula falsi.
+// Each trial point is found by integrating again from the start of the 
+// current bracket.
+static void localizePlaneHit(const GeodesicOnImplicitSurface& eqns,
+                             const Plane& plane, Real s0, 
+                             const Vec<GeodesicOnImplicitSurface::N>& y0,
+                             Real dist0, Real dist1, GeodIntegrator& integ) 
+{
+    Real sLo = s0,              dLo = dist0;
+    Real sHi = integ.getTime(), dHi = dist1;
+    Vec<GeodesicOnImplicitSurface::N> yLo = y0;
+    int lastMoved = 0; // -1 if sLo moved last, 1 if sHi did
+    for (int i=0; i < MaxPlaneHitIterations; ++i) {
+        Real s = (sLo*dHi - sHi*dLo) / (dHi - dLo);
+        if (!(sLo < s && s < sHi)) 
+            s = (sLo + sHi)/2;
+        integ.setTimeAndState(sLo, yLo);
+        integ.setNextStepSizeToTry(s - sLo);
+        do {integ.takeOneStep(s);} while (integ.getTime() < s);
+
+        const Real d = plane.getDistance(GeodesicOnImplicitSurface::getP(
+                                            integ.getY()));
+        if (std::abs(d) <= PlaneHitTol)
+            return;
+        if ((d > 0) == (dLo > 0)) {
+            sLo = s; dLo = d; yLo = integ.getY();
+            if (lastMoved == -1) dHi /= 2;
+            lastMoved = -1;
+        } else {
+            sHi = s; dHi = d;
+            if (lastMoved == 1) dLo /= 2;
+            lastMoved = 1;
+        }
+        if (sHi - sLo <= SignificantReal*(1 + sHi))
+            return;
     }
-
-    geod.setBinormalCurvatureAtP(
-        calcSurfaceCurvatureInDirection(geod.getPointP(),geod.getBinormalP()));
-    geod.setBinormalCurvatureAtQ(
-        calcSurfaceCurvatureInDirection(geod.getPointQ(),geod.getBinormalQ()));
-
-    //TODO: numerical torsion estimate for now
-    const Array_<Transform>& frenet = geod.getFrenetFrames();
-    const Array_<Real>& arcLen = geod.getArcLengths();
-    const int last = geod.getNumPoints()-1;
-    const Real lFirst = arcLen[1];
-    const Real lLast  = arcLen[last] - arcLen[last-1];
-    const Real tauP = lFirst==0 ? Real(0)
-        : -dot(frenet[0].z(), 
-              (frenet[1].x()-frenet[0].x())) / lFirst; // dbP/ds
-    const Real tauQ = lLast==0 ? Real(0)
-        : -dot(frenet[last].z(), 
-              (frenet[last].x()-frenet[last-1].x())) / lLast;
-
-    geod.setTorsionAtP(tauP); geod.setTorsionAtQ(tauQ);
-
-    geod.setIsShortest(false); // TODO
-    geod.setAchievedAccuracy(IntegratorAccuracy); // TODO: accuracy of length?
-    // TODO: better to use something like the second-to-last step, or average
-    // excluding initial and last steps, so that we don't have to start small.
-    geod.setInitialStepSizeHint(integ.getActualInitialStepSizeTaken());
 }
 
 void ContactGeometryImpl::
-shootGeodesicInDirection2(const Vec3& P, const UnitVec3& tP,
-        const Real& finalArcLength, const GeodesicOptions& options,
+shootGeodesicInDirection(const Vec3& P, const UnitVec3& tP,
+        const Real& finalArcLength, const Plane* terminatingPlane,
         Geodesic& geod) const {
 
     // integrator settings
     const Real startArcLength = 0;
 
     GeodesicOnImplicitSurface eqns(*this);
-    GeodesicIntegrator<GeodesicOnImplicitSurface> 
-        integ(eqns,IntegratorAccuracy,IntegratorConstraintTol);
+    GeodIntegrator integ(eqns,IntegratorAccuracy,IntegratorConstraintTol);
     static const int N = GeodesicOnImplicitSurface::N;
 
     ++numGeodesicsShot;
@@ -1493,6 +1432,10 @@ shootGeodesicInDirection2(const Vec3& P, const UnitVec3& tP,
     const Vec<N>& y = integ.getY();
     const Real&   s = integ.getTime();  // arc length
 
+    Real dist = terminatingPlane 
+                ? terminatingPlane->getDistance(eqns.getP(y)) : Real(0);
+    bool hitPlane = false;
+
     // Simulate it, and record geodesic knot points after each step
     int stepcnt = 0;
     geod.setIsConvex(true); // Set false if we see negative curvature anywhere.
@@ -1514,10 +1457,23 @@ shootGeodesicInDirection2(const Vec3& P, const UnitVec3& tP,
         geod.addCurvature(kappa);
         if (kappa < 0) geod.setIsConvex(false);
 
-        if (s == finalArcLength)
+        if (hitPlane || s == finalArcLength)
             break;
 
-        integ.takeOneStep(finalArcLength);
+        if (!terminatingPlane) {
+            integ.takeOneStep(finalArcLength);
+        } else {
+            const Real s0 = s, dist0 = dist;
+            const Vec<N> y0 = y;
+            integ.takeOneStep(finalArcLength);
+            dist = terminatingPlane->getDistance(eqns.getP(y));
+            if (dist0 != 0 && (dist == 0 || (dist > 0) != (dist0 > 0))) {
+                if (dist != 0)
+                    localizePlaneHit(eqns, *terminatingPlane, s0, y0, 
+                                     dist0, dist, integ);
+                hitPlane = true;
+            }
+        }
         ++stepcnt;
     }
 
@@ -1558,78 +1514,13 @@ shootGeodesicInDirection2(const Vec3& P, const UnitVec3& tP,
 //                      CALC GEODESIC REVERSE SENSITIVITY
 //------------------------------------------------------------------------------
 // After a geodesic has been calculated, this method integrates backwards
-// to fill in the missing reverse Jacobi term.
-void ContactGeometryImpl::
-calcGeodesicReverseSensitivity(Geodesic& geod, const Vec2& initJacobi) const {
-    
-    // Don't look for a plane.
-    geodHitPlaneEvent->setEnabled(false);
-
-    // integrator settings
-
-    //RungeKutta3Integrator integ(ptOnSurfSys);
-    RungeKuttaMersonIntegrator integ(*ptOnSurfSys);
-    integ.setAccuracy(IntegratorAccuracy);
-    integ.setConstraintTolerance(IntegratorConstraintTol);
-    State sysState = ptOnSurfSys->getDefaultState();
-    Vector& q = sysState.updQ();
-    Vector& u = sysState.updU();
-
-    // Initial Jacobi field states.
-    q[3] = initJacobi[0]; 
-    u[3] = initJacobi[1];
-
-    Array_<Vec2>& jQ = geod.updDirectionalSensitivityQtoP();
-    jQ.resize(geod.getNumPoints());
-    jQ.back() = initJacobi;
-
-    for (int step=geod.getNumPoints()-1; step >= 1; --step) {
-        // Curve goes from P to Q. We have to integrate backwards from Q to P.
-        const Transform& QFrenet = geod.getFrenetFrames()[step];
-        const Transform& PFrenet = geod.getFrenetFrames()[step-1];
-        const Real sQ = geod.getArcLengths()[step];
-        const Real sP = geod.getArcLengths()[step-1];
-        const Vec3&      Q = QFrenet.p();
-        const UnitVec3&  tQ = QFrenet.x(); // we'll reverse this
-        const Vec3&      P = PFrenet.p();
-        const UnitVec3&  tP = PFrenet.x();
-
-        // Initialize state
-        sysState.setTime(0);
-        q[0] = Q[0]; q[1] = Q[1]; q[2] = Q[2];
-        u[0] = -tQ[0]; u[1] = -tQ[1]; u[2] = -tQ[2];
-        q[3] = jQ[step][0]; 
-        u[3] = jQ[step][1];
-
-        const Real arcLength = sQ-sP; // how far to integrate
-
-        integ.initialize(sysState);
-
-        Integrator::SuccessfulStepStatus status;
-        do {
-            status = integ.stepTo(arcLength);
-            if (status == Integrator::StartOfContinuousInterval)
-                continue;
-            if (integ.getTime() < arcLength) {
-                printf("integ to %g returned early at %g with status=%s\n",
-                    arcLength, integ.getTime(),
-                    Integrator::getSuccessfulStepStatusString(status).c_str());
-            }
-        } while (integ.getTime() < arcLength);
-
-        // Save Jacobi field value.
-        const State& state = integ.getState();
-        jQ[step-1] = Vec2(state.getQ()[3],state.getU()[3]);
-    }
-}
-
+// to fill in the missing reverse Jacobi terms.
 void ContactGeometryImpl::
-calcGeodesicReverseSensitivity2
+calcGeodesicReverseSensitivity
    (Geodesic& geod, const Vec2& initJRot, const Vec2& initJTrans) const {
 
     GeodesicOnImplicitSurface eqns(*this);
-    GeodesicIntegrator<GeodesicOnImplicitSurface> 
-        integ(eqns,IntegratorAccuracy,IntegratorConstraintTol);
+    GeodIntegrator integ(eqns,IntegratorAccuracy,IntegratorConstraintTol);
     static const int N = GeodesicOnImplicitSurface::N;
 
     integ.initialize(0, 
@@ -1650,13 +1541,10 @@ calcGeodesicReverseSensitivity2
     for (int step=geod.getNumPoints()-1; step >= 1; --step) {
         // Curve goes from P to Q. We have to integrate backwards from Q to P.
         const Transform& QFrenet = geod.getFrenetFrames()[step];
-        const Transform& PFrenet = geod.getFrenetFrames()[step-1];
         const Real sQ = geod.getArcLengths()[step];
         const Real sP = geod.getArcLengths()[step-1];
         const Vec3&      Q = QFrenet.p();
-        const UnitVec3&  tQ = QFrenet.x(); // we'll reverse this
-        const Vec3&      P = PFrenet.p();
-        const UnitVec3&  tP = PFrenet.x();
+        const UnitVec3&  tQ = QFrenet.y(); // we'll reverse this
 
         // Initialize state
         Vec<N> yInit;
@@ -1697,11 +1585,9 @@ void ContactGeometryImpl::
 shootGeodesicInDirectionUntilPlaneHit(const Vec3& xP, const UnitVec3& tP,
         const Plane& terminatingPlane, const GeodesicOptions& options,
         Geodesic& geod) const {
-    geodHitPlaneEvent->setEnabled(true);
-    geodHitPlaneEvent->setPlane(terminatingPlane);
     // TODO: need a reasonable max length
     const Real MaxLength = /*Infinity*/100;
-    shootGeodesicInDirection(xP, tP, MaxLength, options, geod);
+    shootGeodesicInDirection(xP, tP, MaxLength, &terminatingPlane, geod);
 }
 
 
@@ -1712,12 +1598,7 @@ void ContactGeometryImpl::
 shootGeodesicInDirectionUntilLengthReached(const Vec3& xP, const UnitVec3& tP,
         const Real& terminatingLength, const GeodesicOptions& options,
         Geodesic& geod) const {
-    geodHitPlaneEvent->setEnabled(false);
-#ifdef USE_NEW_INTEGRATOR
-    shootGeodesicInDirection2(xP, tP, terminatingLength, options, geod);
-#else
-    shootGeodesicInDirection(xP, tP, terminatingLength, options, geod);
-#endif
+    shootGeodesicInDirection(xP, tP, terminatingLength, 0, geod);
 }
 
 
@@ -1763,7 +1644,7 @@ void ContactGeometryImpl::calcGeodesic(const Vec3& xP, const Vec3& xQ,
     // calculate plane bisecting P and Q, and use as termination condition for integrator
     UnitVec3 normal(xQ - xP);
     Real offset = (~(xP+xQ)*normal)/2 ;
-    geodHitPlaneEvent->setPlane(Plane(normal, offset));
+    const Plane plane(normal, offset);
 
     Mat22 J;
     Vec2 x, xold, dx, Fx;
@@ -1779,7 +1660,7 @@ void ContactGeometryImpl::calcGeodesic(const Vec3& xP, const Vec3& xQ,
 //    Differentiator diff( *const_cast<SplitGeodesicError*>(splitGeodErr));
 
 //    splitGeodErr->f(x, Fx);
-    Fx = calcSplitGeodError(xP, xQ, x[0], x[1]);
+    Fx = calcSplitGeodError(xP, xQ, x[0], x[1], plane);
     if (vizReporter != NULL) {
         vizReporter->handleEvent(ptOnSurfSys->getDefaultState());
         sleepInSec(pauseBetweenGeodIterations);
@@ -1794,7 +1675,7 @@ void ContactGeometryImpl::calcGeodesic(const Vec3& xP, const Vec3& xQ,
             break;
         }
 //        diff.calcJacobian(x,  Fx, J, Differentiator::ForwardDifference);
-        J = calcSplitGeodErrorJacobian(xP, xQ, x[0], x[1],
+        J = calcSplitGeodErrorJacobian(xP, xQ, x[0], x[1], plane,
                 Differentiator::ForwardDifference);
         dx = J.invert()*Fx;
 
@@ -1806,7 +1687,7 @@ void ContactGeometryImpl::calcGeodesic(const Vec3& xP, const Vec3& xQ,
         while (true) {
             x = xold - lam*dx;
 //            splitGeodErr->f(x, Fx);
-            Fx = calcSplitGeodError(xP, xQ, x[0], x[1]);
+            Fx = calcSplitGeodError(xP, xQ, x[0], x[1], plane);
             f = std::sqrt(~Fx*Fx);
             if (f > fold && lam > minlam) {
                 lam = lam / 2;
@@ -1829,9 +1710,9 @@ void ContactGeometryImpl::calcGeodesic(const Vec3& xP, const Vec3& xQ,
 
     // Finish each geodesic with reverse Jacobi field.
     calcGeodesicReverseSensitivity(geodP,
-        geodQ.getDirectionalSensitivityPtoQ().back());
+        geodQ.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
     calcGeodesicReverseSensitivity(geodQ,
-        geodP.getDirectionalSensitivityPtoQ().back());
+        geodP.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
 
     mergeGeodesics(geodP, geodQ, geod);
 }
@@ -2025,11 +1906,7 @@ void ContactGeometryImpl::calcGeodesicUsingOrthogonalMethod
                     << MaxIterations << " iterations with err=" << f << std::endl;
 
     // Finish each geodesic with reverse Jacobi field.
-#ifdef USE_NEW_INTEGRATOR
-    calcGeodesicReverseSensitivity2(geod, Vec2(0,1), Vec2(1,0));
-#else
-    calcGeodesicReverseSensitivity(geod, Vec2(0,1));
-#endif
+    calcGeodesicReverseSensitivity(geod, Vec2(0,1), Vec2(1,0));
 
 }
 
@@ -2057,18 +1934,18 @@ void ContactGeometryImpl::calcGeodesicAnalytical(const Vec3& xP, const Vec3& xQ,
 // resulting (kinked) geodesic if the supplied pointer is non-null.
 Vec2 ContactGeometryImpl::
 calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
-              Real thetaP, Real thetaQ,
+              Real thetaP, Real thetaQ, const Plane& plane,
               Geodesic* geodesic) const
 {
     UnitVec3 tP = calcUnitTangentVec(thetaP, R_SP);
     UnitVec3 tQ = calcUnitTangentVec(thetaQ, R_SQ);
-    return calcSplitGeodError(xP, xQ, tP, tQ, geodesic);
+    return calcSplitGeodError(xP, xQ, tP, tQ, plane, geodesic);
 }
 
 // Calculate the "geodesic error" for tP and tQ
 Vec2 ContactGeometryImpl::
 calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
-              const UnitVec3& tP, const UnitVec3& tQ,
+              const UnitVec3& tP, const UnitVec3& tQ, const Plane& plane,
               Geodesic* geodesic) const
 {
     geodP.clear();
@@ -2076,15 +1953,15 @@ calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
 
     GeodesicOptions opts;
     shootGeodesicInDirectionUntilPlaneHit(xP, tP,
-            geodHitPlaneEvent->getPlane(), opts, geodP);
+            plane, opts, geodP);
     shootGeodesicInDirectionUntilPlaneHit(xQ, tQ,
-            geodHitPlaneEvent->getPlane(), opts, geodQ);
+            plane, opts, geodQ);
 
     // Finish each geodesic with reverse Jacobi field.
     calcGeodesicReverseSensitivity(geodP,
-        geodQ.getDirectionalSensitivityPtoQ().back());
+        geodQ.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
     calcGeodesicReverseSensitivity(geodQ,
-        geodP.getDirectionalSensitivityPtoQ().back());
+        geodP.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
 
     if (geodesic)
         mergeGeodesics(geodP, geodQ, *geodesic);
@@ -2129,7 +2006,7 @@ calcOrthogonalGeodError(const Vec3& xP, const Vec3& xQ,
 // Calculate the "geodesic error" for tP and tQ
 Vec2 ContactGeometryImpl::
 calcSplitGeodErrorAnalytical(const Vec3& xP, const Vec3& xQ,
-              const UnitVec3& tP, const UnitVec3& tQ,
+              const UnitVec3& tP, const UnitVec3& tQ, const Plane& plane,
               Geodesic* geodesic) const
 {
     geodP.clear();
@@ -2137,15 +2014,15 @@ calcSplitGeodErrorAnalytical(const Vec3& xP, const Vec3& xQ,
 
     GeodesicOptions opts;
     shootGeodesicInDirectionUntilPlaneHitAnalytical(xP, tP,
-            geodHitPlaneEvent->getPlane(), opts, geodP);
+            plane, opts, geodP);
     shootGeodesicInDirectionUntilPlaneHitAnalytical(xQ, tQ,
-            geodHitPlaneEvent->getPlane(), opts, geodQ);
+            plane, opts, geodQ);
 
     // Finish each geodesic with reverse Jacobi field.
     calcGeodesicReverseSensitivity(geodP,
-        geodQ.getDirectionalSensitivityPtoQ().back());
+        geodQ.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
     calcGeodesicReverseSensitivity(geodQ,
-        geodP.getDirectionalSensitivityPtoQ().back());
+        geodP.getDirectionalSensitivityPtoQ().back(), Vec2(1,0));
 
     if (geodesic)
         mergeGeodesics(geodP, geodQ, *geodesic);
@@ -2158,7 +2035,8 @@ calcSplitGeodErrorAnalytical(const Vec3& xP, const Vec3& xQ,
 // Calculate the "geodesic jacobian" by numerical perturbation
 Mat22 ContactGeometryImpl::
 calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
-        const Real& thetaP, const Real& thetaQ, Differentiator::Method order) const {
+        const Real& thetaP, const Real& thetaQ, const Plane& plane,
+        Differentiator::Method order) const {
 
 //    UnitVec3 tP = calcUnitTangentVecGG(thetaP, R_SP);
 //    UnitVec3 tQ = calcUnitTangentVecGG(thetaQ, R_SQ);
@@ -2168,9 +2046,9 @@ calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
 //
 //    GeodesicOptions opts;
 //    shootGeodesicInDirectionUntilPlaneHit(xP, tP,
-//            geodHitPlaneEvent->getPlane(), opts, geodP);
+//            getPlane(), opts, geodP);
 //    shootGeodesicInDirectionUntilPlaneHit(xQ, tQ,
-//            geodHitPlaneEvent->getPlane(), opts, geodQ);
+//            getPlane(), opts, geodQ);
 
     GeodesicOptions opts;
 
@@ -2201,7 +2079,7 @@ calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
     // positive perturb
     tP = calcUnitTangentVec(thetaP+h, R_SP);
     shootGeodesicInDirectionUntilPlaneHit(xP, tP,
-            geodHitPlaneEvent->getPlane(), opts, geodPtmp);
+            plane, opts, geodPtmp);
     fyptmp = calcError(geodPtmp, geodQ);
 
     if (order==1) {
@@ -2211,7 +2089,7 @@ calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
         geodPtmp.clear();
         tP = calcUnitTangentVec(thetaP-h, R_SP);
         shootGeodesicInDirectionUntilPlaneHit(xP, tP,
-                geodHitPlaneEvent->getPlane(), opts, geodPtmp);
+                plane, opts, geodPtmp);
         fymtmp = calcError(geodPtmp, geodQ);
 
         dfdy(0) = (fyptmp-fymtmp)/(2*h);
@@ -2224,7 +2102,7 @@ calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
     // positive perturb
     tQ = calcUnitTangentVec(thetaQ+h, R_SQ);
     shootGeodesicInDirectionUntilPlaneHit(xQ, tQ,
-            geodHitPlaneEvent->getPlane(), opts, geodQtmp);
+            plane, opts, geodQtmp);
     fyptmp = calcError(geodP, geodQtmp);
 
     if (order==1) {
@@ -2234,7 +2112,7 @@ calcSplitGeodErrorJacobian(const Vec3& xP, const Vec3& xQ,
         geodQtmp.clear();
         tQ = calcUnitTangentVec(thetaQ-h, R_SQ);
         shootGeodesicInDirectionUntilPlaneHit(xQ, tQ,
-                geodHitPlaneEvent->getPlane(), opts, geodQtmp);
+                plane, opts, geodQtmp);
         fymtmp = calcError(geodP, geodQtmp);
 
         dfdy(1) = (fyptmp-fymtmp)/(2*h);
@@ -46,14 +46,12 @@ class SplitGeodesicError;
 class SimTK_SIMMATH_EXPORT ContactGeometryImpl {
 public:
     ContactGeometryImpl() 
-    :   myHandle(0), ptOnSurfSys(0), geodHitPlaneEvent(0), vizReporter(0),
+    :   myHandle(0), ptOnSurfSys(0), vizReporter(0),
         splitGeodErr(0), numGeodesicsShot(0)
-    {
-        createParticleOnSurfaceSystem();
-    }
+    {}
     ContactGeometryImpl(const ContactGeometryImpl& source)
-    :   myHandle(0), ptOnSurfSys(0), geodHitPlaneEvent(0), vizReporter(0),
-        splitGeodErr(0), numGeodesicsShot(0) 
+    :   myHandle(0), ptOnSurfSys(0), geodHitPlane(source.geodHitPlane),
+        vizReporter(0), splitGeodErr(0), numGeodesicsShot(0) 
     {}
 
     virtual ~ContactGeometryImpl() {
@@ -175,10 +173,10 @@ public:
 
     // Utility method to calculate the "geodesic error" between one geodesic
     // shot from P in the direction tP and another geodesic shot from Q in the
-    // direction tQ.
+    // direction tQ, both stopped where they hit the given plane.
     Vec2 calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
                        const UnitVec3& tP, const UnitVec3& tQ,
-                       Geodesic* geod=0) const;
+                       const Plane& plane, Geodesic* geod=0) const;
 
     // analytical versions of the geodesic API methods
 
@@ -194,7 +192,7 @@ public:
 
     Vec2 calcSplitGeodErrorAnalytical(const Vec3& P, const Vec3& Q,
                        const UnitVec3& tP, const UnitVec3& tQ,
-                       Geodesic* geod=0) const;
+                       const Plane& plane, Geodesic* geod=0) const;
 
 
     // Utility method to calculate the "geodesic error" between the end-points
@@ -317,19 +315,16 @@ public:
 
 
     // Utility method to used by calcGeodesicInDirectionUntilPlaneHit
-    //  and calcGeodesicInDirectionUntilLengthReached
+    // and calcGeodesicInDirectionUntilLengthReached. Integration stops at
+    // finalArcLength, or where the geodesic crosses terminatingPlane if 
+    // that is given.
     void shootGeodesicInDirection(const Vec3& P, const UnitVec3& tP,
-            const Real& finalTime, const GeodesicOptions& options,
-            Geodesic& geod) const;
-    void shootGeodesicInDirection2(const Vec3& P, const UnitVec3& tP,
-            const Real& finalTime, const GeodesicOptions& options,
+            const Real& finalArcLength, const Plane* terminatingPlane,
             Geodesic& geod) const;
 
     // Utility method to integrate geodesic backwards to fill in the Q to P
-    // directional sensitivity.
+    // directional and positional sensitivities.
     void calcGeodesicReverseSensitivity
-       (Geodesic& geod, const Vec2& initJacobi) const;
-    void calcGeodesicReverseSensitivity2
        (Geodesic& geod, const Vec2& initJRot, const Vec2& initJTrans) const;
 
     // Utility method to calculate the "geodesic error" between one geodesic
@@ -338,7 +333,7 @@ public:
     // We optionally return the resulting "kinked" geodesic, which is the real
     // one if the returned errors are below tolerance.
     Vec2 calcSplitGeodError(const Vec3& xP, const Vec3& xQ,
-                       Real thetaP, Real thetaQ,
+                       Real thetaP, Real thetaQ, const Plane& plane,
                        Geodesic* geodesic=0) const;
 
     // Utility method to calculate the "orthogonal error" between a geodesic
@@ -355,7 +350,8 @@ public:
     // shot from P in the direction thetaP and another geodesic shot from Q in the
     // direction thetaQ given the pre-calculated member basis R_SP, R_SQ
     Mat22 calcSplitGeodErrorJacobian(const Vec3& P, const Vec3& Q,
-            const Real& thetaP, const Real& thetaQ, Differentiator::Method method) const;
+            const Real& thetaP, const Real& thetaQ, const Plane& plane,
+            Differentiator::Method method) const;
 
     // Compute rotation matrix using the normal at the given point and the
     // given direction.
@@ -366,14 +362,15 @@ public:
         return R_GS;
     }
 
-    // Get the plane associated with the geodesic hit plane event handler
+    // Get the plane used by the public calcSplitGeodError() debugging
+    // methods. calcGeodesic() passes its own plane and doesn't use this one.
     const Plane& getPlane() const {
-        return geodHitPlaneEvent->getPlane();
+        return geodHitPlane;
     }
 
-    // Set the plane associated with the geodesic hit plane event handler
+    // Set the plane used by the public calcSplitGeodError() debugging methods.
     void setPlane(const Plane& plane) const {
-        return geodHitPlaneEvent->setPlane(plane);
+        geodHitPlane = plane;
     }
 
 
@@ -391,7 +388,11 @@ public:
         return numGeodesicsShot;
     }
 
+    // Geodesics are not computed with the ParticleConSurfaceSystem; it is 
+    // created here only to own the reporter and supply it a State.
     void addVizReporter(ScheduledEventReporter* reporter) const {
+        if (!ptOnSurfSys)
+            ptOnSurfSys = new ParticleConSurfaceSystem(*this);
         vizReporter = reporter;
         ptOnSurfSys->addEventReporter(vizReporter); // takes ownership
         ptOnSurfSys->realizeTopology();
@@ -402,17 +403,9 @@ public:
     class OrthoGeodesicError; // local class
     friend class OrthoGeodesicError;
 
-    void createParticleOnSurfaceSystem() {
-        ptOnSurfSys = new ParticleConSurfaceSystem(*this);
-        geodHitPlaneEvent = new GeodHitPlaneEvent();
-        ptOnSurfSys->addEventHandler(geodHitPlaneEvent); // takes ownership
-        ptOnSurfSys->realizeTopology();
-    }
-
     void clearParticleOnSurfaceSystem() {
         delete ptOnSurfSys;
         ptOnSurfSys = 0;
-        geodHitPlaneEvent = 0; // was deleted by the system
     }
 
     ContactGeometry* getMyHandle() {return myHandle;}
@@ -422,8 +415,8 @@ protected:
     ContactGeometry*        myHandle;
     OBBTree                 obbTree;
 
-    ParticleConSurfaceSystem* ptOnSurfSys;
-    GeodHitPlaneEvent* geodHitPlaneEvent; // don't delete this
+    mutable ParticleConSurfaceSystem* ptOnSurfSys; // only for vizReporter
+    mutable Plane geodHitPlane;
     mutable ScheduledEventReporter* vizReporter; // don't delete this
     mutable SplitGeodesicError* splitGeodErr;
 
@@ -980,17 +973,39 @@ private:
 //==============================================================================
 //                            OBB TREE NODE IMPL
 //==============================================================================
+/* One node of a TriangleMesh's OBB tree. The nodes are owned by an OBBTreeImpl
+which stores them contiguously in depth-first order, so the first child of a
+non-leaf node immediately follows it and the second child is secondChildOffset
+nodes further on. A leaf's triangle list is a view into the OBBTreeImpl's 
+triangle array; it is set by the owning tree and is not copied with the 
+node. */
 class OBBTreeNodeImpl {
 public:
-    OBBTreeNodeImpl() : child1(NULL), child2(NULL), numTriangles(0) {
+    OBBTreeNodeImpl() : secondChildOffset(0), firstTriangle(0), 
+                        numTriangles(0) {}
+    OBBTreeNodeImpl(const OBBTreeNodeImpl& copy) 
+    :   bounds(copy.bounds), secondChildOffset(copy.secondChildOffset),
+        firstTriangle(copy.firstTriangle), numTriangles(copy.numTriangles) {}
+    OBBTreeNodeImpl& operator=(const OBBTreeNodeImpl& copy) {
+        bounds            = copy.bounds;
+        secondChildOffset = copy.secondChildOffset;
+        firstTriangle     = copy.firstTriangle;
+        numTriangles      = copy.numTriangles;
+        triangles.deallocate();
+        return *this;
     }
-    OBBTreeNodeImpl(const OBBTreeNodeImpl& copy);
-    ~OBBTreeNodeImpl();
+
+    bool isLeaf() const {return secondChildOffset == 0;}
+    const OBBTreeNodeImpl& getFirstChild() const 
+    {   assert(!isLeaf()); return this[1]; }
+    const OBBTreeNodeImpl& getSecondChild() const 
+    {   assert(!isLeaf()); return this[secondChildOffset]; }
+
     OrientedBoundingBox bounds;
-    OBBTreeNodeImpl* child1;
-    OBBTreeNodeImpl* child2;
-    Array_<int> triangles;
-    int numTriangles;
+    int secondChildOffset;  // 0 for a leaf
+    int firstTriangle;      // leaf only; index into OBBTreeImpl::triangles
+    Array_<int> triangles;  // leaf only
+    int numTriangles;       // including all descendants
     Vec3 findNearestPoint(const ContactGeometry::TriangleMesh::Impl& mesh, 
                           const Vec3& position, Real cutoff2, Real& distance2, 
                           int& face, Vec2& uv) const;
@@ -1001,6 +1016,79 @@ public:
 
 
 
+//==============================================================================
+//                               OBB TREE IMPL
+//==============================================================================
+/* The OBB tree of a TriangleMesh, flattened into arrays. nodes[0] is the root
+and the triangles of all the leaves are stored together in depth-first order,
+so each leaf holds a contiguous range of them. 
+
+Alongside each node there is a Box holding just what a traversal needs: the 
+box center, axes and half-dimensions expressed in the mesh frame, the tree 
+links and the leaf's triangle range. Traversals that only test boxes and visit
+leaves, like mesh-mesh intersection, can then work from one small contiguous
+array without touching the OrientedBoundingBox objects or the node views. */
+class OBBTreeImpl {
+public:
+    struct Box {
+        Real center[3];
+        Real axes[3][3];    // axes[i] is box axis i, expressed in the mesh frame
+        Real halfSize[3];
+        int  secondChildOffset;
+        int  firstTriangle;
+        int  numTriangles;
+        bool isLeaf() const {return secondChildOffset == 0;}
+    };
+
+    OBBTreeImpl() {}
+    OBBTreeImpl(const OBBTreeImpl& copy) 
+    :   nodes(copy.nodes), boxes(copy.boxes), triangles(copy.triangles) 
+    {   linkLeafTriangles(); }
+    OBBTreeImpl& operator=(const OBBTreeImpl& copy) {
+        if (&copy != this) {
+            nodes     = copy.nodes;
+            boxes     = copy.boxes;
+            triangles = copy.triangles;
+            linkLeafTriangles();
+        }
+        return *this;
+    }
+
+    const OBBTreeNodeImpl& getRoot() const {return nodes.front();}
+    const Array_<Box>& getBoxes() const {return boxes;}
+    const Array_<int>& getTriangles() const {return triangles;}
+
+    void clear() {nodes.clear(); boxes.clear(); triangles.clear();}
+    
+    // Append a node with the given bounds to the end of the node array and 
+    // return its index. The node's children, if any, must be added next.
+    int addNode(const OrientedBoundingBox& bounds, int numTriangles) {
+        nodes.emplace_back();
+        nodes.back().bounds = bounds;
+        nodes.back().numTriangles = numTriangles;
+        return (int)nodes.size()-1;
+    }
+    // Call after adding a node's first subtree, right before its second.
+    void startSecondChild(int parent) 
+    {   nodes[parent].secondChildOffset = (int)nodes.size()-parent; }
+    // Make a node a leaf containing the given triangles.
+    void setLeafTriangles(int leaf, const Array_<int>& faces) {
+        nodes[leaf].firstTriangle = (int)triangles.size();
+        triangles.insert(triangles.end(), faces.begin(), faces.end());
+    }
+    // Call once after all nodes have been added.
+    void finishConstruction();
+
+private:
+    void linkLeafTriangles();
+
+    Array_<OBBTreeNodeImpl> nodes;
+    Array_<Box>             boxes;
+    Array_<int>             triangles;
+};
+
+
+
 //==============================================================================
 //                            TRIANGLE MESH IMPL
 //==============================================================================
@@ -1040,6 +1128,8 @@ public:
     bool isConvex() const override {return false;}
     bool isFinite() const override {return true;}
 
+    const OBBTreeImpl& getMeshOBBTree() const {return obb;}
+
 
     static ContactGeometryTypeId classTypeId() {
         static const ContactGeometryTypeId id = 
@@ -1048,7 +1138,7 @@ public:
     }
 private:
     void init(const Array_<Vec3>& vertexPositions, const Array_<int>& faceIndices);
-    void createObbTree(OBBTreeNodeImpl& node, const Array_<int>& faceIndices);
+    void createObbTree(const Array_<int>& faceIndices);
     void splitObbAxis(const Array_<int>& parentIndices, 
                       Array_<int>& child1Indices, 
                       Array_<int>& child2Indices, int axis);
@@ -1062,7 +1152,7 @@ private:
     Array_<Vertex>  vertices;
     Vec3            boundingSphereCenter;
     Real            boundingSphereRadius;
-    OBBTreeNodeImpl obb;
+    OBBTreeImpl     obb;
     bool            smooth;
 };
 
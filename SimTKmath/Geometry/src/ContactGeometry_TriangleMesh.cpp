@@ -185,7 +185,7 @@ bool ContactGeometry::TriangleMesh::intersectsRay
 
 ContactGeometry::TriangleMesh::OBBTreeNode 
 ContactGeometry::TriangleMesh::getOBBTreeNode() const {
-    return OBBTreeNode(getImpl().obb);
+    return OBBTreeNode(getImpl().obb.getRoot());
 }
 
 PolygonalMesh ContactGeometry::TriangleMesh::createPolygonalMesh() const {
@@ -257,7 +257,7 @@ Vec3 ContactGeometry::TriangleMesh::Impl::
 findNearestPoint(const Vec3& position, bool& inside, int& face, Vec2& uv) const 
 {
     Real distance2;
-    Vec3 nearestPoint = obb.findNearestPoint(*this, position, MostPositiveReal, distance2, face, uv);
+    Vec3 nearestPoint = obb.getRoot().findNearestPoint(*this, position, MostPositiveReal, distance2, face, uv);
     Vec3 delta = position-nearestPoint;
     inside = (~delta*faces[face].normal < 0);
     return nearestPoint;
@@ -278,9 +278,9 @@ bool ContactGeometry::TriangleMesh::Impl::
 intersectsRay(const Vec3& origin, const UnitVec3& direction, Real& distance, 
               int& face, Vec2& uv) const {
     Real boundsDistance;
-    if (!obb.bounds.intersectsRay(origin, direction, boundsDistance))
+    if (!obb.getRoot().bounds.intersectsRay(origin, direction, boundsDistance))
         return false;
-    return obb.intersectsRay(*this, origin, direction, distance, face, uv);
+    return obb.getRoot().intersectsRay(*this, origin, direction, distance, face, uv);
 }
 
 void ContactGeometry::TriangleMesh::Impl::
@@ -373,7 +373,7 @@ ContactGeometry::TriangleMesh::Impl::Impl
     // face's normal will be pointing back at us. If it is wrong, the face 
     // normal will also be pointing inwards, in roughly the same direction as 
     // the ray.
-    origin -= max(obb.bounds.getSize())*direction;
+    origin -= max(obb.getRoot().bounds.getSize())*direction;
     Real distance;
     int face;
     Vec2 uv;
@@ -534,7 +534,9 @@ void ContactGeometry::TriangleMesh::Impl::init
     Array_<int> allFaces(faces.size());
     for (int i = 0; i < (int) allFaces.size(); i++)
         allFaces[i] = i;
-    createObbTree(obb, allFaces);
+    obb.clear();
+    createObbTree(allFaces);
+    obb.finishConstruction();
     
     // Find the bounding sphere.
     Array_<const Vec3*> points(vertices.size());
@@ -545,10 +547,11 @@ void ContactGeometry::TriangleMesh::Impl::init
     boundingSphereRadius = bnd.getRadius();
 }
 
+// Add a node for the given faces to the end of the OBB tree, followed by its
+// subtrees in depth-first order.
 void ContactGeometry::TriangleMesh::Impl::createObbTree
-   (OBBTreeNodeImpl& node, const Array_<int>& faceIndices) 
+   (const Array_<int>& faceIndices) 
 {   // Find all vertices in the node and build the OrientedBoundingBox.
-    node.numTriangles = faceIndices.size();
     set<int> vertexIndices;
     for (int i = 0; i < (int) faceIndices.size(); i++) 
         for (int j = 0; j < 3; j++)
@@ -558,13 +561,14 @@ void ContactGeometry::TriangleMesh::Impl::createObbTree
     for (set<int>::iterator iter = vertexIndices.begin(); 
                             iter != vertexIndices.end(); ++iter)
         points[index++] = vertices[*iter].pos;
-    node.bounds = OrientedBoundingBox(points);
+    const OrientedBoundingBox bounds(points);
+    const int node = obb.addNode(bounds, (int)faceIndices.size());
     if (faceIndices.size() > 3) {
 
         // Order the axes by size.
 
         int axisOrder[3];
-        const Vec3& size = node.bounds.getSize();
+        const Vec3& size = bounds.getSize();
         if (size[0] > size[1]) {
             if (size[0] > size[2]) {
                 axisOrder[0] = 0;
@@ -609,10 +613,9 @@ void ContactGeometry::TriangleMesh::Impl::createObbTree
             if (child1Indices.size() > 0 && child2Indices.size() > 0) {
                 // It was successfully split, so create the child nodes.
 
-                node.child1 = new OBBTreeNodeImpl();
-                node.child2 = new OBBTreeNodeImpl();
-                createObbTree(*node.child1, child1Indices);
-                createObbTree(*node.child2, child2Indices);
+                createObbTree(child1Indices);
+                obb.startSecondChild(node);
+                createObbTree(child2Indices);
                 return;
             }
         }
@@ -620,8 +623,7 @@ void ContactGeometry::TriangleMesh::Impl::createObbTree
     
     // This is a leaf node.
     
-    node.triangles.insert(node.triangles.begin(), faceIndices.begin(), 
-                          faceIndices.end());
+    obb.setLeafTriangles(node, faceIndices);
 }
 
 void ContactGeometry::TriangleMesh::Impl::splitObbAxis
@@ -768,36 +770,55 @@ Vec3 ContactGeometry::TriangleMesh::Impl::findNearestPointToFace
 
 
 //==============================================================================
-//                            OBB TREE NODE IMPL
+//                               OBB TREE IMPL
 //==============================================================================
 
-OBBTreeNodeImpl::OBBTreeNodeImpl(const OBBTreeNodeImpl& copy) 
-:   bounds(copy.bounds), triangles(copy.triangles), 
-    numTriangles(copy.numTriangles) {
-    if (copy.child1 == NULL) {
-        child1 = NULL;
-        child2 = NULL;
-    }
-    else {
-        child1 = new OBBTreeNodeImpl(*copy.child1);
-        child2 = new OBBTreeNodeImpl(*copy.child2);
+void OBBTreeImpl::finishConstruction() {
+    boxes.resize(nodes.size());
+    for (int n = 0; n < (int)nodes.size(); ++n) {
+        const OBBTreeNodeImpl& node = nodes[n];
+        const Transform& X_MB = node.bounds.getTransform();
+        const Vec3 halfSize = node.bounds.getSize()/2;
+        const Vec3 center = X_MB*halfSize;
+        Box& box = boxes[n];
+        for (int i = 0; i < 3; ++i) {
+            box.center[i]   = center[i];
+            box.halfSize[i] = halfSize[i];
+            for (int j = 0; j < 3; ++j)
+                box.axes[i][j] = X_MB.R().asMat33()(j,i);
+        }
+        box.secondChildOffset = node.secondChildOffset;
+        box.firstTriangle     = node.isLeaf() ? node.firstTriangle : 0;
+        box.numTriangles      = node.numTriangles;
     }
+    linkLeafTriangles();
 }
 
-OBBTreeNodeImpl::~OBBTreeNodeImpl() {
-    if (child1 != NULL)
-        delete child1;
-    if (child2 != NULL)
-        delete child2;
+void OBBTreeImpl::linkLeafTriangles() {
+    for (auto& node : nodes) {
+        if (node.isLeaf() && node.numTriangles)
+            node.triangles.shareData(&triangles[node.firstTriangle],
+                                     node.numTriangles);
+        else
+            node.triangles.deallocate();
+    }
 }
 
+
+
+//==============================================================================
+//                            OBB TREE NODE IMPL
+//==============================================================================
+
 Vec3 OBBTreeNodeImpl::findNearestPoint
    (const ContactGeometry::TriangleMesh::Impl& mesh, 
     const Vec3& position, Real cutoff2, 
     Real& distance2, int& face, Vec2& uv) const 
 {
     Real tol = 100*Eps;
-    if (child1 != NULL) {
+    if (!isLeaf()) {
+        const OBBTreeNodeImpl& child1 = getFirstChild();
+        const OBBTreeNodeImpl& child2 = getSecondChild();
         // Recursively check the child nodes.
         
         Real child1distance2 = MostPositiveReal, 
@@ -806,21 +827,21 @@ Vec3 OBBTreeNodeImpl::findNearestPoint
         Vec2 child1uv, child2uv;
         Vec3 child1point, child2point;
         Real child1BoundsDist2 = 
-            (child1->bounds.findNearestPoint(position)-position).normSqr();
+            (child1.bounds.findNearestPoint(position)-position).normSqr();
         Real child2BoundsDist2 = 
-            (child2->bounds.findNearestPoint(position)-position).normSqr();
+            (child2.bounds.findNearestPoint(position)-position).normSqr();
         if (child1BoundsDist2 < child2BoundsDist2) {
             if (child1BoundsDist2 < cutoff2) {
-                child1point = child1->findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
+                child1point = child1.findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
                 if (child2BoundsDist2 < child1distance2 && child2BoundsDist2 < cutoff2)
-                    child2point = child2->findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
+                    child2point = child2.findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
             }
         }
         else {
             if (child2BoundsDist2 < cutoff2) {
-                child2point = child2->findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
+                child2point = child2.findNearestPoint(mesh, position, cutoff2, child2distance2, child2face, child2uv);
                 if (child1BoundsDist2 < child2distance2 && child1BoundsDist2 < cutoff2)
-                    child1point = child1->findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
+                    child1point = child1.findNearestPoint(mesh, position, cutoff2, child1distance2, child1face, child1uv);
             }
         }
         if (   child1distance2 <= child2distance2*(1+tol) 
@@ -870,34 +891,36 @@ bool OBBTreeNodeImpl::
 intersectsRay(const ContactGeometry::TriangleMesh::Impl& mesh,
               const Vec3& origin, const UnitVec3& direction, Real& distance, 
               int& face, Vec2& uv) const {
-    if (child1 != NULL) {
+    if (!isLeaf()) {
+        const OBBTreeNodeImpl& child1 = getFirstChild();
+        const OBBTreeNodeImpl& child2 = getSecondChild();
         // Recursively check the child nodes.
         
         Real child1distance, child2distance;
         int child1face, child2face;
         Vec2 child1uv, child2uv;
-        bool child1intersects = child1->bounds.intersectsRay(origin, direction, child1distance);
-        bool child2intersects = child2->bounds.intersectsRay(origin, direction, child2distance);
+        bool child1intersects = child1.bounds.intersectsRay(origin, direction, child1distance);
+        bool child2intersects = child2.bounds.intersectsRay(origin, direction, child2distance);
         if (child1intersects) {
             if (child2intersects) {
                 // The ray intersects both child nodes.  First check the closer one.
                 
                 if (child1distance < child2distance) {
-                    child1intersects = child1->intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
+                    child1intersects = child1.intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
                     if (!child1intersects || child2distance < child1distance)
-                        child2intersects = child2->intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
+                        child2intersects = child2.intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
                 }
                 else {
-                    child2intersects = child2->intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
+                    child2intersects = child2.intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
                     if (!child2intersects || child1distance < child2distance)
-                        child1intersects = child1->intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
+                        child1intersects = child1.intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
                 }
             }
             else
-                child1intersects = child1->intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
+                child1intersects = child1.intersectsRay(mesh, origin,  direction, child1distance, child1face, child1uv);
         }
         else if (child2intersects)
-            child2intersects = child2->intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
+            child2intersects = child2.intersectsRay(mesh, origin,  direction, child2distance, child2face, child2uv);
         
         // If either one had an intersection, return the closer one.
         
@@ -1002,26 +1025,26 @@ ContactGeometry::TriangleMesh::OBBTreeNode::getBounds() const {
 }
 
 bool ContactGeometry::TriangleMesh::OBBTreeNode::isLeafNode() const {
-    return (impl->child1 == NULL);
+    return impl->isLeaf();
 }
 
 const ContactGeometry::TriangleMesh::OBBTreeNode 
 ContactGeometry::TriangleMesh::OBBTreeNode::getFirstChildNode() const {
-    SimTK_ASSERT_ALWAYS(impl->child1, 
+    SimTK_ASSERT_ALWAYS(!impl->isLeaf(), 
         "Called getFirstChildNode() on a leaf node");
-    return OBBTreeNode(*impl->child1);
+    return OBBTreeNode(impl->getFirstChild());
 }
 
 const ContactGeometry::TriangleMesh::OBBTreeNode 
 ContactGeometry::TriangleMesh::OBBTreeNode::getSecondChildNode() const {
-    SimTK_ASSERT_ALWAYS(impl->child2, 
-        "Called getFirstChildNode() on a leaf node");
-    return OBBTreeNode(*impl->child2);
+    SimTK_ASSERT_ALWAYS(!impl->isLeaf(), 
+        "Called getSecondChildNode() on a leaf node");
+    return OBBTreeNode(impl->getSecondChild());
 }
 
 const Array_<int>& ContactGeometry::TriangleMesh::OBBTreeNode::
 getTriangles() const {
-    SimTK_ASSERT_ALWAYS(impl->child2 == NULL, 
+    SimTK_ASSERT_ALWAYS(impl->isLeaf(), 
         "Called getTriangles() on a non-leaf node");
     return impl->triangles;
 }
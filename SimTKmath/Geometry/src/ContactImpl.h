@@ -240,6 +240,11 @@ public:
                             const Transform&        X_S1S2,
                             const std::set<int>&    faces1, 
                             const std::set<int>&    faces2);
+    TriangleMeshContactImpl(ContactSurfaceIndex     surf1, 
+                            ContactSurfaceIndex     surf2,
+                            const Transform&        X_S1S2,
+                            const Array_<int>&      faces1, 
+                            const Array_<int>&      faces2);
 
     ContactTypeId getTypeId() const override {return classTypeId();}
     static ContactTypeId classTypeId() {
@@ -252,6 +257,9 @@ friend class TriangleMeshContact;
 
     const std::set<int> faces1;
     const std::set<int> faces2;
+    // The same faces, flattened for cheap traversal.
+    const Array_<int>   faceArray1;
+    const Array_<int>   faceArray2;
 };
 
 
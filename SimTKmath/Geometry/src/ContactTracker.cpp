@@ -23,6 +23,8 @@
 
 #include "SimTKmath.h"
 
+#include "ContactGeometryImpl.h"
+
 #include <algorithm>
 using std::pair; using std::make_pair;
 #include <iostream>
@@ -1015,17 +1017,11 @@ bool ContactTracker::TriangleMeshTriangleMesh::trackContact
 
     // Transform giving mesh2 (M2) frame in the mesh1 (M1) frame.
     const Transform X_M1M2 = ~X_GM1*X_GM2; 
-    std::set<int> insideFaces1, insideFaces2;
-
-    // Get M2's bounding box in M1's frame.
-    const OrientedBoundingBox 
-        mesh2Bounds_M1 = X_M1M2*mesh2.getOBBTreeNode().getBounds();
+    Array_<int> insideFaces1, insideFaces2;
 
     // Find the faces that are actually intersecting faces on the other
     // surface (this doesn't yet include faces that may be completely buried).
-    findIntersectingFaces(mesh1, mesh2, 
-                          mesh1.getOBBTreeNode(), mesh2.getOBBTreeNode(), 
-                          mesh2Bounds_M1, X_M1M2, insideFaces1, insideFaces2);
+    findIntersectingFaces(mesh1, mesh2, X_M1M2, insideFaces1, insideFaces2);
     
     // It should never be the case that one set of faces is empty and the
     // other isn't, however it is conceivable that roundoff error could cause
@@ -1048,73 +1044,212 @@ bool ContactTracker::TriangleMeshTriangleMesh::trackContact
     return true; // success
 }
 
+// The number of box pairs tested together by testBoxPairs(). Splitting two
+// non-leaf nodes produces four pairs of children.
+static const int BoxBatch = 4;
+
+// Determine which of the n <= BoxBatch node pairs have overlapping boxes, 
+// using the separating axis test of Gottschalk, S., Lin, MC, Manocha, D, 
+// "OBBTree: a hierarchical structure for rapid interference detection." 
+// Proceedings of the 23rd Annual Conference on Computer Graphics and 
+// Interactive Techniques, pp. 171-180, 1996 (as in 
+// OrientedBoundingBox::intersectsBox()). The first node of each pair is in
+// mesh1's tree and the second in mesh2's. 
+//
+// The box data is gathered into arrays indexed [...][pair] and all the pairs
+// go through all 15 axis tests in lockstep, using fixed-length loops over the
+// batch that the compiler can vectorize. Unused slots are filled with copies
+// of the first pair. A small tolerance is added to the absolute rotation
+// elements so that nearly parallel edges can't produce a spurious separating
+// axis from their nearly zero cross product.
+static void testBoxPairs
+   (int n, const std::pair<int,int> pairs[],
+    const Array_<OBBTreeImpl::Box>& boxes1, 
+    const Array_<OBBTreeImpl::Box>& boxes2,
+    const Transform& X_M1M2, bool overlaps[])
+{
+    const int B = BoxBatch;
+    Real ca[3][B], ha[3][B], axa[3][3][B]; // box a, in M1
+    Real cb[3][B], hb[3][B], axb[3][3][B]; // box b, in M2
+    for (int k = 0; k < B; ++k) {
+        const OBBTreeImpl::Box& a = boxes1[pairs[k < n ? k : 0].first];
+        const OBBTreeImpl::Box& b = boxes2[pairs[k < n ? k : 0].second];
+        for (int i = 0; i < 3; ++i) {
+            ca[i][k] = a.center[i];   ha[i][k] = a.halfSize[i];
+            cb[i][k] = b.center[i];   hb[i][k] = b.halfSize[i];
+            for (int j = 0; j < 3; ++j) {
+                axa[i][j][k] = a.axes[i][j];
+                axb[i][j][k] = b.axes[i][j];
+            }
+        }
+    }
+
+    // Re-express box b in M1: t is the vector from a's center to b's and 
+    // bax[j] is b's j'th axis.
+    const Mat33& R = X_M1M2.R().asMat33();
+    const Vec3&  p = X_M1M2.p();
+    Real t[3][B], bax[3][3][B];
+    for (int i = 0; i < 3; ++i)
+        for (int k = 0; k < B; ++k)
+            t[i][k] = p[i] - ca[i][k] 
+                    + R(i,0)*cb[0][k] + R(i,1)*cb[1][k] + R(i,2)*cb[2][k];
+    for (int j = 0; j < 3; ++j)
+        for (int i = 0; i < 3; ++i)
+            for (int k = 0; k < B; ++k)
+                bax[j][i][k] = R(i,0)*axb[j][0][k] + R(i,1)*axb[j][1][k]
+                             + R(i,2)*axb[j][2][k];
+
+    // r(i,j) is a's axis i dotted with b's axis j; d is t in a's frame.
+    Real r[3][3][B], rabs[3][3][B], d[3][B];
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < B; ++k)
+            d[i][k] = axa[i][0][k]*t[0][k] + axa[i][1][k]*t[1][k] 
+                    + axa[i][2][k]*t[2][k];
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < B; ++k) {
+                r[i][j][k] = axa[i][0][k]*bax[j][0][k] 
+                           + axa[i][1][k]*bax[j][1][k]
+                           + axa[i][2][k]*bax[j][2][k];
+                rabs[i][j][k] = std::abs(r[i][j][k]) + SignificantReal;
+            }
+    }
+
+    bool separated[B] = {};
+    // The axes of box a.
+    for (int i = 0; i < 3; ++i)
+        for (int k = 0; k < B; ++k) {
+            const Real rb = rabs[i][0][k]*hb[0][k] + rabs[i][1][k]*hb[1][k]
+                          + rabs[i][2][k]*hb[2][k];
+            separated[k] |= std::abs(d[i][k]) > ha[i][k] + rb;
+        }
+    // The axes of box b.
+    for (int j = 0; j < 3; ++j)
+        for (int k = 0; k < B; ++k) {
+            const Real ra = ha[0][k]*rabs[0][j][k] + ha[1][k]*rabs[1][j][k]
+                          + ha[2][k]*rabs[2][j][k];
+            const Real dist = d[0][k]*r[0][j][k] + d[1][k]*r[1][j][k]
+                            + d[2][k]*r[2][j][k];
+            separated[k] |= std::abs(dist) > ra + hb[j][k];
+        }
+    // The nine cross products of an axis of a with an axis of b.
+    for (int i = 0; i < 3; ++i) {
+        const int i1 = (i+1)%3, i2 = (i+2)%3;
+        for (int j = 0; j < 3; ++j) {
+            const int j1 = (j+1)%3, j2 = (j+2)%3;
+            for (int k = 0; k < B; ++k) {
+                const Real ra = ha[i1][k]*rabs[i2][j][k] 
+                              + ha[i2][k]*rabs[i1][j][k];
+                const Real rb = hb[j1][k]*rabs[i][j2][k] 
+                              + hb[j2][k]*rabs[i][j1][k];
+                const Real dist = d[i2][k]*r[i1][j][k] - d[i1][k]*r[i2][j][k];
+                separated[k] |= std::abs(dist) > ra + rb;
+            }
+        }
+    }
+
+    for (int k = 0; k < n; ++k)
+        overlaps[k] = !separated[k];
+}
+
+// The tree traversal is iterative, working from a stack of node pairs whose
+// boxes are known to overlap. Popping a pair in which either node has 
+// children produces up to four child pairs which are tested as a batch; those
+// that overlap are pushed. When both nodes are leaves their triangles are 
+// tested against each other. Faces are collected in arrays which are sorted
+// and pruned of duplicates at the end.
 void ContactTracker::TriangleMeshTriangleMesh::
 findIntersectingFaces
    (const ContactGeometry::TriangleMesh&                mesh1, 
     const ContactGeometry::TriangleMesh&                mesh2,
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node1, 
-    const ContactGeometry::TriangleMesh::OBBTreeNode&   node2, 
-    const OrientedBoundingBox&                          node2Bounds_M1,
     const Transform&                                    X_M1M2, 
-    std::set<int>&                                      triangles1, 
-    std::set<int>&                                      triangles2) const 
-{   // See if the bounding boxes intersect.
-    
-    if (!node1.getBounds().intersectsBox(node2Bounds_M1))
-        return;
-    
-    // If either node is not a leaf node, process the children recursively.
-    
-    if (!node1.isLeafNode()) {
-        if (!node2.isLeafNode()) {
-            const OrientedBoundingBox firstChildBounds = 
-                X_M1M2*node2.getFirstChildNode().getBounds();
-            const OrientedBoundingBox secondChildBounds = 
-                X_M1M2*node2.getSecondChildNode().getBounds();
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
+    Array_<int>&                                        triangles1, 
+    Array_<int>&                                        triangles2) const 
+{
+    typedef std::pair<int,int> NodePair;
+    const OBBTreeImpl& tree1 = mesh1.getImpl().getMeshOBBTree();
+    const OBBTreeImpl& tree2 = mesh2.getImpl().getMeshOBBTree();
+    const Array_<OBBTreeImpl::Box>& boxes1 = tree1.getBoxes();
+    const Array_<OBBTreeImpl::Box>& boxes2 = tree2.getBoxes();
+
+    triangles1.clear();
+    triangles2.clear();
+
+    // Reused from call to call so that a traversal doesn't allocate once the
+    // stack has grown to its working size.
+    static thread_local Array_<NodePair> pending;
+    pending.clear();
+
+    NodePair candidates[BoxBatch];
+    bool overlaps[BoxBatch];
+    candidates[0] = NodePair(0, 0);
+    testBoxPairs(1, candidates, boxes1, boxes2, X_M1M2, overlaps);
+    if (overlaps[0])
+        pending.push_back(candidates[0]);
+
+    while (!pending.empty()) {
+        const NodePair nodes = pending.back();
+        pending.pop_back();
+        const OBBTreeImpl::Box& box1 = boxes1[nodes.first];
+        const OBBTreeImpl::Box& box2 = boxes2[nodes.second];
+
+        if (box1.isLeaf() && box2.isLeaf()) {
+            // These are both leaf nodes, so check triangles for 
+            // intersections.
+            const int* node1triangles = &tree1.getTriangles()[box1.firstTriangle];
+            const int* node2triangles = &tree2.getTriangles()[box2.firstTriangle];
+            for (int i = 0; i < box2.numTriangles; i++) {
+                const int face2 = node2triangles[i];
+                Vec3 a1 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 0));
+                Vec3 a2 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 1));
+                Vec3 a3 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 2));
+                const Geo::Triangle A(a1,a2,a3);
+                for (int j = 0; j < box1.numTriangles; j++) {
+                    const int face1 = node1triangles[j];
+                    const Vec3& b1 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 0));
+                    const Vec3& b2 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 1));
+                    const Vec3& b3 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 2));
+                    const Geo::Triangle B(b1,b2,b3);
+                    if (A.overlapsTriangle(B)) 
+                    {   // The triangles intersect.
+                        triangles1.push_back(face1);
+                        triangles2.push_back(face2);
+                    }
+                }
+            }
+            continue;
         }
-        else {
-            findIntersectingFaces(mesh1, mesh2, node1.getFirstChildNode(), node2, node2Bounds_M1, X_M1M2, triangles1, triangles2);
-            findIntersectingFaces(mesh1, mesh2, node1.getSecondChildNode(), node2, node2Bounds_M1, X_M1M2, triangles1, triangles2);
+
+        // Descend into whichever of the nodes have children.
+        int children1[2] = {nodes.first, nodes.first}, nChildren1 = 1;
+        int children2[2] = {nodes.second, nodes.second}, nChildren2 = 1;
+        if (!box1.isLeaf()) {
+            children1[0] = nodes.first + 1;
+            children1[1] = nodes.first + box1.secondChildOffset;
+            nChildren1 = 2;
         }
-        return;
-    }
-    else if (!node2.isLeafNode()) {
-        const OrientedBoundingBox firstChildBounds = 
-            X_M1M2*node2.getFirstChildNode().getBounds();
-        const OrientedBoundingBox secondChildBounds = 
-            X_M1M2*node2.getSecondChildNode().getBounds();
-        findIntersectingFaces(mesh1, mesh2, node1, node2.getFirstChildNode(), firstChildBounds, X_M1M2, triangles1, triangles2);
-        findIntersectingFaces(mesh1, mesh2, node1, node2.getSecondChildNode(), secondChildBounds, X_M1M2, triangles1, triangles2);
-        return;
-    }
-    
-    // These are both leaf nodes, so check triangles for intersections.
-    
-    const Array_<int>& node1triangles = node1.getTriangles();
-    const Array_<int>& node2triangles = node2.getTriangles();
-    for (unsigned i = 0; i < node2triangles.size(); i++) {
-        const int face2 = node2triangles[i];
-        Vec3 a1 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 0));
-        Vec3 a2 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 1));
-        Vec3 a3 = X_M1M2*mesh2.getVertexPosition(mesh2.getFaceVertex(face2, 2));
-        const Geo::Triangle A(a1,a2,a3);
-        for (unsigned j = 0; j < node1triangles.size(); j++) {
-            const int face1 = node1triangles[j];
-            const Vec3& b1 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 0));
-            const Vec3& b2 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 1));
-            const Vec3& b3 = mesh1.getVertexPosition(mesh1.getFaceVertex(face1, 2));
-            const Geo::Triangle B(b1,b2,b3);
-            if (A.overlapsTriangle(B)) 
-            {   // The triangles intersect.
-                triangles1.insert(face1);
-                triangles2.insert(face2);
-            }
+        if (!box2.isLeaf()) {
+            children2[0] = nodes.second + 1;
+            children2[1] = nodes.second + box2.secondChildOffset;
+            nChildren2 = 2;
         }
+        int n = 0;
+        for (int i = 0; i < nChildren1; ++i)
+            for (int j = 0; j < nChildren2; ++j)
+                candidates[n++] = NodePair(children1[i], children2[j]);
+        testBoxPairs(n, candidates, boxes1, boxes2, X_M1M2, overlaps);
+
+        // Push in reverse so the pairs are visited in the order listed.
+        for (int i = n-1; i >= 0; --i)
+            if (overlaps[i])
+                pending.push_back(candidates[i]);
     }
+
+    std::sort(triangles1.begin(), triangles1.end());
+    triangles1.erase(std::unique(triangles1.begin(), triangles1.end()), 
+                     triangles1.end());
+    std::sort(triangles2.begin(), triangles2.end());
+    triangles2.erase(std::unique(triangles2.begin(), triangles2.end()), 
+                     triangles2.end());
 }
 
 static const int Outside  = -1;
@@ -1126,15 +1261,14 @@ void ContactTracker::TriangleMeshTriangleMesh::
 findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M 
                 const ContactGeometry::TriangleMesh&    otherMesh,  // O
                 const Transform&                        X_OM, 
-                std::set<int>&                          insideFaces) const 
+                Array_<int>&                            insideFaces) const 
 {  
     // Find which faces are inside.
     // We're passed in the list of Boundary faces, that is, those faces of
     // "mesh" that intersect faces of "otherMesh".
     Array_<int> faceType(mesh.getNumFaces(), Unknown);
-    for (std::set<int>::iterator iter = insideFaces.begin(); 
-                                 iter != insideFaces.end(); ++iter)
-        faceType[*iter] = Boundary;
+    for (int face : insideFaces)
+        faceType[face] = Boundary;
 
     for (int i = 0; i < (int) faceType.size(); i++) {
         if (faceType[i] == Unknown) {
@@ -1149,7 +1283,7 @@ findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M
                 && ~direction_O*otherMesh.getFaceNormal(face) > 0) 
             {
                 faceType[i] = Inside;
-                insideFaces.insert(i);
+                insideFaces.push_back(i);
             } else
                 faceType[i] = Outside;
             
@@ -1157,6 +1291,9 @@ findBuriedFaces(const ContactGeometry::TriangleMesh&    mesh,       // M
             tagFaces(mesh, faceType, insideFaces, i, 0);
         }
     }
+
+    // Each face was added at most once, but not in order.
+    std::sort(insideFaces.begin(), insideFaces.end());
 }
 
 //TODO: the following method uses depth-first recursion to iterate through
@@ -1169,7 +1306,7 @@ static const int MaxRecursionDepth = 500;
 void ContactTracker::TriangleMeshTriangleMesh::
 tagFaces(const ContactGeometry::TriangleMesh&   mesh, 
          Array_<int>&                           faceType,
-         std::set<int>&                         triangles, 
+         Array_<int>&                           triangles, 
          int                                    index,
          int                                    depth) const 
 {
@@ -1181,7 +1318,7 @@ tagFaces(const ContactGeometry::TriangleMesh&   mesh,
         if (faceType[face] == Unknown) {
             faceType[face] = faceType[index];
             if (faceType[index] > 0)
-                triangles.insert(face);
+                triangles.push_back(face);
             if (depth < MaxRecursionDepth)
                 tagFaces(mesh, faceType, triangles, face, depth+1);
         }
@@ -1274,6 +1411,35 @@ bool ContactTracker::ConvexImplicitPair::trackContact
     const ContactGeometry& shapeB,
     Real                   cutoff,
     Contact&               currentStatus) const
+{
+    PairCache noHistory;
+    return trackContactUsingCache(priorStatus, X_GA, shapeA, X_GB, shapeB,
+                                  cutoff, noHistory, currentStatus);
+}
+
+// Return true if the plane with normal dirInA separates the shapes, using the
+// same support point test as MPR.
+static bool isSeparatingDirection
+   (const ContactGeometry& shapeA, const ContactGeometry& shapeB,
+    const Transform& X_AB, const UnitVec3& dirInA)
+{
+    const Support support(shapeA, shapeB, X_AB, dirInA);
+    return support.depth <= 0;
+}
+
+// With no prior contact and an empty cache this is the original algorithm:
+// MPR for a rough guess, then Newton refinement. The cache only ever holds a
+// separating direction, which proves there is no contact when it still
+// applies, so it can't change the result.
+bool ContactTracker::ConvexImplicitPair::trackContactUsingCache
+   (const Contact&         priorStatus,
+    const Transform&       X_GA, 
+    const ContactGeometry& shapeA,
+    const Transform&       X_GB, 
+    const ContactGeometry& shapeB,
+    Real                   cutoff,
+    PairCache&             cache,
+    Contact&               currentStatus) const
 {
     SimTK_ASSERT_ALWAYS
        (   shapeA.isConvex() && shapeA.isSmooth() 
@@ -1284,50 +1450,102 @@ bool ContactTracker::ConvexImplicitPair::trackContact
     const Transform X_AB = ~X_GA*X_GB; // 63 flops
     const Rotation& R_AB = X_AB.R();
 
-    // 1. Get a rough guess at the contact points P and Q and contact normal.
-    Vec3 pointP_A, pointQ_B; // on A and B, resp.
-    UnitVec3 norm_A;
-    int numMPRIters;
-    const bool mightBeContact = estimateConvexImplicitPairContactUsingMPR
-                                   (shapeA, shapeB, X_AB,
-                                    pointP_A, pointQ_B, norm_A, numMPRIters);
-
-    #ifdef MPR_DEBUG
-    std::cout << "MPR: " << (mightBeContact?"MAYBE":"NO") << std::endl;
-    std::cout << "  P=" << X_GA*pointP_A << " Q=" << X_GB*pointQ_B << std::endl;
-    std::cout << "  N=" << X_GA.R()*norm_A << std::endl;
-    #endif
-
-    if (!mightBeContact) {
-        currentStatus.clear(); // definitely not touching
-        return true; // successful return
+    // 0. If the shapes were separated last time, the plane that separated
+    //    them then probably still does. That costs one support point per
+    //    shape, much less than MPR.
+    if (cache.hasSeparatingDirection) {
+        if (isSeparatingDirection(shapeA, shapeB, X_AB, 
+                                  cache.separatingDirection)) {
+            currentStatus.clear(); // definitely not touching
+            return true;
+        }
+        cache.hasSeparatingDirection = false;
     }
 
-    // 2. Refine the contact points to near machine precision.
     const Real accuracyRequested = SignificantReal;
     Real accuracyAchieved; int numNewtonIters;
-    bool converged = refineImplicitPair(shapeA, pointP_A, shapeB, pointQ_B,
-        X_AB, accuracyRequested, accuracyAchieved, numNewtonIters);
+    Vec3 pointP_A, pointQ_B; // on A and B, resp.
+    Rotation R_AP; Vec2 curvatureP;
+    bool haveRefinedPoints = false;
+
+    // 1a. If the surfaces were in contact at the previous step, as recorded
+    //     in priorStatus, refine the points found then directly. P and Q lie
+    //     on the contact normal, half the depth either side of the contact
+    //     frame origin. The refinement can't distinguish the right solution
+    //     from one with the normals pointing the same way, so we insist on
+    //     opposed normals and otherwise start over with MPR.
+    if (EllipticalPointContact::isInstance(priorStatus)) {
+        const EllipticalPointContact& prior =
+            EllipticalPointContact::getAs(priorStatus);
+        const Transform& X_AC = prior.getContactFrame();
+        const Vec3 halfDepth_A = (prior.getDepth()/2)*X_AC.z();
+        pointP_A = X_AC.p() + halfDepth_A;
+        pointQ_B = ~prior.getTransform()*(X_AC.p() - halfDepth_A);
+        if (refineImplicitPair(shapeA, pointP_A, shapeB, pointQ_B, X_AB, 
+                               accuracyRequested, accuracyAchieved, 
+                               numNewtonIters)) {
+            shapeA.calcCurvature(pointP_A, curvatureP, R_AP);
+            const UnitVec3 normQ_A = 
+                R_AB*shapeB.calcSurfaceUnitNormal(pointQ_B);
+            haveRefinedPoints = (~R_AP.z()*normQ_A < 0);
+        }
+    }
 
-    const Vec3 pointQ_A = X_AB*pointQ_B;  // Q on B, measured & expressed in A
+    if (!haveRefinedPoints) {
+        // 1b. Get a rough guess at the contact points P and Q and contact 
+        //     normal.
+        UnitVec3 norm_A;
+        int numMPRIters;
+        const bool mightBeContact = estimateConvexImplicitPairContactUsingMPR
+                                       (shapeA, shapeB, X_AB,
+                                        pointP_A, pointQ_B, norm_A, 
+                                        numMPRIters);
 
-    // 3. Compute the curvatures and surface normals of the two surfaces at 
-    //    P and Q. Once we have the first normal we can check whether there was
-    //    actually any contact and duck out early if not.
-    Rotation R_AP; Vec2 curvatureP;
-    shapeA.calcCurvature(pointP_A, curvatureP, R_AP);
+        #ifdef MPR_DEBUG
+        std::cout << "MPR: " << (mightBeContact?"MAYBE":"NO") << std::endl;
+        std::cout << "  P=" << X_GA*pointP_A << " Q=" << X_GB*pointQ_B 
+                  << std::endl;
+        std::cout << "  N=" << X_GA.R()*norm_A << std::endl;
+        #endif
 
-    // If the surfaces are in contact then the vector from Q on surface B
-    // (supposedly inside A) to P on surface A (supposedly inside B) should be 
-    // aligned with the outward normal on A.
+        if (!mightBeContact) {
+            if (!isNaN(norm_A[0])) { // MPR found a separating plane
+                cache.hasSeparatingDirection = true;
+                cache.separatingDirection = norm_A;
+            }
+            currentStatus.clear(); // definitely not touching
+            return true; // successful return
+        }
+
+        // 2. Refine the contact points to near machine precision.
+        bool converged = refineImplicitPair(shapeA, pointP_A, shapeB, pointQ_B,
+            X_AB, accuracyRequested, accuracyAchieved, numNewtonIters);
+
+        // 3. Compute the curvature and surface normal of surface A at P.
+        shapeA.calcCurvature(pointP_A, curvatureP, R_AP);
+    }
+
+    const Vec3 pointQ_A = X_AB*pointQ_B;  // Q on B, measured & expressed in A
+
+    // Once we have the first normal we can check whether there was actually
+    // any contact and duck out early if not. If the surfaces are in contact 
+    // then the vector from Q on surface B (supposedly inside A) to P on 
+    // surface A (supposedly inside B) should be aligned with the outward 
+    // normal on A.
     const Real depth = dot(pointP_A-pointQ_A, R_AP.z());
 
     #ifdef MPR_DEBUG
-    printf("MPR %2d iters, Newton %2d iters->accuracy=%g depth=%g\n",
-        numMPRIters, numNewtonIters, accuracyAchieved, depth);
+    printf("Newton %2d iters->accuracy=%g depth=%g\n",
+        numNewtonIters, accuracyAchieved, depth);
     #endif  
 
     if (depth <= 0) {
+        // P and Q are the closest points, so A's normal at P separates the
+        // surfaces unless the refinement went astray.
+        if (isSeparatingDirection(shapeA, shapeB, X_AB, R_AP.z())) {
+            cache.hasSeparatingDirection = true;
+            cache.separatingDirection = R_AP.z();
+        }
         currentStatus.clear(); // not touching
         return true; // successful return
     }
@@ -33,4 +33,8 @@ Real GCVSPLUtil::splder(int derivOrder, int degree, Real t, const Vector& x, con
     return splder(derivOrder, degree, t, x, reinterpret_cast<const Vector_<Vec1>&>(coeff))[0];
 }
 
+Real GCVSPLUtil::splder(int derivOrder, int degree, Real t, const Vector& x, const Vector& coeff, int& interval) {
+    return splder(derivOrder, degree, t, x, reinterpret_cast<const Vector_<Vec1>&>(coeff), interval)[0];
+}
+
 } // namespace SimTK
@@ -320,6 +320,19 @@ public:
     /// when projecting the state (either a Q- or U-projection) since
     /// the last call to resetAllStatistics().
     int getNumProjectionFailures() const;
+    /// Get the number of steps in which an event trigger was seen and the 
+    /// time of the event had to be localized, since the last call to 
+    /// resetAllStatistics().
+    int getNumEventLocalizations() const;
+    /// Get the number of trial states at which the event triggers were 
+    /// evaluated while localizing events, since the last call to 
+    /// resetAllStatistics(). Each trial state is interpolated from the step's
+    /// end points and realized only through the highest stage at which any
+    /// remaining candidate's trigger is evaluated; those realizations are
+    /// also counted in getNumRealizations(). Integrators that leave event
+    /// localization to the underlying method, such as CPodesIntegrator, 
+    /// report zero here and in getNumEventLocalizations().
+    int getNumEventLocalizationIterations() const;
     /// For iterative methods, get the number of internal step iterations in steps that led to 
     /// convergence (not necessarily successful steps). Reset to zero by resetAllStatistics().
     int getNumConvergentIterations() const;
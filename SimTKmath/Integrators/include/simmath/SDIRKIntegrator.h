@@ -0,0 +1,88 @@
+#ifndef SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
+#define SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+#include "simmath/internal/common.h"
+#include "simmath/Integrator.h"
+
+namespace SimTK {
+
+class SDIRKIntegratorRep;
+
+/**
+ * This is an error controlled, third order, L-stable implicit Integrator 
+ * for stiff systems, using a singly diagonally implicit Runge-Kutta (SDIRK)
+ * method. It is a lighter weight alternative to CPodesIntegrator that makes
+ * use of the System's own Jacobian when one is available.
+ *
+ * Each step solves three nonlinear systems, one per stage, by simplified 
+ * Newton iteration with the iteration matrix I-h*gamma*J, where J is the 
+ * Jacobian d ydot/d y of the state derivatives and gamma is the method's 
+ * diagonal coefficient. J comes from System::calcYDotJacobian() if the 
+ * System supports that, and otherwise from numerical differentiation, 
+ * which costs one realization per state variable. If a fresh Jacobian from
+ * the System fails to give convergence, the step is retried once with a 
+ * numerical Jacobian before the step size is reduced; the System is asked
+ * again for the Jacobian after that.
+ *
+ * The Jacobian and the factored iteration matrix are kept from step to step.
+ * The Jacobian is evaluated again only when the Newton iteration fails or 
+ * converges slowly, and the iteration matrix is refactored only when the 
+ * Jacobian changes or the step size has changed by more than 20%. 
+ *
+ * The method is stiffly accurate so the result of a step is its last stage;
+ * the error estimate comes from an embedded second order method and is
+ * filtered through the iteration matrix so that it stays meaningful for
+ * very stiff components. Position and velocity constraints are handled by 
+ * projection after each step, just as for the explicit integrators.
+ */
+class SimTK_SIMMATH_EXPORT SDIRKIntegrator : public Integrator {
+public:
+    explicit SDIRKIntegrator(const System& sys);
+
+    /** Say whether to ask the System for its Jacobian with 
+    System::calcYDotJacobian(). If this is false, or the System can't supply
+    one, the Jacobian is calculated by numerical differentiation. The 
+    default is true. **/
+    void setUseSystemJacobian(bool useSystemJacobian);
+    /** Return whether the System will be asked for its Jacobian. **/
+    bool getUseSystemJacobian() const;
+
+    /** Get the total number of times the Jacobian was evaluated since the
+    last call to resetAllStatistics(). **/
+    int getNumJacobianEvaluations() const;
+    /** Get the number of those Jacobian evaluations that were done by 
+    numerical differentiation. Their realizations are included in 
+    getNumRealizations(). **/
+    int getNumNumericalJacobianEvaluations() const;
+    /** Get the number of times the iteration matrix was factored since the
+    last call to resetAllStatistics(). **/
+    int getNumIterationMatrixFactorizations() const;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_SDIRK_INTEGRATOR_H_
@@ -32,6 +32,32 @@ AbstractIntegratorRep::AbstractIntegratorRep
 :   IntegratorRep(handle, sys), minOrder(minOrder), maxOrder(maxOrder), 
     methodName(methodName), hasErrorControl(hasErrorControl) {}
 
+// Return the highest stage at which any of the given event triggers is
+// calculated. Once a State has been realized through that stage, all of their
+// values are available.
+static Stage findHighestTriggerStage
+   (const State& s, const Array_<SystemEventTriggerIndex>& triggers) {
+    for (Stage g = Stage::HighestRuntime; g > Stage::LowestRuntime; --g) {
+        const int start = s.getEventTriggerStartByStage(g);
+        const int end   = start + s.getNEventTriggersByStage(g);
+        for (SystemEventTriggerIndex e : triggers)
+            if (start <= e && e < end)
+                return g;
+    }
+    return Stage::LowestRuntime;
+}
+
+// Gather the event trigger values for stages up through g from a State 
+// realized only that far; getEventTriggers() would require Acceleration stage.
+// Triggers belonging to later stages are left as they were in e.
+static void getEventTriggersThroughStage(const State& s, Stage g, Vector& e) {
+    for (Stage gs = Stage::LowestRuntime; gs <= g; ++gs) {
+        const int n = s.getNEventTriggersByStage(gs);
+        if (n) e(s.getEventTriggerStartByStage(gs), n) 
+                    = s.getEventTriggersByStage(gs);
+    }
+}
+
 
 
 //==============================================================================
@@ -634,6 +660,8 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
         return false;
     }
 
+    ++statsEventLocalizations;
+
     Real tLow = t0;
     Real tHigh = t1;
 
@@ -654,7 +682,7 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
     // From above we have earliestTimeEst which is the time at which we
     // think the first event is triggering.
 
-    Vector eLow = e0, eHigh = e1;
+    Vector eLow = e0, eHigh = e1, eMid;
     Real bias = 1; // neutral
 
     // There is an event in (tLow,tHigh], with the eariest occurrence
@@ -678,13 +706,23 @@ bool AbstractIntegratorRep::takeOneStep(Real tMax, Real tReport)
                           ? tReport : earliestTimeEst;
 
         createInterpolatedState(tMid);
+        ++statsEventLocalizationIterations;
 
+        // All the remaining candidates are evaluated together at tMid, and 
+        // only their trigger values are looked at, so we realize no further 
+        // than the highest stage they need. Position-level witnesses like 
+        // contact onset don't need accelerations.
         // Failure to evaluate at the interpolated state is a disaster of some
         // kind, not something we expect to be able to recover from, so this 
         // will throw an exception if it fails.
-        realizeStateDerivatives(getInterpolatedState());
-
-        const Vector& eMid = getInterpolatedState().getEventTriggers();
+        const Stage gMid = 
+            findHighestTriggerStage(getInterpolatedState(), eventCandidates);
+        realizeEventTriggers(getInterpolatedState(), gMid);
+
+        // Only the candidates' values are looked at; the others keep the
+        // values they had at tLow.
+        eMid = eLow;
+        getEventTriggersThroughStage(getInterpolatedState(), gMid, eMid);
 
         // TODO: should search in the wider interval first
 
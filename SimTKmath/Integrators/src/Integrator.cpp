@@ -223,6 +223,12 @@ int Integrator::getNumProjectionFailures() const {
     return getRep().getNumQProjectionFailures()
          + getRep().getNumUProjectionFailures();
 }
+int Integrator::getNumEventLocalizations() const {
+    return getRep().getNumEventLocalizations();
+}
+int Integrator::getNumEventLocalizationIterations() const {
+    return getRep().getNumEventLocalizationIterations();
+}
 int Integrator::getNumConvergentIterations() const {
     return getRep().getNumConvergentIterations();
 }
@@ -760,6 +760,18 @@ protected:
         }
     }
 
+    // Realize the supplied state only as far as the given stage, which is
+    // enough to evaluate the event triggers that belong to that stage or 
+    // earlier ones. Statistics are bumped as for realizeStateDerivatives();
+    // nothing happens if the state has already been realized that far.
+    void realizeEventTriggers(const State& s, Stage g) const {
+        if (s.getSystemStage() < g) {
+            ++statsRealizations; ++statsRealizationFailures;
+            getSystem().realize(s, g);
+            --statsRealizationFailures;
+        }
+    }
+
     // State should have had its q's prescribed and realized through Position
     // stage. This will attempt to project q's and the q part of the yErrEst
     // (if yErrEst is not length zero). Returns false if we fail which you
@@ -939,6 +951,7 @@ protected:
         statsQProjections = statsUProjections = 0;
         statsRealizationFailures = 0;
         statsQProjectionFailures = statsUProjectionFailures = 0;
+        statsEventLocalizations = statsEventLocalizationIterations = 0;
     }
 
     int getNumRealizations() const {return statsRealizations;} 
@@ -949,6 +962,10 @@ protected:
     int getNumQProjectionFailures() const {return statsQProjectionFailures;} 
     int getNumUProjectionFailures() const {return statsUProjectionFailures;} 
 
+    int getNumEventLocalizations() const {return statsEventLocalizations;}
+    int getNumEventLocalizationIterations() const 
+    {   return statsEventLocalizationIterations; }
+
 private:
     class EventSorter {
     public:
@@ -1004,6 +1021,8 @@ protected:
     mutable int statsQProjections, statsUProjections;
     mutable int statsRealizations;
     mutable int statsRealizationFailures;
+    // Integrators that localize events themselves count these.
+    int statsEventLocalizations, statsEventLocalizationIterations;
 private:
 
         // SYSTEM INFORMATION
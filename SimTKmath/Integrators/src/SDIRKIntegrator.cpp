@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/** @file
+ * This is the private (library side) implementation of the 
+ * SDIRKIntegrator and SDIRKIntegratorRep classes.
+ */
+
+#include "SimTKcommon.h"
+#include "simmath/Integrator.h"
+#include "simmath/SDIRKIntegrator.h"
+
+#include "IntegratorRep.h"
+#include "SDIRKIntegratorRep.h"
+
+#include <cmath>
+
+using namespace SimTK;
+
+//------------------------------------------------------------------------------
+//                            SDIRK INTEGRATOR
+//------------------------------------------------------------------------------
+
+SDIRKIntegrator::SDIRKIntegrator(const System& sys) 
+{
+    rep = new SDIRKIntegratorRep(this, sys);
+}
+
+void SDIRKIntegrator::setUseSystemJacobian(bool useSystemJacobian) {
+    dynamic_cast<SDIRKIntegratorRep&>(*rep)
+        .setUseSystemJacobian(useSystemJacobian);
+}
+
+bool SDIRKIntegrator::getUseSystemJacobian() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getUseSystemJacobian();
+}
+
+int SDIRKIntegrator::getNumJacobianEvaluations() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getNumJacobianEvaluations();
+}
+
+int SDIRKIntegrator::getNumNumericalJacobianEvaluations() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getNumNumericalJacobianEvaluations();
+}
+
+int SDIRKIntegrator::getNumIterationMatrixFactorizations() const {
+    return dynamic_cast<const SDIRKIntegratorRep&>(*rep)
+                .getNumIterationMatrixFactorizations();
+}
+
+
+//------------------------------------------------------------------------------
+//                          SDIRK INTEGRATOR REP
+//------------------------------------------------------------------------------
+
+// This is Alexander's three stage, third order, L-stable and stiffly accurate
+// SDIRK method (R. Alexander, SIAM J. Numer. Anal. 14(6):1006-1021, 1977).
+// gamma is the root of x^3 - 3x^2 + 3x/2 - 1/6 near 0.4359. The embedded 
+// second order method uses the first two stages only, with weights chosen to 
+// satisfy sum(bhat)=1 and sum(bhat*c)=1/2.
+namespace {
+const Real Gamma = Real(0.43586652150845899941601945);
+const Real C2    = (1+Gamma)/2;
+const Real A21   = (1-Gamma)/2;
+const Real B1    = -(6*Gamma*Gamma - 16*Gamma + 1)/4;
+const Real B2    =  (6*Gamma*Gamma - 20*Gamma + 5)/4;
+const Real BHat2 = (1-2*Gamma)/(1-Gamma);
+const Real BHat1 = 1-BHat2;
+
+// Newton iteration parameters. The iteration has converged when the 
+// predicted remaining change is below Kappa times the accuracy. If the 
+// convergence rate is worse than SlowConvergence we'll ask for a new 
+// Jacobian at the next step. The iteration matrix is refactored if h 
+// changed by more than MaxRelHChange since it was last factored.
+const int  MaxIterations   = 7;
+const Real Kappa           = Real(0.1);
+const Real SlowConvergence = Real(0.5);
+const Real MaxRelHChange   = Real(0.2);
+}
+
+SDIRKIntegratorRep::SDIRKIntegratorRep(Integrator* handle, const System& sys) 
+:   AbstractIntegratorRep(handle, sys, 2, 3, "SDIRK", true),
+    useSystemJacobian(true), statsJacobians(0), statsNumericalJacobians(0),
+    statsFactorizations(0), haveJacobian(false), tJacobian(NaN),
+    jacobianFromSystem(false), systemJacobianUnsupported(false), 
+    retryNumerically(false), recalcJacobian(false), hgFactored(NaN), eta(1) {
+}
+
+void SDIRKIntegratorRep::methodInitialize(const State& state) {
+    AbstractIntegratorRep::methodInitialize(state);
+    // The state may have changed discontinuously so start over.
+    haveJacobian = jacobianFromSystem = systemJacobianUnsupported = false;
+    retryNumerically = recalcJacobian = false;
+    tJacobian = hgFactored = NaN;
+    eta = 1;
+}
+
+void SDIRKIntegratorRep::resetMethodStatistics() {
+    AbstractIntegratorRep::resetMethodStatistics();
+    statsJacobians = statsNumericalJacobians = statsFactorizations = 0;
+}
+
+// Evaluate J at the start of the step. Ask the System first unless this is
+// a retry after its Jacobian failed; if it can't supply J we difference ydot,
+// one realization per state variable.
+void SDIRKIntegratorRep::calcJacobian() {
+    const Real    t0 = getPreviousTime();
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const int ny = y0.size();
+
+    ++statsJacobians;
+    haveJacobian = true; recalcJacobian = false;
+    tJacobian = t0; hgFactored = NaN;
+
+    const bool numericalOnly = retryNumerically;
+    retryNumerically = false;
+    if (useSystemJacobian && !systemJacobianUnsupported && !numericalOnly) {
+        setAdvancedStateAndRealizeDerivatives(t0, y0);
+        if (getSystem().calcYDotJacobian(getAdvancedState(), J)) {
+            jacobianFromSystem = true;
+            return;
+        }
+        systemJacobianUnsupported = true; // don't ask again
+    }
+
+    jacobianFromSystem = false;
+    ++statsNumericalJacobians;
+    J.resize(ny, ny);
+    Y = y0;
+    for (int j=0; j < ny; ++j) {
+        Y[j] = y0[j] + SqrtEps*std::max(Real(1), std::abs(y0[j]));
+        const Real dy = Y[j] - y0[j]; // exactly representable
+        setAdvancedStateAndRealizeDerivatives(t0, Y);
+        J(j) = (getAdvancedState().getYDot() - f0) / dy;
+        Y[j] = y0[j];
+    }
+}
+
+bool SDIRKIntegratorRep::factorIterationMatrix(Real hg) {
+    Matrix A = -hg*J;
+    for (int i=0; i < A.nrow(); ++i)
+        A(i,i) += 1;
+    iterationMatrix.factor(A);
+    ++statsFactorizations;
+    hgFactored = hg;
+    return !iterationMatrix.isSingular();
+}
+
+// Simplified Newton iteration for one stage, with the convergence test of
+// Hairer & Wanner, Solving ODEs II, section IV.8. The change in Y is measured
+// with the same weighted norm as the error estimate.
+bool SDIRKIntegratorRep::solveStage(Real tStage, Real hg, const Vector& ystage,
+                                    Vector& Y, Vector& f, int& numIterations) 
+{
+    const Real tol = Kappa*getAccuracyInUse();
+    eta = std::pow(std::max(eta, Eps), Real(0.8));
+    Real dnormPrev = NaN;
+    for (int k=0; k < MaxIterations; ++k) {
+        setAdvancedStateAndRealizeDerivatives(tStage, Y);
+        ++numIterations;
+        G = ystage + hg*getAdvancedState().getYDot() - Y;
+        iterationMatrix.solve(G, dY);
+
+        int worstY;
+        const Real dnorm = calcErrorNorm(getAdvancedState(), dY, worstY);
+        if (!isFinite(dnorm))
+            return false;
+        Y += dY;
+
+        if (k > 0) {
+            const Real theta = dnorm/dnormPrev;
+            if (theta >= 1)
+                return false; // diverging
+            if (theta > SlowConvergence)
+                recalcJacobian = true;
+            // Give up now if this rate won't get there in time.
+            if (   std::pow(theta, MaxIterations-1-k)/(1-theta) * dnorm 
+                 > tol)
+                return false;
+            eta = theta/(1-theta);
+        }
+
+        if (eta*dnorm <= tol) {
+            f = (Y - ystage) / hg; // satisfies the stage equation exactly
+            return true;
+        }
+        dnormPrev = dnorm;
+    }
+    return false;
+}
+
+bool SDIRKIntegratorRep::takeStages
+   (Real t0, Real h, Vector& y1err, int& numIterations) 
+{
+    const Vector& y0 = getPreviousY();
+    const Vector& f0 = getPreviousYDot();
+    const Real hg = h*Gamma;
+
+    ystage = y0;
+    Y = y0 + hg*f0;
+    if (!solveStage(t0 + Gamma*h, hg, ystage, Y, f[0], numIterations))
+        return false;
+
+    ystage = y0 + (A21*h)*f[0];
+    Y = ystage + hg*f[0];
+    if (!solveStage(t0 + C2*h, hg, ystage, Y, f[1], numIterations))
+        return false;
+
+    ystage = y0 + h*(B1*f[0] + B2*f[1]);
+    Y = ystage + hg*f[1];
+    if (!solveStage(t0 + h, hg, ystage, Y, f[2], numIterations))
+        return false;
+
+    // Y is now the result. Filter the raw error estimate through the 
+    // iteration matrix to damp its stiff components.
+    err = h*((B1-BHat1)*f[0] + (B2-BHat2)*f[1] + Gamma*f[2]);
+    iterationMatrix.solve(err, y1err);
+    return true;
+}
+
+bool SDIRKIntegratorRep::attemptODEStep
+   (Real t1, Vector& y1err, int& errOrder, int& numIterations)
+{
+    const Real t0 = getPreviousTime();
+    assert(t1 > t0);
+
+    statsStepsAttempted++;
+    errOrder = 3;
+    numIterations = 0;
+    const Real h = t1-t0, hg = h*Gamma;
+
+    if (getPreviousY().size() == 0) {
+        setAdvancedStateAndRealizeKinematics(t1, getPreviousY());
+        return true;
+    }
+
+    // Reuse the Jacobian and iteration matrix if we can. If the iteration 
+    // fails with an old Jacobian, try again with a new one; if it fails with
+    // a new one from the System, try again with a numerical one, for this
+    // step only since h may just have been too big. Otherwise report failure
+    // so the step size will be reduced.
+    while (true) {
+        if (!haveJacobian || recalcJacobian)
+            calcJacobian();
+        bool ok = true;
+        if (isNaN(hgFactored) 
+            || std::abs(hg-hgFactored) > MaxRelHChange*hgFactored)
+            ok = factorIterationMatrix(hg);
+
+        if (ok && takeStages(t0, h, y1err, numIterations))
+            break;
+
+        if (tJacobian != t0) 
+            recalcJacobian = true;
+        else if (jacobianFromSystem)
+            recalcJacobian = retryNumerically = true;
+        else
+            return false;
+    }
+
+    setAdvancedStateAndRealizeKinematics(t1, Y);
+    return true;
+}
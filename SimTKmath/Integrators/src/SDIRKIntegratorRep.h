@@ -0,0 +1,92 @@
+#ifndef SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
+#define SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
+
+/* -------------------------------------------------------------------------- *
+ *                        Simbody(tm): SimTKmath                              *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "simmath/LinearAlgebra.h"
+#include "AbstractIntegratorRep.h"
+
+namespace SimTK {
+
+/**
+ * This is the private (library side) implementation of the 
+ * SDIRKIntegrator class which is a concrete class
+ * implementing the abstract IntegratorRep.
+ */
+
+class SDIRKIntegratorRep : public AbstractIntegratorRep {
+public:
+    SDIRKIntegratorRep(Integrator* handle, const System& sys);
+
+    void setUseSystemJacobian(bool use) {useSystemJacobian = use;}
+    bool getUseSystemJacobian() const {return useSystemJacobian;}
+
+    int getNumJacobianEvaluations() const {return statsJacobians;}
+    int getNumNumericalJacobianEvaluations() const 
+    {   return statsNumericalJacobians; }
+    int getNumIterationMatrixFactorizations() const 
+    {   return statsFactorizations; }
+
+    void methodInitialize(const State&) override;
+    void resetMethodStatistics() override;
+protected:
+    bool attemptODEStep
+       (Real t1, Vector& yErrEst, int& errOrder, int& numIterations) override;
+private:
+    static const int NStages = 3;
+
+    // Evaluate J at the start of the step, from the System if we can.
+    void calcJacobian();
+    // Factor I - hg*J, where hg is h*gamma. Returns false if singular.
+    bool factorIterationMatrix(Real hg);
+    // Take the three stages, returning false if any of them didn't converge.
+    bool takeStages(Real t0, Real h, Vector& y1err, int& numIterations);
+    // Solve the stage equation Y = ystage + hg*f(tStage, Y) for Y, starting
+    // from the guess in Y, and return f(tStage, Y) in f. Returns false if 
+    // the Newton iteration failed to converge.
+    bool solveStage(Real tStage, Real hg, const Vector& ystage, 
+                    Vector& Y, Vector& f, int& numIterations);
+
+    bool        useSystemJacobian;
+    int         statsJacobians, statsNumericalJacobians, statsFactorizations;
+
+    // The Jacobian and the factored iteration matrix, kept across steps.
+    Matrix      J;
+    FactorLU    iterationMatrix;
+    bool        haveJacobian;       // J is usable
+    Real        tJacobian;          // the step start time at which J was found
+    bool        jacobianFromSystem; // J came from System::calcYDotJacobian()
+    bool        systemJacobianUnsupported; // don't ask the System again
+    bool        retryNumerically;   // next J is numerical whatever the System
+    bool        recalcJacobian;     // convergence was slow; get a new J 
+    Real        hgFactored;         // h*gamma in the factored matrix or NaN
+    Real        eta;                // Newton convergence rate memory
+
+    // Scratch.
+    Vector      f[NStages], ystage, Y, G, dY, err;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMMATH_SDIRK_INTEGRATOR_REP_H_
@@ -180,6 +180,17 @@ FactorQTZRepBase* FactorQTZRep<T>::clone() const {
 template <typename T >
 FactorQTZRep<T>::~FactorQTZRep() {}
 
+// Per-thread workspace for the solves, grown as needed but never shrunk, so 
+// that repeated solves with a factorization don't touch the heap while solve()
+// remains safe to call concurrently on the same object.
+template <class T> struct FactorQTZSolveWorkspace {
+    Array_<T> rhs, x, work, pivoted;
+};
+template <class T> static FactorQTZSolveWorkspace<T>& getSolveWorkspace() {
+    static thread_local FactorQTZSolveWorkspace<T> ws;
+    return ws;
+}
+
 template < class T >
 void FactorQTZRep<T>::solve( const Vector_<T>& b, Vector_<T> &x ) const {
 
@@ -190,15 +201,19 @@ void FactorQTZRep<T>::solve( const Vector_<T>& b, Vector_<T> &x ) const {
        "number of rows in right hand side=%d does not match number of rows in original matrix=%d \n", 
         b.size(), nRow );
 
-
-    Matrix_<T> m(maxmn,1);
-
+    FactorQTZSolveWorkspace<T>& ws = getSolveWorkspace<T>();
+    ws.rhs.resize(maxmn);
     for(int i=0;i<b.size();i++) {
-        m(i,0) = b(i);
+        ws.rhs[i] = b(i);
+    }
+    ws.x.resize(nCol);
+    ws.x.fill(T(0)); // in case the rank is zero
+    doSolve( ws.rhs.data(), maxmn, 1, ws.x.data(), nCol );
+
+    x.resize(nCol);
+    for(int i=0;i<nCol;i++) {
+        x(i) = ws.x[i];
     }
-    Matrix_<T> r(nCol, 1 );
-    doSolve( m, r );
-    x.copyAssign(r);
 }
 
 template <typename T >
@@ -214,15 +229,17 @@ void FactorQTZRep<T>::solve(  const Matrix_<T>& b, Matrix_<T>& x ) const {
     Matrix_<T> tb;
     tb.resize(maxmn, b.ncol() );
     for(int j=0;j<b.ncol();j++) for(int i=0;i<b.nrow();i++) tb(i,j) = b(i,j);
-    doSolve(tb, x);
+    doSolve(&tb(0,0), tb.nrow(), tb.ncol(), &x(0,0), nCol);
 }
 
+// The right hand sides b are overwritten; b has leading dimension ldb and
+// must have at least max(nRow,nCol) rows. Columns of the solution go into x,
+// whose leading dimension is ldx.
 template <typename T >
-void FactorQTZRep<T>::doSolve(Matrix_<T>& b, Matrix_<T>& x) const {
+void FactorQTZRep<T>::doSolve(T* b, int ldb, int nrhs, T* x, int ldx) const {
     int info;
     typedef typename CNT<T>::TReal RealType;
     RealType bnrm, smlnum, bignum;
-    int nrhs = b.ncol();
     int n = nCol;
     int m = nRow;
     typename CNT<T>::TReal rhsScaleF; // scale factor applied to right hand side
@@ -233,19 +250,21 @@ void FactorQTZRep<T>::doSolve(Matrix_<T>& b, Matrix_<T>& x) const {
     // Ask the experts for their optimal workspace sizes. The size parameters
     // here must match the calls below.
     T workSz;
-    LapackInterface::ormqr<T>('L', 'T', nRow, b.ncol(), mn, 0, nRow, 
-                               0, 0, b.nrow(), &workSz, -1, info );
+    LapackInterface::ormqr<T>('L', 'T', nRow, nrhs, mn, 0, nRow, 
+                               0, 0, ldb, &workSz, -1, info );
     const int lwork1 = (int)NTraits<T>::real(workSz);
 
-    LapackInterface::ormrz<T>('L', 'T', nCol, b.ncol(), rank, nCol-rank, 
+    LapackInterface::ormrz<T>('L', 'T', nCol, nrhs, rank, nCol-rank, 
                               0, nRow, 0, 0, 
-                              b.nrow(), &workSz, -1, info );
+                              ldb, &workSz, -1, info );
     const int lwork2 = (int)NTraits<T>::real(workSz);
     
-    TypedWorkSpace<T> work(std::max(lwork1, lwork2));
+    FactorQTZSolveWorkspace<T>& ws = getSolveWorkspace<T>();
+    ws.work.resize(std::max(lwork1, lwork2));
+    const int lwork = (int)ws.work.size();
 
     // compute norm of RHS
-    bnrm = (RealType)LapackInterface::lange<T>('M', m, nrhs, &b(0,0), b.nrow());
+    bnrm = (RealType)LapackInterface::lange<T>('M', m, nrhs, b, ldb);
 
     LapackInterface::getMachinePrecision<RealType>(smlnum, bignum);
  
@@ -260,49 +279,50 @@ void FactorQTZRep<T>::doSolve(Matrix_<T>& b, Matrix_<T>& x) const {
 
 
     if (scaleRHS) {   // apply scale factor to RHS
-        LapackInterface::lascl<T>('G', 0, 0, bnrm, rhsScaleF, b.nrow(), nrhs, 
-                                  &b(0,0), b.nrow(), info ); 
+        LapackInterface::lascl<T>('G', 0, 0, bnrm, rhsScaleF, ldb, nrhs, 
+                                  b, ldb, info ); 
     }
     // b1 = Q'*b0
-    LapackInterface::ormqr<T>('L', 'T', nRow, b.ncol(), mn, qtz.data, 
-                              nRow, tauGEQP3.data, &b(0,0), b.nrow(), 
-                              work.data, work.size, info );
+    LapackInterface::ormqr<T>('L', 'T', nRow, nrhs, mn, qtz.data, 
+                              nRow, tauGEQP3.data, b, ldb, 
+                              ws.work.data(), lwork, info );
     // b2 = T^-1*b1 = T^-1 * Q' * b0
-    LapackInterface::trsm<T>('L', 'U', 'N', 'N', rank, b.ncol(), 1.0, 
-                             qtz.data, nRow, &b(0,0), b.nrow() );
+    LapackInterface::trsm<T>('L', 'U', 'N', 'N', rank, nrhs, 1.0, 
+                             qtz.data, nRow, b, ldb );
 
     //  zero out elements of RHS for rank deficient systems
     for(int j = 0; j<nrhs; ++j) {
         for(int i = rank; i<n; ++i)
-            b(i,j) = 0;
+            b[i + j*ldb] = 0;
     }
    
     if (rank < nCol) {
         // b3 = Z'*b2 = Z'*T^-1*Q'*b0
-        LapackInterface::ormrz<T>('L', 'T', nCol, b.ncol(), rank, nCol-rank, 
-                                  qtz.data, nRow, tauORMQR.data, &b(0,0), 
-                                  b.nrow(), work.data, work.size, info );
+        LapackInterface::ormrz<T>('L', 'T', nCol, nrhs, rank, nCol-rank, 
+                                  qtz.data, nRow, tauORMQR.data, b, 
+                                  ldb, ws.work.data(), lwork, info );
     }
 
     // adjust for pivoting
-    Array_<T> b_pivot(n);
+    Array_<T>& b_pivot = ws.pivoted;
+    b_pivot.resize(n);
     for(int j = 0; j<nrhs; ++j) {
         for(int i = 0; i<n; ++i)
-            b_pivot[pivots.data[i]-1] = b(i,j);
+            b_pivot[pivots.data[i]-1] = b[i + j*ldb];
 
-        LapackInterface::copy<T>(n, b_pivot.begin(), 1, &x(0,j), 1 );
+        LapackInterface::copy<T>(n, b_pivot.begin(), 1, x + j*ldx, 1 );
     }
 
     // compensate for scaling of linear system 
     if (scaleLinSys) { 
-        LapackInterface::lascl<T>('g', 0, 0, anrm, linSysScaleF, nCol, x.ncol(),
-                                  &x(0,0), nCol, info );
+        LapackInterface::lascl<T>('g', 0, 0, anrm, linSysScaleF, nCol, nrhs,
+                                  x, ldx, info );
     }
 
     // compensate for scaling of RHS 
     if (scaleRHS) { 
-        LapackInterface::lascl<T>('g', 0, 0, bnrm, rhsScaleF, nCol, x.ncol(), 
-                                  &x(0,0), nCol, info);
+        LapackInterface::lascl<T>('g', 0, 0, bnrm, rhsScaleF, nCol, nrhs, 
+                                  x, ldx, info);
     }
 }
 
@@ -312,7 +332,7 @@ void FactorQTZRep<T>::inverse(  Matrix_<T>& inverse ) const {
     Matrix_<T> iden(mn,mn);
     inverse.resize(mn,mn);
     iden = 1.0;
-    doSolve( iden, inverse );
+    doSolve( &iden(0,0), iden.nrow(), iden.ncol(), &inverse(0,0), mn );
 
     return;
 }
@@ -130,7 +130,7 @@ public:
    FactorQTZRepBase* clone() const override;
  
 private:
-   void doSolve( Matrix_<T>& b, Matrix_<T>& x ) const;
+   void doSolve( T* b, int ldb, int nrhs, T* x, int ldx ) const;
 
    int                      mn;           // min of number of rows or columns
    int                      maxmn;        // max of number of rows or columns
@@ -55,6 +55,7 @@
 #include "simmath/TimeStepper.h"
 #include "simmath/CPodesIntegrator.h"
 #include "simmath/RungeKuttaMersonIntegrator.h"
+#include "simmath/SDIRKIntegrator.h"
 #include "simmath/RungeKuttaFeldbergIntegrator.h"
 #include "simmath/RungeKutta3Integrator.h"
 #include "simmath/RungeKutta2Integrator.h"
@@ -72,7 +72,25 @@ namespace SimTK {
  *
  * Then the derivative, gradient element, or Jacobian column is computed 
  * as df/dy=[f(x+h)-f(x)]/h (1st order) or df/dy=[f(x+h)-f(x-h)]/(2h) 
- * (2nd order).
+ * (2nd order). The RichardsonExtrapolation method combines central 
+ * differences with steps h and h/2 as [4*D(h/2)-D(h)]/3, which cancels the 
+ * h^2 error term, giving a 4th order estimate from four function evaluations;
+ * for that h0=eps^(1/5).
+ *
+ * @par Reducing the cost
+ *
+ * Each gradient element or Jacobian column requires its own perturbed 
+ * function evaluations; there are two ways to make that cheaper:
+ *  - If you provide additional copies ("clones") of the function with 
+ *    setFunctionClones(), the perturbations are evaluated concurrently, one 
+ *    thread per function object. Each thread only ever calls its own function
+ *    object so the user function need not be thread safe. The results are 
+ *    identical to those computed without clones.
+ *  - If you provide the sparsity pattern of a Jacobian with 
+ *    setJacobianSparsity(), columns that have no nonzero rows in common are 
+ *    grouped (Curtis, Powell and Reid, 1974) and perturbed together, so 
+ *    that a Jacobian needs only as many perturbations as there are groups. 
+ *    Entries outside the pattern are returned as zero.
  */
 class SimTK_SIMMATH_EXPORT Differentiator {
 public:
@@ -92,7 +110,8 @@ public:
     enum Method {
         UnspecifiedMethod=0,
         ForwardDifference=1,
-        CentralDifference=2
+        CentralDifference=2,
+        RichardsonExtrapolation=3
     };
     static bool        isValidMethod(Method);
     static const char* getMethodName(Method);
@@ -123,6 +142,34 @@ public:
     Vector calcGradient  (const Vector& y0, Method=UnspecifiedMethod) const;
     Matrix calcJacobian  (const Vector& y0, Method=UnspecifiedMethod) const;
 
+    /** Supply additional function objects, each equivalent to the one this 
+    Differentiator was constructed with (same kind and dimensions), so that 
+    perturbations can be evaluated on 1+clones.size() threads. Each function 
+    object is used by only one thread at a time. The clones are referenced,
+    not copied, and must persist while this Differentiator uses them; pass
+    an empty array to go back to using a single thread. Statistics for calls
+    made through a clone are kept in that clone's own function object. **/
+    Differentiator& setFunctionClones(const Array_<const Function*>& clones);
+    /** Return the number of threads used to evaluate perturbations; that is
+    one more than the number of function clones. **/
+    int getNumThreads() const;
+
+    /** Specify which rows of each Jacobian column may be nonzero; 
+    nonzeroRows[j] lists the rows (function indices) of column j 
+    (parameter j). This must have one entry for each parameter. Columns are
+    then grouped so that no two columns in a group share a row, and each 
+    group is evaluated with a single set of perturbations. This affects only 
+    calcJacobian(). **/
+    Differentiator& setJacobianSparsity
+       (const Array_< Array_<int> >& nonzeroRows);
+    /** Forget any Jacobian sparsity pattern; every column is then evaluated
+    separately. **/
+    Differentiator& clearJacobianSparsity();
+    /** Return the number of separately-perturbed column groups used for a
+    Jacobian; this is the number of parameters unless a sparsity pattern has 
+    been supplied. **/
+    int getNumJacobianColumnGroups() const;
+
     // Statistics (mutable)
     void resetAllStatistics();                 // reset all stats to zero
     int getNumDifferentiations() const;        // total # calls of calcWhatever
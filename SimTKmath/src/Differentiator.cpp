@@ -30,6 +30,7 @@
 #include "simmath/Differentiator.h"
 
 #include <exception>
+#include <memory>
 
 namespace SimTK {
 
@@ -102,6 +103,32 @@ static Differentiator::Method getMethodOrThrow
     return (m==Differentiator::UnspecifiedMethod ? def : m);
 }
 
+// A finite difference method estimates the derivative along a perturbation
+// h as [weight0*f(y0) + sum_k weight[k]*f(y0+offset[k]*h)]/h. Perturbations 
+// are evaluated in the order given.
+struct Stencil {
+    int  n;
+    Real offset[4];
+    Real weight[4];
+    Real weight0;
+};
+
+static const Stencil& getStencil(Differentiator::Method m) {
+    static const Stencil forward = {1, {1}, {1}, -1};
+    static const Stencil central = {2, {1,-1}, {Real(0.5),Real(-0.5)}, 0};
+    // [4*D(h/2)-D(h)]/3 where D(h) = [f(y0+h)-f(y0-h)]/(2h).
+    static const Stencil richardson = 
+        {4, {1,-1,Real(0.5),Real(-0.5)}, 
+            {Real(-1)/6,Real(1)/6,Real(8)/6,Real(-8)/6}, 0};
+    switch(m) {
+    case Differentiator::ForwardDifference: return forward;
+    case Differentiator::CentralDifference: return central;
+    case Differentiator::RichardsonExtrapolation: return richardson;
+    default: assert(!"Unrecognized Differentiator method");
+    }
+    return forward;
+}
+
     ///////////////////////////////////////////////////////////
     // REP CLASS DECLARATIONS FOR DIFFERENTIATOR & FUNCTIONS //
     ///////////////////////////////////////////////////////////
@@ -136,6 +163,7 @@ public:
     const Real& getAccFac(int order) const {
         if (order==1) return AccFac1;
         if (order==2) return AccFac2;
+        if (order==4) return AccFac4;
         assert(!"Unrecognized Differentiator order");
         return NaN;
     }
@@ -144,6 +172,14 @@ public:
         nDifferentiations = nDifferentiationFailures = nCallsToUserFunction = 0;
     }
 
+    void setFunctionClones
+       (const Array_<const Differentiator::Function::FunctionRep*>& clones);
+    int getNumThreads() const {return (int)funcReps.size();}
+
+    void setJacobianSparsity(const Array_< Array_<int> >& nonzeroRows);
+    void clearJacobianSparsity();
+    int getNumJacobianColumnGroups() const {return (int)columnGroups.size();}
+
     // Statistics
     mutable int nDifferentiations; 
     mutable int nDifferentiationFailures; 
@@ -162,16 +198,37 @@ private:
     // This is set on construction, but can be changed.
     Differentiator::Method defaultMethod;
 
-    // These are pre-calculated accuracy factors for 1st order and
-    // 2nd order step size estimates, derived from EstimatedAccuracy
-    // upon construction.
-    const Real AccFac1, AccFac2;
+    // These are pre-calculated accuracy factors for 1st, 2nd and 4th order
+    // step size estimates, derived from EstimatedAccuracy upon construction.
+    const Real AccFac1, AccFac2, AccFac4;
+
+    // Perturbations are evaluated on one thread per function object; the
+    // first is always frep and the rest are clones supplied by the user. 
+    // Thread t evaluates perturbations t, t+nThreads, ... so the results
+    // don't depend on the number of threads.
+    Array_<const Differentiator::Function::FunctionRep*> funcReps;
+    std::unique_ptr<ParallelExecutor>                    executor;
+
+    // Run work(t) for each thread t, concurrently if there are clones. If
+    // any of them throws, the exception from the lowest t is rethrown.
+    template <class Work> void forEachThread(const Work& work) const {
+        if (executor) executor->forEach(getNumThreads(), work);
+        else for (int t=0; t < getNumThreads(); ++t) work(t);
+    }
+
+    // The Jacobian sparsity pattern (empty if dense), and the groups of 
+    // columns that are perturbed together (one column each if dense).
+    Array_< Array_<int> > nonzeroRows;
+    Array_< Array_<int> > columnGroups;
 
-    // These temporaries are kept here so we can reuse their storage space
-    // from call to call once they have been allocated at construction. 
+    // These temporaries are kept here, one set per thread, so we can reuse
+    // their storage space from call to call once they have been allocated. 
     // The *values* do not persist across calls.
-    mutable Vector ytmp;           // [NParameters]
-    mutable Vector fyptmp, fymtmp; // [NFunctions]
+    struct Workspace {
+        Vector y, h;        // [NParameters]
+        Vector fy, diff;    // [NFunctions]
+    };
+    mutable Array_<Workspace> workspace;
 
     // suppress
     DifferentiatorRep(const DifferentiatorRep&);
@@ -545,6 +602,64 @@ Matrix Differentiator::calcJacobian
     return dfdy;
 }
 
+Differentiator& Differentiator::setFunctionClones
+   (const Array_<const Function*>& clones) 
+{
+    Array_<const Function::FunctionRep*> cloneReps;
+    for (unsigned i=0; i < clones.size(); ++i) {
+        SimTK_APIARGCHECK1_ALWAYS(clones[i] != 0, "Differentiator", 
+            "setFunctionClones", "Function clone %d was null.", (int)i);
+        const Function::FunctionRep& crep = *clones[i]->rep;
+        SimTK_APIARGCHECK1_ALWAYS(&crep != &rep->frep, "Differentiator", 
+            "setFunctionClones", "Function clone %d is the function being"
+            " differentiated; each thread needs its own function object.",
+            (int)i);
+        SimTK_APIARGCHECK4_ALWAYS(
+               crep.functionKind() == rep->frep.functionKind()
+            && crep.getNumFunctions() == rep->NFunctions 
+            && crep.getNumParameters() == rep->NParameters,
+            "Differentiator", "setFunctionClones", "Function clone %d is a"
+            " %s with %d functions of %d parameters; it must be the same as"
+            " the function being differentiated.", (int)i, 
+            crep.functionKind().c_str(), crep.getNumFunctions(), 
+            crep.getNumParameters());
+        cloneReps.push_back(&crep);
+    }
+    rep->setFunctionClones(cloneReps);
+    return *this;
+}
+
+int Differentiator::getNumThreads() const {
+    return rep->getNumThreads();
+}
+
+Differentiator& Differentiator::setJacobianSparsity
+   (const Array_< Array_<int> >& nonzeroRows) 
+{
+    SimTK_APIARGCHECK2_ALWAYS((int)nonzeroRows.size()==rep->NParameters, 
+        "Differentiator", "setJacobianSparsity",
+        "Expecting nonzero rows for %d columns but got %d", 
+        rep->NParameters, (int)nonzeroRows.size());
+    for (unsigned j=0; j < nonzeroRows.size(); ++j)
+        for (unsigned k=0; k < nonzeroRows[j].size(); ++k)
+            SimTK_APIARGCHECK3_ALWAYS(
+                0 <= nonzeroRows[j][k] && nonzeroRows[j][k] < rep->NFunctions,
+                "Differentiator", "setJacobianSparsity",
+                "Row %d given for column %d is out of range; there are %d"
+                " functions.", nonzeroRows[j][k], (int)j, rep->NFunctions);
+    rep->setJacobianSparsity(nonzeroRows);
+    return *this;
+}
+
+Differentiator& Differentiator::clearJacobianSparsity() {
+    rep->clearJacobianSparsity();
+    return *this;
+}
+
+int Differentiator::getNumJacobianColumnGroups() const {
+    return rep->getNumJacobianColumnGroups();
+}
+
 void Differentiator::resetAllStatistics() {
     rep->resetAllStatistics();
 }
@@ -568,6 +683,7 @@ Differentiator::isValidMethod(Differentiator::Method m) {
     case UnspecifiedMethod:
     case ForwardDifference:
     case CentralDifference:
+    case RichardsonExtrapolation:
         return true;
     }
     return false;
@@ -580,6 +696,7 @@ Differentiator::getMethodName(Differentiator::Method m) {
     case UnspecifiedMethod: return "UnspecifiedMethod";
     case ForwardDifference: return "ForwardDifference";
     case CentralDifference: return "CentralDifference";
+    case RichardsonExtrapolation: return "RichardsonExtrapolation";
     }
     return 0; // can't happen
 }
@@ -592,6 +709,7 @@ Differentiator::getMethodOrder(Differentiator::Method m) {
     switch(m) {
     case ForwardDifference: return 1;
     case CentralDifference: return 2;
+    case RichardsonExtrapolation: return 4;
     default:
         assert(!"Shouldn't be any other cases");
     }
@@ -687,15 +805,70 @@ Differentiator::DifferentiatorRep::DifferentiatorRep
     EstimatedAccuracy(fr.getEstimatedAccuracy()),
     defaultMethod(getMethodOrThrow(defMthd, DefaultDefaultMethod, "Differentiator")),
     AccFac1(std::sqrt(EstimatedAccuracy)),
-    AccFac2(std::pow(EstimatedAccuracy, OneThird))
+    AccFac2(std::pow(EstimatedAccuracy, OneThird)),
+    AccFac4(std::pow(EstimatedAccuracy, Real(0.2)))
 {
     //TODO
     assert(NParameters >= 0 && NFunctions >= 0 && EstimatedAccuracy > 0);
 
     resetAllStatistics();
-    ytmp.resize(NParameters);
-    fyptmp.resize(NFunctions);
-    fymtmp.resize(NFunctions);
+    setFunctionClones(Array_<const Differentiator::Function::FunctionRep*>());
+    clearJacobianSparsity();
+}
+
+void Differentiator::DifferentiatorRep::setFunctionClones
+   (const Array_<const Differentiator::Function::FunctionRep*>& clones)
+{
+    funcReps.clear();
+    funcReps.push_back(&frep);
+    funcReps.insert(funcReps.end(), clones.begin(), clones.end());
+
+    workspace.resize(funcReps.size());
+    for (unsigned t=0; t < workspace.size(); ++t) {
+        workspace[t].y.resize(NParameters);
+        workspace[t].h.resize(NParameters);
+        workspace[t].fy.resize(NFunctions);
+        workspace[t].diff.resize(NFunctions);
+    }
+
+    if (funcReps.size() > 1)
+        executor.reset(new ParallelExecutor(funcReps.size()));
+    else
+        executor.reset();
+}
+
+// Group the columns greedily in order, putting each column in the first
+// group none of whose columns has a nonzero in any of this column's rows.
+void Differentiator::DifferentiatorRep::setJacobianSparsity
+   (const Array_< Array_<int> >& rows)
+{
+    nonzeroRows = rows;
+    columnGroups.clear();
+    Array_< Array_<bool> > rowUsed; // [group][row]
+    for (int j=0; j < NParameters; ++j) {
+        const Array_<int>& jRows = nonzeroRows[j];
+        unsigned g = 0;
+        for (; g < columnGroups.size(); ++g) {
+            bool fits = true;
+            for (unsigned k=0; k < jRows.size() && fits; ++k)
+                fits = !rowUsed[g][jRows[k]];
+            if (fits) break;
+        }
+        if (g == columnGroups.size()) {
+            columnGroups.push_back(Array_<int>());
+            rowUsed.push_back(Array_<bool>(NFunctions, false));
+        }
+        columnGroups[g].push_back(j);
+        for (unsigned k=0; k < jRows.size(); ++k)
+            rowUsed[g][jRows[k]] = true;
+    }
+}
+
+void Differentiator::DifferentiatorRep::clearJacobianSparsity() {
+    nonzeroRows.clear();
+    columnGroups.resize(NParameters);
+    for (int j=0; j < NParameters; ++j)
+        columnGroups[j].assign(1, j);
 }
 
 void Differentiator::DifferentiatorRep::calcDerivative
@@ -707,20 +880,19 @@ void Differentiator::DifferentiatorRep::calcDerivative
     //TODO
     assert(NParameters==1 && NFunctions==1);
 
-    const int  order = Differentiator::getMethodOrder(method);
-    const Real hEst  = getAccFac(order)*std::max(std::abs(y0), YMin);
-    const Real h     = cleanUpH(hEst, y0);
-
-    Real fyplus, fyminus;
-    Real y = y0+h; 
-    nCallsToUserFunction++; f.call(y, fyplus);
-    if (order==1) {
-        dfdy = (fyplus-fy0)/h;
-    } else {
-        y = y0-h; 
-        nCallsToUserFunction++; f.call(y, fyminus);
-        dfdy = (fyplus-fyminus)/(2*h);
+    const int     order = Differentiator::getMethodOrder(method);
+    const Stencil& st   = getStencil(method);
+    const Real    hEst  = getAccFac(order)*std::max(std::abs(y0), YMin);
+    const Real    h     = cleanUpH(hEst, y0);
+
+    Real sum = st.weight0 != 0 ? st.weight0*fy0 : Real(0);
+    for (int k=0; k < st.n; ++k) {
+        const Real y = y0 + st.offset[k]*h;
+        Real fy;
+        nCallsToUserFunction++; f.call(y, fy);
+        sum += st.weight[k]*fy;
     }
+    dfdy = sum/h;
 }
 
 void Differentiator::DifferentiatorRep::calcGradient
@@ -731,29 +903,37 @@ void Differentiator::DifferentiatorRep::calcGradient
 
     //TODO
     assert(NFunctions==1);
-    assert(ytmp.size()==NParameters);
     assert(y0.size() == NParameters);
 
     gradf.resize(NParameters);
 
-    ytmp = y0;
-    const int order = Differentiator::getMethodOrder(method);
-
-    for (int i=0; i < f.getNumParameters(); ++i) {
-        const Real hEst = getAccFac(order)*std::max(std::abs(y0[i]), YMin);
-        const Real h = cleanUpH(hEst, y0[i]);
-        Real fyplus, fyminus;
-        ytmp[i] = y0[i]+h; 
-        nCallsToUserFunction++; f.call(ytmp, fyplus);
-        if (order==1) {
-            gradf[i] = (fyplus-fy0)/h;
-        } else {
-            ytmp[i] = y0[i]-h; 
-            nCallsToUserFunction++; f.call(ytmp, fyminus);
-            gradf[i] = (fyplus-fyminus)/(2*h);
+    const int      order    = Differentiator::getMethodOrder(method);
+    const Stencil& st       = getStencil(method);
+    const int      nThreads = getNumThreads();
+    Array_<int>    nCalls(nThreads, 0);
+
+    forEachThread([&](int t) {
+        const GradientFunctionRep& ft = t==0 
+            ? f : static_cast<const GradientFunctionRep&>(*funcReps[t]);
+        Vector& y = workspace[t].y;
+        y = y0;
+        for (int i=t; i < NParameters; i += nThreads) {
+            const Real hEst = getAccFac(order)*std::max(std::abs(y0[i]), YMin);
+            const Real h = cleanUpH(hEst, y0[i]);
+            Real sum = st.weight0 != 0 ? st.weight0*fy0 : Real(0);
+            for (int k=0; k < st.n; ++k) {
+                y[i] = y0[i] + st.offset[k]*h;
+                Real fy;
+                ++nCalls[t]; ft.call(y, fy);
+                sum += st.weight[k]*fy;
+            }
+            y[i] = y0[i]; // restore
+            gradf[i] = sum/h;
         }
-        ytmp[i] = y0[i]; // restore
-    }
+    });
+
+    for (int t=0; t < nThreads; ++t)
+        nCallsToUserFunction += nCalls[t];
 }
 
 void Differentiator::DifferentiatorRep::calcJacobian
@@ -764,31 +944,62 @@ void Differentiator::DifferentiatorRep::calcJacobian
     const Differentiator::Method method = getMethodOrThrow(m, defaultMethod, "calcJacobian");
 
     //TODO
-    assert(ytmp.size()==NParameters && fyptmp.size()==NFunctions && fymtmp.size()==NFunctions);
     assert(y0.size()  == NParameters);
     assert(fy0.size() == NFunctions);
 
     dfdy.resize(NFunctions,NParameters);
 
-    const int order = Differentiator::getMethodOrder(method);
-
-    ytmp = y0;
-    for (int i=0; i < NParameters; ++i) {
-        const Real hEst = getAccFac(order)*std::max(std::abs(y0[i]), YMin);
-        const Real h = cleanUpH(hEst, y0[i]);
-        ytmp[i] = y0[i]+h; 
-        nCallsToUserFunction++; f.call(ytmp, fyptmp);
-        if (order==1) {
-            dfdy(i) = (fyptmp-fy0)/h;
-        } else {
-            ytmp[i] = y0[i]-h; 
-            nCallsToUserFunction++; f.call(ytmp, fymtmp);
-            dfdy(i) = (fyptmp-fymtmp)/(2*h);
+    const int      order    = Differentiator::getMethodOrder(method);
+    const Stencil& st       = getStencil(method);
+    const int      nThreads = getNumThreads();
+    const int      nGroups  = getNumJacobianColumnGroups();
+    Array_<int>    nCalls(nThreads, 0);
+
+    forEachThread([&](int t) {
+        const JacobianFunctionRep& ft = t==0 
+            ? f : static_cast<const JacobianFunctionRep&>(*funcReps[t]);
+        Workspace& ws = workspace[t];
+        ws.y = y0;
+        for (int g=t; g < nGroups; g += nThreads) {
+            // Perturb all the columns in this group at once; each has its
+            // own step size.
+            const Array_<int>& cols = columnGroups[g];
+            for (unsigned c=0; c < cols.size(); ++c) {
+                const int  j    = cols[c];
+                const Real hEst = getAccFac(order)*std::max(std::abs(y0[j]), YMin);
+                ws.h[j] = cleanUpH(hEst, y0[j]);
+            }
+            for (int r=0; r < NFunctions; ++r)
+                ws.diff[r] = st.weight0 != 0 ? st.weight0*fy0[r] : Real(0);
+            for (int k=0; k < st.n; ++k) {
+                for (unsigned c=0; c < cols.size(); ++c)
+                    ws.y[cols[c]] = y0[cols[c]] + st.offset[k]*ws.h[cols[c]];
+                ++nCalls[t]; ft.call(ws.y, ws.fy);
+                for (int r=0; r < NFunctions; ++r)
+                    ws.diff[r] += st.weight[k]*ws.fy[r];
+            }
+
+            for (unsigned c=0; c < cols.size(); ++c) {
+                const int  j = cols[c];
+                const Real h = ws.h[j];
+                ws.y[j] = y0[j]; // restore
+                if (nonzeroRows.empty()) {
+                    for (int r=0; r < NFunctions; ++r)
+                        dfdy(r,j) = ws.diff[r]/h;
+                } else {
+                    // The other columns in the group contributed only to
+                    // rows outside this column's pattern.
+                    dfdy(j) = 0;
+                    const Array_<int>& rows = nonzeroRows[j];
+                    for (unsigned k=0; k < rows.size(); ++k)
+                        dfdy(rows[k],j) = ws.diff[rows[k]]/h;
+                }
+            }
         }
-        ytmp[i] = y0[i]; // restore
-    }
+    });
+
+    for (int t=0; t < nThreads; ++t)
+        nCallsToUserFunction += nCalls[t];
 }
 
 } // namespace SimTK
-
-
@@ -439,6 +439,44 @@ void testAnalyticalCylinderGeodesic() {
     testAnalyticalGeodesicRandom(cylinder);
 }
 
+// Shoot along a great circle of a sphere, for which the end point and the
+// Jacobi field j(s) = r sin(s/r) are known in closed form.
+void testShootSphereGeodesic(const ContactGeometry& sphere) {
+    const Vec3 P(r,0,0);
+    const UnitVec3 tP(0,1,0);
+    const Real len = 2;
+    Geodesic geod;
+
+    sphere.shootGeodesicInDirectionUntilLengthReached(P, tP, len,
+                                                      GeodesicOptions(), geod);
+    assertEqual(geod.getLength(), len);
+    assertEqual(geod.getPointQ(), Vec3(r*cos(len/r), r*sin(len/r), 0));
+    assertEqual(geod.getJacobiQ(), r*sin(len/r));
+
+    sphere.calcGeodesicReverseSensitivity(geod);
+    assertEqual(geod.getJacobiP(), r*sin(len/r));
+
+    // The same shot, stopped at the plane y = r sin(len/r) instead.
+    const Plane plane(Vec3(0,1,0), r*sin(len/r));
+    sphere.shootGeodesicInDirectionUntilPlaneHit(P, tP, plane,
+                                                 GeodesicOptions(), geod);
+    ASSERT(std::abs(plane.getDistance(geod.getPointQ())) < 1e-8);
+    assertEqual(geod.getLength(), len);
+    assertEqual(geod.getPointQ(), Vec3(r*cos(len/r), r*sin(len/r), 0));
+}
+
+void testShootGeodesic() {
+    ContactGeometry::Sphere sphere(r);
+    testShootSphereGeodesic(sphere);
+
+    // Copies must be able to shoot geodesics too.
+    ContactGeometry::Sphere copy(sphere);
+    testShootSphereGeodesic(copy);
+    ContactGeometry::Sphere assigned(1);
+    assigned = sphere;
+    testShootSphereGeodesic(assigned);
+}
+
 void testProjectDownhillToNearestPoint(const ContactGeometry& geom, Real r) {
 
     bool inside;
@@ -470,6 +508,8 @@ int main() {
         testCylinder();
         testTorus();
 
+        testShootGeodesic();
+
         // TODO clean up these tests and use them
 //        testAnalyticalSphereGeodesic();
 //        testAnalyticalCylinderGeodesic();
@@ -0,0 +1,197 @@
+/* -------------------------------------------------------------------------- *
+ *                         SimTK Simbody: SimTKmath                           *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the Differentiator's Richardson extrapolation method, concurrent
+evaluation with function clones, and Jacobian column grouping. */
+
+#include "SimTKmath.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// f(y) = sum_i sin(i+1)*exp(y_i/2), with a known gradient.
+class SumFunc : public Differentiator::GradientFunction {
+public:
+    explicit SumFunc(int ny) : Differentiator::GradientFunction(ny) {}
+    int f(const Vector& y, Real& fy) const override {
+        fy = 0;
+        for (int i=0; i < y.size(); ++i)
+            fy += std::sin(Real(i+1))*std::exp(y[i]/2);
+        return 0;
+    }
+    Vector calcGradient(const Vector& y) const {
+        Vector g(y.size());
+        for (int i=0; i < y.size(); ++i)
+            g[i] = std::sin(Real(i+1))*std::exp(y[i]/2)/2;
+        return g;
+    }
+};
+
+// A tridiagonal system: f_i = y_{i-1} y_i - sin(y_i) + y_{i+1}^2. Calls are
+// counted here too so we can check that each thread uses its own function.
+class TridiagonalFunc : public Differentiator::JacobianFunction {
+public:
+    explicit TridiagonalFunc(int n) 
+    :   Differentiator::JacobianFunction(n, n), nCalls(0) {}
+    int f(const Vector& y, Vector& fy) const override {
+        ++nCalls;
+        const int n = y.size();
+        for (int i=0; i < n; ++i) {
+            fy[i] = -std::sin(y[i]);
+            if (i > 0)   fy[i] += y[i-1]*y[i];
+            if (i < n-1) fy[i] += square(y[i+1]);
+        }
+        return 0;
+    }
+    Matrix calcJacobian(const Vector& y) const {
+        const int n = y.size();
+        Matrix J(n, n); J = 0;
+        for (int i=0; i < n; ++i) {
+            J(i,i) = -std::cos(y[i]) + (i > 0 ? y[i-1] : Real(0));
+            if (i > 0)   J(i,i-1) = y[i];
+            if (i < n-1) J(i,i+1) = 2*y[i+1];
+        }
+        return J;
+    }
+    // Column j of the Jacobian has rows j-1, j, j+1.
+    static Array_< Array_<int> > calcSparsity(int n) {
+        Array_< Array_<int> > rows(n);
+        for (int j=0; j < n; ++j)
+            for (int r=std::max(j-1,0); r <= std::min(j+1,n-1); ++r)
+                rows[j].push_back(r);
+        return rows;
+    }
+    mutable int nCalls;
+};
+
+Vector makeY(int n) {
+    Vector y(n);
+    for (int i=0; i < n; ++i) y[i] = 0.1*i - 0.3;
+    return y;
+}
+
+void testRichardson() {
+    const int n = 5;
+    SumFunc func(n);
+    Differentiator diff(func, Differentiator::RichardsonExtrapolation);
+    SimTK_TEST(Differentiator::getMethodOrder(
+                   Differentiator::RichardsonExtrapolation) == 4);
+    const Vector y = makeY(n);
+    const Vector exact = func.calcGradient(y);
+
+    const Vector grad4 = diff.calcGradient(y);
+    const Vector grad2 = diff.calcGradient(y, 
+                                           Differentiator::CentralDifference);
+    SimTK_TEST((grad4-exact).normInf() < 1e-11);
+    SimTK_TEST((grad4-exact).normInf() < (grad2-exact).normInf());
+    // One unperturbed call and four per parameter.
+    SimTK_TEST(diff.getNumCallsToUserFunction() == (1+4*n) + (1+2*n));
+}
+
+// Same answers, bit for bit, using clones on several threads.
+void testClones() {
+    const int n = 12;
+    TridiagonalFunc func(n), clone1(n), clone2(n);
+    const Vector y = makeY(n);
+    Vector fy(n); func.f(y, fy);
+
+    Differentiator diff(func, Differentiator::CentralDifference);
+    Matrix J1; diff.calcJacobian(y, fy, J1);
+    SimTK_TEST_EQ_TOL(J1, func.calcJacobian(y), 1e-8);
+
+    Array_<const Differentiator::Function*> clones;
+    clones.push_back(&clone1); clones.push_back(&clone2);
+    diff.setFunctionClones(clones);
+    SimTK_TEST(diff.getNumThreads() == 3);
+    func.nCalls = 0;
+    Matrix J3; diff.calcJacobian(y, fy, J3);
+    SimTK_TEST((J3 - J1).norm() == 0);
+    // Perturbations were divided round robin among the function objects.
+    SimTK_TEST(func.nCalls == 8 && clone1.nCalls == 8 && clone2.nCalls == 8);
+
+    SumFunc sum(n), sumClone(n);
+    Differentiator gdiff(sum);
+    const Vector g1 = gdiff.calcGradient(y);
+    gdiff.setFunctionClones(Array_<const Differentiator::Function*>
+                                (1, &sumClone));
+    const Vector g2 = gdiff.calcGradient(y);
+    SimTK_TEST((g2 - g1).norm() == 0);
+
+    // A clone must be a distinct function of the same kind and shape.
+    TridiagonalFunc wrongSize(n+1);
+    SimTK_TEST_MUST_THROW(diff.setFunctionClones(
+        Array_<const Differentiator::Function*>(1, &wrongSize)));
+    SimTK_TEST_MUST_THROW(diff.setFunctionClones(
+        Array_<const Differentiator::Function*>(1, &func)));
+    SimTK_TEST_MUST_THROW(diff.setFunctionClones(
+        Array_<const Differentiator::Function*>(1, &sum)));
+    diff.setFunctionClones(Array_<const Differentiator::Function*>());
+    SimTK_TEST(diff.getNumThreads() == 1);
+}
+
+// A tridiagonal Jacobian needs just three column groups.
+void testSparsity() {
+    const int n = 20;
+    TridiagonalFunc func(n);
+    const Vector y = makeY(n);
+    Vector fy(n); func.f(y, fy);
+    const Matrix exact = func.calcJacobian(y);
+
+    Differentiator diff(func);
+    Matrix Jdense; diff.calcJacobian(y, fy, Jdense);
+    SimTK_TEST(diff.getNumJacobianColumnGroups() == n);
+
+    diff.setJacobianSparsity(TridiagonalFunc::calcSparsity(n));
+    SimTK_TEST(diff.getNumJacobianColumnGroups() == 3);
+    const int before = diff.getNumCallsToUserFunction();
+    Matrix J; diff.calcJacobian(y, fy, J);
+    SimTK_TEST(diff.getNumCallsToUserFunction() - before == 3);
+    SimTK_TEST((J - Jdense).normRMS() < 1e-14);
+    SimTK_TEST_EQ_TOL(J, exact, 1e-6);
+
+    // Higher order methods and clones work with the groups too.
+    TridiagonalFunc clone(n);
+    diff.setFunctionClones(Array_<const Differentiator::Function*>(1, &clone));
+    diff.calcJacobian(y, fy, J, Differentiator::RichardsonExtrapolation);
+    SimTK_TEST_EQ_TOL(J, exact, 1e-10);
+    SimTK_TEST(J(0, n-1) == 0); // outside the pattern
+
+    diff.clearJacobianSparsity();
+    SimTK_TEST(diff.getNumJacobianColumnGroups() == n);
+
+    Array_< Array_<int> > bad = TridiagonalFunc::calcSparsity(n);
+    bad[3].push_back(n);
+    SimTK_TEST_MUST_THROW(diff.setJacobianSparsity(bad));
+    bad.pop_back();
+    SimTK_TEST_MUST_THROW(diff.setJacobianSparsity(bad));
+}
+
+int main() {
+    SimTK_START_TEST("TestDifferentiatorOptions");
+        SimTK_SUBTEST(testRichardson);
+        SimTK_SUBTEST(testClones);
+        SimTK_SUBTEST(testSparsity);
+    SimTK_END_TEST();
+}
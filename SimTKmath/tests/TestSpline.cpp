@@ -159,6 +159,62 @@ void testRealSpline() {
     SimTK_TEST_EQ_TOL(3, spline2.getSplineDegree(),TESTTOL);
 }
 
+// Spline evaluation starts its interval search from the last interval found.
+// Results must not depend on the order of the evaluations, and the scalar and
+// Vector signatures must agree.
+void testSplineIntervalHint() {
+    const int n = 40;
+    Vector x(n);
+    Vector_<Vec2> y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = i*i*0.01; // non-uniform spacing
+        y[i] = Vec2(std::sin(x[i]), i%3);
+    }
+    const Spline_<Vec2> spline(3, x, y);
+    const Spline_<Vec2> copy(spline); // shares the hint
+
+    Random::Uniform random(x[0], x[n-1]);
+    random.setSeed(42);
+    Array_<Real> ts;
+    for (int i = 0; i <= 200; ++i)              // sweep forward
+        ts.push_back(x[n-1]*i/200.);
+    for (int i = 200; i >= 0; --i)              // and back
+        ts.push_back(x[n-1]*i/200.);
+    for (int i = 0; i < 200; ++i)               // jump around
+        ts.push_back(random.getValue());
+    ts.push_back(x[0]); ts.push_back(x[n-1]);   // ends
+
+    for (Real t : ts) {
+        // Without a hint the search starts from a uniform-spacing guess.
+        const Vec2 v = GCVSPLUtil::splder(0, 3, t, x, y);
+        const Vec2 d1 = GCVSPLUtil::splder(1, 3, t, x, y);
+        const Vec2 d2 = GCVSPLUtil::splder(2, 3, t, x, y);
+        SimTK_TEST(spline.calcValue(t) == v);
+        SimTK_TEST(copy.calcDerivative(1, t) == d1);
+        SimTK_TEST(spline.calcDerivative(2, t) == d2);
+        SimTK_TEST(spline.calcValue(Vector(1, t)) == v);
+        SimTK_TEST(spline.calcValue(Vec1(t)) == v);
+        SimTK_TEST(spline.calcDerivative(Array_<int>(2,0), Vec1(t)) == d2);
+
+        // Any hint at all, even a silly one, must give the same answer.
+        for (int hint : {-3, 0, 1, n/2, n-1, n, 1000}) {
+            int interval = hint;
+            SimTK_TEST(GCVSPLUtil::splder(1, 3, t, x, y, interval) == d1);
+            SimTK_TEST(0 <= interval && interval <= n);
+        }
+    }
+
+    // Same for a scalar spline through the Function interface.
+    Vector yr(n);
+    for (int i = 0; i < n; ++i) yr[i] = y[i][0];
+    const Spline sr(3, x, yr);
+    const Function& f = sr;
+    for (Real t : ts) {
+        SimTK_TEST(f.calcValue(t) == GCVSPLUtil::splder(0, 3, t, x, yr));
+        SimTK_TEST(f.calcDerivative(1, t) == GCVSPLUtil::splder(1, 3, t, x, yr));
+    }
+}
+
 //MM bits added to test the numerical accuracy of the natural cubic splines.
 /**
 * This function computes a standard central difference dy/dx. 
@@ -642,6 +698,7 @@ int main () {
         SimTK_SUBTEST(testSpline);
         SimTK_SUBTEST(testSplineFitter);
         SimTK_SUBTEST(testRealSpline);
+        SimTK_SUBTEST(testSplineIntervalHint);
         SimTK_SUBTEST(testNaturalCubicSpline);
     SimTK_END_TEST();
 }
@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "SimTKmath.h"
+#include <algorithm>
 #include <vector>
 #include <exception>
 
@@ -199,6 +200,94 @@ void testOBBTree() {
     validateOBBTree(mesh, mesh.getOBBTreeNode(), mesh.getOBBTreeNode(), faceReferenceCount);
     for (int i = 0; i < (int) faceReferenceCount.size(); i++)
         SimTK_TEST(faceReferenceCount[i] == 1);
+
+    // A copy must have its own tree, still valid after the original is gone.
+
+    ContactGeometry::TriangleMesh* original = 
+        new ContactGeometry::TriangleMesh(vertices, faceIndices);
+    ContactGeometry::TriangleMesh copy(*original);
+    delete original;
+    vector<int> copyReferenceCount(copy.getNumFaces(), 0);
+    validateOBBTree(copy, copy.getOBBTreeNode(), copy.getOBBTreeNode(), copyReferenceCount);
+    for (int i = 0; i < (int) copyReferenceCount.size(); i++)
+        SimTK_TEST(copyReferenceCount[i] == 1);
+}
+
+// Compare the faces reported by the mesh-mesh contact tracker for two
+// overlapping spheres against a brute force check of every pair of faces.
+void testMeshMeshContact() {
+    const Real radius = 1;
+    ContactGeometry::TriangleMesh 
+        mesh1(PolygonalMesh::createSphereMesh(radius, 3)),
+        mesh2(PolygonalMesh::createSphereMesh(radius, 2));
+    ContactTracker::TriangleMeshTriangleMesh tracker;
+    const UntrackedContact prior(ContactSurfaceIndex(0), ContactSurfaceIndex(1));
+
+    Random::Uniform random(-1, 1);
+    for (int trial = 0; trial < 10; ++trial) {
+        const Rotation R_GM2(random.getValue()*Pi, 
+            UnitVec3(random.getValue(), random.getValue(), random.getValue()));
+        const Vec3 p_GM2 = 
+            1.2*radius*UnitVec3(random.getValue(), random.getValue(), 
+                                random.getValue());
+        const Transform X_GM1, X_GM2(R_GM2, p_GM2);
+
+        Contact contact;
+        SimTK_TEST(tracker.trackContact(prior, X_GM1, mesh1, X_GM2, mesh2, 0,
+                                        contact));
+        SimTK_TEST(TriangleMeshContact::isInstance(contact));
+        const TriangleMeshContact& meshContact = 
+            TriangleMeshContact::getAs(contact);
+        const Array_<int>& faces1 = meshContact.getSurface1FaceArray();
+        const Array_<int>& faces2 = meshContact.getSurface2FaceArray();
+        SimTK_TEST(faces1.size() == meshContact.getSurface1Faces().size());
+        SimTK_TEST(faces2.size() == meshContact.getSurface2Faces().size());
+        for (unsigned i = 1; i < faces1.size(); ++i)
+            SimTK_TEST(faces1[i-1] < faces1[i]);
+        for (unsigned i = 1; i < faces2.size(); ++i)
+            SimTK_TEST(faces2[i-1] < faces2[i]);
+
+        // Every face that intersects the other mesh must be reported.
+        vector<bool> crossing1(mesh1.getNumFaces()), 
+                     crossing2(mesh2.getNumFaces());
+        for (int f2 = 0; f2 < mesh2.getNumFaces(); ++f2) {
+            const Geo::Triangle A
+               (X_GM2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2, 0)),
+                X_GM2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2, 1)),
+                X_GM2*mesh2.getVertexPosition(mesh2.getFaceVertex(f2, 2)));
+            for (int f1 = 0; f1 < mesh1.getNumFaces(); ++f1) {
+                const Geo::Triangle B
+                   (mesh1.getVertexPosition(mesh1.getFaceVertex(f1, 0)),
+                    mesh1.getVertexPosition(mesh1.getFaceVertex(f1, 1)),
+                    mesh1.getVertexPosition(mesh1.getFaceVertex(f1, 2)));
+                if (A.overlapsTriangle(B))
+                    crossing1[f1] = crossing2[f2] = true;
+            }
+        }
+        for (int f1 = 0; f1 < mesh1.getNumFaces(); ++f1)
+            if (crossing1[f1])
+                SimTK_TEST(std::binary_search(faces1.begin(), faces1.end(), f1));
+        for (int f2 = 0; f2 < mesh2.getNumFaces(); ++f2)
+            if (crossing2[f2])
+                SimTK_TEST(std::binary_search(faces2.begin(), faces2.end(), f2));
+
+        // Any other reported face must be buried in the other sphere, and
+        // faces well inside it must be reported.
+        for (int f1 = 0; f1 < mesh1.getNumFaces(); ++f1) {
+            const Real depth = radius - (mesh1.findCentroid(f1)-p_GM2).norm();
+            const bool found = 
+                std::binary_search(faces1.begin(), faces1.end(), f1);
+            if (found && !crossing1[f1]) SimTK_TEST(depth > 0);
+            if (depth > 0.2*radius) SimTK_TEST(found);
+        }
+        for (int f2 = 0; f2 < mesh2.getNumFaces(); ++f2) {
+            const Real depth = radius - (X_GM2*mesh2.findCentroid(f2)).norm();
+            const bool found = 
+                std::binary_search(faces2.begin(), faces2.end(), f2);
+            if (found && !crossing2[f2]) SimTK_TEST(depth > 0);
+            if (depth > 0.2*radius) SimTK_TEST(found);
+        }
+    }
 }
 
 void testRayIntersection() {
@@ -312,6 +401,7 @@ int main() {
         SimTK_SUBTEST(testTriangleMesh);
         SimTK_SUBTEST(testIncorrectMeshes);
         SimTK_SUBTEST(testOBBTree);
+        SimTK_SUBTEST(testMeshMeshContact);
         SimTK_SUBTEST(testRayIntersection);
         SimTK_SUBTEST(testSmoothMesh);
         SimTK_SUBTEST(testFindNearestPoint);
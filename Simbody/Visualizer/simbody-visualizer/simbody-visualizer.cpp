@@ -2058,26 +2058,85 @@ static void readDataFromPipe(int srcPipe, unsigned char* buffer, int bytes) {
         totalRead += retval;
     }
 }
+// Scene data from the most recent StartOfScene command, kept so that 
+// UpdateScene commands can be applied to it; see VisualizerProtocol.h.
+static vector<unsigned char> lastSceneData;
+static bool recordingSceneData = false;
+// While this is set, readData() takes scene data from here instead of inPipe.
+static const unsigned char* replaySceneData = 0;
+
 // Throws ReadingInterrupted if inPipe is closed.
 static void readData(unsigned char* buffer, int bytes) {
+    if (replaySceneData) {
+        memcpy(buffer, replaySceneData, bytes);
+        replaySceneData += bytes;
+        return;
+    }
     readDataFromPipe(inPipe, buffer, bytes);
+    if (recordingSceneData)
+        lastSceneData.insert(lastSceneData.end(), buffer, buffer+bytes);
 }
 
-// We have just processed a StartOfScene command. Read in all the scene
-// elements until we see an EndOfScene command. We allocate a new Scene
-// object to hold the scene and return a pointer to it. Don't forget to
-// delete that object when you are done with it.
-static Scene* readNewScene() {
+// Define a new mesh that will be assigned the next available mesh index. It
+// will be cached here and then can be referenced in this scene and others by
+// using its mesh index.
+static void readMeshDefinition() {
+    unsigned char buffer[256];
+    unsigned short* shortBuffer = (unsigned short*) buffer;
+
+    readData(buffer, 2*sizeof(short));
+    PendingMesh* mesh = new PendingMesh(); // assigns next mesh index
+    int numVertices = shortBuffer[0];
+    int numFaces = shortBuffer[1];
+    mesh->vertices.resize(3*numVertices, 0);
+    mesh->normals.resize(3*numVertices);
+    mesh->faces.resize(3*numFaces);
+    readData((unsigned char*)&mesh->vertices[0], (int)(mesh->vertices.size()*sizeof(float)));
+    readData((unsigned char*)&mesh->faces[0], (int)(mesh->faces.size()*sizeof(short)));
+
+    // Compute normal vectors for the mesh.
+
+    vector<fVec3> normals(numVertices, fVec3(0));
+    for (int i = 0; i < numFaces; i++) {
+        int v1 = mesh->faces[3*i];
+        int v2 = mesh->faces[3*i+1];
+        int v3 = mesh->faces[3*i+2];
+        fVec3 vert1(mesh->vertices[3*v1], mesh->vertices[3*v1+1], mesh->vertices[3*v1+2]);
+        fVec3 vert2(mesh->vertices[3*v2], mesh->vertices[3*v2+1], mesh->vertices[3*v2+2]);
+        fVec3 vert3(mesh->vertices[3*v3], mesh->vertices[3*v3+1], mesh->vertices[3*v3+2]);
+        fVec3 norm = (vert2-vert1)%(vert3-vert1);
+        float length = norm.norm();
+        if (length > 0) {
+            norm /= length;
+            normals[v1] += norm;
+            normals[v2] += norm;
+            normals[v3] += norm;
+        }
+    }
+    for (int i = 0; i < numVertices; i++) {
+        normals[i] = normals[i].normalize();
+        mesh->normals[3*i] = normals[i][0];
+        mesh->normals[3*i+1] = normals[i][1];
+        mesh->normals[3*i+2] = normals[i][2];
+    }
+
+    // A real mesh will be generated from this the next
+    // time the scene is redrawn.
+    std::lock_guard<std::mutex> lock(sceneMutex); //--- LOCK SCENE ----
+    pendingCommands.insert(pendingCommands.begin(), mesh);
+}                                                 //--- UNLOCK SCENE ---
+
+// Read in all the scene elements until we see an EndOfScene command. We 
+// allocate a new Scene object to hold the scene and return a pointer to it.
+// Don't forget to delete that object when you are done with it.
+static Scene* readSceneElements(float simTime) {
     unsigned char buffer[256];
     float*          floatBuffer = (float*)          buffer;
     int*            intBuffer   = (int*)            buffer;
     unsigned short* shortBuffer = (unsigned short*) buffer;
 
     Scene* newScene = new Scene;
-
-    // Simulated time for this frame comes first.
-    readData(buffer, sizeof(float));
-    newScene->simTime = floatBuffer[0];
+    newScene->simTime = simTime;
 
     bool finished = false;
     while (!finished) {
@@ -2215,53 +2274,6 @@ static Scene* readNewScene() {
             break;
         }
 
-        // Define a new mesh that will be assigned the next available mesh
-        // index. It will be cached here and then can be referenced in this
-        // scene and others by using it mesh index.
-        case DefineMesh: {
-            readData(buffer, 2*sizeof(short));
-            PendingMesh* mesh = new PendingMesh(); // assigns next mesh index
-            int numVertices = shortBuffer[0];
-            int numFaces = shortBuffer[1];
-            mesh->vertices.resize(3*numVertices, 0);
-            mesh->normals.resize(3*numVertices);
-            mesh->faces.resize(3*numFaces);
-            readData((unsigned char*)&mesh->vertices[0], (int)(mesh->vertices.size()*sizeof(float)));
-            readData((unsigned char*)&mesh->faces[0], (int)(mesh->faces.size()*sizeof(short)));
-
-            // Compute normal vectors for the mesh.
-
-            vector<fVec3> normals(numVertices, fVec3(0));
-            for (int i = 0; i < numFaces; i++) {
-                int v1 = mesh->faces[3*i];
-                int v2 = mesh->faces[3*i+1];
-                int v3 = mesh->faces[3*i+2];
-                fVec3 vert1(mesh->vertices[3*v1], mesh->vertices[3*v1+1], mesh->vertices[3*v1+2]);
-                fVec3 vert2(mesh->vertices[3*v2], mesh->vertices[3*v2+1], mesh->vertices[3*v2+2]);
-                fVec3 vert3(mesh->vertices[3*v3], mesh->vertices[3*v3+1], mesh->vertices[3*v3+2]);
-                fVec3 norm = (vert2-vert1)%(vert3-vert1);
-                float length = norm.norm();
-                if (length > 0) {
-                    norm /= length;
-                    normals[v1] += norm;
-                    normals[v2] += norm;
-                    normals[v3] += norm;
-                }
-            }
-            for (int i = 0; i < numVertices; i++) {
-                normals[i] = normals[i].normalize();
-                mesh->normals[3*i] = normals[i][0];
-                mesh->normals[3*i+1] = normals[i][1];
-                mesh->normals[3*i+2] = normals[i][2];
-            }
-
-            // A real mesh will be generated from this the next
-            // time the scene is redrawn.
-            std::lock_guard<std::mutex> lock(sceneMutex); //--- LOCK SCENE ----
-            pendingCommands.insert(pendingCommands.begin(), mesh);
-            break;                                        //--- UNLOCK SCENE --
-        }
-
         default:
             SimTK_ASSERT_ALWAYS(false, "Unexpected scene data sent to visualizer");
         }
@@ -2270,6 +2282,32 @@ static Scene* readNewScene() {
     return newScene;
 }
 
+// We have just processed a StartOfScene command. The simulated time for this
+// frame comes first, then the scene data which we keep in case the following
+// frames are sent as updates to this one.
+static Scene* readNewScene() {
+    float simTime;
+    readData((unsigned char*)&simTime, sizeof(float));
+    lastSceneData.clear();
+    recordingSceneData = true;
+    Scene* newScene = readSceneElements(simTime);
+    recordingSceneData = false;
+    return newScene;
+}
+
+// We have just processed an UpdateScene command. Patch the changed poses into
+// the scene data we kept from the last full scene, then read that in as
+// though it had just arrived.
+static Scene* readSceneUpdate() {
+    float simTime;
+    readData((unsigned char*)&simTime, sizeof(float));
+    applySceneUpdate(readData, &lastSceneData[0], (int)lastSceneData.size());
+    replaySceneData = &lastSceneData[0];
+    Scene* newScene = readSceneElements(simTime);
+    replaySceneData = 0;
+    return newScene;
+}
+
 // This is the main program for the listener thread. It reads continuously
 // from the input pipe, which contains data from the simulator's calls
 // to a Visualizer object. Any changes to the scene must wait until the
@@ -2454,8 +2492,14 @@ void listenForInput() {
             showFrameNum = shouldShow;
             break;                                        //--- UNLOCK SCENE ---
         }
-        case StartOfScene: {
-            Scene* newScene = readNewScene();
+        case DefineMesh: {
+            readMeshDefinition();
+            break;
+        }
+        case StartOfScene:
+        case UpdateScene: {
+            Scene* newScene = buffer[0] == StartOfScene ? readNewScene() 
+                                                        : readSceneUpdate();
             std::unique_lock<std::mutex> lock(sceneMutex); //--- LOCK SCENE ----
             if (scene != NULL) {
                 // -------- WAIT FOR CONDITION --------
@@ -30,6 +30,7 @@
 
 #include "VisualizerGeometry.h"
 #include "VisualizerProtocol.h"
+#include "VisualizerFrameQueue.h"
 
 #include <cstdlib>
 #include <cstdio>
@@ -38,6 +39,7 @@
 #include <iostream>
 #include <limits>
 #include <condition_variable>
+#include <atomic>
 
 using namespace SimTK;
 using namespace std;
@@ -110,7 +112,7 @@ public:
             secToNs(DefaultSlopAsFractionOfFrameInterval/DefaultFrameRateFPS)),
         m_adjustedRealTimeBase(realTimeInNs()),
         m_prevFrameSimTime(-1), m_nextFrameDueAdjRT(-1), 
-        m_oldest(0),m_nframe(0),
+        m_simThreadIsWaiting(false), m_drawThreadIsWaiting(false),
         m_drawThreadIsRunning(false), m_drawThreadShouldSuicide(false),
         m_refCount(0)
     {   
@@ -125,7 +127,7 @@ public:
     }
     
     ~Impl() {
-        if (m_mode==RealTime && m_pool.size()) {
+        if (m_mode==RealTime && m_queue.capacity()) {
             killDrawThreadIfNecessary();
         }
         for (unsigned i = 0; i < m_controllers.size(); i++)
@@ -166,11 +168,7 @@ public:
         m_drawThreadShouldSuicide = true;
         // The draw thread might be waiting on an empty queue, in which
         // case we have to wake it up (see getOldestFrameInQueue()).
-        // We'll do it twice 100ms apart to avoid a timing issue where
-        // we signal just before the thread waits.
-        m_queueNotEmpty.notify_one(); // wake it if necessary
-        sleepInSec(0.1); 
-        m_queueNotEmpty.notify_one();
+        notifyQueueCondition(m_queueNotEmpty); // wake it if necessary
         m_drawThread.join(); // wait for death
         m_drawThreadIsRunning = m_drawThreadShouldSuicide = false;
     }
@@ -214,8 +212,8 @@ public:
         // If we're in RealTime mode and we have changed the number of
         // frames in the buffer, reallocate the pool and kill or start
         // the draw thread if necessary.
-        if (m_mode == RealTime && numFrames != m_pool.size()) {
-            if (m_pool.size()) {
+        if (m_mode == RealTime && numFrames != m_queue.capacity()) {
+            if (m_queue.capacity()) {
                 // draw thread isn't needed if we get rid of the buffer
                 if (numFrames == 0)
                     killDrawThreadIfNecessary();
@@ -247,7 +245,7 @@ public:
 
         // Mode is changing. If it was buffered RealTime before we have
         // to clean up first.
-        if (m_mode == RealTime && m_pool.size()) {
+        if (m_mode == RealTime && m_queue.capacity()) {
             killDrawThreadIfNecessary();
             initializePool(0);  // clear the buffer
         }
@@ -282,7 +280,7 @@ public:
     Real getDesiredBufferLengthInSec() const 
     {   return m_desiredBufferLengthInSec; }
 
-    int getActualBufferLengthInFrames() const {return m_pool.size();}
+    int getActualBufferLengthInFrames() const {return m_queue.capacity();}
     Real getActualBufferLengthInSec() const 
     {   return (Real)nsToSec(getActualBufferLengthInFrames()
                              *m_timeBetweenFramesInNs); }
@@ -305,15 +303,39 @@ public:
     // Set the maximum number of frames in the buffer.
     void initializePool(int sz) {
         std::lock_guard<std::mutex> lock(m_queueMutex);
-        m_pool.resize(sz);m_oldest=m_nframe=0;
+        m_queue.resize(sz);
     }
 
-    int getNFramesInQueue() const {return m_nframe;}
+    int getNFramesInQueue() const {return m_queue.size();}
 
     // Queing is enabled if the pool was allocated.
-    bool queuingIsEnabled() const {return m_pool.size() != 0;}
-    bool queueIsFull() const {return m_nframe==m_pool.size();}
-    bool queueIsEmpty() const {return m_nframe==0;}
+    bool queuingIsEnabled() const {return m_queue.capacity() != 0;}
+    bool queueIsFull() const {return m_queue.isFull();}
+    bool queueIsEmpty() const {return m_queue.isEmpty();}
+
+    // Adding or removing a frame doesn't need a lock; see
+    // VisualizerFrameQueue. A thread only takes the lock to block on a full
+    // or empty queue; it first raises its "is waiting" flag so that the other
+    // thread knows to notify it after changing the queue. Both are
+    // sequentially consistent atomics, so either the waiter sees the change
+    // or the other thread sees the flag.
+    template <class Predicate>
+    void waitForQueueCondition(std::condition_variable& condition,
+                               std::atomic<bool>& isWaiting,
+                               Predicate ready) {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        isWaiting = true;
+        // atomic: unlock, long wait, relock; ignore spurious wakeups.
+        condition.wait(lock, ready);
+        isWaiting = false;
+    }
+
+    // Taking the lock ensures that a thread that has found its condition
+    // false is already waiting by the time we notify it.
+    void notifyQueueCondition(std::condition_variable& condition) {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        condition.notify_one();
+    }
 
     // Called from simulation thread. Blocks until there is room in
     // the queue, then inserts this state unconditionally, with the indicated
@@ -323,17 +345,17 @@ public:
     void addFrameToQueueWithWait(const State& state, 
                                  const long long& desiredDrawTimeAdjRT)
     {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
         ++numReportedFramesThatWereQueued;
         if (queueIsFull()) {
             ++numQueuedFramesThatHadToWait;
-            // atomic: unlock, long wait, relock
-            // Only wake up if queue is not full (ignore spurious wakeups).
-            m_queueNotFull.wait(lock, [&] {return !queueIsFull();});
+            // Only wake up if queue is not full.
+            waitForQueueCondition(m_queueNotFull, m_simThreadIsWaiting,
+                                  [&] {return !queueIsFull();});
         }
 
-        // There is room in the queue now. We're holding the lock.
-        Frame& frame = m_pool[(m_oldest+m_nframe)%m_pool.size()];
+        // There is room in the queue now. The drawing thread won't look at
+        // the newest slot until we push it below.
+        Frame& frame = m_queue.updNewest();
         frame.state  = state;
         frame.desiredDrawTimeAdjRT = desiredDrawTimeAdjRT;
 
@@ -343,22 +365,20 @@ public:
         // Set the expected next frame time (in AdjRT).
         m_nextFrameDueAdjRT = desiredDrawTimeAdjRT + m_timeBetweenFramesInNs;
 
-        if (++m_nframe == 1) 
-            // wake up rendering thread on first frame
-            m_queueNotEmpty.notify_one();
-
-        lock.unlock();
+        m_queue.push(); // the frame is now visible to the drawing thread
+        if (m_drawThreadIsWaiting)
+            // wake up rendering thread if it ran out of frames
+            notifyQueueCondition(m_queueNotEmpty);
     }
 
     // Call from simulation thread to allow the drawing thread to flush
     // any frames currently in the queue.
     void waitUntilQueueIsEmpty() {
-        if (   !queuingIsEnabled() || m_nframe==0 
+        if (   !queuingIsEnabled() || queueIsEmpty()
             || !m_drawThreadIsRunning || m_drawThreadShouldSuicide)
             return;
-        std::unique_lock<std::mutex> lock(m_queueMutex);
-        m_queueIsEmpty.wait(lock, [&] {return m_nframe == 0;});
-        lock.unlock();
+        waitForQueueCondition(m_queueIsEmpty, m_simThreadIsWaiting,
+                              [&] {return queueIsEmpty();});
     }
 
     // The drawing thread uses this to find the oldest frame in the buffer.
@@ -370,37 +390,34 @@ public:
     // operation since it waits until one is available), false if the draw
     // thread should quit.
     bool getOldestFrameInQueue(const Frame** fp) {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
-        if (m_nframe == 0 && !m_drawThreadShouldSuicide) {
+        const int nframe = m_queue.size();
+        if (nframe == 0 && !m_drawThreadShouldSuicide) {
             ++numTimesDrawThreadBlockedOnEmptyQueue;
-            // atomic: unlock, long wait, relock; ignore spurious wakeups.
-            m_queueNotEmpty.wait(lock,
-                    [&] {return m_nframe || m_drawThreadShouldSuicide;});
+            waitForQueueCondition(m_queueNotEmpty, m_drawThreadIsWaiting,
+                [&] {return !queueIsEmpty() || m_drawThreadShouldSuicide;});
         } else {
-            sumOfQueueLengths        += double(m_nframe);
-            sumSquaredOfQueueLengths += double(square(m_nframe));
+            sumOfQueueLengths        += double(nframe);
+            sumSquaredOfQueueLengths += double(square(nframe));
         }
         // There is at least one frame available now, unless we're supposed
-        // to quit. We are holding the lock.
-        lock.unlock();
+        // to quit.
         if (m_drawThreadShouldSuicide) {*fp=0; return false;}
-        else {*fp=&m_pool[m_oldest]; return true;} // sim thread won't change oldest
+        else {*fp=&m_queue.getOldest(); return true;} // sim thread won't change oldest
     }
 
     // Drawing thread uses this to note that it is done with the oldest
-    // frame which may now be reused by the simulation thread. The queueNotFull
-    // condition is posted if there is a reasonable amount of room in the pool 
-    // now.
+    // frame which may now be reused by the simulation thread. If the 
+    // simulation thread is waiting, the queueNotFull condition is posted if
+    // there is a reasonable amount of room in the pool now.
     void noteThatOldestFrameIsNowAvailable() {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
-        m_oldest = (m_oldest+1)%m_pool.size(); // move to next-oldest
-        --m_nframe; // there is now one fewer frame in use
-        if (m_nframe == 0)
-            m_queueIsEmpty.notify_one(); // in case we're flushing
+        const int nframe = m_queue.pop(); // one fewer frame in use
+        if (!m_simThreadIsWaiting)
+            return;
+        if (nframe == 0)
+            notifyQueueCondition(m_queueIsEmpty); // in case we're flushing
         // Start the simulation again when the pool is about half empty.
-        if (m_nframe <= m_pool.size()/2+1)
-            m_queueNotFull.notify_one();
-        lock.unlock();
+        if (nframe <= m_queue.capacity()/2+1)
+            notifyQueueCondition(m_queueNotFull);
     }
 
     // Given a time t in simulation time units, return the equivalent time r in
@@ -493,16 +510,17 @@ public:
     double m_prevFrameSimTime;
 
     // The frame buffer:
-    Array_<Frame,int> m_pool; // fixed size, old to new order but circular
-    int m_oldest, m_nframe;   // oldest is index into pool, nframe is #valid entries
-    std::mutex              m_queueMutex;
+    VisualizerFrameQueue<Frame> m_queue;
+    std::atomic<bool>       m_simThreadIsWaiting;
+    std::atomic<bool>       m_drawThreadIsWaiting;
+    std::mutex              m_queueMutex;    // only for blocking
     std::condition_variable m_queueNotFull;  // these must use m_queueMutex
     std::condition_variable m_queueNotEmpty;
     std::condition_variable m_queueIsEmpty;
 
     std::thread         m_drawThread;    // the rendering thread
     bool                m_drawThreadIsRunning;
-    bool                m_drawThreadShouldSuicide;
+    std::atomic<bool>   m_drawThreadShouldSuicide;
 
     mutable int         m_refCount; // how many Visualizer handles reference
                                     //   this Impl object?
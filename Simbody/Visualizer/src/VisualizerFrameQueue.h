@@ -0,0 +1,82 @@
+#ifndef SimTK_SIMBODY_VISUALIZER_FRAME_QUEUE_H_
+#define SimTK_SIMBODY_VISUALIZER_FRAME_QUEUE_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+#include <atomic>
+#include <cassert>
+
+namespace SimTK {
+
+/* The Visualizer's RealTime frame buffer: a fixed-size ring of frames with a
+single producer (the simulation thread) and a single consumer (the drawing
+thread), so adding or removing a frame doesn't need a lock. The producer fills
+updNewest() and then calls push(); the consumer reads getOldest() and then
+calls pop(). The frame count is a sequentially consistent atomic, so a thread
+that sees the new count also sees the frame. Blocking on a full or empty queue
+is up to the caller. Only resize() must not be called concurrently. */
+template <class Frame>
+class VisualizerFrameQueue {
+public:
+    VisualizerFrameQueue() : m_oldest(0), m_newest(0), m_nframe(0) {}
+
+    // Discard any frames and make room for capacity of them.
+    void resize(int capacity)
+    {   m_pool.resize(capacity); m_oldest=m_newest=0; m_nframe=0; }
+
+    int capacity() const {return m_pool.size();}
+    int size() const {return m_nframe;}
+    bool isEmpty() const {return m_nframe == 0;}
+    bool isFull() const {return m_nframe == m_pool.size();}
+
+    // Producer only. The queue must not be full.
+    Frame& updNewest() {assert(!isFull()); return m_pool[m_newest];}
+    // Producer only. Make the newest frame visible to the consumer and return
+    // the number of frames now in the queue.
+    int push() {
+        m_newest = (m_newest+1) % m_pool.size();
+        return ++m_nframe;
+    }
+
+    // Consumer only. The queue must not be empty.
+    const Frame& getOldest() const {assert(!isEmpty()); return m_pool[m_oldest];}
+    // Consumer only. Give the oldest frame back to the producer and return
+    // the number of frames left in the queue.
+    int pop() {
+        m_oldest = (m_oldest+1) % m_pool.size();
+        return --m_nframe;
+    }
+
+private:
+    Array_<Frame,int>   m_pool;   // fixed size, old to new order but circular
+    int                 m_oldest; // index into pool; consumer only
+    int                 m_newest; // next slot to fill; producer only
+    std::atomic<int>    m_nframe; // number of valid entries
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_VISUALIZER_FRAME_QUEUE_H_
@@ -450,22 +450,48 @@ void VisualizerProtocol::stopListeningIfNecessary() {
     }
 }
 
+// The scene is collected in memory and sent by finishScene() with a single
+// write, either in full or as an update to the previous scene.
 void VisualizerProtocol::beginScene(Real time) {
     sceneLockBeginFinishScene.lock();
-    char command = StartOfScene;
-    WRITE(outPipe, &command, 1);
-    float fTime = (float)time;
-    WRITE(outPipe, &fTime, sizeof(float));
+    sceneTime = (float)time;
+    sceneData.clear();
+    poseOffsets.clear();
     // The sceneMutex is NOT unlocked at the end of this scope
     // (sceneLockBeginFinishScene is a member variable); see finishScene().
 }
 
 void VisualizerProtocol::finishScene() {
-    char command = EndOfScene;
-    WRITE(outPipe, &command, 1);
+    sceneData.push_back(EndOfScene);
+    try {
+        writeSceneOrUpdate();
+    } catch (...) {
+        sceneLockBeginFinishScene.unlock();
+        throw;
+    }
     sceneLockBeginFinishScene.unlock();
 }
 
+void VisualizerProtocol::
+addSceneElement(const void* element, int size, int poseOffset) {
+    poseOffsets.push_back((int)sceneData.size() + poseOffset);
+    const char* bytes = (const char*)element;
+    sceneData.insert(sceneData.end(), bytes, bytes+size);
+}
+
+// If only the poses have changed since the last scene we sent, which is
+// typical when nothing but the State's positions differ, just send the poses
+// that changed. Otherwise send the whole scene. 
+void VisualizerProtocol::writeSceneOrUpdate() {
+    encodeScene(sceneTime, sceneData, poseOffsets,
+                prevSceneData, prevPoseOffsets, message);
+    WRITE(outPipe, &message[0], (unsigned)message.size());
+
+    // The GUI now has this scene; it is the base for the next update.
+    sceneData.swap(prevSceneData);
+    poseOffsets.swap(prevPoseOffsets);
+}
+
 void VisualizerProtocol::drawBox(const Transform& X_GB, const Vec3& scale, const Vec4& color, int representation) {
     drawMesh(X_GB, scale, color, (short) representation, MeshBox, 0);
 }
@@ -560,6 +586,7 @@ void VisualizerProtocol::drawPolygonalMesh(const PolygonalMesh& mesh, const Tran
         "VisualizerProtocol::drawPolygonalMesh()",
         "Too many unique DecorativeMesh objects; max is 65535.");
     
+    // This goes to the GUI right away, ahead of the scene that uses it.
     meshes[impl] = (unsigned short)index;    // insert new mesh
     WRITE(outPipe, &DefineMesh, 1);
     unsigned short numVertices = (unsigned short)(vertices.size()/3);
@@ -580,7 +607,8 @@ drawMesh(const Transform& X_GM, const Vec3& scale, const Vec4& color,
                     ? AddPointMesh 
                     : (representation == DecorativeGeometry::DrawWireframe 
                         ? AddWireframeMesh : AddSolidMesh));
-    WRITE(outPipe, &command, 1);
+    char element[1 + 13*sizeof(float) + 2*sizeof(unsigned short)];
+    element[0] = command;
     float buffer[13];
     Vec3 rot = X_GM.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -596,17 +624,19 @@ drawMesh(const Transform& X_GM, const Vec3& scale, const Vec4& color,
     buffer[10] = (float) color[1];
     buffer[11] = (float) color[2];
     buffer[12] = (float) color[3];
-    WRITE(outPipe, buffer, 13*sizeof(float));
+    memcpy(element+1, buffer, 13*sizeof(float));
     unsigned short buffer2[2];
     buffer2[0] = meshIndex;
     buffer2[1] = resolution;
-    WRITE(outPipe, buffer2, 2*sizeof(unsigned short));
+    memcpy(element+1+13*sizeof(float), buffer2, 2*sizeof(unsigned short));
+    addSceneElement(element, sizeof(element), 1);
 }
 
 void VisualizerProtocol::
 drawLine(const Vec3& end1, const Vec3& end2, const Vec4& color, Real thickness)
 {
-    WRITE(outPipe, &AddLine, 1);
+    char element[1 + 10*sizeof(float)];
+    element[0] = AddLine;
     float buffer[10];
     buffer[0] = (float) color[0];
     buffer[1] = (float) color[1];
@@ -618,7 +648,8 @@ drawLine(const Vec3& end1, const Vec3& end2, const Vec4& color, Real thickness)
     buffer[7] = (float) end2[0];
     buffer[8] = (float) end2[1];
     buffer[9] = (float) end2[2];
-    WRITE(outPipe, buffer, 10*sizeof(float));
+    memcpy(element+1, buffer, 10*sizeof(float));
+    addSceneElement(element, sizeof(element), 1 + 4*sizeof(float));
 }
 
 void VisualizerProtocol::
@@ -628,7 +659,8 @@ drawText(const Transform& X_GT, const Vec3& scale, const Vec4& color,
         "VisualizerProtocol::drawText()",
         "Can't display DecorativeText longer than 256 characters;"
         " received text of length %u.", (unsigned)string.size());
-    WRITE(outPipe, &AddText, 1);
+    char element[1 + 12*sizeof(float) + 3*sizeof(short) + 256];
+    element[0] = AddText;
     float buffer[12];
     const Vec3 rot = X_GT.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -643,19 +675,22 @@ drawText(const Transform& X_GT, const Vec3& scale, const Vec4& color,
     buffer[9] = (float) color[0];
     buffer[10]= (float) color[1];
     buffer[11]= (float) color[2];
-    WRITE(outPipe, buffer, 12*sizeof(float));
-    short face = (short)faceCamera;
-    WRITE(outPipe, &face, sizeof(short));
-    short screen = (short)isScreenText;
-    WRITE(outPipe, &screen, sizeof(short));
-    short length = (short)string.size();
-    WRITE(outPipe, &length, sizeof(short));
-    WRITE(outPipe, &string[0], length);
+    memcpy(element+1, buffer, 12*sizeof(float));
+    short shorts[3];
+    shorts[0] = (short)faceCamera;
+    shorts[1] = (short)isScreenText;
+    shorts[2] = (short)string.size();
+    memcpy(element+1+12*sizeof(float), shorts, 3*sizeof(short));
+    memcpy(element+1+12*sizeof(float)+3*sizeof(short), string.c_str(), 
+           string.size());
+    addSceneElement(element, 
+        (int)(1 + 12*sizeof(float) + 3*sizeof(short) + string.size()), 1);
 }
 
 void VisualizerProtocol::
 drawCoords(const Transform& X_GF, const Vec3& axisLengths, const Vec4& color) {
-    WRITE(outPipe, &AddCoords, 1);
+    char element[1 + 12*sizeof(float)];
+    element[0] = AddCoords;
     float buffer[12];
     const Vec3 rot = X_GF.R().convertRotationToBodyFixedXYZ();
     buffer[0] = (float) rot[0];
@@ -670,7 +705,8 @@ drawCoords(const Transform& X_GF, const Vec3& axisLengths, const Vec4& color) {
     buffer[9] = (float) color[0];
     buffer[10]= (float) color[1];
     buffer[11]= (float) color[2];
-    WRITE(outPipe, buffer, 12*sizeof(float));
+    memcpy(element+1, buffer, 12*sizeof(float));
+    addSceneElement(element, sizeof(element), 1);
 }
 
 void VisualizerProtocol::
@@ -29,6 +29,9 @@
 #include <utility>
 #include <map>
 #include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 
 /** @file
  * This file defines commands that are used for communication between the 
@@ -37,7 +40,7 @@
 
 // Increment this every time you make *any* change to the protocol;
 // we insist on an exact match.
-static const unsigned ProtocolVersion   = 34;
+static const unsigned ProtocolVersion   = 35;
 
 // The visualizer has several predefined cached meshes for common
 // shapes so that we don't have to send them. These are the mesh 
@@ -87,6 +90,84 @@ static const unsigned char SetShowSimTime        = 28;
 static const unsigned char SetShowFrameNumber    = 29;
 static const unsigned char Shutdown              = 30;
 static const unsigned char StopCommunication     = 31;
+static const unsigned char UpdateScene           = 32;
+
+// Scene data is everything that follows the StartOfScene command and its
+// time, up to and including EndOfScene. Each scene element carries exactly
+// NumPoseFloats floats giving its placement: the body-fixed XYZ angles and
+// position for meshes, text and coordinate frames, and the two end points for
+// lines. When a scene differs from the previous one only in those floats we
+// send UpdateScene instead: the time, the number of changed elements, and for
+// each one the byte offset of its pose within the previous scene data (an int)
+// followed by the new pose. Meshes are never defined inside a scene.
+static const int           NumPoseFloats         = 6;
+
+// Replace message with what is to be sent for a scene (data and pose offsets
+// as described above) when the GUI already has the previous one: UpdateScene
+// with just the changed poses if the scenes differ only in their poses,
+// otherwise StartOfScene with the whole scene. Return true for an update.
+inline bool encodeScene(float time,
+                        const std::vector<char>& sceneData,
+                        const std::vector<int>&  poseOffsets,
+                        const std::vector<char>& prevSceneData,
+                        const std::vector<int>&  prevPoseOffsets,
+                        std::vector<char>&       message) {
+    const int poseBytes = NumPoseFloats*sizeof(float);
+    const int nBytes = (int)sceneData.size();
+    bool canUpdate = nBytes == (int)prevSceneData.size()
+                     && poseOffsets == prevPoseOffsets;
+    // Compare the bytes between the poses.
+    for (int i=0, start=0; canUpdate && i <= (int)poseOffsets.size(); ++i) {
+        const int end = i < (int)poseOffsets.size() ? poseOffsets[i] : nBytes;
+        canUpdate = std::equal(sceneData.begin()+start, sceneData.begin()+end,
+                               prevSceneData.begin()+start);
+        start = end + poseBytes;
+    }
+
+    const char* timeBytes = (const char*)&time;
+    message.clear();
+    if (!canUpdate) {
+        message.push_back(StartOfScene);
+        message.insert(message.end(), timeBytes, timeBytes + sizeof(float));
+        message.insert(message.end(), sceneData.begin(), sceneData.end());
+        return false;
+    }
+
+    message.push_back(UpdateScene);
+    message.insert(message.end(), timeBytes, timeBytes + sizeof(float));
+    const int countAt = (int)message.size();
+    message.resize(countAt + sizeof(int));
+    int numChanged = 0;
+    for (const int offset : poseOffsets) {
+        const auto pose = sceneData.begin() + offset;
+        if (std::equal(pose, pose+poseBytes, prevSceneData.begin()+offset))
+            continue;
+        message.insert(message.end(), (const char*)&offset,
+                       (const char*)&offset + sizeof(int));
+        message.insert(message.end(), pose, pose+poseBytes);
+        ++numChanged;
+    }
+    memcpy(&message[countAt], &numChanged, sizeof(int));
+    return true;
+}
+
+// The GUI's side of encodeScene(): apply an UpdateScene message, following
+// its time, to the sceneSize bytes of data kept from the last full scene.
+// readData(buffer, n) must supply the next n bytes of the message.
+template <class ReadData>
+void applySceneUpdate(ReadData readData, unsigned char* sceneData,
+                      int sceneSize) {
+    const int poseBytes = NumPoseFloats*sizeof(float);
+    int numChanged;
+    readData((unsigned char*)&numChanged, sizeof(int));
+    for (int i=0; i < numChanged; ++i) {
+        int offset;
+        readData((unsigned char*)&offset, sizeof(int));
+        SimTK_ASSERT_ALWAYS(offset >= 0 && offset + poseBytes <= sceneSize,
+            "Unexpected scene update sent to visualizer");
+        readData(sceneData + offset, poseBytes);
+    }
+}
 
 
 // Events sent from the GUI back to the simulation application.
@@ -157,8 +238,19 @@ private:
     void drawMesh(const Transform& transform, const Vec3& scale, 
                   const Vec4& color, short representation, 
                   unsigned short meshIndex, unsigned short resolution);
+    // Append a scene element to sceneData; its pose floats start at 
+    // poseOffset bytes into the element.
+    void addSceneElement(const void* element, int size, int poseOffset);
+    void writeSceneOrUpdate();
     int outPipe;
 
+    // The scene being built between beginScene() and finishScene(), and the
+    // last one sent, with the byte offsets of all their pose floats.
+    float               sceneTime;
+    std::vector<char>   sceneData, prevSceneData;
+    std::vector<int>    poseOffsets, prevPoseOffsets;
+    std::vector<char>   message; // reused to send each scene
+
     // For user-defined meshes, map their unique memory addresses to the 
     // assigned visualizer cache index.
     mutable std::map<const void*, unsigned short> meshes;
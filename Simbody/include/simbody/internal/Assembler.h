@@ -391,6 +391,83 @@ void updateFromInternalState(State& state) const {
 }
 /*@}*/
 
+/** @name                    Batch tracking
+These methods track a whole trial of observation frames in one call. The 
+observations for every frame are supplied up front in a Trial, and the 
+resulting q's are written into a Matrix with one column per frame. Each frame
+is solved with track(), warm started from a q predicted by linear 
+extrapolation of the two previous solutions in the same segment. A trial may 
+be split into independent segments (for example at gaps in the data), which 
+can then be tracked concurrently by several identically-configured 
+Assemblers. **/
+/*@{*/
+
+/** The observations for a sequence of frames to be tracked by trackTrial().
+The observations for all frames are stored contiguously, frame by frame, so
+frame f's observations for a Markers condition with nObs observations are
+entries [f*nObs, (f+1)*nObs) of markerObservations, in ObservationIx order;
+likewise for an OrientationSensors condition. Use NaN for missing 
+observations, as usual. **/
+struct Trial {
+    /** The time of each frame; this also sets the number of frames. **/
+    Vector                  frameTimes;
+    /** The index returned when a Markers condition was adopted; leave it 
+    invalid if there are no marker observations. **/
+    AssemblyConditionIndex  markers;
+    /** nFrames*nObs marker locations in Ground, frame by frame. **/
+    Array_<Vec3>            markerObservations;
+    /** The index returned when an OrientationSensors condition was adopted;
+    leave it invalid if there are no orientation observations. **/
+    AssemblyConditionIndex  osensors;
+    /** nFrames*nObs sensor orientations in Ground, frame by frame. **/
+    Array_<Rotation>        osensorObservations;
+    /** The first frame of each independent segment in increasing order. If
+    this is empty the whole trial is a single segment. **/
+    Array_<int>             segmentStarts;
+};
+
+/** Statistics for one frame tracked by trackTrial(). The evaluation counts
+are the increments in getNumGoalEvals() etc. while tracking the frame. **/
+struct FrameStats {
+    FrameStats() : goal(NaN), realTime(0), nGoalEvals(0), nErrorEvals(0),
+                   nGoalGradientEvals(0), nErrorJacobianEvals(0) {}
+    Real    goal;       ///< Value returned by track().
+    double  realTime;   ///< Elapsed time for the frame, in seconds.
+    int     nGoalEvals, nErrorEvals, nGoalGradientEvals, nErrorJacobianEvals;
+};
+
+/** Track every frame of a Trial, one segment after another. Each segment
+starts from the internal State as it was when this was called. The Assembler
+should already have been initialized and assembled as for track(). 
+@param[in]      trial
+    The frame times and observations.
+@param[out]     qTrajectory
+    The internal State's q's (using Euler angles) after each frame, one 
+    column per frame. This is resized to nq X nFrames only if it doesn't 
+    have that size already.
+@param[out]     stats
+    If given, this is resized to nFrames and filled with per-frame 
+    statistics.
+Any exception thrown by track() is propagated; the frames that were already
+tracked have their results. **/
+void trackTrial(const Trial& trial, Matrix& qTrajectory,
+                Array_<FrameStats>* stats = 0);
+
+/** Track the segments of a Trial concurrently, using one thread for each
+of the given Assemblers. These must all have been constructed for the same
+System and configured identically, with the same assembly conditions adopted
+in the same order, and are typically initialized from the same assembled 
+State. Assembler i tracks segments i, i+n, i+2n, ... where n is the number 
+of Assemblers. Every segment is started from the first Assembler's internal
+State as it was when this was called, so the results are the same as those
+of the serial trackTrial() on that Assembler whatever n is. If tracking 
+fails in more than one segment the exception from the earliest one is 
+rethrown. See the other signature for the arguments. **/
+static void trackTrial(const Array_<Assembler*>& assemblers,
+                       const Trial& trial, Matrix& qTrajectory,
+                       Array_<FrameStats>* stats = 0);
+/*@}*/
+
 /** @name                Parameter restrictions
 These methods restrict which q's are allowed to be modified while trying
 to assemble the system, or restrict the range within which the final q's
@@ -620,6 +697,17 @@ Vector getFreeQsFromInternalState() const {
 void reinitializeWithExtraQsLocked
     (const Array_<QIndex>& toBeLocked) const;
 
+// Check the Trial's contents against this Assembler's conditions; return
+// the number of frames.
+int checkTrial(const Trial& trial) const;
+
+// Track frames [first,end) of a Trial as a single segment, starting from 
+// the given free q's, writing columns of qTrajectory and entries of stats 
+// (if non-null), which must already be the right size.
+void trackSegment(const Trial& trial, const Vector& seedFreeQs,
+                  int first, int end, Matrix& qTrajectory, 
+                  Array_<FrameStats>* stats);
+
 
 
 //------------------------------------------------------------------------------
@@ -686,6 +774,9 @@ mutable Optimizer*       optimizer;
 mutable int nAssemblySteps;   // count assemble() and track() calls
 mutable int nInitializations; // # times we had to reinitialize
 
+// Threads for the static trackTrial(); created there when needed.
+ParallelExecutor* trackExecutor;
+
 friend class AssemblerSystem;
 };
 
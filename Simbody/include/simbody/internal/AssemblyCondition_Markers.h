@@ -480,6 +480,7 @@ int calcGoalGradient(const State& state, Vector& grad) const override;
 //------------------------------------------------------------------------------
 const Marker& getMarker(MarkerIx i) const {return markers[i];}
 Marker& updMarker(MarkerIx i) {uninitializeAssembler(); return markers[i];}
+Real calcTotalWeight() const;
 
                                 // data members                               
                                
@@ -489,6 +489,7 @@ int calcGoalGradient(const State& state, Vector& grad) const override;
 //------------------------------------------------------------------------------
 const OSensor& getOSensor(OSensorIx i) const {return osensors[i];}
 OSensor& updOSensor(OSensorIx i) {uninitializeAssembler(); return osensors[i];}
+Real calcTotalWeight() const;
 
                                 // data members                               
                                
@@ -57,6 +57,7 @@ public:
 
     // For constraint:
     int getNumEquations(const State&) const {return 1;}
+    int getNumErrors(const State&) const override {return 1;}
     int calcErrors(const State& state, Vector& error) const override {
         const SimbodyMatterSubsystem& matter = getMatterSubsystem();
         const MobilizedBody& mobod = matter.getMobilizedBody(mobodIndex);
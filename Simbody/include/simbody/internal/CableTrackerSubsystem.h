@@ -80,6 +80,18 @@ const CablePath& getCablePath(CablePathIndex cableIx) const;
 /** Get writable access to a particular cable path. **/
 CablePath& updCablePath(CablePathIndex cableIx);
 
+/** Set the number of threads used to solve for the cable paths. Each 
+CablePath is solved independently, at Position stage for its path and length
+and at Velocity stage for its rate of length change, so with more than one
+thread the paths are done concurrently. The results are the same regardless
+of the number of threads. This is worthwhile for models with many cables 
+that wrap over surface obstacles. The default is 1.
+@see getNumberOfThreads() **/
+void setNumberOfThreads(int numThreads);
+/** Return the number of threads used to solve for the cable paths.
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
+
 /** @cond **/ // Hide from Doxygen.
 SimTK_PIMPL_DOWNCAST(CableTrackerSubsystem, Subsystem);
 class Impl;
@@ -85,6 +85,22 @@ has not been set.
 @see getDissipatedEnergy(),setDissipatedEnergy(),setTrackDissipatedEnergy() **/
 bool getTrackDissipatedEnergy() const;
 
+/** Set the number of threads used to calculate contact forces. Each active
+Contact is independent so their forces are calculated concurrently; and when
+there is a single large triangle mesh contact, its ElasticFoundation springs
+are instead divided into batches of faces that are done concurrently. Either
+way the partial results are combined in a fixed order, so the contact forces,
+potential energy, and dissipated power are the same regardless of the number
+of threads. The default is 1.
+
+@note Any ContactForceGenerator you add with adoptForceGenerator() must then
+be safe to call concurrently for different Contacts; the built-in ones are. 
+@see getNumberOfThreads() **/
+void setNumberOfThreads(int numThreads);
+/** Return the number of threads used to calculate contact forces.
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
+
 /** Determine how many of the active Contacts are currently generating
 contact forces. You can call this at Velocity stage or later; the contact
 forces will be realized first if necessary before we report how many there 
@@ -807,14 +823,14 @@ void calcContactForceAndDetails
 
 void calcWeightedPatchCentroid
    (const ContactGeometry::TriangleMesh&    mesh,
-    const std::set<int>&                    insideFaces,
+    const Array_<int>&                      insideFaces,
     Vec3&                                   weightedPatchCentroid,
     Real&                                   patchArea) const;
                        
 void processOneMesh
    (const State&                            state,
     const ContactGeometry::TriangleMesh&    mesh,
-    const std::set<int>&                    insideFaces,
+    const Array_<int>&                      insideFaces,
     const Transform&                        X_MO, 
     const SpatialVec&                       V_MO,
     const ContactGeometry&                  other,
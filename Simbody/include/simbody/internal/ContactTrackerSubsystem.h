@@ -243,6 +243,56 @@ be false. If no tracker was registered, this will be the default tracker. **/
 const ContactTracker& getContactTracker(ContactGeometryTypeId surface1, 
                                         ContactGeometryTypeId surface2,
                                         bool& reverseOrder) const;
+
+/** Algorithms available for the "broad phase", which uses a bounding sphere
+around each contact surface to weed out pairs of surfaces that can't possibly
+be touching before any ContactTracker is invoked. All of them produce the same
+set of surface pairs; they differ only in how fast they do it.
+@see setBroadPhaseMethod() **/
+enum BroadPhaseMethod {
+    /** Sort the bounding spheres from scratch along the single axis with 
+    the greatest spread at each evaluation, and sweep along that axis. This
+    keeps no history but degrades to quadratic cost when many surfaces 
+    overlap along that axis, as in a pile of objects resting on a plane. **/
+    SingleAxisSweep             = 0,
+    /** (Default) Sweep and prune on all three axes, keeping the sorted 
+    lists from the previous evaluation of the same State and re-sorting them
+    incrementally. Cost is nearly linear in the number of surfaces when 
+    surfaces move only a little between evaluations. The boxes are slightly
+    enlarged and are moved only when a surface leaves its box, so surfaces
+    at rest cost almost nothing. **/
+    IncrementalSweepAndPrune    = 1,
+    /** A bounding volume hierarchy of slightly enlarged boxes, updated only
+    for surfaces that have moved out of their boxes. This is a good choice 
+    when surfaces are spread out in all three directions and some of them 
+    move rapidly. **/
+    DynamicAABBTree             = 2
+};
+
+/** Select the broad phase algorithm to be used. This can be changed at any
+time; the next evaluation of contacts will use the new method. The default
+is IncrementalSweepAndPrune. **/
+void setBroadPhaseMethod(BroadPhaseMethod method);
+
+/** Return the broad phase algorithm currently in use.
+@see setBroadPhaseMethod() **/
+BroadPhaseMethod getBroadPhaseMethod() const;
+
+/** Set the number of threads used for the "narrow phase", in which the 
+ContactTracker for each pair of surfaces that survived the broad phase decides
+whether they are actually in contact. Pairs are independent so they are 
+tracked concurrently, which pays off when some of them are expensive, such as
+pairs of triangle meshes. The resulting ContactSnapshot, including the order 
+of the contacts and the ContactIds assigned to new ones, is identical to the 
+one produced by a single thread. The default is 1. 
+
+@note Any ContactTracker you add with adoptContactTracker() must then be safe
+to call concurrently for different surface pairs; the built-in ones are. **/
+void setNumberOfThreads(int numThreads);
+
+/** Return the number of threads used for the narrow phase.
+@see setNumberOfThreads() **/
+int getNumberOfThreads() const;
 /**@}**/
 
 /**@name                     Advanced/Obscure
@@ -58,6 +58,14 @@ public:
     /// be at Dynamics stage or later.
     virtual Real calcPotentialEnergy(const State& state) const = 0;
 
+    /// Add in this subsystem's contribution to the partial derivatives of the
+    /// mobility forces with respect to the matter subsystem's q and u, if it
+    /// can. The state must be at Dynamics stage or later. The default does
+    /// nothing, leaving this subsystem's forces out of the System's
+    /// approximate Jacobian; see MultibodySystem.
+    virtual void addInMobilityForcePartials(const State& state, Matrix& dfdq,
+                                            Matrix& dfdu) const {}
+
     SimTK_DOWNCAST(ForceSubsystem::Guts, Subsystem::Guts);
 };
 
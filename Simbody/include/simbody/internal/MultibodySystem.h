@@ -44,6 +44,14 @@ having exactly one SimbodyMatterSubsystem, and we would like also to have:
     - a DecorationSubsystem for visualization
     - a GeneralContactSubsystem for contact geometry
 There will also be a generic System-level "subsystem" for global variables.
+
+A %MultibodySystem supplies System::calcYDotJacobian() for an unconstrained
+tree with no prescribed motion, built from the matter subsystem's exact 
+acceleration partial derivatives plus the mobility force partials of the
+force elements that provide them (the mobility springs, dampers and stops 
+and Force::GlobalDamper). Other force elements, such as gravity, are held 
+fixed, and the dependence of N(q) on q is left out, so this is an 
+approximation meant for the iteration matrix of an implicit integrator.
 **/
 class SimTK_SIMBODY_EXPORT MultibodySystem : public System {
 public:
@@ -205,6 +205,76 @@ void setShowDefaultGeometry(bool show);
 geometry that can be used to visualize this multibody system. **/
 bool getShowDefaultGeometry() const;
 
+/** Set the number of threads this matter subsystem may use for its recursive
+base-to-tip and tip-to-base sweeps (position and velocity kinematics, 
+articulated body inertias, and the forward dynamics operator). Bodies at the 
+same level of the multibody tree are independent during those sweeps, so for
+models with wide levels (many branches, or many free bodies attached to 
+Ground) they can be processed concurrently. Results are bit-identical to the
+serial computation. The default is 1, meaning all sweeps are done serially on
+the calling thread. Levels with fewer bodies than the threshold set by
+setParallelSweepThreshold() are always swept serially.
+
+@note This method should NOT be called while realizing a State. If you use
+Custom mobilizers, their implementations must be safe to call concurrently
+for different bodies. **/
+void setNumberOfThreads(unsigned numThreads);
+
+/** Return the number of threads this matter subsystem may use for its 
+recursive sweeps; see setNumberOfThreads(). **/
+int getNumberOfThreads() const;
+
+/** Set the minimum number of bodies that a tree level must have before its
+bodies are processed concurrently; narrower levels are swept serially since
+the threading overhead would outweigh the gain. This has no effect unless
+setNumberOfThreads() has been called with more than one thread. The default
+is 16. **/
+void setParallelSweepThreshold(int minBodiesPerLevel);
+
+/** Return the minimum number of bodies a tree level must have to be swept in
+parallel; see setParallelSweepThreshold(). **/
+int getParallelSweepThreshold() const;
+
+/** Set the number of acceleration-level constraint equations at or above which
+forward dynamics will try a sparse factorization of the mXm constraint-space
+matrix G M^-1 ~G rather than the dense one. Two constraint equations are
+coupled in that matrix only if they involve a common subtree hanging from
+Ground, so models made up of many separate loops or closed chains give a
+sparse matrix. Its structure is analyzed once whenever Stage::Instance is
+realized and the analysis, including a fill-reducing ordering, is reused for
+every factorization after that. If the factor would not be sparse enough, or
+if the constraints turn out to be redundant, the dense rank-revealing method 
+is used instead, so results are the same up to roundoff either way. The 
+default is 100 equations. **/
+void setSparseConstraintSolverThreshold(int minNumEquations);
+
+/** Return the number of constraint equations at or above which the sparse 
+constraint solver is tried; see setSparseConstraintSolverThreshold(). **/
+int getSparseConstraintSolverThreshold() const;
+
+/** Set how many times a factored constraint matrix may be reused after it was
+computed before it must be recalculated. This applies to the matrix G M^-1 ~G
+used to calculate constraint forces during forward dynamics, and to the 
+weighted constraint Jacobians used by position and velocity projection. These
+are kept in the State and ordinarily refactored every time they are needed,
+although within an integrator step the configuration changes very little from
+one stage to the next. With a nonzero limit an earlier factorization is used
+instead: multipliers are corrected by iterative refinement, and projection 
+becomes a modified Newton iteration. Whenever that fails to converge rapidly,
+or the limit has been reached, a fresh factorization is made and the count 
+restarts. Projection never reuses a factorization if the ProjectOptions::
+ForceFullNewton option is set (see Integrator::setForceFullNewton()). All
+factorizations are discarded when Stage::Instance is invalidated.
+
+The default is 0, meaning that every factorization is computed from scratch. 
+Results obtained with reuse satisfy the constraints to the same tolerances 
+but are not bit-identical to those obtained without it. **/
+void setConstraintFactorReuseLimit(int maxReuses);
+
+/** Return the number of times a constraint matrix factorization may be reused;
+see setConstraintFactorReuseLimit(). **/
+int getConstraintFactorReuseLimit() const;
+
 /** The number of bodies includes all mobilized bodies \e including Ground,
 which is the first mobilized body, at MobilizedBodyIndex 0. (Note: if 
 special particle handling were implemented, the count here would \e not 
@@ -2170,6 +2240,172 @@ void calcResidualForce
     Vector&                    residualMobilityForces) const;
 
 
+/** This is the directional derivative of the inverse dynamics operator
+calcResidualForceIgnoringConstraints(). Treating
+<pre>
+     f_residual(q,u,udot) = M(q) udot + f_inertial(q,u) - f_applied
+</pre>
+as a function of q, u and udot with the applied forces held fixed, this
+returns both f_residual and its derivative along a direction (dq,du,dudot),
+that is
+<pre>
+     df_residual = d f_residual/dq * dq + d f_residual/du * du + M(q) dudot
+</pre>
+in one O(n) sweep. The two inverse dynamics passes are done with the Dual
+number type in place of Real, so the derivative is exact to roundoff rather
+than a finite difference approximation;  residualMobilityForces agrees
+with calcResidualForceIgnoringConstraints() to roundoff.
+
+<b>Supported mobilizers:</b> the dependence on q is available only for
+mobilizers whose hinge matrix H_FM is independent of q. Those are Pin,
+Slider, Cylinder, Screw, Planar, Translation, Ball, Free and Weld, used in
+the forward direction. Gimbal, Universal, Bushing, Ellipsoid,
+LineOrientation, FreeLine, BendStretch, SphericalCoords, Custom and
+FunctionBased mobilizers, and any reversed mobilizer, are \e not supported;
+an exception is thrown if the system contains one. This restriction applies
+to all four of the derivative operators here. For such systems, use finite
+differences of calcResidualForceIgnoringConstraints() or
+calcAccelerationIgnoringConstraints() instead.
+
+@param[in] state
+     A State realized to Stage::Velocity.
+@param[in] appliedMobilityForces, appliedBodyForces, knownUdot
+     As for calcResidualForceIgnoringConstraints(); each may be zero length
+     meaning all zero.
+@param[in] dq
+     The direction in q, of length nq or zero length meaning all zero.
+@param[in] du
+     The direction in u, of length nu or zero length meaning all zero.
+@param[in] dudot
+     The direction in udot, of length nu or zero length meaning all zero.
+@param[out] residualMobilityForces
+     The residual generalized forces, resized to nu if necessary.
+@param[out] dResidualMobilityForces
+     Their derivative along (dq,du,dudot), resized to nu if necessary.
+
+@par Required stage
+  \c Stage::Velocity 
+
+@see calcAccelerationIgnoringConstraintsDirectionalDerivative() **/
+void calcResidualForceIgnoringConstraintsDirectionalDerivative
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForces,
+    const Vector&              knownUdot,
+    const Vector&              dq,
+    const Vector&              du,
+    const Vector&              dudot,
+    Vector&                    residualMobilityForces,
+    Vector&                    dResidualMobilityForces) const;
+
+/** This is the directional derivative of the forward dynamics operator
+calcAccelerationIgnoringConstraints(). With the applied forces held fixed,
+it returns udot(q,u) and its derivative
+<pre>
+     dudot = d udot/dq * dq + d udot/du * du
+</pre>
+along the direction (dq,du). Since f_residual(q,u,udot(q,u)) is identically
+zero, this is dudot = -M^-1 df_residual, with df_residual from
+calcResidualForceIgnoringConstraintsDirectionalDerivative() with no change
+in udot. The cost is that of a forward dynamics, an inverse dynamics sweep
+in Dual arithmetic, and a multiplyByMInv().
+
+Prescribed motion is not supported and neither are the mobilizers excluded
+by calcResidualForceIgnoringConstraintsDirectionalDerivative(); an exception
+is thrown for those.
+
+@param[in] state
+     A State realized to Stage::Dynamics.
+@param[in] appliedMobilityForces, appliedBodyForces
+     As for calcAccelerationIgnoringConstraints().
+@param[in] dq
+     The direction in q, of length nq or zero length meaning all zero.
+@param[in] du
+     The direction in u, of length nu or zero length meaning all zero.
+@param[out] udot
+     The generalized accelerations, resized to nu if necessary.
+@param[out] dudot
+     Their derivative along (dq,du), resized to nu if necessary.
+
+@par Required stage
+  \c Stage::Dynamics **/
+void calcAccelerationIgnoringConstraintsDirectionalDerivative
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               dq,
+    const Vector&               du,
+    Vector&                     udot,
+    Vector&                     dudot) const;
+
+/** Calculate the partial derivatives of the residual forces of
+calcResidualForceIgnoringConstraints() with respect to q and u, with the
+applied forces and \a knownUdot held fixed. The partial derivative with
+respect to udot is the mass matrix; see calcM().
+
+Each column is an exact directional derivative from
+calcResidualForceIgnoringConstraintsDirectionalDerivative() along a unit
+direction, so the cost is O(n) per column and O(n^2) in all, with no finite
+differencing. The same mobilizer restrictions apply. Scratch space is
+obtained once per call; there is no allocation per column, and the output
+matrices are written in place if they already have the right dimensions.
+
+@param[in] state
+     A State realized to Stage::Velocity.
+@param[in] appliedMobilityForces, appliedBodyForces, knownUdot
+     As for calcResidualForceIgnoringConstraints(); each may be zero length
+     meaning all zero.
+@param[out] dfdq
+     The nu X nq matrix d f_residual/dq; resized if necessary.
+@param[out] dfdu
+     The nu X nu matrix d f_residual/du; resized if necessary.
+
+@par Required stage
+  \c Stage::Velocity **/
+void calcResidualForceIgnoringConstraintsPartials
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForces,
+    const Vector&              knownUdot,
+    Matrix&                    dfdq,
+    Matrix&                    dfdu) const;
+
+/** Calculate the generalized accelerations of
+calcAccelerationIgnoringConstraints() and their partial derivatives with
+respect to q and u, with the applied forces held fixed.
+
+Column k of each matrix is -M^-1 times the corresponding column of the
+residual force partials, computed as in
+calcAccelerationIgnoringConstraintsDirectionalDerivative(). The cost is one
+forward dynamics and then O(n) per column, O(n^2) in all, where finite
+differencing through realize(Stage::Acceleration) would take O(n)
+realizations. Scratch space is obtained once per call; there is no
+allocation per column, and the output matrices are written in place if they
+already have the right dimensions. Prescribed motion is not supported and
+the same mobilizer restrictions apply.
+
+@param[in] state
+     A State realized to Stage::Dynamics.
+@param[in] appliedMobilityForces, appliedBodyForces
+     As for calcAccelerationIgnoringConstraints().
+@param[out] udot
+     The generalized accelerations, resized to nu if necessary.
+@param[out] dudotdq
+     The nu X nq matrix d udot/dq; resized if necessary.
+@param[out] dudotdu
+     The nu X nu matrix d udot/du; resized if necessary.
+
+@par Required stage
+  \c Stage::Dynamics **/
+void calcAccelerationIgnoringConstraintsPartials
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    Vector&                     udot,
+    Matrix&                     dudotdq,
+    Matrix&                     dudotdu) const;
+
+
 /** This operator calculates the composite body inertias R given a State 
 realized to Position stage. Composite body inertias are the spatial mass 
 properties of the rigid body formed by a particular body and all bodies 
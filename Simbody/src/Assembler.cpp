@@ -27,6 +27,10 @@
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/Assembler.h"
 #include "simbody/internal/AssemblyCondition.h"
+#include "simbody/internal/AssemblyCondition_Markers.h"
+#include "simbody/internal/AssemblyCondition_OrientationSensors.h"
+#include <algorithm>
+#include <exception>
 #include <map>
 #include <iostream>
 using std::cout; using std::endl;
@@ -501,7 +505,8 @@ Assembler::Assembler(const MultibodySystem& system)
 :   system(system), accuracy(0), tolerance(0), // i.e., 1e-3, 1e-4
     forceNumericalGradient(false), forceNumericalJacobian(false), 
     useRMSErrorNorm(false), alreadyInitialized(false), 
-    asmSys(0), optimizer(0), nAssemblySteps(0), nInitializations(0)
+    asmSys(0), optimizer(0), nAssemblySteps(0), nInitializations(0),
+    trackExecutor(0)
 {
     const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
     matter.convertToEulerAngles(system.getDefaultState(),
@@ -522,6 +527,7 @@ Assembler::~Assembler() {
     Array_<AssemblyCondition*,AssemblyConditionIndex>::reverse_iterator p;
     for (p = conditions.rbegin(); p != conditions.rend(); ++p)
         delete *p;
+    delete trackExecutor;
 }
 
 
@@ -978,6 +984,195 @@ Real Assembler::track(Real frameTime) {
     return calcCurrentGoal();
 }
 
+// Segment boundaries of a Trial with nf frames: segment k is frames
+// [bounds[k], bounds[k+1]).
+static void findTrialSegments(const Assembler::Trial& trial, int nf,
+                              Array_<int>& bounds) {
+    bounds.clear();
+    bounds.push_back(0);
+    for (unsigned i=0; i < trial.segmentStarts.size(); ++i) {
+        const int start = trial.segmentStarts[i];
+        SimTK_ERRCHK3_ALWAYS(bounds.back() <= start && start < nf,
+            "Assembler::trackTrial()", "Segment start %d is %d; segment starts"
+            " must be increasing frame numbers less than %d.", 
+            (int)i, start, nf);
+        if (start > bounds.back()) bounds.push_back(start);
+    }
+    if (nf > 0) bounds.push_back(nf);
+}
+
+int Assembler::checkTrial(const Trial& trial) const {
+    const int nf = trial.frameTimes.size();
+    if (trial.markers.isValid()) {
+        SimTK_ERRCHK1_ALWAYS(trial.markers < conditions.size()
+            && dynamic_cast<const Markers*>(conditions[trial.markers]),
+            "Assembler::trackTrial()", "Assembly condition %d is not a"
+            " Markers condition.", (int)trial.markers);
+        const Markers& markers = 
+            static_cast<const Markers&>(*conditions[trial.markers]);
+        SimTK_ERRCHK3_ALWAYS((int)trial.markerObservations.size() 
+                             == nf*markers.getNumObservations(),
+            "Assembler::trackTrial()", "Expected %d frames of %d marker"
+            " observations but got %d observations.", nf, 
+            markers.getNumObservations(), 
+            (int)trial.markerObservations.size());
+    } else 
+        SimTK_ERRCHK_ALWAYS(trial.markerObservations.empty(),
+            "Assembler::trackTrial()", "Marker observations were supplied but"
+            " no Markers condition was specified.");
+
+    if (trial.osensors.isValid()) {
+        SimTK_ERRCHK1_ALWAYS(trial.osensors < conditions.size()
+            && dynamic_cast<const OrientationSensors*>
+                                                (conditions[trial.osensors]),
+            "Assembler::trackTrial()", "Assembly condition %d is not an"
+            " OrientationSensors condition.", (int)trial.osensors);
+        const OrientationSensors& osensors = 
+            static_cast<const OrientationSensors&>(*conditions[trial.osensors]);
+        SimTK_ERRCHK3_ALWAYS((int)trial.osensorObservations.size() 
+                             == nf*osensors.getNumObservations(),
+            "Assembler::trackTrial()", "Expected %d frames of %d orientation"
+            " sensor observations but got %d observations.", nf, 
+            osensors.getNumObservations(), 
+            (int)trial.osensorObservations.size());
+    } else 
+        SimTK_ERRCHK_ALWAYS(trial.osensorObservations.empty(),
+            "Assembler::trackTrial()", "Orientation sensor observations were"
+            " supplied but no OrientationSensors condition was specified.");
+    return nf;
+}
+
+void Assembler::trackSegment(const Trial& trial, const Vector& seedFreeQs,
+                             int first, int end, Matrix& qTrajectory, 
+                             Array_<FrameStats>* stats) {
+    Markers* markers = trial.markers.isValid() 
+        ? static_cast<Markers*>(conditions[trial.markers]) : 0;
+    OrientationSensors* osensors = trial.osensors.isValid() 
+        ? static_cast<OrientationSensors*>(conditions[trial.osensors]) : 0;
+    const int nMarkerObs = markers ? markers->getNumObservations() : 0;
+    const int nOSensorObs = osensors ? osensors->getNumObservations() : 0;
+
+    setInternalStateFromFreeQs(seedFreeQs);
+    Vector freeQs(getNumFreeQs());
+    for (int f=first; f < end; ++f) {
+        // After the first two frames, start from a linear extrapolation of
+        // the previous two solutions rather than from the last one.
+        const Real dt1 = f-first >= 2 
+            ? trial.frameTimes[f-1] - trial.frameTimes[f-2] : Real(0);
+        if (dt1 > 0) {
+            const Real s = (trial.frameTimes[f] - trial.frameTimes[f-1])/dt1;
+            for (FreeQIndex fx(0); fx < getNumFreeQs(); ++fx) {
+                const QIndex qx = getQIndexOfFreeQ(fx);
+                const Real q1 = qTrajectory(qx, f-1), q2 = qTrajectory(qx, f-2);
+                freeQs[fx] = q1 + s*(q1-q2);
+                if (lower.size()) 
+                    freeQs[fx] = clamp(lower[fx], freeQs[fx], upper[fx]);
+            }
+            setInternalStateFromFreeQs(freeQs);
+        }
+
+        for (int i=0; i < nMarkerObs; ++i)
+            markers->moveOneObservation(Markers::ObservationIx(i),
+                trial.markerObservations[f*nMarkerObs + i]);
+        for (int i=0; i < nOSensorObs; ++i)
+            osensors->moveOneObservation(OrientationSensors::ObservationIx(i),
+                trial.osensorObservations[f*nOSensorObs + i]);
+
+        const int nGoal = getNumGoalEvals(), nErr = getNumErrorEvals(),
+                  nGrad = getNumGoalGradientEvals(), 
+                  nJac = getNumErrorJacobianEvals();
+        const double start = realTime();
+
+        const Real goal = track(trial.frameTimes[f]);
+        qTrajectory(f) = internalState.getQ();
+
+        if (stats) {
+            FrameStats& frame = (*stats)[f];
+            frame.realTime = realTime() - start;
+            frame.goal = goal;
+            frame.nGoalEvals = getNumGoalEvals() - nGoal;
+            frame.nErrorEvals = getNumErrorEvals() - nErr;
+            frame.nGoalGradientEvals = getNumGoalGradientEvals() - nGrad;
+            frame.nErrorJacobianEvals = getNumErrorJacobianEvals() - nJac;
+        }
+    }
+}
+
+void Assembler::trackTrial(const Trial& trial, Matrix& qTrajectory,
+                           Array_<FrameStats>* stats) {
+    initialize();
+    const int nf = checkTrial(trial);
+    const int nq = internalState.getNQ();
+    if (qTrajectory.nrow() != nq || qTrajectory.ncol() != nf)
+        qTrajectory.resize(nq, nf);
+    if (stats) stats->resize(nf);
+
+    Array_<int> bounds;
+    findTrialSegments(trial, nf, bounds);
+    const Vector seedFreeQs = getFreeQsFromInternalState();
+    for (int k=0; k+1 < (int)bounds.size(); ++k)
+        trackSegment(trial, seedFreeQs, bounds[k], bounds[k+1], 
+                     qTrajectory, stats);
+}
+
+void Assembler::trackTrial(const Array_<Assembler*>& assemblers,
+                           const Trial& trial, Matrix& qTrajectory,
+                           Array_<FrameStats>* stats) {
+    SimTK_ERRCHK_ALWAYS(!assemblers.empty(), "Assembler::trackTrial()",
+        "At least one Assembler is required.");
+    const int n = assemblers.size();
+    // Each Assembler will be driven by its own thread so none may be repeated.
+    Array_<Assembler*> sorted(assemblers);
+    std::sort(sorted.begin(), sorted.end());
+    SimTK_ERRCHK_ALWAYS(
+        std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end(),
+        "Assembler::trackTrial()", "An Assembler appears more than once.");
+    int nf = 0;
+    for (int i=0; i < n; ++i) {
+        Assembler& assembler = *assemblers[i];
+        SimTK_ERRCHK1_ALWAYS(&assembler.system == &assemblers[0]->system,
+            "Assembler::trackTrial()", 
+            "Assembler %d is for a different System.", i);
+        assembler.initialize();
+        nf = assembler.checkTrial(trial);
+    }
+
+    const int nq = assemblers[0]->internalState.getNQ();
+    if (qTrajectory.nrow() != nq || qTrajectory.ncol() != nf)
+        qTrajectory.resize(nq, nf);
+    if (stats) stats->resize(nf);
+
+    Array_<int> bounds;
+    findTrialSegments(trial, nf, bounds);
+    const int nSegments = (int)bounds.size() - 1;
+
+    // Every segment starts from the first Assembler's current solution, so
+    // the results don't depend on how the segments are divided up. Assembler
+    // i does segments i, i+n, ...; failures are kept by segment so that the
+    // earliest one in the trial is reported.
+    const Vector seedFreeQs = assemblers[0]->getFreeQsFromInternalState();
+    Array_<std::exception_ptr> errors(nSegments);
+    const int nUsed = std::min(n, nSegments);
+    ParallelExecutor*& executor = assemblers[0]->trackExecutor;
+    if (nUsed > 1 && (!executor || executor->getMaxThreads() < nUsed)) {
+        delete executor;
+        executor = new ParallelExecutor(nUsed);
+    }
+    auto trackSegments = [&](int i) {
+        for (int k=i; k < nSegments; k += n) {
+            try {assemblers[i]->trackSegment(trial, seedFreeQs, 
+                    bounds[k], bounds[k+1], qTrajectory, stats);}
+            catch (...) {errors[k] = std::current_exception();}
+        }
+    };
+    if (nUsed > 1)
+        executor->forEach(nUsed, trackSegments);
+    else
+        trackSegments(0);
+    for (int k=0; k < nSegments; ++k)
+        if (errors[k]) std::rethrow_exception(errors[k]);
+}
+
 int Assembler::getNumGoalEvals()  const 
 {   return asmSys ? asmSys->getNumObjectiveEvals() : 0;}
 int Assembler::getNumErrorEvals() const
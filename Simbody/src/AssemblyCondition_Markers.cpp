@@ -134,18 +134,108 @@ int Markers::calcGoalGradient(const State& state, Vector& gradient) const {
     return 0;
 }
 
-// TODO: We want the constraint version to minimize the same goal as above. But
-// there can never be more than six independent constraints on the pose of
-// a rigid body; this method should attempt to produce a minimal set so that
-// the optimizer doesn't have to figure it out.
-int Markers::calcErrors(const State& state, Vector& err) const
-{   return AssemblyCondition::calcErrors(state,err); } //TODO
-
-
-int Markers::calcErrorJacobian(const State& state, Matrix& jacobian) const
-{   return AssemblyCondition::calcErrorJacobian(state,jacobian); } //TODO
-int Markers::getNumErrors(const State& state) const
-{   return AssemblyCondition::getNumErrors(state); } //TODO
+// The constraint version minimizes the same goal as above: there are three
+// errors per active marker, the marker position error scaled by 
+// sqrt(wi/sum(wi)), so that goal = 1/2 err^2. Markers whose observations are
+// NaN in the current frame still occupy their slots so that the number of
+// errors doesn't change from frame to frame, but their errors are zero. Note
+// that this can produce more than six equations per body; the optimizer
+// has to cope with the redundancy.
+int Markers::calcErrors(const State& state, Vector& err) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    err.resize(getNumErrors(state));
+    const Real wtot = calcTotalWeight();
+    int nxt = 0;
+    // Loop over each body that has one or more active markers.
+    PerBodyMarkers::const_iterator bodyp = bodiesWithMarkers.begin();
+    for (; bodyp != bodiesWithMarkers.end(); ++bodyp) {
+        const MobilizedBodyIndex    mobodIx     = bodyp->first;
+        const Array_<MarkerIx>&     bodyMarkers = bodyp->second;
+        const MobilizedBody&        mobod = matter.getMobilizedBody(mobodIx);
+        const Transform&            X_GB  = mobod.getBodyTransform(state);
+        // Loop over each marker on this body.
+        for (unsigned m=0; m < bodyMarkers.size(); ++m, nxt += 3) {
+            const MarkerIx  mx = bodyMarkers[m];
+            const Marker&   marker = markers[mx];
+            const Vec3& location = observations[getObservationIxForMarker(mx)];
+            Vec3 e(0);
+            if (location.isFinite()) // skip NaNs
+                e = std::sqrt(marker.weight/wtot) 
+                    * (X_GB*marker.markerInB - location);
+            err[nxt] = e[0]; err[nxt+1] = e[1]; err[nxt+2] = e[2];
+        }
+    }
+    return 0;
+}
+
+// The Jacobian of marker i's errors is sqrt(wi/sum(wi)) * JSi * N^-1 where JSi
+// is the marker's 3 X nu station Jacobian. We form all the station Jacobians at
+// once, then map each row from u space to q space with ~N^-1, which is cheap
+// since N is block diagonal. Only the columns for the free q's are returned.
+int Markers::calcErrorJacobian(const State& state, Matrix& jacobian) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    const int np = getNumFreeQs();
+    const int nq = state.getNQ();
+    const int nu = state.getNU();
+    const int m  = getNumErrors(state);
+    jacobian.resize(m, np);
+    const Real wtot = calcTotalWeight();
+
+    Array_<MobilizedBodyIndex> onBodies; 
+    Array_<Vec3>               stations;
+    Array_<Real>               scale;
+    PerBodyMarkers::const_iterator bodyp = bodiesWithMarkers.begin();
+    for (; bodyp != bodiesWithMarkers.end(); ++bodyp) {
+        const Array_<MarkerIx>& bodyMarkers = bodyp->second;
+        for (unsigned i=0; i < bodyMarkers.size(); ++i) {
+            const MarkerIx  mx = bodyMarkers[i];
+            const Marker&   marker = markers[mx];
+            const Vec3& location = observations[getObservationIxForMarker(mx)];
+            onBodies.push_back(bodyp->first);
+            stations.push_back(marker.markerInB);
+            scale.push_back(location.isFinite() 
+                            ? std::sqrt(marker.weight/wtot) : Real(0));
+        }
+    }
+
+    Matrix JS(m, nu);
+    if (m) matter.calcStationJacobian(state, onBodies, stations, JS);
+
+    Vector rowU(nu), rowQ(nq);
+    for (int r=0; r < m; ++r) {
+        const Real s = scale[r/3];
+        if (s == 0) {jacobian[r] = 0; continue;}
+        rowU = ~JS[r];
+        matter.multiplyByNInv(state, true, rowU, rowQ);
+        for (Assembler::FreeQIndex fx(0); fx < np; ++fx)
+            jacobian(r,fx) = s * rowQ[getQIndexOfFreeQ(fx)];
+    }
+    return 0;
+}
+
+int Markers::getNumErrors(const State& state) const {
+    int nActive = 0;
+    PerBodyMarkers::const_iterator bodyp = bodiesWithMarkers.begin();
+    for (; bodyp != bodiesWithMarkers.end(); ++bodyp)
+        nActive += bodyp->second.size();
+    return 3*nActive;
+}
+
+// Sum of the weights of the active markers whose observations are present
+// in the current frame.
+Real Markers::calcTotalWeight() const {
+    Real wtot = 0;
+    PerBodyMarkers::const_iterator bodyp = bodiesWithMarkers.begin();
+    for (; bodyp != bodiesWithMarkers.end(); ++bodyp) {
+        const Array_<MarkerIx>& bodyMarkers = bodyp->second;
+        for (unsigned m=0; m < bodyMarkers.size(); ++m) {
+            const MarkerIx mx = bodyMarkers[m];
+            if (observations[getObservationIxForMarker(mx)].isFinite())
+                wtot += markers[mx].weight;
+        }
+    }
+    return wtot;
+}
 
 // Run through all the Markers to find all the bodies that have at least one
 // active marker. For each of those bodies, we collect all its markers so that
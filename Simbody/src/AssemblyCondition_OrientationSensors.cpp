@@ -142,18 +142,135 @@ calcGoalGradient(const State& state, Vector& gradient) const {
     return 0;
 }
 
-// TODO: We want the constraint version to minimize the same goal as above. But
-// there can never be more than six independent constraints on the pose of
-// a rigid body; this method should attempt to produce a minimal set so that
-// the optimizer doesn't have to figure it out.
-int OrientationSensors::calcErrors(const State& state, Vector& err) const
-{   return AssemblyCondition::calcErrors(state,err); } //TODO
-
-
-int OrientationSensors::calcErrorJacobian(const State& state, Matrix& jacobian) const
-{   return AssemblyCondition::calcErrorJacobian(state,jacobian); } //TODO
-int OrientationSensors::getNumErrors(const State& state) const
-{   return AssemblyCondition::getNumErrors(state); } //TODO
+// The constraint version minimizes the same goal as above: there are three
+// errors per active osensor, the rotation vector ai*ui (angle times axis) of 
+// the sensor-to-observation rotation R_SO, expressed in S and scaled by
+// sqrt(wi/sum(wi)), so that goal = 1/2 err^2. OSensors whose observations are
+// NaN in the current frame still occupy their slots so that the number of
+// errors doesn't change from frame to frame, but their errors are zero.
+int OrientationSensors::calcErrors(const State& state, Vector& err) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    err.resize(getNumErrors(state));
+    const Real wtot = calcTotalWeight();
+    int nxt = 0;
+    // Loop over each body that has one or more active osensors.
+    PerBodyOSensors::const_iterator bodyp = bodiesWithOSensors.begin();
+    for (; bodyp != bodiesWithOSensors.end(); ++bodyp) {
+        const MobilizedBodyIndex    mobodIx      = bodyp->first;
+        const Array_<OSensorIx>&    bodyOSensors = bodyp->second;
+        const MobilizedBody&        mobod = matter.getMobilizedBody(mobodIx);
+        const Rotation&             R_GB  = mobod.getBodyRotation(state);
+        // Loop over each osensor on this body.
+        for (unsigned m=0; m < bodyOSensors.size(); ++m, nxt += 3) {
+            const OSensorIx mx = bodyOSensors[m];
+            const OSensor&  osensor = osensors[mx];
+            const Rotation& R_GO = observations[getObservationIxForOSensor(mx)];
+            Vec3 e(0);
+            if (R_GO.isFinite()) { // skip NaNs
+                const Rotation R_GS = R_GB * osensor.orientationInB;
+                const Rotation R_SO = ~R_GS*R_GO; // error, in S
+                const Vec4 aa_SO = R_SO.convertRotationToAngleAxis();
+                e = std::sqrt(osensor.weight/wtot) 
+                    * aa_SO[0] * aa_SO.getSubVec<3>(1);
+            }
+            err[nxt] = e[0]; err[nxt+1] = e[1]; err[nxt+2] = e[2];
+        }
+    }
+    return 0;
+}
+
+// With the error rotation R_SO = ~R_GS*R_GO and the observation fixed, 
+// d/dt R_SO = -w_S x R_SO where w_S is the sensor's angular velocity in 
+// Ground, expressed in S. The rate of change of the rotation vector p=a*u is 
+// then pdot = -inv(Jl(p))*w_S, where inv(Jl(p)) = I - [p]/2 + c*[p]^2 is the 
+// inverse of the left Jacobian of SO(3), with c = (1-(a/2)cot(a/2))/a^2. So 
+// the Jacobian of osensor i's errors is -sqrt(wi/sum(wi)) inv(Jl) ~R_GS JBi 
+// N^-1 where JBi is the angular part of its body's frame Jacobian. As for 
+// Markers, each row is mapped from u space to q space with ~N^-1 and only the
+// free q columns are returned.
+int OrientationSensors::
+calcErrorJacobian(const State& state, Matrix& jacobian) const {
+    const SimbodyMatterSubsystem& matter = getMatterSubsystem();
+    const int np = getNumFreeQs();
+    const int nq = state.getNQ();
+    const int nu = state.getNU();
+    const int m  = getNumErrors(state);
+    jacobian.resize(m, np);
+    const Real wtot = calcTotalWeight();
+
+    Array_<MobilizedBodyIndex> onBodies;
+    Array_<Vec3>               origins;
+    Array_<Mat33>              dpdw; // maps w_G to scaled pdot
+    PerBodyOSensors::const_iterator bodyp = bodiesWithOSensors.begin();
+    for (; bodyp != bodiesWithOSensors.end(); ++bodyp) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(bodyp->first);
+        const Rotation&      R_GB  = mobod.getBodyRotation(state);
+        const Array_<OSensorIx>& bodyOSensors = bodyp->second;
+        for (unsigned i=0; i < bodyOSensors.size(); ++i) {
+            const OSensorIx mx = bodyOSensors[i];
+            const OSensor&  osensor = osensors[mx];
+            const Rotation& R_GO = observations[getObservationIxForOSensor(mx)];
+            onBodies.push_back(bodyp->first);
+            origins.push_back(Vec3(0));
+            if (!R_GO.isFinite()) {dpdw.push_back(Mat33(0)); continue;}
+
+            const Rotation R_GS = R_GB * osensor.orientationInB;
+            const Rotation R_SO = ~R_GS*R_GO;
+            const Vec4 aa_SO = R_SO.convertRotationToAngleAxis();
+            const Real a = aa_SO[0];
+            const Mat33 P = crossMat(a * aa_SO.getSubVec<3>(1));
+            const Real c = a < Real(1e-4)
+                ? Real(1)/12 + a*a/720 // avoid 0/0; error is O(a^4)
+                : (1 - (a/2)/std::tan(a/2)) / (a*a);
+            const Mat33 JlInv = Mat33(1) - P/2 + c*(P*P);
+            dpdw.push_back(-std::sqrt(osensor.weight/wtot) 
+                           * JlInv * ~R_GS.asMat33());
+        }
+    }
+
+    const int nt = onBodies.size();
+    Matrix JF(6*nt, nu);
+    if (nt) matter.calcFrameJacobian(state, onBodies, origins, JF);
+
+    Vector rowU(nu), rowQ(nq);
+    for (int t=0; t < nt; ++t) {
+        const Mat33& D = dpdw[t];
+        for (int k=0; k < 3; ++k) {
+            const int r = 3*t + k;
+            if (D[k] == Row3(0)) {jacobian[r] = 0; continue;}
+            // Row k of D * (angular rows of this task's frame Jacobian).
+            rowU = D(k,0)*~JF[6*t] + D(k,1)*~JF[6*t+1] + D(k,2)*~JF[6*t+2];
+            matter.multiplyByNInv(state, true, rowU, rowQ);
+            for (Assembler::FreeQIndex fx(0); fx < np; ++fx)
+                jacobian(r,fx) = rowQ[getQIndexOfFreeQ(fx)];
+        }
+    }
+    return 0;
+}
+
+int OrientationSensors::getNumErrors(const State& state) const {
+    int nActive = 0;
+    PerBodyOSensors::const_iterator bodyp = bodiesWithOSensors.begin();
+    for (; bodyp != bodiesWithOSensors.end(); ++bodyp)
+        nActive += bodyp->second.size();
+    return 3*nActive;
+}
+
+// Sum of the weights of the active osensors whose observations are present
+// in the current frame.
+Real OrientationSensors::calcTotalWeight() const {
+    Real wtot = 0;
+    PerBodyOSensors::const_iterator bodyp = bodiesWithOSensors.begin();
+    for (; bodyp != bodiesWithOSensors.end(); ++bodyp) {
+        const Array_<OSensorIx>& bodyOSensors = bodyp->second;
+        for (unsigned m=0; m < bodyOSensors.size(); ++m) {
+            const OSensorIx mx = bodyOSensors[m];
+            if (observations[getObservationIxForOSensor(mx)].isFinite())
+                wtot += osensors[mx].weight;
+        }
+    }
+    return wtot;
+}
 
 // Run through all the OSensors to find all the bodies that have at least one
 // active osensor. For each of those bodies, we collect all its osensors so that
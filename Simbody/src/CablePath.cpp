@@ -61,6 +61,71 @@ PathInstanceInfo::PathInstanceInfo
     }
 }
 
+//------------------------------------------------------------------------------
+//                           PATH ERROR JACOBIAN
+//------------------------------------------------------------------------------
+void PathErrorJacobian::resize(int nBlocks) {
+    lower.resize(nBlocks); diag.resize(nBlocks); upper.resize(nBlocks);
+    pivotInv.resize(nBlocks); multiplier.resize(nBlocks);
+    for (int k=0; k < nBlocks; ++k)
+        lower[k] = diag[k] = upper[k] = 0;
+    useDense = false;
+}
+
+// Block LU without pivoting between blocks:
+//    pivot[0] = diag[0]
+//    pivot[k] = diag[k] - lower[k]*inv(pivot[k-1])*upper[k-1]
+void PathErrorJacobian::factor() {
+    useDense = false;
+    const int n = getNumBlocks();
+    for (int k=0; k < n; ++k) {
+        Mat66 pivot = diag[k];
+        if (k > 0) {
+            multiplier[k] = lower[k]*pivotInv[k-1];
+            pivot -= multiplier[k]*upper[k-1];
+        }
+        bool isSingular = false;
+        try {pivotInv[k] = lapackInverse(pivot);}
+        catch (const std::exception&) {isSingular = true;}
+        if (isSingular || !pivotInv[k].isFinite()) {
+            useDense = true;
+            denseLU.factor(toDense());
+            return;
+        }
+    }
+}
+
+void PathErrorJacobian::solve(const Vector& b, Vector& x) const {
+    const int n = getNumBlocks();
+    if (useDense) {
+        Vector bcopy(b); // in case x and b are the same Vector
+        denseLU.solve(bcopy, x);
+        return;
+    }
+    if (&x != &b) x = b;
+    // Forward elimination.
+    for (int k=1; k < n; ++k)
+        Vec6::updAs(&x[6*k]) -= multiplier[k]*Vec6::getAs(&x[6*(k-1)]);
+    // Back substitution.
+    for (int k=n-1; k >= 0; --k) {
+        Vec6 yk = Vec6::getAs(&x[6*k]);
+        if (k < n-1)
+            yk -= upper[k]*Vec6::getAs(&x[6*(k+1)]);
+        Vec6::updAs(&x[6*k]) = pivotInv[k]*yk;
+    }
+}
+
+Matrix PathErrorJacobian::toDense() const {
+    const int n = getNumBlocks();
+    Matrix J(6*n, 6*n, Real(0));
+    for (int k=0; k < n; ++k) {
+        if (k > 0)   J(6*k, 6*(k-1), 6, 6) = Matrix(lower[k]);
+        J(6*k, 6*k, 6, 6) = Matrix(diag[k]);
+        if (k < n-1) J(6*k, 6*(k+1), 6, 6) = Matrix(upper[k]);
+    }
+    return J;
+}
+
 std::ostream& operator<<(std::ostream& o, const PathInstanceInfo& info) {
     o << "PathInstanceInfo nObs=" << info.getNumObstacles()
         << " nSurf=" << info.getNumSurfaceObstacles() << endl;
@@ -90,7 +155,7 @@ std::ostream& operator<<(std::ostream& o, const PathPosEntry& ppe) {
     cout << endl;
     cout << "x=" << ppe.x << endl;
     cout << "err=" << ppe.err << endl;
-    cout << "J dims=" << ppe.J.nrow() << " x " << ppe.J.ncol() << endl;
+    cout << "J blocks=" << ppe.J.getNumBlocks() << endl;
     return o;
 }
 
@@ -692,8 +757,7 @@ ensureVelocityKinematicsCalculated(const State& state) const {
 
     if (ppe.x.size()) {
         findKinematicVelocityErrors(state, instInfo, ppe, pve);
-        ppe.JInv.solve(pve.nerrdotK, pve.xdot);
-        cout << "*** xdot=" << pve.xdot << endl;
+        ppe.J.solve(pve.nerrdotK, pve.xdot);
     }
 
     //TODO: calc length dot
@@ -725,35 +789,6 @@ ensureVelocityKinematicsCalculated(const State& state) const {
     cables->markDiscreteVarUpdateValueRealized(state, velEntryIx);
 }
 
-// Numerical Jacobian calculation.
-
-class PathError : public Differentiator::JacobianFunction {
-public:
-    // Caution: we're holding references.
-    PathError(int nx, 
-              const CablePath::Impl&  path,
-              const State&            state,
-              const PathInstanceInfo& instInfo,
-              const PathPosEntry&     ppe, 
-              Real                    accuracy)
-    :   Differentiator::JacobianFunction(nx, nx), path(path),
-        state(state),instInfo(instInfo),localPpe(ppe)
-    {   setEstimatedAccuracy(accuracy); }
-
-    int f(const Vector& x, Vector& fx) const override {
-        localPpe.x = x;
-        path.calcPathError(state, instInfo, localPpe);
-        fx = localPpe.err;
-        return 0;
-    }
-
-private:
-    const CablePath::Impl&  path;
-    const State&            state;
-    const PathInstanceInfo& instInfo;
-    mutable PathPosEntry    localPpe;
-};
-
 //------------------------------------------------------------------------------
 //                         PROJECT ONTO SURFACE
 //------------------------------------------------------------------------------
@@ -796,9 +831,24 @@ void CablePath::Impl::
 solveForPathPoints(const State& state, const PathInstanceInfo& instInfo, 
                    PathPosEntry& ppe) const 
 {
+    // Start with the previous solution if there is one. If we also have the
+    // contact point velocities xdot that were calculated along with it, 
+    // extrapolate to the current time. The previous geodesics are used to
+    // warm start the new ones in calcPathError().
     const PathPosEntry& prevPPE = getPrevPosEntry(state);
-    if (prevPPE.x.size())
-        ppe.x = prevPPE.x; // start with previous solution if there is one
+    if (prevPPE.x.size() && prevPPE.x.size() == ppe.x.size()) {
+        ppe.x = prevPPE.x;
+        const PathVelEntry& prevPVE = getPrevVelEntry(state);
+        const Real tPos = 
+            cables->getDiscreteVarLastUpdateTime(state, posEntryIx);
+        const Real tVel = 
+            cables->getDiscreteVarLastUpdateTime(state, velEntryIx);
+        if (tPos == tVel && prevPVE.xdot.size() == ppe.x.size()) {
+            const Real h = state.getTime() - tPos;
+            if (h != 0 && isFinite(prevPVE.xdot.normSqr()))
+                ppe.x += h*prevPVE.xdot;
+        }
+    }
 
     projectOntoSurface(instInfo,ppe); // clean up first
 
@@ -810,16 +860,12 @@ solveForPathPoints(const State& state, const PathInstanceInfo& instInfo,
     const Real ftol = Real(1e-12)*1000; // TODO
     const Real xtol = Real(1e-12)*1000;
 
-    const Real estimatedPathErrorAccuracy = ftol;
-    PathError pathErrorFnc(ppe.x.size(), *this, state, instInfo, ppe, 
-                           estimatedPathErrorAccuracy);
-    Differentiator diff(pathErrorFnc);
-
-    Vector dx, xold, xchg;
+    // Scratch space for the Newton iteration lives with this path's entry.
+    Vector& dx   = ppe.dx;
+    Vector& xold = ppe.xold;
+    Vector& xchg = ppe.xchg;
 
     Real f = ppe.err.norm();
-    cout << "\n***PATH solveForPathPoints@t=" << state.getTime() 
-         << " err=" << f << "\n"; 
 
     Real fold, lam = 1, nextlam = 1;
     Real dxnormPrev = Infinity;
@@ -828,36 +874,21 @@ solveForPathPoints(const State& state, const PathInstanceInfo& instInfo,
         // We always need a Jacobian even if the path is already good enough
         // because we use it to solve for xdot. So we might as well do one
         // iteration.
-        if (i > 0 && f <= ftol) {
-            std::cout << "\n***PATH converged in " 
-                << i << " iterations err=" << f << "\n\n";
+        if (i > 0 && f <= ftol)
             break;
-        }
         //cout << "obstacle err = " << f << ", x = " << ppe.x << endl;
 
-        //diff.calcJacobian(ppe.x, ppe.err, ppe.J, 
-        //                  Differentiator::ForwardDifference);
-       // Matrix Jnum = ppe.J;
         calcPathErrorJacobian(state, instInfo, ppe);
-
-        //cout << "DIFF J=" << Jnum-ppe.J;
-        //cout << "DIFF NORM=" << (Jnum-ppe.J).norm() << "\n";
-
-        ppe.JInv.factor(ppe.J);
-        //ppe.JInv.factor(Jnum);
+        ppe.J.factor();
 
         fold = f;
         xold = ppe.x;
 
-        ppe.JInv.solve(ppe.err, dx);
+        ppe.J.solve(ppe.err, dx);
 
         const Real dxnorm = std::sqrt(dx.normSqr()/ppe.x.size()); // rms
-        cout << "|dx| = " << dxnorm << endl;
-        if (dxnorm > Real(.99)*dxnormPrev) {
-           std::cout << "\nPATH stalled in " 
-                << i << " iterations err=" << f << " |dx|=" << dxnorm << "\n\n";
+        if (dxnorm > Real(.99)*dxnormPrev)
             break;
-        }
 
         // backtracking
         lam = nextlam;
@@ -1132,9 +1163,9 @@ calcPathError(const State& state, const PathInstanceInfo& instInfo,
 //------------------------------------------------------------------------------
 //                          CALC PATH ERROR JACOBIAN
 //------------------------------------------------------------------------------
-// Assemble the nx X nx banded Jacobian J=D patherr / Dx from per-obstacle 
-// blocks. The obstacles compute the Jacobian of their own path error 
-// functions, which are eHat(eIn_S, xP, xQ, eOut_S), with all arguments in the
+// Assemble the nx X nx block tridiagonal Jacobian J=D patherr / Dx from 
+// per-obstacle blocks. The obstacles compute the Jacobian of their own path
+// error functions, which are eHat(eIn_S, xP, xQ, eOut_S), with all arguments in the
 // obstacle frame S. The blocks we need are instead the Jacobian of
 //    e(xQ-1, xP, xQ, xP+1) = eHat(eIn_S(xQ-1,xP), xP, xQ, eOut_S(xQ,xP+1))
 // so we need to apply the chain rule terms
@@ -1151,8 +1182,7 @@ calcPathErrorJacobian(const State&            state,
     const PathPosEntry& prevPPE = getPrevPosEntry(state);
 
     const int nx = ppe.x.size();
-    ppe.J.resize(nx, nx);
-    ppe.J.setToZero();
+    ppe.J.resize(nx/6); // one block row per active surface
     if (nx == 0)
         return; // only via points; nothing to do
 
@@ -1275,12 +1305,16 @@ calcPathErrorJacobian(const State&            state,
         //cout << "DehatDxQ1=" << DehatDxQ1;
         //cout << "diff=" << (DehatDxQ-DehatDxQ1).norm() << ": " << (DehatDxQ-DehatDxQ1);
 
-        if (xSlot >= 3)
-            ppe.J(xSlot,xSlot-3,6,3) = Matrix(DehatDein*DeinDQp);
-        ppe.J(xSlot,xSlot,  6,3) = Matrix(DehatDxP + DehatDein *DeinDP);
-        ppe.J(xSlot,xSlot+3,6,3) = Matrix(DehatDxQ + DehatDeout*DeoutDQ);
-        if (xSlot+9 < nx)
-            ppe.J(xSlot,xSlot+6,6,3) = Matrix(DehatDeout*DeoutDPn);
+        // The block row for this surface couples to the Q coordinates of the
+        // previous active obstacle and the P coordinates of the next one, but
+        // only if those are surfaces; via points have no coordinates.
+        Mat66& Jdiag = ppe.J.updDiag(asx);
+        Jdiag.updSubMat<6,3>(0,0) = DehatDxP + DehatDein *DeinDP;
+        Jdiag.updSubMat<6,3>(0,3) = DehatDxQ + DehatDeout*DeoutDQ;
+        if (ppe.mapToActiveSurface[prevActiveOx].isValid())
+            ppe.J.updLower(asx).updSubMat<6,3>(0,3) = DehatDein*DeinDQp;
+        if (ppe.mapToActiveSurface[nextActiveOx].isValid())
+            ppe.J.updUpper(asx).updSubMat<6,3>(0,0) = DehatDeout*DeoutDPn;
 
         prevActiveOx = thisActiveOx;
         thisActiveOx = ppe.findNextActiveObstacle(prevActiveOx);       
@@ -1423,31 +1457,13 @@ Vec6 CableObstacle::Surface::Impl::calcSurfacePathError
 
     const UnitVec3& nP = current.getNormalP();
     const UnitVec3& nQ = current.getNormalQ();
-    const UnitVec3& tP = current.getTangentP();
-    const UnitVec3& tQ = current.getTangentQ();
     const UnitVec3& bP = current.getBinormalP();
     const UnitVec3& bQ = current.getBinormalQ();
     const Real      length = current.getLength();
 
-    // Watch for backwards geodesic and flip tangent error conditions.
-    Real signP = Real(~eIn *tP < 0 ? -1 : 1);
-    Real signQ = Real(~eOut*tQ < 0 ? -1 : 1);
-    //XXX 
-    //signP = signQ = 1;
-
-    // If length is very short, or geodesic is backwards, use path binormals
-    // rather than geodesic binormals.
+    // If length is very short, use path binormals rather than geodesic 
+    // binormals.
     const Real ShortLength = Real(1e-3);
-    if (length <= ShortLength)
-        cout << "==> Using short formulation for length=" << length << endl;
-    if (signP < 0 || signQ < 0) { 
-        cout << "==> Backwards geodesic with length=" << length 
-             << " eIn*tP=" << ~eIn*tP << " eOut*tQ=" << ~eOut*tQ << endl;
-        if (signP != signQ) {
-            cout <<"    Mismatch eIn="<<eIn << " eOut="<<eOut<<endl;
-            cout <<"             tP=" <<tP << " tQ="<<tQ<<endl;
-        }
-    }
 
     const Vec3 bbarP = length<=ShortLength ? eOut % nP : Vec3(bP);
     const Vec3 bbarQ = length<=ShortLength ? eIn  % nQ : Vec3(bQ);
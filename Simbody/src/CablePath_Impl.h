@@ -86,6 +86,49 @@ public:
 };
 
 
+// This is the path error Jacobian J=D patherr/Dx. Each active surface 
+// obstacle has six unknowns (xP,xQ) and six path errors, and those errors
+// depend only on its own unknowns, on the Q point of the preceding active
+// obstacle, and on the P point of the following one. So J is block tridiagonal
+// with one row of 6x6 blocks per active surface, and the off-diagonal blocks
+// are zero unless the neighboring active obstacle is also a surface. We factor
+// J by block elimination, which is O(n) in the number of active surfaces
+// rather than O(n^3). There is no pivoting between blocks; if a pivot block
+// turns out to be singular we fall back to a dense LU factorization with 
+// partial pivoting.
+class PathErrorJacobian {
+public:
+    // Set the number of 6x6 block rows and zero all the blocks.
+    void resize(int nBlocks);
+    int getNumBlocks() const {return diag.size();}
+
+    // Blocks (k,k-1), (k,k), and (k,k+1). The lower block of the first row
+    // and the upper block of the last row are unused.
+    Mat66& updLower(int k) {return lower[k];}
+    Mat66& updDiag(int k)  {return diag[k];}
+    Mat66& updUpper(int k) {return upper[k];}
+
+    // Factor J after all the blocks have been filled in.
+    void factor();
+
+    // Solve J x = b using the current factorization. b and x may be the same
+    // Vector.
+    void solve(const Vector& b, Vector& x) const;
+
+    // Return J as a dense matrix.
+    Matrix toDense() const;
+
+private:
+    Array_<Mat66>   lower, diag, upper;
+
+    // Results of block elimination: the inverse of each pivot block, and the
+    // multiplier lower[k]*pivotInv[k-1] used to eliminate lower[k].
+    Array_<Mat66>   pivotInv, multiplier;
+
+    bool            useDense = false;
+    FactorLU        denseLU;
+};
+
 // This is a cache entry for holding a path's calculated position-level 
 // information. At the time it is created we know the total number of
 // obstacles n (including the end points), but not which ones are active. We 
@@ -128,7 +171,7 @@ public:
         geodesics.clear(); geodesics.resize(nas);
         x.clear(); x.resize(nx);
         err.clear(); err.resize(nx);
-        J.clear(); J.resize(nx,nx);
+        J.resize(nas);
     }
 
     // Return the obstacle index of the first active obstacle following the
@@ -209,11 +252,13 @@ public:
     // This is the patherr corresponding to x and is always the same length.
     Vector      err;    // patherr (nx of these)
 
-    // This is J(x) where J=partial(patherr)/partial(x), and its LU 
+    // This is J(x) where J=partial(patherr)/partial(x), and its 
     // factorization for use in solving for length dot at Velocity stage.
-    // TODO: this is banded but we're treating it as full.
-    Matrix      J;      // nx X nx
-    FactorLU    JInv;
+    PathErrorJacobian J; // nx X nx, block tridiagonal
+
+    // Scratch space for the Newton iteration in solveForPathPoints(); these
+    // are resized there and keep their storage between solves.
+    Vector      dx, xold, xchg; // nx each
 };
 
 
@@ -85,3 +85,8 @@ CablePath& CableTrackerSubsystem::
 updCablePath(CablePathIndex cableIx)
 {   return updImpl().updCablePath(cableIx); }
 
+void CableTrackerSubsystem::setNumberOfThreads(int numThreads)
+{   updImpl().setNumberOfThreads(numThreads); }
+
+int CableTrackerSubsystem::getNumberOfThreads() const
+{   return getImpl().getNumberOfThreads(); }
@@ -32,6 +32,7 @@
 #include "simbody/internal/CablePath.h"
 
 #include "CablePath_Impl.h"
+#include "OptionalExecutor.h"
 
 #include <cassert>
 #include <iostream>
@@ -78,6 +79,16 @@ const MultibodySystem& getMultibodySystem() const
 const SimbodyMatterSubsystem& getMatterSubsystem() const 
 {   return getMultibodySystem().getMatterSubsystem(); }
 
+void setNumberOfThreads(int numThreads) 
+{   m_executor.setNumberOfThreads(numThreads, "CableTrackerSubsystem"); }
+int getNumberOfThreads() const
+{   return m_executor.getNumberOfThreads(); }
+
+// Call body(i) for each cable path; see ParallelExecutor::forEach(). Paths
+// keep all their results in their own cache entries so they don't interfere.
+template <class Body> void forEachCablePath(const Body& body) const
+{   m_executor.forEach(getNumCablePaths(), body); }
+
 // Get access to state variables and cache entries.
 // TODO
 
@@ -124,19 +135,20 @@ int realizeSubsystemInstanceImpl(const State& state) const override {
     return 0;
 }
 
+// Solving for the cable paths is the expensive part; each path is solved
+// independently so this and the velocity calculation may be done 
+// concurrently.
 int realizeSubsystemPositionImpl(const State& state) const override {
-    for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix) {
-        const CablePath& path = getCablePath(ix);
-        path.getImpl().realizePosition(state);
-    }
+    forEachCablePath([&](int i) {
+        getCablePath(CablePathIndex(i)).getImpl().realizePosition(state);
+    });
     return 0;
 }
 
 int realizeSubsystemVelocityImpl(const State& state) const override {
-    for (CablePathIndex ix(0); ix < cablePaths.size(); ++ix) {
-        const CablePath& path = getCablePath(ix);
-        path.getImpl().realizeVelocity(state);
-    }
+    forEachCablePath([&](int i) {
+        getCablePath(CablePathIndex(i)).getImpl().realizeVelocity(state);
+    });
     return 0;
 }
 
@@ -260,6 +272,8 @@ SimTK_DOWNCAST(Impl, Subsystem::Guts);
 private:
 // TOPOLOGY STATE
 Array_<CablePath, CablePathIndex> cablePaths;
+
+OptionalExecutor                    m_executor;
 };
 
 } // namespace SimTK
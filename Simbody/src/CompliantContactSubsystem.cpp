@@ -36,6 +36,11 @@ patch analysis methods.
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/MultibodySystem.h"
 
+#include "OptionalExecutor.h"
+#include "SimbodyMatterSubsystemRep.h"
+
+#include <algorithm>
+
 namespace SimTK {
 
 //==============================================================================
@@ -152,6 +157,15 @@ bool calcContactPatchDetailsById(const State&   state,
 const ContactTrackerSubsystem& getContactTrackerSubsystem() const
 {   return m_tracker; }
 
+void setNumberOfThreads(int numThreads) 
+{   m_executor.setNumberOfThreads(numThreads, "CompliantContactSubsystem"); }
+int getNumberOfThreads() const
+{   return m_executor.getNumberOfThreads(); }
+
+// See ParallelExecutor::forEach().
+template <class Body> void forEach(int n, const Body& body) const
+{   m_executor.forEach(n, body); }
+
 ~CompliantContactSubsystemImpl() {
     delete m_defaultGenerator;
     for (GeneratorMap::iterator p  = m_generators.begin(); 
@@ -357,6 +371,12 @@ void markForceCacheValid(const State& s) const
 void ensurePotentialEnergyCacheValid(const State&) const;
 void ensureForceCacheValid(const State&) const;
 
+// Calculate the force for one active contact and re-express it in Ground. The
+// result is left invalid if the contact is broken or generates no force.
+void calcContactForceInGround(const State&      state, 
+                              const Contact&    contact,
+                              ContactForce&     force_G) const;
+
 
 
     // TOPOLOGY "STATE"
@@ -383,6 +403,8 @@ GeneratorMap                        m_generators;
 // this will either do nothing silently or throw an error.
 ContactForceGenerator*              m_defaultGenerator;
 
+OptionalExecutor                    m_executor;
+
     // TOPOLOGY "CACHE"
 
 // These must be set during realizeTopology and treated as const thereafter.
@@ -416,17 +438,24 @@ ensurePotentialEnergyCacheValid(const State& state) const {
 
     // The State has been realized to Position stage, so we're going to have
     // to calculate forces at zero velocity and then throw away all the 
-    // results except for the PE.
+    // results except for the PE. The force cache can't be valid yet so we
+    // borrow its storage for those, one slot per contact.
     const ContactSnapshot& active = m_tracker.getActiveContacts(state);
     const int nContacts = active.getNumContacts();
-    for (int i=0; i<nContacts; ++i) {
+    Array_<ContactForce>& forces = updForceCache(state);
+    forces.resize(nContacts);
+    forEach(nContacts, [&](int i) {
         const Contact& contact = active.getContact(i);
         const ContactForceGenerator& generator = 
             getForceGenerator(contact.getTypeId());
-        ContactForce force;
-        generator.calcContactForce(state,contact,SpatialVec(Vec3(0)), force);
-        pe += force.getPotentialEnergy();
-    }
+        forces[i].clear();
+        generator.calcContactForce(state,contact,SpatialVec(Vec3(0)), 
+                                   forces[i]);
+    });
+    for (int i=0; i<nContacts; ++i)
+        if (forces[i].isValid())
+            pe += forces[i].getPotentialEnergy();
+    forces.clear();
 
     markPotentialEnergyCacheValid(state);
 }
@@ -439,54 +468,65 @@ ensureForceCacheValid(const State& state) const {
     SimTK_STAGECHECK_GE_ALWAYS(getStage(state), Stage::Velocity,
         "CompliantContactSubystemImpl::ensureForceCacheValid()");
 
+    // Contacts are independent so their forces may be calculated 
+    // concurrently. Each goes in its own slot; then we squeeze out the
+    // invalid ones, keeping contact order so the result doesn't depend on the
+    // number of threads.
+    const ContactSnapshot& active = m_tracker.getActiveContacts(state);
+    const int nContacts = active.getNumContacts();
     Array_<ContactForce>& forces = updForceCache(state);
-    forces.clear();
+    forces.resize(nContacts);
+    forEach(nContacts, [&](int i) {
+        forces[i].clear();
+        calcContactForceInGround(state, active.getContact(i), forces[i]);
+    });
+    int nValid = 0;
+    for (int i=0; i<nContacts; ++i)
+        if (forces[i].isValid())
+            forces[nValid++] = forces[i];
+    forces.resize(nValid);
 
+    markForceCacheValid(state);
+}
 
-    const ContactSnapshot& active = m_tracker.getActiveContacts(state);
-    const int nContacts = active.getNumContacts();
-    for (int i=0; i<nContacts; ++i) {
-        const Contact& contact = active.getContact(i);
-        if (contact.getCondition() == Contact::Broken) {
-            // No need to generate forces; this will be gone next time.
-            continue;
-        }
-        const Transform& X_S1S2 = contact.getTransform();
-        const ContactSurfaceIndex surf1(contact.getSurface1());
-        const ContactSurfaceIndex surf2(contact.getSurface2());
-        const MobilizedBody& mobod1 = m_tracker.getMobilizedBody(surf1);
-        const MobilizedBody& mobod2 = m_tracker.getMobilizedBody(surf2);
-
-        // TODO: These two are expensive (63 flops each) and shouldn't have 
-        // to be recalculated here since we must have used them in creating
-        // the Contact and X_S1S2.
-        const Transform X_GS1 = mobod1.findFrameTransformInGround
-            (state, m_tracker.getContactSurfaceTransform(surf1));
-        const Transform X_GS2 = mobod2.findFrameTransformInGround
-            (state, m_tracker.getContactSurfaceTransform(surf2));
-
-        const SpatialVec V_GS1 = mobod1.findFrameVelocityInGround
-            (state, m_tracker.getContactSurfaceTransform(surf1));
-        const SpatialVec V_GS2 = mobod2.findFrameVelocityInGround
-            (state, m_tracker.getContactSurfaceTransform(surf2));
-
-        // Calculate the relative velocity of S2 in S1, expressed in S1.
-        const SpatialVec V_S1S2 =
-            findRelativeVelocity(X_GS1, V_GS1, X_GS2, V_GS2);   // 51 flops
 
-        const ContactForceGenerator& generator = 
-            getForceGenerator(contact.getTypeId());
-        forces.push_back(); // allocate a new garbage ContactForce
-        // Calculate the contact force measured and expressed in S1.
-        generator.calcContactForce(state, contact, V_S1S2, forces.back());
-        // Re-express the contact force in Ground for later use.
-        if (forces.back().isValid())
-            forces.back().changeFrameInPlace(X_GS1); // switch to Ground
-        else
-            forces.pop_back(); // never mind ...
+void CompliantContactSubsystemImpl::
+calcContactForceInGround(const State&   state, 
+                         const Contact& contact,
+                         ContactForce&  force_G) const {
+    if (contact.getCondition() == Contact::Broken) {
+        // No need to generate forces; this will be gone next time.
+        return;
     }
+    const ContactSurfaceIndex surf1(contact.getSurface1());
+    const ContactSurfaceIndex surf2(contact.getSurface2());
+    const MobilizedBody& mobod1 = m_tracker.getMobilizedBody(surf1);
+    const MobilizedBody& mobod2 = m_tracker.getMobilizedBody(surf2);
 
-    markForceCacheValid(state);
+    // TODO: These two are expensive (63 flops each) and shouldn't have 
+    // to be recalculated here since we must have used them in creating
+    // the Contact and X_S1S2.
+    const Transform X_GS1 = mobod1.findFrameTransformInGround
+        (state, m_tracker.getContactSurfaceTransform(surf1));
+    const Transform X_GS2 = mobod2.findFrameTransformInGround
+        (state, m_tracker.getContactSurfaceTransform(surf2));
+
+    const SpatialVec V_GS1 = mobod1.findFrameVelocityInGround
+        (state, m_tracker.getContactSurfaceTransform(surf1));
+    const SpatialVec V_GS2 = mobod2.findFrameVelocityInGround
+        (state, m_tracker.getContactSurfaceTransform(surf2));
+
+    // Calculate the relative velocity of S2 in S1, expressed in S1.
+    const SpatialVec V_S1S2 =
+        findRelativeVelocity(X_GS1, V_GS1, X_GS2, V_GS2);   // 51 flops
+
+    const ContactForceGenerator& generator = 
+        getForceGenerator(contact.getTypeId());
+    // Calculate the contact force measured and expressed in S1.
+    generator.calcContactForce(state, contact, V_S1S2, force_G);
+    // Re-express the contact force in Ground for later use.
+    if (force_G.isValid())
+        force_G.changeFrameInPlace(X_GS1); // switch to Ground
 }
 
 
@@ -614,6 +654,12 @@ const ContactTrackerSubsystem& CompliantContactSubsystem::
 getContactTrackerSubsystem() const
 {   return getImpl().getContactTrackerSubsystem(); }
 
+void CompliantContactSubsystem::setNumberOfThreads(int numThreads)
+{   updImpl().setNumberOfThreads(numThreads); }
+
+int CompliantContactSubsystem::getNumberOfThreads() const
+{   return getImpl().getNumberOfThreads(); }
+
 const MultibodySystem& CompliantContactSubsystem::getMultibodySystem() const
 {   return MultibodySystem::downcast(getSystem()); }
 
@@ -1475,6 +1521,36 @@ void ContactForceGenerator::BrickHalfSpacePenalty::calcContactPatch
 //==============================================================================
 //                         ELASTIC FOUNDATION GENERATOR
 //==============================================================================
+namespace {
+// Number of elastic foundation springs (mesh faces) evaluated together. This
+// is fixed so that the order of the partial sums, and hence the roundoff, is
+// the same however many threads are used.
+const int FacesPerBatch = 64;
+
+// Partial results accumulated by one batch of springs. These are reused
+// from scratch space so clear() keeps the details' capacity.
+struct FaceBatchResult {
+    void clear() {
+        force = SpatialVec(Vec3(0), Vec3(0));
+        potentialEnergy = powerLoss = sumOfAllPressureMoments = 0;
+        weightedCenterOfPressure = Vec3(0);
+        details.clear();
+    }
+
+    SpatialVec              force{Vec3(0), Vec3(0)};
+    Real                    potentialEnergy = 0;
+    Real                    powerLoss = 0;
+    Vec3                    weightedCenterOfPressure{0};
+    Real                    sumOfAllPressureMoments = 0;
+    Array_<ContactDetail>   details;
+};
+
+const CompliantContactSubsystemImpl& 
+getCompliantContactSubsystemImpl(const CompliantContactSubsystem& subsys) 
+{   return SimTK_DYNAMIC_CAST_DEBUG<const CompliantContactSubsystemImpl&>
+                                            (subsys.getRep()); }
+}
+
 void ContactForceGenerator::ElasticFoundation::calcContactForce
    (const State&            state,
     const Contact&          overlap,    // contains X_S1S2
@@ -1619,7 +1695,7 @@ void ContactForceGenerator::ElasticFoundation::calcContactForceAndDetails
         const ContactGeometry::TriangleMesh& mesh1 = 
             ContactGeometry::TriangleMesh::getAs(shape1);
 
-        calcWeightedPatchCentroid(mesh1, contact.getSurface1Faces(),
+        calcWeightedPatchCentroid(mesh1, contact.getSurface1FaceArray(),
                                   weightedPatchCentroid1_S1, patchArea1);
     }
     if (shape2.getTypeId() == ContactGeometry::TriangleMesh::classTypeId()) {
@@ -1627,7 +1703,7 @@ void ContactForceGenerator::ElasticFoundation::calcContactForceAndDetails
             ContactGeometry::TriangleMesh::getAs(shape2);
         Vec3 weightedPatchCentroid2_S2;
 
-        calcWeightedPatchCentroid(mesh2, contact.getSurface2Faces(),
+        calcWeightedPatchCentroid(mesh2, contact.getSurface2FaceArray(),
                                   weightedPatchCentroid2_S2, patchArea2);
         // Remeasure patch2's weighted centroid from surface1's frame;
         // be sure to weight the new offset also.
@@ -1695,7 +1771,7 @@ void ContactForceGenerator::ElasticFoundation::calcContactForceAndDetails
             ContactGeometry::TriangleMesh::getAs(shape1);
 
         processOneMesh(state, 
-            mesh, contact.getSurface1Faces(),
+            mesh, contact.getSurface1FaceArray(),
             X_S1S2, V_S1S2, shape2,
             s1, areaScale1,
             kh, c, us, ud, uv,
@@ -1725,7 +1801,7 @@ void ContactForceGenerator::ElasticFoundation::calcContactForceAndDetails
             wantDetails ? contactDetails_S1->size() : 0;
 
         processOneMesh(state, 
-            mesh, contact.getSurface2Faces(),
+            mesh, contact.getSurface2FaceArray(),
             X_S2S1, V_S2S1, shape1,
             s2, areaScale2,
             kh, c, us, ud, uv,
@@ -1790,14 +1866,13 @@ void ContactForceGenerator::ElasticFoundation::calcContactForceAndDetails
 void ContactForceGenerator::ElasticFoundation::
 calcWeightedPatchCentroid
    (const ContactGeometry::TriangleMesh&    mesh,
-    const std::set<int>&                    insideFaces,
+    const Array_<int>&                      insideFaces,
     Vec3&                                   weightedPatchCentroid,
     Real&                                   patchArea) const
 {
     weightedPatchCentroid = Vec3(0); patchArea = 0;
-    for (std::set<int>::const_iterator iter = insideFaces.begin(); 
-                                       iter != insideFaces.end(); ++iter)
-    {   const int  face = *iter;
+    for (const int face : insideFaces)
+    {   
         const Real area = mesh.getFaceArea(face);
         weightedPatchCentroid   += area*mesh.findCentroid(face); 
         patchArea               += area; 
@@ -1824,7 +1899,7 @@ void ContactForceGenerator::ElasticFoundation::
 processOneMesh
    (const State&                            state,
     const ContactGeometry::TriangleMesh&    mesh,
-    const std::set<int>&                    insideFaces,
+    const Array_<int>&                      insideFaces,
     const Transform&                        X_MO, 
     const SpatialVec&                       V_MO,
     const ContactGeometry&                  other,
@@ -1863,157 +1938,185 @@ processOneMesh
 
     // Now loop over all the faces again, evaluate the force from each 
     // spring, and apply it at the patch centroid.
-    // This costs roughly 300 flops per contacting face.
-    for (std::set<int>::const_iterator iter = insideFaces.begin(); 
-                                       iter != insideFaces.end(); ++iter) 
-    {   const int   face        = *iter;
-        const Vec3  springPos_M = mesh.findCentroid(face);
-        const Real  faceArea    = areaScaleFactor*mesh.getFaceArea(face);
-
-        bool        inside;
-        UnitVec3    normal_O; // not used
-        const Vec3  nearestPoint_O = // 18 flops + cost of findNearestPoint
-            other.findNearestPoint(~X_MO*springPos_M, inside, normal_O);
-        if (!inside)
-            continue;
+    // This costs roughly 300 flops per contacting face. The faces are divided
+    // into fixed-size batches that may be processed concurrently. Each batch 
+    // accumulates its own partial results and those are combined in batch 
+    // order below, so the result doesn't depend on the number of threads.
+    // Several contacts may be processed at once for the same State, so the
+    // batches come from this thread's scratch space rather than the State's.
+    const int nFaces   = (int)insideFaces.size();
+    const int nBatches = (nFaces + FacesPerBatch-1) / FacesPerBatch;
+    SBScratchCache::Frame scratch
+       (SimbodyMatterSubsystemRep::updThreadScratchCache());
+    Array_<FaceBatchResult>& batches = scratch.array<FaceBatchResult>(nBatches);
+    const auto processBatch = [&](int b) {
+        FaceBatchResult& batch = batches[b];
+        batch.clear();
+        const int end = std::min(nFaces, (b+1)*FacesPerBatch);
+        for (int i=b*FacesPerBatch; i < end; ++i) 
+        {   const int   face        = insideFaces[i];
+            const Vec3  springPos_M = mesh.findCentroid(face);
+            const Real  faceArea    = areaScaleFactor*mesh.getFaceArea(face);
+
+            bool        inside;
+            UnitVec3    normal_O; // not used
+            const Vec3  nearestPoint_O = // 18 flops + cost of findNearestPoint
+                other.findNearestPoint(~X_MO*springPos_M, inside, normal_O);
+            if (!inside)
+                continue;
         
-        // Although the "spring" is associated with just one surface (the mesh M)
-        // it is considered here to include the compression of both surfaces
-        // together, using composite material properties for stiffness and 
-        // dissipation properties of the spring. The total displacement vector
-        // for both surfaces points from the nearest point on the undeformed other 
-        // surface to the undeformed spring position (face centroid) on the 
-        // mesh. Since these overlap (we checked above) the nearest point is 
-        // *inside* the mesh thus the vector points towards the mesh exterior; 
-        // i.e., in the  direction that the force will be applied to the 
-        // "other" body. This is the same convention we use for the patch 
-        // normal for Hertz contact.
-        const Vec3 nearestPoint_M = X_MO*nearestPoint_O; // 18 flops
-        const Vec3 overlap_M      = springPos_M - nearestPoint_M; // 3 flops
-        const Real overlap        = overlap_M.norm(); // ~40 flops
-
-        // If there is no overlap we can't generate forces.
-        if (overlap == 0)
-            continue;
-
-        // The surfaces are compressed by total amount "overlap".
-        const UnitVec3 normal_M(overlap_M/overlap, true); // ~15 flops
-
-        // Calculate the contact point location based on the relative 
-        // squishiness of the two surfaces. The mesh deformation fraction (0-1)
-        // gives the fraction of the material squishing that is done by the
-        // mesh; the rest is done by the other surface. At 0 (rigid mesh) the 
-        // contact point will be at the undeformed mesh face centroid; at 1 
-        // (other body rigid) it will be at the (undeformed) nearest point on 
-        // the other body.
-        const Real meshSquish = meshDeformationFraction*overlap; // mesh displacement
-        // Remember that the normal points towards the exterior of this mesh.
-        const Vec3 contactPt_M = springPos_M - meshSquish*normal_M; // 6 flops
+            // Although the "spring" is associated with just one surface (the
+            // mesh M) it is considered here to include the compression of both
+            // surfaces together, using composite material properties for
+            // stiffness and dissipation properties of the spring. The total
+            // displacement vector for both surfaces points from the nearest
+            // point on the undeformed other surface to the undeformed spring
+            // position (face centroid) on the mesh. Since these overlap (we
+            // checked above) the nearest point is *inside* the mesh thus the
+            // vector points towards the mesh exterior; i.e., in the  direction
+            // that the force will be applied to the "other" body. This is the
+            // same convention we use for the patch normal for Hertz contact.
+            const Vec3 nearestPoint_M = X_MO*nearestPoint_O; // 18 flops
+            const Vec3 overlap_M      = springPos_M - nearestPoint_M; // 3 flops
+            const Real overlap        = overlap_M.norm(); // ~40 flops
+
+            // If there is no overlap we can't generate forces.
+            if (overlap == 0)
+                continue;
+
+            // The surfaces are compressed by total amount "overlap".
+            const UnitVec3 normal_M(overlap_M/overlap, true); // ~15 flops
+
+            // Calculate the contact point location based on the relative
+            // squishiness of the two surfaces. The mesh deformation fraction
+            // (0-1) gives the fraction of the material squishing that is done
+            // by the mesh; the rest is done by the other surface. At 0 (rigid
+            // mesh) the contact point will be at the undeformed mesh face
+            // centroid; at 1 (other body rigid) it will be at the (undeformed)
+            // nearest point on the other body.
+            const Real meshSquish = meshDeformationFraction*overlap; // mesh displacement
+            // Remember that the normal points towards the exterior of this
+            // mesh.
+            const Vec3 contactPt_M = springPos_M - meshSquish*normal_M; // 6 flops
         
-        // Calculate the relative velocity of the two bodies at the contact 
-        // point. We're considering the mesh M fixed, so we just need the 
-        // velocity in M of the station of O that is coincident with the 
-        // contact point.
+            // Calculate the relative velocity of the two bodies at the contact 
+            // point. We're considering the mesh M fixed, so we just need the 
+            // velocity in M of the station of O that is coincident with the 
+            // contact point.
 
-        // O station, exp. in M
-        const Vec3 contactPtO_M = contactPt_M - pMO;    // 3 flops 
+            // O station, exp. in M
+            const Vec3 contactPtO_M = contactPt_M - pMO;    // 3 flops 
 
-        // All vectors are in M; dropping the "_M" notation now.
+            // All vectors are in M; dropping the "_M" notation now.
 
-        // Velocity of other at contact point is opposite direction of normal
-        // when penetration is increasing.
-        const Vec3 vel = vMO + wMO % contactPtO_M;      // 12 flops
+            // Velocity of other at contact point is opposite direction of
+            // normal when penetration is increasing.
+            const Vec3 vel = vMO + wMO % contactPtO_M;      // 12 flops
 
-        // Want odot > 0 when overlap is increasing; normal points the 
-        // other way. odot is signed penetration (overlap) rate.
-        const Real odot = -dot(vel, normal_M);          // 6 flops
-        const Vec3 velNormal  = -odot*normal_M;         // 4 flops
-        const Vec3 velTangent = vel-velNormal;          // 3 flops
+            // Want odot > 0 when overlap is increasing; normal points the 
+            // other way. odot is signed penetration (overlap) rate.
+            const Real odot = -dot(vel, normal_M);          // 6 flops
+            const Vec3 velNormal  = -odot*normal_M;         // 4 flops
+            const Vec3 velTangent = vel-velNormal;          // 3 flops
         
-        // Calculate scalar normal force                  (5 flops)
-        // Here kh has units of pressure/area/displacement
-        const Real fK = kh*faceArea*overlap; // normal elastic force (conservative)
-        const Real fC = fK*c*odot;           // normal dissipation force (loss)
-        const Real fNormal = fK + fC;        // normal force
-
-        // Total force can be negative under unusual circumstances ("yanking");
-        // that means no force is generated and no stored PE will be recovered.
-        // This will most often occur in to-be-rejected trial steps but can
-        // occasionally be real.
-        if (fNormal <= 0) {
-            //SimTK_DEBUG1("YANKING!!! (face %d)\n", face);
-            continue;
-        }
+            // Calculate scalar normal force                  (5 flops)
+            // Here kh has units of pressure/area/displacement
+            const Real fK = kh*faceArea*overlap; // normal elastic force (conservative)
+            const Real fC = fK*c*odot;           // normal dissipation force (loss)
+            const Real fNormal = fK + fC;        // normal force
+
+            // Total force can be negative under unusual circumstances
+            // ("yanking"); that means no force is generated and no stored PE
+            // will be recovered. This will most often occur in to-be-rejected
+            // trial steps but can occasionally be real.
+            if (fNormal <= 0) {
+                //SimTK_DEBUG1("YANKING!!! (face %d)\n", face);
+                continue;
+            }
 
-        // 12 flops in this series.
-        const Vec3 forceK          = fK*normal_M;   // as applied to other surf
-        const Vec3 forceC          = fC*normal_M;
-        const Real PE              = fK*overlap/2;  // 1/2 kAx^2
-        const Real powerC          = fC*odot;       // rate of energy loss, >= 0
-        const Vec3 forceNormal     = forceK + forceC;
-
-        // This is the moment r X f about the resultant point produced by 
-        // applying this pure force at the contact point. Cost ~60 flops.
-        const Vec3 r = contactPt_M - resultantPt_M;
-        const Real pressureMoment = (r % forceNormal).norm();
-        weightedCenterOfPressure_M += pressureMoment*r;
-        sumOfAllPressureMoments    += pressureMoment;
+            // 12 flops in this series.
+            const Vec3 forceK          = fK*normal_M;   // as applied to other surf
+            const Vec3 forceC          = fC*normal_M;
+            const Real PE              = fK*overlap/2;  // 1/2 kAx^2
+            const Real powerC          = fC*odot;       // rate of energy loss, >= 0
+            const Vec3 forceNormal     = forceK + forceC;
+
+            // This is the moment r X f about the resultant point produced by 
+            // applying this pure force at the contact point. Cost ~60 flops.
+            const Vec3 r = contactPt_M - resultantPt_M;
+            const Real pressureMoment = (r % forceNormal).norm();
+            batch.weightedCenterOfPressure += pressureMoment*r;
+            batch.sumOfAllPressureMoments  += pressureMoment;
         
-        // Calculate the friction force. Cost is about 60 flops.
-        Vec3 forceFriction(0);
-        Real powerFriction = 0;
-        const Real vslipSq = velTangent.normSqr();  // 5 flops
-        if (vslipSq > square(SignificantReal)) {
-            const Real vslip = std::sqrt(vslipSq); // expensive: ~25 flops
-            // Express slip velocity as unitless multiple of transition velocity.
-            const Real v = vslip * ooVtrans;
-            // Must scale viscous coefficient to match unitless velocity.
-            const Real mu=stribeck(us,ud,uv*vtrans,v); // ~10 flops
-            //const Real mu=hollars(us,ud,uv*vtrans,v);
-            const Real fFriction = fNormal * mu;
-            // Force direction on O opposes O's velocity.
-            forceFriction = (-fFriction/vslip)*velTangent; // ~20 flops
-            powerFriction = fFriction * vslip; // always >= 0
-        }
-
-        const Vec3 forceLoss  = forceC + forceFriction;     // 3 flops
-        const Vec3 forceTotal = forceK + forceLoss;         // 3 flops
-
-        // Accumulate the moment and force on the *other* surface as though 
-        // applied at the point of O that is coincident with the resultant
-        // point; we'll move it later.                      (15 flops)
-        resultantForceOnOther_M += SpatialVec(r % forceTotal, forceTotal);
-
-        // Accumulate potential energy stored in elastic displacement.
-        potentialEnergy += PE;                  // 1 flop
-
-        // Don't include dot(forceK,velNormal) power due to conservative force
-        // here. This way we don't double-count the energy on the way in as
-        // integrated power and potential energy. Although the books would 
-        // balance again when the contact is broken, it makes continuous 
-        // contact look as though some energy has been lost. In the "yanking" 
-        // case above, without including the conservative power term we will 
-        // actually lose energy because the deformed material isn't allowed to 
-        // push back on us so the energy is lost to surface vibrations or some
-        // other unmodeled effect.
-        const Real powerLossThisElement = powerC + powerFriction; // 1 flop
-        powerLoss += powerLossThisElement;                        // 1 flop
+            // Calculate the friction force. Cost is about 60 flops.
+            Vec3 forceFriction(0);
+            Real powerFriction = 0;
+            const Real vslipSq = velTangent.normSqr();  // 5 flops
+            if (vslipSq > square(SignificantReal)) {
+                const Real vslip = std::sqrt(vslipSq); // expensive: ~25 flops
+                // Express slip velocity as unitless multiple of transition
+                // velocity.
+                const Real v = vslip * ooVtrans;
+                // Must scale viscous coefficient to match unitless velocity.
+                const Real mu=stribeck(us,ud,uv*vtrans,v); // ~10 flops
+                //const Real mu=hollars(us,ud,uv*vtrans,v);
+                const Real fFriction = fNormal * mu;
+                // Force direction on O opposes O's velocity.
+                forceFriction = (-fFriction/vslip)*velTangent; // ~20 flops
+                powerFriction = fFriction * vslip; // always >= 0
+            }
 
-        if (wantDetails) {
-            contactDetails_M->push_back();
-            ContactDetail& detail = contactDetails_M->back();
-            detail.m_contactPt          = contactPt_M;
-            detail.m_patchNormal        = normal_M;
-            detail.m_slipVelocity       = velTangent;
-            detail.m_forceOnSurface2    = forceTotal;
-            detail.m_deformation        = overlap;
-            detail.m_deformationRate    = odot;
-            detail.m_patchArea          = faceArea;
-            detail.m_peakPressure       = (faceArea != 0 ? fNormal/faceArea 
-                                                         : Real(0));
-            detail.m_potentialEnergy    = PE;
-            detail.m_powerLoss          = powerLossThisElement;
+            const Vec3 forceLoss  = forceC + forceFriction;     // 3 flops
+            const Vec3 forceTotal = forceK + forceLoss;         // 3 flops
+
+            // Accumulate the moment and force on the *other* surface as though 
+            // applied at the point of O that is coincident with the resultant
+            // point; we'll move it later.                      (15 flops)
+            batch.force += SpatialVec(r % forceTotal, forceTotal);
+
+            // Accumulate potential energy stored in elastic displacement.
+            batch.potentialEnergy += PE;                // 1 flop
+
+            // Don't include dot(forceK,velNormal) power due to conservative
+            // force here. This way we don't double-count the energy on the way
+            // in as integrated power and potential energy. Although the books
+            // would balance again when the contact is broken, it makes
+            // continuous contact look as though some energy has been lost. In
+            // the "yanking" case above, without including the conservative
+            // power term we will actually lose energy because the deformed
+            // material isn't allowed to push back on us so the energy is lost
+            // to surface vibrations or some other unmodeled effect.
+            const Real powerLossThisElement = powerC + powerFriction; // 1 flop
+            batch.powerLoss += powerLossThisElement;                  // 1 flop
+
+            if (wantDetails) {
+                batch.details.push_back();
+                ContactDetail& detail = batch.details.back();
+                detail.m_contactPt          = contactPt_M;
+                detail.m_patchNormal        = normal_M;
+                detail.m_slipVelocity       = velTangent;
+                detail.m_forceOnSurface2    = forceTotal;
+                detail.m_deformation        = overlap;
+                detail.m_deformationRate    = odot;
+                detail.m_patchArea          = faceArea;
+                detail.m_peakPressure       = (faceArea != 0 ? fNormal/faceArea 
+                                                             : Real(0));
+                detail.m_potentialEnergy    = PE;
+                detail.m_powerLoss          = powerLossThisElement;
+            }
         }
+    };
+    getCompliantContactSubsystemImpl(subsys).forEach(nBatches, processBatch);
+
+    for (const FaceBatchResult& batch : batches) {
+        resultantForceOnOther_M    += batch.force;
+        potentialEnergy            += batch.potentialEnergy;
+        powerLoss                  += batch.powerLoss;
+        weightedCenterOfPressure_M += batch.weightedCenterOfPressure;
+        sumOfAllPressureMoments    += batch.sumOfAllPressureMoments;
+        if (wantDetails)
+            for (const ContactDetail& detail : batch.details)
+                contactDetails_M->push_back(detail);
     }
 }
 
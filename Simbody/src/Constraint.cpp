@@ -2429,7 +2429,7 @@ Constraint::CoordinateCouplerImpl::CoordinateCouplerImpl
     const Array_<MobilizerQIndex>&      coordQIndex)
 :   Implementation(matter, 1, 0, 0), function(function), 
     coordBodies(coordMobod.size()), coordIndices(coordQIndex),
-    temp(coordBodies.size()), referenceCount(new int[1]) 
+    referenceCount(new int[1]) 
 {
     assert(coordBodies.size() == coordIndices.size());
     assert(coordIndices.size() == function->getArgumentSize());
@@ -2441,6 +2441,12 @@ Constraint::CoordinateCouplerImpl::CoordinateCouplerImpl
     }
 }
 
+SBScratchCache& Constraint::CoordinateCouplerImpl::
+updScratchCache(const State& s) const {
+    return getImpl().getCustomImpl().getMyMatterSubsystemRep()
+                                    .updScratchCache(s);
+}
+
 void Constraint::CoordinateCouplerImpl::
 calcPositionErrors     
    (const State&                                    s,
@@ -2448,6 +2454,8 @@ calcPositionErrors
     const Array_<Real,     ConstrainedQIndex>&      constrainedQ,
     Array_<Real>&                                   perr) const
 {
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = scratch.vector((int)coordBodies.size());
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQ(s, constrainedQ, coordBodies[i], coordIndices[i]);
     perr[0] = function->calcValue(temp);
@@ -2460,10 +2468,12 @@ calcPositionDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDot,
     Array_<Real>&                                   pverr) const
 {
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = scratch.vector((int)coordBodies.size());
     pverr[0] = 0;
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
-    Array_<int> components(1);
+    Array_<int>& components = scratch.array<int>(1);
     for (int i = 0; i < temp.size(); ++i) {
         components[0] = i;
         pverr[0] += function->calcDerivative(components, temp)
@@ -2479,12 +2489,14 @@ calcPositionDotDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDotDot,
     Array_<Real>&                                   paerr) const
 {
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = scratch.vector((int)coordBodies.size());
     paerr[0] = 0.0;
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
 
     // TODO this could be made faster by using symmetry.
-    Array_<int> components(2);
+    Array_<int>& components = scratch.array<int>(2);
     for (int i = 0; i < temp.size(); ++i) {
         components[0] = i;
         Real qdoti = getOneQDotFromState(s, coordBodies[i], coordIndices[i]);
@@ -2496,7 +2508,7 @@ calcPositionDotDotErrors
         }
     }
 
-    Array_<int> component(1);
+    Array_<int>& component = scratch.array<int>(1);
     for (int i = 0; i < temp.size(); ++i) {
         component[0] = i;
         paerr[0] += function->calcDerivative(component, temp)
@@ -2514,13 +2526,15 @@ addInPositionConstraintForces
 {
     assert(multipliers.size() == 1);
     assert(bodyForces.size() == 0);
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = scratch.vector((int)coordBodies.size());
 
     const Real lambda = multipliers[0];
 
     for (int i = 0; i < temp.size(); ++i)
         temp[i] = getOneQFromState(s, coordBodies[i], coordIndices[i]);
 
-    Array_<int> components(1);
+    Array_<int>& components = scratch.array<int>(1);
     for (int i = 0; i < temp.size(); ++i) {
         components[0] = i;
         const Real fq = lambda * function->calcDerivative(components, temp);
@@ -2562,11 +2576,12 @@ Constraint::SpeedCouplerImpl::SpeedCouplerImpl
 :   Implementation(matter, 0, 1, 0), function(function), 
     speedBodies(speedBody.size()), speedIndices(speedIndex), 
     coordBodies(coordBody), coordIndices(coordIndex),
-    temp(speedBody.size()+coordBody.size()), referenceCount(new int[1]) 
+    referenceCount(new int[1]) 
 {
     assert(speedBodies.size() == speedIndices.size());
     assert(coordBodies.size() == coordIndices.size());
-    assert(temp.size() == function->getArgumentSize());
+    assert((int)(speedBodies.size() + coordBodies.size())
+           == function->getArgumentSize());
     assert(function->getMaxDerivativeOrder() >= 2);
 
     referenceCount[0] = 1;
@@ -2576,6 +2591,12 @@ Constraint::SpeedCouplerImpl::SpeedCouplerImpl
     }
 }
 
+SBScratchCache& Constraint::SpeedCouplerImpl::
+updScratchCache(const State& s) const {
+    return getImpl().getCustomImpl().getMyMatterSubsystemRep()
+                                    .updScratchCache(s);
+}
+
 // Constraint is f(q,u)=0, i.e. verr=f(q,u).
 void Constraint::SpeedCouplerImpl::
 calcVelocityErrors     
@@ -2584,6 +2605,9 @@ calcVelocityErrors
     const Array_<Real,      ConstrainedUIndex>&     constrainedU,
     Array_<Real>&                                   verr) const
 {
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = 
+        scratch.vector((int)(speedBodies.size() + coordBodies.size()));
     for (int i = 0; i < (int) speedBodies.size(); ++i)
         temp[i] = getOneU(s, constrainedU, speedBodies[i], speedIndices[i]);
     for (int i = 0; i < (int) coordBodies.size(); ++i)
@@ -2601,6 +2625,9 @@ calcVelocityDotErrors
     const Array_<Real,      ConstrainedUIndex>&     constrainedUDot,
     Array_<Real>&                                   vaerr) const 
 {
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = 
+        scratch.vector((int)(speedBodies.size() + coordBodies.size()));
     for (int i = 0; i < (int)speedBodies.size(); ++i)
         temp[i] = getOneUFromState(s, speedBodies[i], speedIndices[i]);
     for (int i = 0; i < (int)coordBodies.size(); ++i) {
@@ -2609,7 +2636,7 @@ calcVelocityDotErrors
         temp[i+speedBodies.size()] = q;
     }
 
-    Array_<int> components(1);
+    Array_<int>& components = scratch.array<int>(1);
     vaerr[0] = 0;
     // Differentiate the u-dependent terms here.
     for (int i = 0; i < (int)speedBodies.size(); ++i) {
@@ -2637,6 +2664,9 @@ addInVelocityConstraintForces
 {
     assert(multipliers.size() == 1);
     const Real lambda = multipliers[0];
+    SBScratchCache::Frame scratch(updScratchCache(s));
+    Vector& temp = 
+        scratch.vector((int)(speedBodies.size() + coordBodies.size()));
 
     for (int i = 0; i < (int) speedBodies.size(); ++i)
         temp[i] = getOneUFromState(s, speedBodies[i], speedIndices[i]);
@@ -2645,7 +2675,7 @@ addInVelocityConstraintForces
             getMatterSubsystem().getMobilizedBody(coordBodies[i])
                                 .getOneQ(s, coordIndices[i]);
 
-    Array_<int> components(1);
+    Array_<int>& components = scratch.array<int>(1);
     // Only the u-dependent terms generate forces.
     for (int i = 0; i < (int) speedBodies.size(); ++i) {
         components[0] = i;
@@ -2674,7 +2704,7 @@ Constraint::PrescribedMotionImpl::PrescribedMotionImpl
     MobilizedBodyIndex coordBody, 
     MobilizerQIndex coordIndex)
 :   Implementation(matter, 1, 0, 0), function(function), 
-    coordIndex(coordIndex), temp(1), referenceCount(new int[1]) 
+    coordIndex(coordIndex), referenceCount(new int[1]) 
 {
     assert(function->getArgumentSize() == 1);
     assert(function->getMaxDerivativeOrder() >= 2);
@@ -2691,9 +2721,8 @@ calcPositionErrors
     const Array_<Real,     ConstrainedQIndex>&      constrainedQ,
     Array_<Real>&                                   perr) const
 {
-    temp[0] = s.getTime();
     perr[0] = getOneQ(s, constrainedQ, coordBody, coordIndex) 
-              - function->calcValue(temp);
+              - function->calcValue(s.getTime());
 }
 
 void Constraint::PrescribedMotionImpl::
@@ -2703,10 +2732,8 @@ calcPositionDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDot,
     Array_<Real>&                                   pverr) const
 {
-    temp[0] = s.getTime();
-    Array_<int> components(1, 0); // i.e., components={0}
     pverr[0] = getOneQDot(s, constrainedQDot, coordBody, coordIndex) 
-               - function->calcDerivative(components, temp);
+               - function->calcDerivative(1, s.getTime());
 }
 
 void Constraint::PrescribedMotionImpl::
@@ -2716,10 +2743,8 @@ calcPositionDotDotErrors
     const Array_<Real,      ConstrainedQIndex>&     constrainedQDotDot,
     Array_<Real>&                                   paerr) const
 {
-    temp[0] = s.getTime();
-    Array_<int> components(2, 0); // i.e., components={0,0}
     paerr[0] = getOneQDotDot(s, constrainedQDotDot, coordBody, coordIndex)  
-               - function->calcDerivative(components, temp);
+               - function->calcDerivative(2, s.getTime());
 }
 
 void Constraint::PrescribedMotionImpl::
@@ -3955,8 +3980,12 @@ calcPositionErrorsFromState(const State& s, Array_<Real>& perr) const {
     const int ncb = getNumConstrainedBodies();
     const int ncq = cInfo.getNumConstrainedQ();
 
-    Array_<Transform, ConstrainedBodyIndex> X_AB(ncb);
-    Array_<Real, ConstrainedQIndex>         cq(ncq);
+    SBScratchCache::Frame scratch
+       (getMyMatterSubsystemRep().updScratchCache(s));
+    Array_<Transform, ConstrainedBodyIndex>& X_AB = 
+        scratch.array<Transform, ConstrainedBodyIndex>(ncb);
+    Array_<Real, ConstrainedQIndex>& cq = 
+        scratch.array<Real, ConstrainedQIndex>(ncq);
 
     for (ConstrainedBodyIndex cbx(0); cbx < ncb; ++cbx) 
         X_AB[cbx] = getBodyTransformFromState(s, cbx);
@@ -3985,8 +4014,12 @@ calcPositionDotErrorsFromState(const State& s, Array_<Real>& pverr) const {
     const int ncb = getNumConstrainedBodies();
     const int ncq = cInfo.getNumConstrainedQ();
 
-    Array_<SpatialVec, ConstrainedBodyIndex> V_AB(ncb);
-    Array_<Real, ConstrainedQIndex>          cqdot(ncq);
+    SBScratchCache::Frame scratch
+       (getMyMatterSubsystemRep().updScratchCache(s));
+    Array_<SpatialVec, ConstrainedBodyIndex>& V_AB = 
+        scratch.array<SpatialVec, ConstrainedBodyIndex>(ncb);
+    Array_<Real, ConstrainedQIndex>& cqdot = 
+        scratch.array<Real, ConstrainedQIndex>(ncq);
 
     for (ConstrainedBodyIndex cbx(0); cbx < ncb; ++cbx) 
         V_AB[cbx] = getBodyVelocityFromState(s, cbx);
@@ -4013,8 +4046,12 @@ calcVelocityErrorsFromState(const State& s, Array_<Real>& verr) const {
     const int ncb = getNumConstrainedBodies();
     const int ncu = cInfo.getNumConstrainedU();
 
-    Array_<SpatialVec, ConstrainedBodyIndex> V_AB(ncb);
-    Array_<Real, ConstrainedUIndex>          cu(ncu);
+    SBScratchCache::Frame scratch
+       (getMyMatterSubsystemRep().updScratchCache(s));
+    Array_<SpatialVec, ConstrainedBodyIndex>& V_AB = 
+        scratch.array<SpatialVec, ConstrainedBodyIndex>(ncb);
+    Array_<Real, ConstrainedUIndex>& cu = 
+        scratch.array<Real, ConstrainedUIndex>(ncu);
 
     for (ConstrainedBodyIndex cbx(0); cbx < ncb; ++cbx) 
         V_AB[cbx] = getBodyVelocityFromState(s, cbx);
@@ -3120,6 +3120,9 @@ void addInPositionConstraintForces
                                     private:
 friend class Constraint::CoordinateCoupler;
 
+// The State's scratch arena, which supplies the function arguments.
+SBScratchCache& updScratchCache(const State& state) const;
+
 //  TOPOLOGY STATE
 const Function*                     function;
 Array_<ConstrainedMobilizerIndex>   coordBodies;
@@ -3128,10 +3131,6 @@ Array_<MobilizerQIndex>             coordIndices;
 //  TOPOLOGY CACHE
 //  None.
 
-//  A reusable temporary variable allocated to the correct size
-//  to hold all the Function arguments.
-mutable Vector                      temp;
-
 // This allows copies to be made of this constraint which share
 // the function object.
 int*                                referenceCount;
@@ -3186,13 +3185,15 @@ void addInVelocityConstraintForces
 //------------------------------------------------------------------------------
                                     private:
 
+// The State's scratch arena, which supplies the function arguments.
+SBScratchCache& updScratchCache(const State& state) const;
+
 const Function*                     function;
 int*                                referenceCount;
 Array_<ConstrainedMobilizerIndex>   speedBodies;
 Array_<MobilizedBodyIndex>          coordBodies;
 Array_<MobilizerUIndex>             speedIndices;
 Array_<MobilizerQIndex>             coordIndices;
-mutable Vector                      temp;
 };
 
 
@@ -3250,7 +3251,6 @@ const Function*             function;
 int*                        referenceCount;
 ConstrainedMobilizerIndex   coordBody;
 MobilizerQIndex             coordIndex;
-mutable Vector              temp;
 };
 
 
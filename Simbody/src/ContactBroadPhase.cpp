@@ -0,0 +1,324 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ContactBroadPhase.h"
+
+#include <algorithm>
+
+using namespace SimTK;
+
+namespace {
+Vec3 elementMin(const Vec3& a, const Vec3& b) 
+{   return Vec3(std::min(a[0],b[0]), std::min(a[1],b[1]), std::min(a[2],b[2])); }
+Vec3 elementMax(const Vec3& a, const Vec3& b) 
+{   return Vec3(std::max(a[0],b[0]), std::max(a[1],b[1]), std::max(a[2],b[2])); }
+}
+
+
+
+//==============================================================================
+//                        INCREMENTAL SWEEP AND PRUNE
+//==============================================================================
+void IncrementalSweepAndPrune::
+findOverlappingPairs(const Array_<Vec4>&            spheres,
+                     Array_<std::pair<int,int> >&   pairs) 
+{
+    const int n = (int)spheres.size();
+    const bool mustRebuild = (n != numBoxes);
+    lower.resize(n); upper.resize(n);
+    bool anyEscaped = false;
+    for (int i=0; i < n; ++i) {
+        const Vec3& center = spheres[i].getSubVec<3>(0);
+        const Real  radius = spheres[i][3];
+        if (!mustRebuild && contains(i, center-Vec3(radius), 
+                                        center+Vec3(radius)))
+            continue;
+        const Vec3 fatRadius(radius*(1+margin));
+        lower[i] = center - fatRadius;
+        upper[i] = center + fatRadius;
+        anyEscaped = true;
+    }
+
+    if (mustRebuild) {
+        numBoxes = n;
+        rebuild();
+    } else if (anyEscaped) {
+        for (int axis=0; axis < 3; ++axis)
+            updateAxis(axis);
+    }
+
+    for (std::uint64_t key : overlapping)
+        pairs.push_back(std::make_pair(int(key >> 32), 
+                                       int(key & 0xffffffffU)));
+}
+
+// Sort all the endpoints from scratch, then find the overlapping pairs by 
+// sweeping along the x axis. This is the only O(n log n) step and happens
+// only when the number of boxes changes.
+void IncrementalSweepAndPrune::rebuild() {
+    overlapping.clear();
+    for (int axis=0; axis < 3; ++axis) {
+        Array_<Endpoint>& ends = endpoints[axis];
+        ends.resize(2*numBoxes);
+        for (int i=0; i < numBoxes; ++i) {
+            ends[2*i]   = Endpoint{lower[i][axis], i, false};
+            ends[2*i+1] = Endpoint{upper[i][axis], i, true};
+        }
+        std::sort(ends.begin(), ends.end());
+    }
+
+    Array_<int> active;
+    for (const Endpoint& e : endpoints[0]) {
+        if (e.isUpper) {
+            Array_<int>::iterator p = std::find(active.begin(), active.end(), 
+                                                e.box);
+            *p = active.back();
+            active.pop_back();
+        } else {
+            for (int other : active)
+                if (boxesOverlap(e.box, other))
+                    overlapping.insert(pairKey(e.box, other));
+            active.push_back(e.box);
+        }
+    }
+}
+
+// Refresh the endpoint values for this axis and restore sorted order with
+// an insertion sort. Every time a lower bound moves ahead of another box's
+// upper bound, those two boxes have begun to overlap along this axis and
+// become an overlapping pair if they also overlap along the other two. 
+// Every time an upper bound moves ahead of another box's lower bound, the
+// boxes have separated. The box bounds have already been updated for all
+// three axes, so the overlap test uses the final configuration and the
+// result doesn't depend on the order in which the axes are processed.
+void IncrementalSweepAndPrune::updateAxis(int axis) {
+    Array_<Endpoint>& ends = endpoints[axis];
+    for (Endpoint& e : ends)
+        e.value = e.isUpper ? upper[e.box][axis] : lower[e.box][axis];
+
+    const int nEnds = (int)ends.size();
+    for (int i=1; i < nEnds; ++i) {
+        const Endpoint e = ends[i];
+        int j = i-1;
+        while (j >= 0 && e < ends[j]) {
+            const Endpoint& f = ends[j];
+            if (e.isUpper != f.isUpper && e.box != f.box) {
+                if (f.isUpper) {    // e is a lower bound
+                    if (boxesOverlap(e.box, f.box))
+                        overlapping.insert(pairKey(e.box, f.box));
+                } else              // e is an upper bound
+                    overlapping.erase(pairKey(e.box, f.box));
+            }
+            ends[j+1] = f;
+            --j;
+        }
+        ends[j+1] = e;
+    }
+}
+
+
+
+//==============================================================================
+//                            DYNAMIC AABB TREE
+//==============================================================================
+void DynamicAABBTree::
+findOverlappingPairs(const Array_<Vec4>&            spheres,
+                     Array_<std::pair<int,int> >&   pairs) 
+{
+    const int n = (int)spheres.size();
+    if (n != (int)leafOfBox.size()) {
+        clear();
+        leafOfBox.resize(n);
+        for (int i=0; i < n; ++i) {
+            const int leaf = allocateNode();
+            nodes[leaf].box = i;
+            setFatBox(leaf, spheres[i]);
+            insertLeaf(leaf);
+            leafOfBox[i] = leaf;
+        }
+    } else {
+        // Reinsert only the leaves whose spheres have left their fat boxes.
+        for (int i=0; i < n; ++i) {
+            const Vec3& center = spheres[i].getSubVec<3>(0);
+            const Vec3  radius(spheres[i][3]);
+            const int leaf = leafOfBox[i];
+            if (!contains(nodes[leaf], center-radius, center+radius)) {
+                removeLeaf(leaf);
+                setFatBox(leaf, spheres[i]);
+                insertLeaf(leaf);
+            }
+        }
+    }
+
+    // Query each sphere's tight box against the fat boxes of the 
+    // higher-numbered spheres. Any overlapping sphere pair has overlapping 
+    // tight boxes, so this finds all of them.
+    if (root < 0) return;
+    Node query;
+    for (int i=0; i < n; ++i) {
+        const Vec3& center = spheres[i].getSubVec<3>(0);
+        const Vec3  radius(spheres[i][3]);
+        query.lower = center - radius;
+        query.upper = center + radius;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if (!overlap(node, query))
+                continue;
+            if (node.isLeaf()) {
+                if (node.box > i)
+                    pairs.push_back(std::make_pair(i, node.box));
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+}
+
+int DynamicAABBTree::allocateNode() {
+    int n;
+    if (freeNodes.empty()) {
+        n = (int)nodes.size();
+        nodes.push_back(Node());
+    } else {
+        n = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    Node& node = nodes[n];
+    node.parent = node.child1 = node.child2 = -1;
+    node.box = -1;
+    return n;
+}
+
+void DynamicAABBTree::freeNode(int n) {
+    nodes[n].box = -1;
+    freeNodes.push_back(n);
+}
+
+void DynamicAABBTree::setFatBox(int leaf, const Vec4& sphere) {
+    const Vec3& center = sphere.getSubVec<3>(0);
+    const Vec3  fatRadius(sphere[3]*(1+margin));
+    nodes[leaf].lower = center - fatRadius;
+    nodes[leaf].upper = center + fatRadius;
+}
+
+// Descend from the root choosing at each level the cheapest place to put the
+// new leaf, measured by the increase in surface area it would cause, then
+// pair it with the sibling found there under a new internal node.
+void DynamicAABBTree::insertLeaf(int leaf) {
+    if (root < 0) {
+        root = leaf;
+        nodes[leaf].parent = -1;
+        return;
+    }
+
+    const Vec3 lo = nodes[leaf].lower, hi = nodes[leaf].upper;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        const Real nodeArea = area(node.lower, node.upper);
+        const Real combinedArea = area(elementMin(node.lower, lo), 
+                                       elementMax(node.upper, hi));
+        // Cost of making a new parent for this node and the leaf, and the
+        // minimum cost of pushing the leaf further down.
+        const Real cost = 2*combinedArea;
+        const Real inheritanceCost = 2*(combinedArea - nodeArea);
+
+        Real childCost[2];
+        const int child[2] = {node.child1, node.child2};
+        for (int c=0; c < 2; ++c) {
+            const Node& ch = nodes[child[c]];
+            const Real grownArea = area(elementMin(ch.lower, lo), 
+                                        elementMax(ch.upper, hi));
+            childCost[c] = (ch.isLeaf() ? grownArea 
+                            : grownArea - area(ch.lower, ch.upper))
+                           + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        index = childCost[0] < childCost[1] ? child[0] : child[1];
+    }
+
+    const int sibling   = index;
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode(); // might move the nodes
+    Node& parent = nodes[newParent];
+    parent.parent = oldParent;
+    parent.lower  = elementMin(nodes[sibling].lower, lo);
+    parent.upper  = elementMax(nodes[sibling].upper, hi);
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent    = newParent;
+
+    if (oldParent < 0)
+        root = newParent;
+    else if (nodes[oldParent].child1 == sibling)
+        nodes[oldParent].child1 = newParent;
+    else
+        nodes[oldParent].child2 = newParent;
+
+    // Enlarge the ancestors' boxes.
+    for (int i = oldParent; i >= 0; i = nodes[i].parent) {
+        Node& node = nodes[i];
+        node.lower = elementMin(nodes[node.child1].lower, 
+                                nodes[node.child2].lower);
+        node.upper = elementMax(nodes[node.child1].upper, 
+                                nodes[node.child2].upper);
+    }
+}
+
+// Detach the leaf and replace its parent by its sibling. The leaf node itself
+// is kept so it can be reinserted.
+void DynamicAABBTree::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    const int parent  = nodes[leaf].parent;
+    const int grand   = nodes[parent].parent;
+    const int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2
+                                                     : nodes[parent].child1;
+    freeNode(parent);
+    nodes[sibling].parent = grand;
+    if (grand < 0) {
+        root = sibling;
+        return;
+    }
+
+    if (nodes[grand].child1 == parent) nodes[grand].child1 = sibling;
+    else                               nodes[grand].child2 = sibling;
+
+    for (int i = grand; i >= 0; i = nodes[i].parent) {
+        Node& node = nodes[i];
+        node.lower = elementMin(nodes[node.child1].lower, 
+                                nodes[node.child2].lower);
+        node.upper = elementMax(nodes[node.child1].upper, 
+                                nodes[node.child2].upper);
+    }
+}
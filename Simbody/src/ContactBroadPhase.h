@@ -0,0 +1,194 @@
+#ifndef SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+#define SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Broad phase algorithms used by the ContactTrackerSubsystem. Each works on
+the axis-aligned bounding boxes of a set of spheres given in a common frame
+and reports every pair (i,j), i<j, whose boxes overlap. That is a superset of
+the overlapping sphere pairs; the caller is expected to finish with an exact
+sphere test. These objects remember what they found last time and are meant
+to be updated with a slowly changing configuration, so they are kept in a
+State cache entry and reused from one realization to the next. They are
+plain values and may be freely copied along with the State. */
+
+#include "SimTKcommon.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+
+namespace SimTK {
+
+//==============================================================================
+//                        INCREMENTAL SWEEP AND PRUNE
+//==============================================================================
+/* Sweep and prune on all three axes. The sorted endpoint lists from the
+previous update are re-sorted with an insertion sort, which is linear when
+little has moved. Each swap of a lower bound with an upper bound means a pair
+of boxes started or stopped overlapping along that axis, so the set of fully
+overlapping pairs is maintained from those swap events alone; the cost is
+proportional to the number of boxes plus the amount of reordering, not to the
+number of pairs that overlap along any one axis. 
+
+The boxes are "fat" like those of the DynamicAABBTree: each is enlarged by a
+margin and its endpoints are moved only when its sphere escapes it. When
+nothing has escaped, the endpoint lists and the overlapping pairs are left
+exactly as they were and an update costs one containment test per box. */
+class IncrementalSweepAndPrune {
+public:
+    IncrementalSweepAndPrune() : numBoxes(-1), margin(Real(0.1)) {}
+
+    /* Update for a new set of spheres (x,y,z,r) and append the overlapping
+    box pairs to `pairs`. If the number of spheres differs from last time
+    everything is rebuilt from scratch. */
+    void findOverlappingPairs(const Array_<Vec4>&              spheres,
+                              Array_<std::pair<int,int> >&     pairs);
+
+    /* The fat box margin as a fraction of each sphere's radius. */
+    void setMargin(Real fractionOfRadius) {margin = fractionOfRadius;}
+
+    void clear() {
+        numBoxes = -1;
+        for (int k=0; k < 3; ++k) endpoints[k].clear();
+        lower.clear(); upper.clear(); overlapping.clear();
+    }
+
+private:
+    struct Endpoint {
+        Real value;
+        int  box;
+        bool isUpper;
+        // Lower bounds sort ahead of equal upper bounds so that touching
+        // boxes count as overlapping.
+        bool operator<(const Endpoint& e) const
+        {   return value < e.value
+                || (value == e.value && !isUpper && e.isUpper); }
+    };
+
+    static std::uint64_t pairKey(int i, int j) {
+        if (i > j) std::swap(i,j);
+        return (std::uint64_t(std::uint32_t(i)) << 32) | std::uint32_t(j);
+    }
+    bool boxesOverlap(int i, int j) const {
+        for (int k=0; k < 3; ++k)
+            if (lower[i][k] > upper[j][k] || lower[j][k] > upper[i][k])
+                return false;
+        return true;
+    }
+    bool contains(int i, const Vec3& lo, const Vec3& hi) const {
+        for (int k=0; k < 3; ++k)
+            if (lo[k] < lower[i][k] || hi[k] > upper[i][k]) return false;
+        return true;
+    }
+
+    void rebuild();
+    void updateAxis(int axis);
+
+    int                                 numBoxes;
+    Real                                margin;
+    Array_<Endpoint>                    endpoints[3];
+    Array_<Vec3>                        lower, upper;   // fat boxes
+    std::unordered_set<std::uint64_t>   overlapping;
+};
+
+
+
+//==============================================================================
+//                            DYNAMIC AABB TREE
+//==============================================================================
+/* A bounding volume hierarchy whose leaves hold "fat" boxes: each sphere's
+box enlarged by a margin proportional to its radius. A leaf is reinserted only
+when its sphere escapes the fat box, so a mostly resting scene leaves the tree
+alone and each update costs a traversal per sphere. Insertion picks the
+sibling that least increases the total surface area of the tree, in the style
+of Box2D's b2DynamicTree. Reported pairs are those whose fat boxes overlap. */
+class DynamicAABBTree {
+public:
+    DynamicAABBTree() : root(-1), margin(Real(0.1)) {}
+
+    void findOverlappingPairs(const Array_<Vec4>&              spheres,
+                              Array_<std::pair<int,int> >&     pairs);
+
+    /* The fat box margin as a fraction of each sphere's radius. */
+    void setMargin(Real fractionOfRadius) {margin = fractionOfRadius;}
+
+    void clear() {
+        nodes.clear(); freeNodes.clear(); leafOfBox.clear(); stack.clear();
+        root = -1;
+    }
+
+private:
+    struct Node {
+        Vec3 lower, upper;
+        int  parent, child1, child2;
+        int  box;   // sphere index for a leaf, -1 for an internal node
+        bool isLeaf() const {return box >= 0;}
+    };
+
+    static Real area(const Vec3& lo, const Vec3& hi) {
+        const Vec3 d = hi - lo;
+        return d[0]*d[1] + d[1]*d[2] + d[2]*d[0];
+    }
+    static bool contains(const Node& n, const Vec3& lo, const Vec3& hi) {
+        for (int k=0; k < 3; ++k)
+            if (lo[k] < n.lower[k] || hi[k] > n.upper[k]) return false;
+        return true;
+    }
+    static bool overlap(const Node& a, const Node& b) {
+        for (int k=0; k < 3; ++k)
+            if (a.lower[k] > b.upper[k] || b.lower[k] > a.upper[k])
+                return false;
+        return true;
+    }
+
+    int  allocateNode();
+    void freeNode(int n);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    void setFatBox(int leaf, const Vec4& sphere);
+
+    Array_<Node>    nodes;
+    Array_<int>     freeNodes;
+    Array_<int>     leafOfBox;
+    Array_<int>     stack;      // traversal workspace
+    int             root;
+    Real            margin;
+};
+
+
+
+//==============================================================================
+//                           CONTACT BROAD PHASE
+//==============================================================================
+/* Per-State workspace holding whichever broad phase structures are in use. */
+class ContactBroadPhase {
+public:
+    IncrementalSweepAndPrune    sweepAndPrune;
+    DynamicAABBTree             aabbTree;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_CONTACT_BROAD_PHASE_H_
@@ -27,11 +27,16 @@
 #include "simbody/internal/SimbodyMatterSubsystem.h"
 #include "simbody/internal/ContactTrackerSubsystem.h"
 
+#include "ContactBroadPhase.h"
+#include "OptionalExecutor.h"
+
 #include <utility>
 using std::pair; using std::make_pair;
 #include <iostream>
 using std::cout; using std::endl;
 #include <set>
+#include <algorithm>
+#include <exception>
 
 using namespace SimTK;
 
@@ -67,6 +72,40 @@ static std::ostream& operator<<(std::ostream& o, const Bubble& bb) {
     return o;
 }
 
+// One surface pair that survived the broad phase, with the surfaces already
+// in the order required by its ContactTracker. The pairs are independent of
+// one another so they can be tracked concurrently; each writes only its own
+// result. Anything thrown is kept to be rethrown afterwards, in pair order.
+// A pair that was found separated last time at exactly the same relative
+// pose is skipped; its result would be the same.
+struct NarrowPhasePair {
+    const Contact& getPrev() const {return prev ? *prev : untracked;}
+
+    void track() {
+        if (skip) return;
+        try {
+            tracker->trackContactUsingCache(getPrev(), X_GS1, *geom1, 
+                                            X_GS2, *geom2, 0/*TODO*/, 
+                                            cache, next);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    const ContactTracker*   tracker;
+    ContactSurfaceIndex     surf1, surf2;
+    Transform               X_GS1, X_GS2;
+    Transform               X_S1S2;     // relative pose
+    const ContactGeometry*  geom1;
+    const ContactGeometry*  geom2;
+    const Contact*          prev;       // null if not previously tracked
+    UntrackedContact        untracked;  // used if prev is null
+    ContactTracker::PairCache cache;    // from last time; updated by tracker
+    bool                    skip;
+    Contact                 next;       // result; might be empty
+    std::exception_ptr      error;
+};
+
 // For spatial sorting of bubbles.
 class BubbleExtent {
 public:
@@ -86,35 +125,49 @@ static std::ostream& operator<<(std::ostream& o, const BubbleExtent& bx) {
 typedef std::map< pair<ContactGeometryTypeId,ContactGeometryTypeId>,
                   pair<ContactTracker*,bool> > TrackerMap;
 
-// This type maps a contact surface onto a set of all the higher-numbered
-// contact surfaces it might be touching, and for each of those we keep
-// a pointer to that pair's Contact object if it is currently being tracked
-// (null if it is new). You must use the *lower* numbered surface as the key 
-// when inserting a pair so that any given pair of surfaces appears just once.
-// However, the surface order in the Contact object will be determined by
-// the order required by the corresponding tracker.
-// TODO: replace with a fast data structure
-typedef std::map<ContactSurfaceIndex,const Contact*> ContactSurfaceSet;
-typedef std::map<ContactSurfaceIndex,ContactSurfaceSet> PairMap;
-
-std::ostream& operator<<(std::ostream& o, const ContactSurfaceSet& css) {
-    ContactSurfaceSet::const_iterator p = css.begin();
-    o << "{";
-    for (; p != css.end(); ++p) {
-        if (p!=css.begin()) o << ", ";
-        o << p->first << ":0x" << p->second;
+// A contact surface pair that needs a narrow phase look, with the *lower*
+// numbered surface first so that any given pair of surfaces appears just 
+// once, and a pointer to that pair's Contact object if it is currently being
+// tracked (null if it is new). However, the surface order in the Contact
+// object will be determined by the order required by the corresponding
+// tracker. These sort by surface pair, with a tracked entry ahead of an 
+// untracked one for the same pair.
+struct SurfacePair {
+    bool operator<(const SurfacePair& other) const {
+        if (low != other.low) return low < other.low;
+        if (high != other.high) return high < other.high;
+        return prev && !other.prev;
     }
-    return o << "}";
-}
+    bool isSamePair(const SurfacePair& other) const 
+    {   return low == other.low && high == other.high; }
 
-std::ostream& operator<<(std::ostream& o, const PairMap& pm) {
-    PairMap::const_iterator p = pm.begin();
-    for (; p != pm.end(); ++p) {
-        if (p != pm.begin()) o << endl;
-        o << p->first << "->" << p->second;
-    }
-    return o;
-}
+    ContactSurfaceIndex low, high;
+    const Contact*      prev;
+};
+
+// What the narrow phase learned about a surface pair the last time it looked
+// at it: the surfaces' relative pose, whether a new pair was found not to be
+// touching, and the tracker's own cache.
+struct PairHistory {
+    ContactSurfaceIndex         low, high;
+    Transform                   X_S1S2;
+    bool                        separated;
+    ContactTracker::PairCache   cache;
+};
+
+// Per-State workspace carried from one realization to the next. The history
+// is sorted by surface pair and covers the pairs that survived the last 
+// broad phase; the other arrays are kept only to reuse their heap space.
+struct ContactTrackerWorkspace {
+    Array_<PairHistory>         history, nextHistory;
+    Array_<Vec4>                spheres;
+    Array_< pair<int,int> >     candidates;
+    Array_<SurfacePair>         interesting;
+    Array_<NarrowPhasePair>     pairs;
+};
+
+bool isSamePose(const Transform& X1, const Transform& X2) 
+{   return X1.p() == X2.p() && X1.R().asMat33() == X2.R().asMat33(); }
 
 } // end of anonymous namespace
 
@@ -126,7 +179,9 @@ class ContactTrackerSubsystemImpl : public Subsystem::Guts {
 public:
 // Constructor registers a default set of Trackers to use with geometry
 // we know about. These can be overridden later.
-ContactTrackerSubsystemImpl() : m_defaultTracker(0) {
+ContactTrackerSubsystemImpl() 
+:   m_defaultTracker(0), 
+    m_broadPhaseMethod(ContactTrackerSubsystem::IncrementalSweepAndPrune) {
     adoptContactTracker(new ContactTracker::HalfSpaceSphere());
     adoptContactTracker(new ContactTracker::SphereSphere());
     adoptContactTracker(new ContactTracker::HalfSpaceEllipsoid());
@@ -224,6 +279,14 @@ int realizeSubsystemTopologyImpl(State& state) const override {
     wThis->m_predictedContactsIx = allocateAutoUpdateDiscreteVariable
         (state, Stage::Dynamics, new Value<ContactSnapshot>(), 
          Stage::Acceleration);  // update depends on accelerations
+    // This is never marked valid; it just carries the broad phase's sorted
+    // lists or tree from one realization to the next.
+    wThis->m_broadPhaseIx = allocateLazyCacheEntry
+        (state, Stage::Topology, new Value<ContactBroadPhase>());
+    // Likewise never valid; this holds what the narrow phase learned about
+    // each surface pair, and reusable scratch space.
+    wThis->m_workspaceIx = allocateLazyCacheEntry
+        (state, Stage::Topology, new Value<ContactTrackerWorkspace>());
 
     const SimbodyMatterSubsystem& matter = getMatterSubsystem();
 
@@ -274,26 +337,91 @@ int realizeSubsystemVelocityImpl(const State& state) const override {
     return 0;
 }
 
-// Adds new pairs to the existing set, if not already present.
-void addInBroadPhasePairs(const State& state, PairMap& pairs) const {
+ContactTrackerWorkspace& updWorkspace(const State& state) const {
+    return Value<ContactTrackerWorkspace>::updDowncast
+        (updCacheEntry(state, m_workspaceIx));
+}
+
+// Appends the pairs whose bubbles touch, as untracked pairs. Some of them
+// may already be present.
+void addInBroadPhasePairs(const State& state, 
+                          ContactTrackerWorkspace& work) const {
     const int numBubbles = getNumBubbles();
     
-    // Perform a sweep-and-prune on a single axis to identify potential 
-    // contacts. First, find which axis has the most variation in body 
-    // locations. That is the axis we will use.
-    // TODO: this one-axis method is not good enough in general
-    
-    Vector_<Vec3> centers(numBubbles);
+    Array_<Vec4>& spheres = work.spheres;
+    spheres.resize(numBubbles);
     for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
         const Bubble&  bubb = m_bubbles[bbx];
         const Surface& surf = m_surfaces[bubb.surface];
-        centers[bbx] = surf.mobod->getBodyTransform(state) 
-                        * bubb.getCenter();
+        spheres[bbx].updSubVec<3>(0) = surf.mobod->getBodyTransform(state) 
+                                        * bubb.getCenter();
+        spheres[bbx][3] = bubb.getRadius();
     }
-    Vec3 average = mean(centers);
+
+    // Find candidate pairs whose bounding boxes overlap using the selected
+    // method. The incremental methods pick up where they left off the last
+    // time this State was realized.
+    Array_< pair<int,int> >& candidates = work.candidates;
+    candidates.clear();
+    ContactBroadPhase& broadPhase = Value<ContactBroadPhase>::updDowncast
+        (updCacheEntry(state, m_broadPhaseIx));
+    switch (m_broadPhaseMethod) {
+    case ContactTrackerSubsystem::SingleAxisSweep:
+        findSingleAxisSweepPairs(spheres, candidates);
+        break;
+    case ContactTrackerSubsystem::IncrementalSweepAndPrune:
+        broadPhase.sweepAndPrune.findOverlappingPairs(spheres, candidates);
+        break;
+    case ContactTrackerSubsystem::DynamicAABBTree:
+        broadPhase.aabbTree.findOverlappingPairs(spheres, candidates);
+        break;
+    }
+
+    for (const pair<int,int>& candidate : candidates) {
+        const BubbleIndex bbx1(candidate.first), bbx2(candidate.second);
+        const Bubble& bubb1 = m_bubbles[bbx1];
+        const Bubble& bubb2 = m_bubbles[bbx2];
+
+        // See if the bubbles are actually touching.
+        const Vec3& center1 = spheres[bbx1].getSubVec<3>(0);
+        const Vec3& center2 = spheres[bbx2].getSubVec<3>(0);
+        if ((center1-center2).normSqr() 
+            > square(bubb1.getRadius()+bubb2.getRadius()))
+            continue; // nope
+
+        // The bubbles are touching. We'll add the corresponding surfaces
+        // to the narrow-phase list unless there are relevant exclusions.
+        const Surface& surf1 = m_surfaces[bubb1.surface];
+        const Surface& surf2 = m_surfaces[bubb2.surface];
+        // Ignore if on the same body.
+        if (surf1.mobod == surf2.mobod) continue;
+        assert(bubb1.surface != bubb2.surface); // duh!
+        // Ignore if surfaces are in a common clique.
+        if (surf1.surface->isInSameClique(*surf2.surface)) continue;
+        // We'll need to do a narrow phase investigation of these two
+        // surfaces; put the lower-numbered one first to avoid duplicates.
+        ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
+        if (low > high) std::swap(low,high);
+        work.interesting.push_back(SurfacePair{low, high, 0});
+    }
+}
+
+// The original broad phase: sort from scratch along the one axis with the
+// most variation in bubble locations and sweep along it. This degrades to
+// O(n^2) when many bubbles overlap along that axis, but it keeps no state.
+static void findSingleAxisSweepPairs(const Array_<Vec4>&            spheres,
+                                     Array_< pair<int,int> >&       pairs) {
+    const int numBubbles = (int)spheres.size();
+    if (numBubbles == 0)
+        return;
+
+    Vec3 average(0);
+    for (int i=0; i < numBubbles; ++i)
+        average += spheres[i].getSubVec<3>(0);
+    average /= numBubbles;
     Vec3 var(0);
-    for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx)
-        var += abs(centers[bbx]-average);
+    for (int i=0; i < numBubbles; ++i)
+        var += abs(spheres[i].getSubVec<3>(0)-average);
     int axis = (var[0] > var[1] ? 0 : 1);
     if (var[2] > var[axis])
         axis = 2;
@@ -302,55 +430,24 @@ void addInBroadPhasePairs(const State& state, PairMap& pairs) const {
     // starting location.
     Array_<BubbleExtent,int> extents(numBubbles);
     for (BubbleIndex bbx(0); bbx < numBubbles; ++bbx) {
-        const Real radius = m_bubbles[bbx].getRadius();
-        const Real center = centers[bbx][axis];
+        const Real radius = spheres[bbx][3];
+        const Real center = spheres[bbx][axis];
         extents[bbx] = BubbleExtent(center-radius, center+radius, bbx);
     }
-    //cout << "Bubble extents:" << extents << "\n";
 
     // Expensive: O(n log n)
     std::sort(extents.begin(), extents.end());
     
     // Now sweep along the axis, finding potential contacts.
-    
     for (int ex1=0; ex1 < numBubbles; ++ex1) {
         const BubbleExtent& extent1 = extents[ex1];
-        const Bubble&       bubb1   = m_bubbles[extent1.index];
-        const Real          radius1 = bubb1.getRadius();
-        const Vec3&         center1 = centers[extent1.index];
-
         // Loop over just the overlapping bubbles.
         for (int ex2(ex1+1); ex2 < numBubbles; ++ex2) {
             const BubbleExtent& extent2 = extents[ex2];
             if (extent2.start > extent1.end)
                 break;  // no more bubbles can overlap with extent1
-
-            // These bubbles do overlap along this axis. See if they are
-            // actually touching.
-            const Bubble& bubb2   = m_bubbles[extent2.index];
-            const Real    radius2 = bubb2.getRadius();
-            const Vec3&   center2 = centers[extent2.index];
-            if ((center1-center2).normSqr() > square(radius1+radius2))
-                continue; // nope
-
-            // The bubbles are touching. We'll add the corresponding surfaces
-            // to the narrow-phase list unless there are relevant exclusions.
-            const Surface& surf1 = m_surfaces[bubb1.surface];
-            const Surface& surf2 = m_surfaces[bubb2.surface];
-            // Ignore if on the same body.
-            if (surf1.mobod == surf2.mobod) continue;
-            assert(bubb1.surface != bubb2.surface); // duh!
-            // Ignore if surfaces are in a common clique.
-            if (surf1.surface->isInSameClique(*surf2.surface)) continue;
-            // We'll need to do a narrow phase investigation of these two
-            // surfaces; use the lower-numbered one as the index to avoid
-            // duplicates.
-            ContactSurfaceIndex low=bubb1.surface, high=bubb2.surface;
-            if (low > high) std::swap(low,high);
-            ContactSurfaceSet& surfSet = pairs[low];
-            // Insert this pair with null Contact if the pair isn't already
-            // in the PairMap.
-            surfSet.insert(make_pair(high,(Contact*)0));
+            pairs.push_back(make_pair((int)extent1.index, 
+                                      (int)extent2.index));
         }
     }
 }
@@ -384,98 +481,145 @@ void ensureActiveContactsUpdated(const State& state) const {
     // TODO: Can we reuse heap space in this cache entry?
     nextActive.clear();
 
-    PairMap interesting;
+    ContactTrackerWorkspace& work = updWorkspace(state);
+    Array_<SurfacePair>& interesting = work.interesting;
+    interesting.clear();
     for (int i=0; i < active.getNumContacts(); ++i) {
         const Contact& contact = active.getContact(i);
         ContactSurfaceIndex low=contact.getSurface1(), 
                             high=contact.getSurface2();
         if (low > high) std::swap(low,high);
-        ContactSurfaceSet& others = interesting[low];
-        assert(others.find(high)==others.end());
-        others[high] = &contact;
+        interesting.push_back(SurfacePair{low, high, &contact});
     }
     for (int i=0; i < predicted.getNumContacts(); ++i) {
         const Contact& contact = predicted.getContact(i);
         ContactSurfaceIndex low=contact.getSurface1(), 
                             high=contact.getSurface2();
         if (low > high) std::swap(low,high);
-        ContactSurfaceSet& others = interesting[low];
-        assert(others.find(high)==others.end());
-        others[high] = &contact;
+        interesting.push_back(SurfacePair{low, high, &contact});
     }
-    // This will ignore pairs that we already inserted above; new ones
-    // will be inserted with null Contact object pointers.
-    addInBroadPhasePairs(state, interesting);
-    //cout << "Interesting pairs:\n" << interesting << "\n";
-
-    PairMap::const_iterator p = interesting.begin();
-    for (; p != interesting.end(); ++p) {
-        const ContactSurfaceIndex index1 = p->first;
+    // New pairs are added with null Contact object pointers. After sorting,
+    // keep just the first entry for each pair, so a pair we were already 
+    // tracking keeps its Contact.
+    addInBroadPhasePairs(state, work);
+    std::sort(interesting.begin(), interesting.end());
+    interesting.erase(std::unique(interesting.begin(), interesting.end(),
+        [](const SurfacePair& a, const SurfacePair& b) 
+        {   return a.isSamePair(b); }), interesting.end());
+
+    // Collect the pairs we have trackers for, in surface pair order. The 
+    // history from last time is in the same order, so we can walk through it
+    // alongside to pick up what we learned about each pair then.
+    const Array_<PairHistory>& history = work.history;
+    int h = 0;
+    Array_<NarrowPhasePair>& pairs = work.pairs;
+    pairs.clear();
+    for (const SurfacePair& candidate : interesting) {
+        const ContactSurfaceIndex index1 = candidate.low;
+        const ContactSurfaceIndex index2 = candidate.high;
+        const ContactGeometry& geom1 = m_surfaces[index1].surface->getShape();
+        const ContactGeometry& geom2 = m_surfaces[index2].surface->getShape();
+        const ContactGeometryTypeId typeId1 = geom1.getTypeId();
+        const ContactGeometryTypeId typeId2 = geom2.getTypeId();
+        if (!hasContactTracker(typeId1,typeId2))
+            continue; // No algorithm available for detecting collisions between these two objects.
+        bool mustReverse;
+        const ContactTracker& tracker = 
+            getContactTracker(typeId1, typeId2, mustReverse);
         const Transform transform1 = 
             m_surfaces[index1].mobod->getBodyTransform(state)
                 * m_surfaces[index1].X_BS;
-        const ContactGeometry& geom1 = m_surfaces[index1].surface->getShape();
-        const ContactGeometryTypeId typeId1 = geom1.getTypeId();
+        const Transform transform2 = 
+            m_surfaces[index2].mobod->getBodyTransform(state)
+                * m_surfaces[index2].X_BS;
+
+        // Put the surfaces in the order required by the tracker.
+        pairs.push_back();
+        NarrowPhasePair& entry = pairs.back();
+        entry.tracker = &tracker;
+        entry.surf1 = (mustReverse? index2:index1);
+        entry.surf2 = (mustReverse? index1:index2);
+        entry.X_GS1 = (mustReverse? transform2:transform1);
+        entry.X_GS2 = (mustReverse? transform1:transform2);
+        entry.X_S1S2 = ~entry.X_GS1*entry.X_GS2;
+        entry.geom1 = (mustReverse? &geom2:&geom1);
+        entry.geom2 = (mustReverse? &geom1:&geom2);
+
+        entry.prev = candidate.prev;
+        if (entry.prev && entry.prev->getCondition() == Contact::Broken)
+            entry.prev = 0; // that contact expired
+        if (!entry.prev) 
+            entry.untracked = UntrackedContact(entry.surf1, entry.surf2);
+
+        while (h < (int)history.size() 
+               && (history[h].low < index1 
+                   || (history[h].low == index1 && history[h].high < index2)))
+            ++h;
+        if (   h < (int)history.size() 
+            && history[h].low == index1 && history[h].high == index2) {
+            entry.cache = history[h].cache;
+            entry.skip = !entry.prev && history[h].separated
+                         && isSamePose(entry.X_S1S2, history[h].X_S1S2);
+        } else {
+            entry.cache.clear();
+            entry.skip = false;
+        }
+    }
 
-        const ContactSurfaceSet& others = p->second;
-        ContactSurfaceSet::const_iterator q = others.begin();
-        for (; q != others.end(); ++q) {
-            const ContactSurfaceIndex index2 = q->first;
-            const Transform transform2 = 
-                m_surfaces[index2].mobod->getBodyTransform(state)
-                    * m_surfaces[index2].X_BS;
-            const ContactGeometry& geom2 = 
-                m_surfaces[index2].surface->getShape();
-            const ContactGeometryTypeId typeId2 = geom2.getTypeId();
-            if (!hasContactTracker(typeId1,typeId2))
-                continue; // No algorithm available for detecting collisions between these two objects.
-            bool mustReverse;
-            const ContactTracker& tracker = 
-                getContactTracker(typeId1, typeId2, mustReverse);
-
-            // Put the surfaces in the order required by the tracker.
-            const ContactSurfaceIndex trackSurf1 = (mustReverse? index2:index1);
-            const ContactSurfaceIndex trackSurf2 = (mustReverse? index1:index2);
-
-            UntrackedContact untracked; // empty handle in case we need it
-            const Contact* prev = q->second;
-            if (prev && prev->getCondition() == Contact::Broken)
-                prev = 0; // that contact expired
-            if (!prev) { 
-                untracked = UntrackedContact(trackSurf1, trackSurf2);
-                prev = &untracked;
-            }
-            Contact next; // empty handle
-            if (mustReverse)
-                tracker.trackContact
-                   (*prev, transform2,geom2, transform1,geom1, 0/*TODO*/, next);
-            else
-                tracker.trackContact
-                   (*prev, transform1,geom1, transform2,geom2, 0/*TODO*/, next);
-
-            if (!next.isEmpty()) {
-                next.setSurfaces(trackSurf1,trackSurf2);
-                next.setContactId(prev->getCondition()==Contact::Untracked
-                                    ? Contact::createNewContactId()
-                                    : prev->getContactId()); // persistent
-                if (   prev->getCondition()==Contact::Untracked
-                    || prev->getCondition()==Contact::Anticipated)
-                    next.setCondition(Contact::NewContact);
-                else { // was NewContact or Ongoing; now Ongoing or Broken
-                    assert(prev->getCondition()==Contact::NewContact
-                           || prev->getCondition()==Contact::Ongoing);
-                    if (next.getTypeId() != BrokenContact::classTypeId())
-                        next.setCondition(Contact::Ongoing);
-                    // Condition will already by Broken for a BrokenContact
-                }
-                nextActive.adoptContact(next);
+    trackNarrowPhasePairs(pairs);
+
+    // Now process the results serially, in the same order as above, so that
+    // the snapshot and any new ContactIds come out the same regardless of
+    // how the pairs were tracked.
+    for (NarrowPhasePair& entry : pairs) {
+        if (entry.error)
+            std::rethrow_exception(entry.error);
+        const Contact* prev = &entry.getPrev();
+        Contact& next = entry.next;
+        if (!next.isEmpty()) {
+            next.setSurfaces(entry.surf1,entry.surf2);
+            next.setContactId(prev->getCondition()==Contact::Untracked
+                                ? Contact::createNewContactId()
+                                : prev->getContactId()); // persistent
+            if (   prev->getCondition()==Contact::Untracked
+                || prev->getCondition()==Contact::Anticipated)
+                next.setCondition(Contact::NewContact);
+            else { // was NewContact or Ongoing; now Ongoing or Broken
+                assert(prev->getCondition()==Contact::NewContact
+                       || prev->getCondition()==Contact::Ongoing);
+                if (next.getTypeId() != BrokenContact::classTypeId())
+                    next.setCondition(Contact::Ongoing);
+                // Condition will already by Broken for a BrokenContact
             }
+            nextActive.adoptContact(next);
         }
     }
 
+    // Remember what we learned about these pairs for next time.
+    Array_<PairHistory>& nextHistory = work.nextHistory;
+    nextHistory.clear();
+    for (const NarrowPhasePair& entry : pairs) {
+        nextHistory.push_back();
+        PairHistory& pairHistory = nextHistory.back();
+        pairHistory.low  = std::min(entry.surf1, entry.surf2);
+        pairHistory.high = std::max(entry.surf1, entry.surf2);
+        pairHistory.X_S1S2 = entry.X_S1S2;
+        pairHistory.separated = !entry.prev && entry.next.isEmpty();
+        pairHistory.cache = entry.cache;
+    }
+    work.history.swap(nextHistory);
+    pairs.clear();
+
     markDiscreteVarUpdateValueRealized(state, m_activeContactsIx);
 }
 
+// Run each pair's ContactTracker, concurrently if we have been given
+// threads; see ParallelExecutor::forEach().
+void trackNarrowPhasePairs(Array_<NarrowPhasePair>& pairs) const {
+    m_narrowPhaseExecutor.forEach((int)pairs.size(), 
+                                  [&](int i) {pairs[i].track();});
+}
+
 // Call this any time after accelerations are known, to ensure that the
 // predicted contact set has been updated for new velocities and accelerations.
 // We can use three sources of information to compute the update:
@@ -546,6 +690,18 @@ getContactTracker(ContactGeometryTypeId id1, ContactGeometryTypeId id2,
     return *m_defaultTracker;
 }
 
+void setBroadPhaseMethod(ContactTrackerSubsystem::BroadPhaseMethod method)
+{   m_broadPhaseMethod = method; }
+ContactTrackerSubsystem::BroadPhaseMethod getBroadPhaseMethod() const
+{   return m_broadPhaseMethod; }
+
+void setNumberOfThreads(int numThreads) {
+    m_narrowPhaseExecutor.setNumberOfThreads(numThreads, 
+                                             "ContactTrackerSubsystem");
+}
+int getNumberOfThreads() const
+{   return m_narrowPhaseExecutor.getNumberOfThreads(); }
+
 int getNumSurfaces() const {return m_surfaces.size();}
 int getNumBubbles()  const {return m_bubbles.size();}
 
@@ -581,6 +737,9 @@ friend class ContactTrackerSubsystem;
 // delete it when replacing or destructing.
 TrackerMap          m_contactTrackers;
 ContactTracker*     m_defaultTracker;
+ContactTrackerSubsystem::BroadPhaseMethod
+                    m_broadPhaseMethod;
+OptionalExecutor    m_narrowPhaseExecutor;
 
     // TOPOLOGY CACHE
 // The pair is the first assigned index, and the number of contact surfaces
@@ -591,6 +750,8 @@ Array_<Surface,ContactSurfaceIndex>     m_surfaces;
 Array_<Bubble,BubbleIndex>              m_bubbles;
 DiscreteVariableIndex                   m_activeContactsIx;
 DiscreteVariableIndex                   m_predictedContactsIx;
+CacheEntryIndex                         m_broadPhaseIx;
+CacheEntryIndex                         m_workspaceIx;
 };
 
 } // namespace SimTK
@@ -658,6 +819,20 @@ void ContactTrackerSubsystem::
 adoptContactTracker(ContactTracker* tracker)
 {   updImpl().adoptContactTracker(tracker); }
 
+void ContactTrackerSubsystem::
+setBroadPhaseMethod(BroadPhaseMethod method)
+{   updImpl().setBroadPhaseMethod(method); }
+
+ContactTrackerSubsystem::BroadPhaseMethod ContactTrackerSubsystem::
+getBroadPhaseMethod() const
+{   return getImpl().getBroadPhaseMethod(); }
+
+void ContactTrackerSubsystem::setNumberOfThreads(int numThreads)
+{   updImpl().setNumberOfThreads(numThreads); }
+
+int ContactTrackerSubsystem::getNumberOfThreads() const
+{   return getImpl().getNumberOfThreads(); }
+
 bool ContactTrackerSubsystem::
 hasContactTracker(ContactGeometryTypeId surface1, 
                   ContactGeometryTypeId surface2) const
@@ -0,0 +1,42 @@
+#ifndef SimTK_SIMBODY_COPYABLE_MUTEX_H_
+#define SimTK_SIMBODY_COPYABLE_MUTEX_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <mutex>
+
+namespace SimTK {
+
+/* A mutex that can be copied along with the subsystem that owns it; the copy
+simply gets a fresh, unlocked mutex of its own. */
+class CopyableMutex : public std::mutex {
+public:
+    CopyableMutex() = default;
+    CopyableMutex(const CopyableMutex&) : std::mutex() {}
+    CopyableMutex& operator=(const CopyableMutex&) {return *this;}
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_COPYABLE_MUTEX_H_
@@ -112,7 +112,7 @@ void ElasticFoundationForceImpl::calcForce
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface1(), 
                 contact.getSurface2(), iter1->second, 
-                contact.getSurface1Faces(), areaScale, bodyForces, pe);
+                contact.getSurface1FaceArray(), areaScale, bodyForces, pe);
         }
 
         if (iter2 != parameters.end()) {
@@ -120,7 +120,7 @@ void ElasticFoundationForceImpl::calcForce
                 static_cast<const TriangleMeshContact&>(contacts[i]);
             processContact(state, contact.getSurface2(), 
                 contact.getSurface1(), iter2->second, 
-                contact.getSurface2Faces(), areaScale, bodyForces, pe);
+                contact.getSurface2FaceArray(), areaScale, bodyForces, pe);
         }
     }
 }
@@ -128,7 +128,7 @@ void ElasticFoundationForceImpl::calcForce
 void ElasticFoundationForceImpl::processContact
    (const State& state, 
     ContactSurfaceIndex meshIndex, ContactSurfaceIndex otherBodyIndex, 
-    const Parameters& param, const std::set<int>& insideFaces,
+    const Parameters& param, const Array_<int>& insideFaces,
     Real areaScale, Vector_<SpatialVec>& bodyForces, Real& pe) const 
 {
     const ContactGeometry& otherObject = subsystem.getBodyGeometry(set, otherBodyIndex);
@@ -140,9 +140,7 @@ void ElasticFoundationForceImpl::processContact
 
     // Loop over all the springs, and evaluate the force from each one.
 
-    for (std::set<int>::const_iterator iter = insideFaces.begin(); 
-                                       iter != insideFaces.end(); ++iter) {
-        int face = *iter;
+    for (const int face : insideFaces) {
         UnitVec3 normal;
         bool inside;
         Vec3 nearestPoint = otherObject.findNearestPoint(t12*param.springPosition[face], inside, normal);
@@ -350,6 +350,17 @@ calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
                              frc, mobilityForces);
 }
 
+void Force::MobilityLinearSpringImpl::
+addInMobilityForcePartials(const State& state, Matrix& dfdq, 
+                           Matrix& dfdu) const 
+{
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    // Same assumption as calcForce(): the u and q indices match.
+    const int ix = mb.getFirstQIndex(state) + m_whichQ;
+    const int iu = mb.getFirstUIndex(state) + m_whichQ;
+    dfdq(iu,ix) -= getParams(state).first;
+}
+
 Real Force::MobilityLinearSpringImpl::
 calcPotentialEnergy(const State& state) const {
     const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
@@ -442,6 +453,15 @@ calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
     mb.applyOneMobilityForce(state, m_whichU, frc, mobilityForces);
 }
 
+void Force::MobilityLinearDamperImpl::
+addInMobilityForcePartials(const State& state, Matrix& dfdq, 
+                           Matrix& dfdu) const 
+{
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const int iu = mb.getFirstUIndex(state) + m_whichU;
+    dfdu(iu,iu) -= getDamping(state);
+}
+
 Real Force::MobilityLinearDamperImpl::
 calcPotentialEnergy(const State& state) const {
     return 0;
@@ -663,6 +683,34 @@ calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
     }
 }
 
+// The force is -k*x*(1+d*qdot) while it is pushing the stop's way, where x
+// is the penetration beyond the nearer bound (the sign of d*qdot flips for 
+// the lower bound). The dependence of qdot on q is ignored.
+void Force::MobilityLinearStopImpl::
+addInMobilityForcePartials(const State& state, Matrix& dfdq, 
+                           Matrix& dfdu) const 
+{
+    const Parameters& param = getParameters(state);
+    if (param.k == 0) return;
+
+    const MobilizedBody& mb = m_matter.getMobilizedBody(m_mobodIx);
+    const Real q = mb.getOneQ(state, m_whichQ);
+    const Real qdot = param.d != 0 ? mb.getOneQDot(state, m_whichQ) 
+                                   : Real(0);
+    Real x, s;
+    if      (q > param.qHigh) {x = q-param.qHigh; s =  1;}
+    else if (q < param.qLow)  {x = q-param.qLow;  s = -1;}
+    else return;
+
+    const Real fraw = param.k*x*(1+s*param.d*qdot);
+    if (s*fraw <= 0) return; // clamped to zero
+
+    const int ix = mb.getFirstQIndex(state) + m_whichQ;
+    const int iu = mb.getFirstUIndex(state) + m_whichQ;
+    dfdq(iu,ix) -= param.k*(1+s*param.d*qdot);
+    dfdu(iu,iu) -= s*param.k*x*param.d;
+}
+
 Real Force::MobilityLinearStopImpl::
 calcPotentialEnergy(const State& state) const {
     const Parameters& param = getParameters(state);
@@ -997,6 +1045,11 @@ void Force::GlobalDamperImpl::calcForce(const State& state, Vector_<SpatialVec>&
     mobilityForces -= damping*matter.getU(state);
 }
 
+void Force::GlobalDamperImpl::addInMobilityForcePartials(const State& state, Matrix& dfdq, Matrix& dfdu) const {
+    for (int i=0; i < dfdu.nrow(); ++i)
+        dfdu(i,i) -= damping;
+}
+
 Real Force::GlobalDamperImpl::calcPotentialEnergy(const State& state) const {
     return 0;
 }
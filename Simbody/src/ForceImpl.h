@@ -84,6 +84,14 @@ public:
     virtual void calcDecorativeGeometryAndAppend
        (const State& s, Stage stage, Array_<DecorativeGeometry>& geom) const {}
 
+    // Add in (+=) this force element's contribution to the partial 
+    // derivatives of the mobility forces with respect to the matter 
+    // subsystem's q and u, in the nu X nq matrix dfdq and the nu X nu matrix
+    // dfdu. This is used to build an approximate Jacobian for implicit
+    // integrators; elements that don't override it are left out of that.
+    virtual void addInMobilityForcePartials
+       (const State& state, Matrix& dfdq, Matrix& dfdu) const {}
+
 private:
         // CONSTRUCTION
     GeneralForceSubsystem* forces;  // just a reference; no delete on destruction
@@ -208,6 +216,8 @@ friend class MobilityLinearSpring;
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInMobilityForcePartials(const State& state, Matrix& dfdq,
+                                    Matrix& dfdu) const override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -258,6 +268,8 @@ friend class MobilityLinearDamper;
                    Vector_<Vec3>& particleForces, Vector& mobilityForces) const
                    override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInMobilityForcePartials(const State& state, Matrix& dfdq,
+                                    Matrix& dfdu) const override;
 
     // Allocate the discrete state variable for the parameters. 
     void realizeTopology(State& s) const override {
@@ -373,6 +385,8 @@ friend class MobilityLinearStop;
 
     // We're not bothering to cache P.E. -- just recalculate it when asked.
     Real calcPotentialEnergy(const State& state) const override; 
+    void addInMobilityForcePartials(const State& state, Matrix& dfdq,
+                                    Matrix& dfdu) const override;
 
     // Allocate the state variables and cache entry. 
     void realizeTopology(State& s) const override {
@@ -561,6 +575,8 @@ public:
     }
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces, Vector_<Vec3>& particleForces, Vector& mobilityForces) const override;
     Real calcPotentialEnergy(const State& state) const override;
+    void addInMobilityForcePartials(const State& state, Matrix& dfdq,
+                                    Matrix& dfdu) const override;
 private:
     const SimbodyMatterSubsystem& matter;
     Real damping;
@@ -30,6 +30,8 @@
 
 #include "ForceImpl.h"
 
+#include <atomic>
+
 namespace SimTK {
 
 //==============================================================================
@@ -144,6 +146,14 @@ friend class Force::Gravity;
         return p.mobodIsImmune[mbx];
     }
 
+    // The counter is atomic so it isn't copied implicitly.
+    GravityImpl(const GravityImpl& src)
+    :   ForceImpl(src), matter(src.matter), defDirection(src.defDirection),
+        defMagnitude(src.defMagnitude), defZeroHeight(src.defZeroHeight),
+        defMobodIsImmune(src.defMobodIsImmune),
+        parametersIx(src.parametersIx), forceCacheIx(src.forceCacheIx),
+        numEvaluations(src.numEvaluations.load()) {}
+
     GravityImpl* clone() const override {
         return new GravityImpl(*this);
     }
@@ -196,7 +206,8 @@ friend class Force::Gravity;
     DiscreteVariableIndex           parametersIx;
     CacheEntryIndex                 forceCacheIx;
 
-    mutable long long               numEvaluations;
+    // Atomic since different States may be realized concurrently.
+    mutable std::atomic<long long>  numEvaluations;
 };
 
 
@@ -38,8 +38,10 @@
 #include <exception>
 
 #include "ForceImpl.h"
+#include "CopyableMutex.h"
 
 #include <memory>
+#include <mutex>
 
 //Threading constants used by CalcForcesTask
 namespace {
@@ -801,15 +803,27 @@ public:
         Vector&                mobilityForces  =
                                     mbs.updMobilityForces (s, Stage::Dynamics);
 
+        // The shared task and executor can serve only one State at a time. If
+        // another thread is already using them (for example because States
+        // are being realized concurrently by System::realizeBatch()), or if
+        // we are ourselves running on a worker thread, use a private task and
+        // calculate the forces serially on this thread.
+        std::unique_lock<std::mutex> lock(calcForcesMutex, std::defer_lock);
+        std::unique_ptr<CalcForcesTask> privateTask;
+        if (ParallelExecutor::isWorkerThread() || !lock.try_lock())
+            privateTask.reset(calcForcesTask->clone());
+        CalcForcesTask& task = privateTask ? *privateTask
+                                           : calcForcesTask.updRef();
+
         // Short circuit if we're not doing any caching here. Note that we're
         // checking whether the *index* is valid (i.e. does the cache entry
         // exist?), not the contents.
         if (!cachedForcesAreValidCacheIndex.isValid()) {
             // Call calcForce() on all Forces, in parallel.
-            calcForcesTask->initializeAll(forces, s,
+            task.initializeAll(forces, s,
                     enabledNonParallelForces, enabledParallelForces,
                     rigidBodyForces, particleForces, mobilityForces);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
+            runCalcForcesTask(task,
                           enabledParallelForces.size() + NumNonParallelThreads);
 
             // Allow forces to do their own realization, but wait until all
@@ -848,21 +862,21 @@ public:
 
             // Run through all the forces, accumulating directly into the
             // force arrays or indirectly into the cache as appropriate.
-            calcForcesTask->initializeCachedAndNonCached(forces, s,
+            task.initializeCachedAndNonCached(forces, s,
                                 enabledNonParallelForces, enabledParallelForces,
                                 rigidBodyForces, particleForces, mobilityForces,
                                 rigidBodyForceCache, particleForceCache,
                                 mobilityForceCache);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
+            runCalcForcesTask(task,
                           enabledParallelForces.size() + NumNonParallelThreads);
             cachedForcesAreValid = true;
         } else {
             // Cache already valid; just need to do the non-cached ones (the
             // ones for which dependsOnlyOnPositions is false).
-            calcForcesTask->initializeNonCached(forces, s,
+            task.initializeNonCached(forces, s,
                                enabledNonParallelForces, enabledParallelForces,
                                rigidBodyForces, particleForces, mobilityForces);
-            calcForcesExecutor->execute(calcForcesTask.updRef(),
+            runCalcForcesTask(task,
                           enabledParallelForces.size() + NumNonParallelThreads);
         }
 
@@ -891,6 +905,16 @@ public:
         return energy;
     }
 
+    void addInMobilityForcePartials(const State& state, Matrix& dfdq, 
+                                    Matrix& dfdu) const override {
+        const Array_<bool>& forceEnabled = Value<Array_<bool> >::downcast
+           (getDiscreteVariable(state, forceEnabledIndex)).get();
+        for (int i = 0; i < (int) forces.size(); ++i)
+            if (forceEnabled[i]) 
+                forces[i]->getImpl().addInMobilityForcePartials(state, 
+                                                                dfdq, dfdu);
+    }
+
     int realizeSubsystemAccelerationImpl(const State& s) const override {
         const Array_<bool>& enabled = Value<Array_<bool> >::downcast
             (getDiscreteVariable(s, forceEnabledIndex));
@@ -920,11 +944,26 @@ public:
     }
 
 private:
+    // Run the task on the shared executor if we own it (task is then the
+    // shared task), otherwise serially on the calling thread.
+    void runCalcForcesTask(CalcForcesTask& task, int times) const {
+        if (&task == calcForcesTask.get()) {
+            calcForcesExecutor->execute(task, times);
+            return;
+        }
+        task.initialize();
+        for (int i = 0; i < times; ++i)
+            task.execute(i);
+        task.finish();
+    }
+
     Array_<Force*>                  forces;
 
-    // For parallel calculation of forces.
+    // For parallel calculation of forces. The mutex guards the shared
+    // executor and task against concurrent realization of different States.
     mutable ClonePtr<ParallelExecutor>               calcForcesExecutor;
     mutable ClonePtr<CalcForcesTask>                 calcForcesTask;
+    mutable CopyableMutex                            calcForcesMutex;
     
     // TOPOLOGY "CACHE"
     // These indices must be filled in during realizeTopology and treated
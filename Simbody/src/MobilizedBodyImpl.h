@@ -1249,6 +1249,10 @@ public:
         for(int i=0; i < 6; i++){
             //Coordinates for this function
             int nc = coordIndices[i].size();
+            if (nc == 1) { // the usual case; no need for a Vector
+                spatialCoords(i) = functions[i]->calcValue(q[coordIndices[i][0]]);
+                continue;
+            }
             Vector fcoords(nc);
     
             for(int j=0; j < nc; j++)
@@ -1720,16 +1724,20 @@ private:
             // Cycle through each row (function describing spatial coordinate)
             Fq = Mat<6,N>(0);
             Vec6 spatialCoords(0);
-            Array_<int> deriv(1);
-            Vector fcoords(coordIndices[0].size()); 
 
             for(int i=0; i < 6; i++){
                 // Determine the number of coordinates for this function
                 int nc = coordIndices[i].size();
-                if (fcoords.size() != nc)
-                    fcoords.resize(nc);
 
-                if (nc > 0) {
+                if (nc == 1) {
+                    // Use the scalar Function interface; nothing to allocate
+                    const Real qi = q(coordIndices[i][0]);
+                    Fq(i, coordIndices[i][0]) = functions[i]->calcDerivative(1, qi);
+                    spatialCoords(i) = functions[i]->calcValue(qi);
+                }
+                else if (nc > 0) {
+                    Array_<int> deriv(1);
+                    Vector fcoords(nc);
                     // Get coordinate values to evaluate the function
                     for(int k = 0; k < nc; k++)
                         fcoords(k) = q(coordIndices[i][k]);
@@ -1769,15 +1777,21 @@ private:
         {
             Mat<6,N> Fqdot(0);
             Vec6 spatialCoords;
-            Array_<int> derivs(2);
-            Vector fcoords(coordIndices[0].size()); 
 
             for(int i=0; i < 6; i++){
                 // Determine the number of coordinates for this function
                 int nc = coordIndices[i].size();
-                if (fcoords.size() != nc)
-                    fcoords.resize(nc);
-                
+
+                if (nc == 1) {
+                    // Use the scalar Function interface; nothing to allocate
+                    const int c = coordIndices[i][0];
+                    Fqdot(i, c) += functions[i]->calcDerivative(2, q(c))*u[c];
+                    spatialCoords(i) = functions[i]->calcValue(q(c));
+                    continue;
+                }
+
+                Array_<int> derivs(2);
+                Vector fcoords(nc);
                 if (nc > 0) {
                     // Get coordinate values to evaluate the function
                     for(int k = 0; k < nc; k++)
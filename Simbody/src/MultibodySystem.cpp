@@ -30,6 +30,7 @@
 #include "simbody/internal/MultibodySystem.h"
 
 #include "MultibodySystemRep.h"
+#include "TreeDynamicsDerivatives.h"
 #include "DecorationSubsystemRep.h"
 
 namespace SimTK {
@@ -300,6 +301,64 @@ int MultibodySystemRep::realizeReportImpl(const State& s) const {
     return 0;
 }
 
+// The udot rows come from the matter subsystem's exact partial derivative
+// operators, which hold the applied forces fixed, plus M^-1 times whatever
+// mobility force partials the force elements can supply. The qdot rows are
+// N for u, leaving out the dependence of N on q. We can only do this for an
+// unconstrained tree of supported mobilizers with no prescribed motion, and
+// when all the state variables are the matter subsystem's q's and u's.
+bool MultibodySystemRep::
+calcYDotJacobianImpl(const State& s, Matrix& dYDotdY) const {
+    const SimbodyMatterSubsystem&    matter = getMatterSubsystem();
+    const SimbodyMatterSubsystemRep& mrep   = matter.getRep();
+    const int nq = s.getNQ(), nu = s.getNU(), ny = s.getNY();
+
+    if (   s.getNZ() != 0 || nq != mrep.getNQ(s) || nu != mrep.getNU(s)
+        || s.getNQErr() != 0 || s.getNUErr() != 0 || s.getNUDotErr() != 0)
+        return false;
+    const SBInstanceCache& ic = mrep.getInstanceCache(s);
+    if (ic.getTotalNumPresQ() + ic.getTotalNumPresU() 
+        + ic.getTotalNumPresUDot() != 0)
+        return false;
+    if (!TreeDynamicsDerivatives::hasSupportedMobilizers(mrep))
+        return false;
+
+    Vector udot; Matrix dudotdq, dudotdu;
+    matter.calcAccelerationIgnoringConstraintsPartials(s, 
+        getMobilityForces(s, Stage::Dynamics), 
+        getRigidBodyForces(s, Stage::Dynamics), udot, dudotdq, dudotdu);
+
+    Matrix dfdq(nu, nq, Real(0)), dfdu(nu, nu, Real(0));
+    for (int i=0; i < (int)forceSubs.size(); ++i)
+        getForceSubsystem(forceSubs[i]).getRep()
+            .addInMobilityForcePartials(s, dfdq, dfdu);
+
+    Vector MInvf;
+    for (int j=0; j < nq; ++j)
+        if (dfdq(j).normInf() != 0) {
+            matter.multiplyByMInv(s, dfdq(j), MInvf);
+            dudotdq(j) += MInvf;
+        }
+    for (int j=0; j < nu; ++j)
+        if (dfdu(j).normInf() != 0) {
+            matter.multiplyByMInv(s, dfdu(j), MInvf);
+            dudotdu(j) += MInvf;
+        }
+
+    dYDotdY.resize(ny, ny);
+    dYDotdY = 0;
+    Vector e(nu, Real(0)), Ne(nq);
+    for (int j=0; j < nu; ++j) {
+        e[j] = 1;
+        mrep.multiplyByN(s, false, e, Ne);
+        dYDotdY(nq+j)(0,nq) = Ne;
+        e[j] = 0;
+    }
+    dYDotdY(nq,0,nu,nq)  = dudotdq;
+    dYDotdY(nq,nq,nu,nu) = dudotdu;
+    return true;
+}
+
 
     ///////////////////////////////////////
     // MULTIBODY SYSTEM GLOBAL SUBSYSTEM //
@@ -444,6 +444,8 @@ public:
         mech.getRep().multiplyByNInv(s,true,fu,fq);
     }  
 
+    bool calcYDotJacobianImpl(const State& s, Matrix& dYDotdY) const override;
+
     // Currently prescribe() and project() affect only the Matter subsystem.
     bool prescribeQImpl(State& state) const override {
         const SimbodyMatterSubsystem& mech = getMatterSubsystem();
@@ -0,0 +1,60 @@
+#ifndef SimTK_SIMBODY_OPTIONAL_EXECUTOR_H_
+#define SimTK_SIMBODY_OPTIONAL_EXECUTOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKcommon.h"
+
+namespace SimTK {
+
+/* The ParallelExecutor behind a subsystem's setNumberOfThreads(). There is
+none until more than one thread is requested. Two callers sharing the
+subsystem (working on different States, say) don't share the threads; the
+one that doesn't get them works serially. Copies share nothing. */
+class OptionalExecutor {
+public:
+    void setNumberOfThreads(int numThreads, const char* className) {
+        SimTK_APIARGCHECK1_ALWAYS(numThreads > 0, className,
+            "setNumberOfThreads",
+            "Number of threads must be positive but was %d.", numThreads);
+        if (numThreads == 1) executor.reset();
+        else executor = new ParallelExecutor(numThreads);
+    }
+
+    int getNumberOfThreads() const
+    {   return executor ? executor->getMaxThreads() : 1; }
+
+    // See ParallelExecutor::forEach().
+    template <class Body> void forEach(int n, const Body& body) const {
+        if (executor) executor.upd()->forEach(n, body);
+        else for (int i=0; i < n; ++i) body(i);
+    }
+
+private:
+    mutable ClonePtr<ParallelExecutor>  executor;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_OPTIONAL_EXECUTOR_H_
@@ -465,6 +465,12 @@ virtual void realizePosition(
 virtual void realizeVelocity(
     const SBStateDigest&         sbs) const=0;
 
+// A node returns true here if its cross-mobilizer hinge matrix H_FM does not
+// depend on q, so that HDot_FM is always zero. The position derivatives of the
+// tree dynamics are available only for systems built from such nodes; see
+// TreeDynamicsDerivatives.
+virtual bool hasConstantH_FM() const {return false;}
+
 // Calculate base-to-tip velocity-dependent terms which will be used
 // in Dynamics stage operators. Assumes realizeVelocity()
 // has already been called on all nodes, as well as any Dynamics 
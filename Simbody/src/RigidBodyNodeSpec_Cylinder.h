@@ -138,6 +138,9 @@ public:
         HDot_FM(1) = SpatialVec( Vec3(0), Vec3(0) );
     }
 
+    // HDot_FM above is zero unless this mobilizer is reversed.
+    bool hasConstantH_FM() const override {return !this->isReversed();}
+
     // Override the computation of reverse-H for this simple mobilizer.
     void calcReverseMobilizerH_FM(
         const SBStateDigest& sbs,
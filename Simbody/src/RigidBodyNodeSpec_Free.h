@@ -218,6 +218,9 @@ void calcAcrossJointVelocityJacobianDot(
     HDot_FM(5) = SpatialVec( Vec3(0), Vec3(0) );
 }
 
+// HDot_FM above is zero unless this mobilizer is reversed.
+bool hasConstantH_FM() const override {return !this->isReversed();}
+
 
 // Calculate qdot=N(q)*u. Precalculations make this fast in Euler angle
 // mode (10 flops); quaternion mode is 27 flops.
@@ -156,6 +156,9 @@ void calcAcrossJointVelocityJacobianDot(
     HDot_FM(2) = SpatialVec( Vec3(0), Vec3(0) );
 }
 
+// HDot_FM above is zero unless this mobilizer is reversed.
+bool hasConstantH_FM() const override {return !this->isReversed();}
+
 };
 
 
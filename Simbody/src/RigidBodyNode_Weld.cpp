@@ -70,6 +70,7 @@ public:
     int  getMaxNQ() const override {return 0;}
     int  getNQInUse(const SBModelVars&) const override {return 0;}
     int  getNUInUse(const SBModelVars&) const override {return 0;}
+    bool hasConstantH_FM() const override {return true;}
     bool isUsingQuaternion(const SBStateDigest&, 
                            MobilizerQIndex& ix) const override
     {   ix.invalidate(); return false; }
@@ -31,6 +31,7 @@
 
 #include "MobilizedBodyImpl.h"
 #include "SimbodyMatterSubsystemRep.h"
+#include "TreeDynamicsDerivatives.h"
 class RigidBodyNode;
 
 #include <string>
@@ -107,6 +108,39 @@ void SimbodyMatterSubsystem::setShowDefaultGeometry(bool show) {
     updRep().setShowDefaultGeometry(show);
 }
 
+void SimbodyMatterSubsystem::setNumberOfThreads(unsigned numThreads) {
+    updRep().setNumberOfThreads(numThreads);
+}
+
+int SimbodyMatterSubsystem::getNumberOfThreads() const {
+    return getRep().getNumberOfThreads();
+}
+
+void SimbodyMatterSubsystem::setParallelSweepThreshold(int minBodiesPerLevel) {
+    updRep().setParallelSweepThreshold(minBodiesPerLevel);
+}
+
+int SimbodyMatterSubsystem::getParallelSweepThreshold() const {
+    return getRep().getParallelSweepThreshold();
+}
+
+void SimbodyMatterSubsystem::
+setSparseConstraintSolverThreshold(int minNumEquations) {
+    updRep().setSparseConstraintSolverThreshold(minNumEquations);
+}
+
+int SimbodyMatterSubsystem::getSparseConstraintSolverThreshold() const {
+    return getRep().getSparseConstraintSolverThreshold();
+}
+
+void SimbodyMatterSubsystem::setConstraintFactorReuseLimit(int maxReuses) {
+    updRep().setConstraintFactorReuseLimit(maxReuses);
+}
+
+int SimbodyMatterSubsystem::getConstraintFactorReuseLimit() const {
+    return getRep().getConstraintFactorReuseLimit();
+}
+
 
 ConstraintIndex SimbodyMatterSubsystem::
 adoptConstraint(Constraint& child) {return updRep().adoptConstraint(child);}
@@ -211,15 +245,22 @@ void SimbodyMatterSubsystem::calcAccelerationIgnoringConstraints
         "Got %d appliedBodyForces but there are %d bodies (including Ground).",
         appliedBodyForces.size(), getNumBodies());
 
-    Vector netHingeForces(getNumMobilities()); // unwanted side effects
-    Array_<SpatialVec,MobilizedBodyIndex> abForcesZ(getNumBodies());   
-    Array_<SpatialVec,MobilizedBodyIndex> abForcesZPlus(getNumBodies());   
-    Vector tau;
-    Vector qdotdot;
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const SBInstanceCache& ic = rep.getInstanceCache(state);
+
+    // Unwanted side effects, in the calling thread's scratch space.
+    SBScratchCache::Frame scratch(rep.updThreadScratchCache());
+    Vector& netHingeForces = scratch.vector(getNumMobilities());
+    Array_<SpatialVec,MobilizedBodyIndex>& abForcesZ =
+        scratch.array<SpatialVec,MobilizedBodyIndex>(getNumBodies());
+    Array_<SpatialVec,MobilizedBodyIndex>& abForcesZPlus =
+        scratch.array<SpatialVec,MobilizedBodyIndex>(getNumBodies());
+    Vector& tau = scratch.vector(ic.getTotalNumPresForces());
+    Vector& qdotdot = scratch.vector(rep.getTotalQAlloc());
 
-    const SBDynamicsCache& dc = getRep().getDynamicsCache(state);
+    const SBDynamicsCache& dc = rep.getDynamicsCache(state);
 
-    getRep().calcTreeAccelerations(state,
+    rep.calcTreeAccelerations(state,
         appliedMobilityForces, appliedBodyForces, dc.presUDotPool,
         netHingeForces, abForcesZ, abForcesZPlus, 
         A_GB, udot, qdotdot, tau);
@@ -374,6 +415,198 @@ void SimbodyMatterSubsystem::calcResidualForce
 
 
 
+//==============================================================================
+//     CALC RESIDUAL FORCE IGNORING CONSTRAINTS DIRECTIONAL DERIVATIVE
+//==============================================================================
+// This is inverse dynamics in Dual arithmetic; see TreeDynamicsDerivatives.
+void SimbodyMatterSubsystem::
+calcResidualForceIgnoringConstraintsDirectionalDerivative
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForcesInG,
+    const Vector&              knownUdot,
+    const Vector&              dq,
+    const Vector&              du,
+    const Vector&              dudot,
+    Vector&                    residualMobilityForces,
+    Vector&                    dResidualMobilityForces) const
+{
+    const char* MethodName =
+        "calcResidualForceIgnoringConstraintsDirectionalDerivative";
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nb = rep.getNumBodies();
+    const int nu = rep.getNU(state);
+    const int nq = rep.getNQ(state);
+
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedMobilityForces.size()==0 || appliedMobilityForces.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d appliedMobilityForces but there are %d mobilities.",
+        appliedMobilityForces.size(), nu);
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedBodyForcesInG.size()==0 || appliedBodyForcesInG.size()==nb,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d appliedBodyForces but there are %d bodies (including Ground).",
+        appliedBodyForcesInG.size(), nb);
+    SimTK_APIARGCHECK2_ALWAYS(
+        knownUdot.size()==0 || knownUdot.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d knownUdots but there are %d mobilities.",
+        knownUdot.size(), nu);
+    SimTK_APIARGCHECK2_ALWAYS(dq.size()==0 || dq.size()==nq,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d dqs but there are %d generalized coordinates.",
+        dq.size(), nq);
+    SimTK_APIARGCHECK2_ALWAYS(du.size()==0 || du.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d dus but there are %d mobilities.", du.size(), nu);
+    SimTK_APIARGCHECK2_ALWAYS(dudot.size()==0 || dudot.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d dudots but there are %d mobilities.", dudot.size(), nu);
+
+    TreeDynamicsDerivatives::checkMobilizers(rep, MethodName);
+    SBScratchCache::Frame scratch(rep.updThreadScratchCache());
+    TreeDynamicsDerivatives derivs(rep, state, scratch);
+    derivs.calcResidualForceDirectionalDerivative(state,
+        appliedMobilityForces, appliedBodyForcesInG, knownUdot, dq, du, dudot,
+        residualMobilityForces, dResidualMobilityForces);
+}
+
+
+
+//==============================================================================
+//       CALC ACCELERATION IGNORING CONSTRAINTS DIRECTIONAL DERIVATIVE
+//==============================================================================
+// Forward dynamics gives udot; differentiating M udot + f_inertial = f_applied
+// along (dq,du) gives M dudot = -df_residual with udot held fixed.
+void SimbodyMatterSubsystem::
+calcAccelerationIgnoringConstraintsDirectionalDerivative
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               dq,
+    const Vector&               du,
+    Vector&                     udot,
+    Vector&                     dudot) const
+{
+    const char* MethodName =
+        "calcAccelerationIgnoringConstraintsDirectionalDerivative";
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nu = rep.getNU(state);
+    const int nq = rep.getNQ(state);
+
+    SimTK_APIARGCHECK2_ALWAYS(dq.size()==0 || dq.size()==nq,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d dqs but there are %d generalized coordinates.",
+        dq.size(), nq);
+    SimTK_APIARGCHECK2_ALWAYS(du.size()==0 || du.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d dus but there are %d mobilities.", du.size(), nu);
+    const SBInstanceCache& ic = rep.getInstanceCache(state);
+    SimTK_ERRCHK_ALWAYS(ic.getTotalNumPresQ() + ic.getTotalNumPresU()
+                        + ic.getTotalNumPresUDot() == 0, MethodName,
+        "Prescribed motion is not supported by this operator.");
+
+    TreeDynamicsDerivatives::checkMobilizers(rep, MethodName);
+    SBScratchCache::Frame scratch(rep.updThreadScratchCache());
+    TreeDynamicsDerivatives derivs(rep, state, scratch);
+
+    // The body accelerations aren't wanted.
+    Vector_<SpatialVec>& A_GB = scratch.spatialVector(getNumBodies());
+    calcAccelerationIgnoringConstraints(state,
+        appliedMobilityForces, appliedBodyForces, udot, A_GB);
+
+    Vector& residual = scratch.vector(nu);
+    Vector& dResidual = scratch.vector(nu);
+    derivs.calcResidualForceDirectionalDerivative(state,
+        appliedMobilityForces, appliedBodyForces, udot, dq, du,
+        scratch.vector(0), residual, dResidual);
+
+    Vector& MInvdResidual = scratch.vector(nu);
+    derivs.multiplyByMInv(state, dResidual, MInvdResidual);
+    dudot.resize(nu);
+    for (int i=0; i < nu; ++i) dudot[i] = -MInvdResidual[i];
+}
+
+
+
+//==============================================================================
+//            CALC RESIDUAL FORCE IGNORING CONSTRAINTS PARTIALS
+//==============================================================================
+// One directional derivative per column; see TreeDynamicsDerivatives.
+void SimbodyMatterSubsystem::calcResidualForceIgnoringConstraintsPartials
+   (const State&               state,
+    const Vector&              appliedMobilityForces,
+    const Vector_<SpatialVec>& appliedBodyForcesInG,
+    const Vector&              knownUdot,
+    Matrix&                    dfdq,
+    Matrix&                    dfdu) const
+{
+    const char* MethodName = "calcResidualForceIgnoringConstraintsPartials";
+    const SimbodyMatterSubsystemRep& rep = getRep();
+    const int nb = rep.getNumBodies();
+    const int nu = rep.getNU(state);
+
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedMobilityForces.size()==0 || appliedMobilityForces.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d appliedMobilityForces but there are %d mobilities.",
+        appliedMobilityForces.size(), nu);
+    SimTK_APIARGCHECK2_ALWAYS(
+        appliedBodyForcesInG.size()==0 || appliedBodyForcesInG.size()==nb,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d appliedBodyForces but there are %d bodies (including Ground).",
+        appliedBodyForcesInG.size(), nb);
+    SimTK_APIARGCHECK2_ALWAYS(
+        knownUdot.size()==0 || knownUdot.size()==nu,
+        "SimbodyMatterSubsystem", MethodName,
+        "Got %d knownUdots but there are %d mobilities.",
+        knownUdot.size(), nu);
+
+    TreeDynamicsDerivatives::checkMobilizers(rep, MethodName);
+    SBScratchCache::Frame scratch(rep.updThreadScratchCache());
+    TreeDynamicsDerivatives derivs(rep, state, scratch);
+    derivs.calcResidualForcePartials(state,
+        appliedMobilityForces, appliedBodyForcesInG, knownUdot, dfdq, dfdu);
+}
+
+
+
+//==============================================================================
+//             CALC ACCELERATION IGNORING CONSTRAINTS PARTIALS
+//==============================================================================
+// Forward dynamics once, then one directional derivative and one M^-1
+// multiply per column.
+void SimbodyMatterSubsystem::calcAccelerationIgnoringConstraintsPartials
+   (const State&                state,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    Vector&                     udot,
+    Matrix&                     dudotdq,
+    Matrix&                     dudotdu) const
+{
+    const char* MethodName = "calcAccelerationIgnoringConstraintsPartials";
+    const SimbodyMatterSubsystemRep& rep = getRep();
+
+    const SBInstanceCache& ic = rep.getInstanceCache(state);
+    SimTK_ERRCHK_ALWAYS(ic.getTotalNumPresQ() + ic.getTotalNumPresU()
+                        + ic.getTotalNumPresUDot() == 0, MethodName,
+        "Prescribed motion is not supported by this operator.");
+
+    TreeDynamicsDerivatives::checkMobilizers(rep, MethodName);
+    SBScratchCache::Frame scratch(rep.updThreadScratchCache());
+    TreeDynamicsDerivatives derivs(rep, state, scratch);
+
+    // The body accelerations aren't wanted.
+    Vector_<SpatialVec>& A_GB = scratch.spatialVector(getNumBodies());
+    calcAccelerationIgnoringConstraints(state,
+        appliedMobilityForces, appliedBodyForces, udot, A_GB);
+
+    derivs.calcAccelerationPartials(state,
+        appliedMobilityForces, appliedBodyForces, udot, dudotdq, dudotdu);
+}
+
+
 //==============================================================================
 //                               MULTIPLY BY M
 //==============================================================================
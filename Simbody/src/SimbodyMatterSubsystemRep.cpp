@@ -47,6 +47,44 @@ SimbodyMatterSubsystemRep::SimbodyMatterSubsystemRep
 }
 
 
+
+//==============================================================================
+//                          PARALLEL TREE SWEEPS
+//==============================================================================
+template <class NodeFunc> void SimbodyMatterSubsystemRep::
+forEachNodeInLevel(int level, const NodeFunc& nodeFunc) const {
+    const RBNodePtrList& nodes = rbNodeLevels[level];
+    const int nNodes = (int)nodes.size();
+    if (nNodes >= parallelSweepThreshold)
+        sweepExecutor.forEach(nNodes, [&](int j) {nodeFunc(*nodes[j]);});
+    else
+        for (int j=0; j < nNodes; ++j)
+            nodeFunc(*nodes[j]);
+}
+
+void SimbodyMatterSubsystemRep::setNumberOfThreads(unsigned numThreads) {
+    sweepExecutor.setNumberOfThreads((int)numThreads,
+                                     "SimbodyMatterSubsystemRep");
+}
+
+int SimbodyMatterSubsystemRep::getNumberOfThreads() const {
+    return sweepExecutor.getNumberOfThreads();
+}
+
+void SimbodyMatterSubsystemRep::
+setParallelSweepThreshold(int minNodesPerLevel) {
+    SimTK_APIARGCHECK_ALWAYS(minNodesPerLevel > 0, "SimbodyMatterSubsystemRep",
+                "setParallelSweepThreshold", 
+                "Minimum number of nodes per level must be positive");
+    parallelSweepThreshold = minNodesPerLevel;
+}
+
+int SimbodyMatterSubsystemRep::getParallelSweepThreshold() const {
+    return parallelSweepThreshold;
+}
+//........................... PARALLEL TREE SWEEPS .............................
+
+
 void SimbodyMatterSubsystemRep::clearTopologyState() {
     // Unilateral constraints reference Constraints but not vice versa,
     // so delete the conditional constraints first.
@@ -477,6 +515,25 @@ int SimbodyMatterSubsystemRep::realizeSubsystemTopologyImpl(State& s) const {
         allocateLazyCacheEntry(s, Stage::Dynamics,
                                new Value<SBConstrainedAccelerationCache>());
 
+    // Constraint matrix factorizations and the structural analysis for the
+    // sparse constraint solver. The structure depends only on which 
+    // constraints are enabled; the factorizations may be reused according to
+    // the reuse limit. All are kept until Instance stage is invalidated.
+    tc.constraintFactorCacheIndex =
+        allocateLazyCacheEntry(s, Stage::Instance,
+                               new Value<SBConstraintFactorCache>());
+
+    // Realized whenever the acceleration factorization is formed afresh, so
+    // while this is valid that factorization is exact for the current 
+    // positions; G M^-1 ~G depends only on q.
+    tc.currentAccelerationFactorCacheIndex =
+        allocateLazyCacheEntry(s, Stage::Position, new Value<bool>(true));
+
+    // Reusable workspace for temporaries; nothing in it is ever valid.
+    tc.scratchCacheIndex =
+        allocateLazyCacheEntry(s, Stage::Topology,
+                               new Value<SBScratchCache>());
+
     tc.valid = true;
 
     // Allocate a cache entry for the topologyCache, and save a copy there.
@@ -485,6 +542,11 @@ int SimbodyMatterSubsystemRep::realizeSubsystemTopologyImpl(State& s) const {
     return 0;
 }
 
+SBScratchCache& SimbodyMatterSubsystemRep::updThreadScratchCache() {
+    static thread_local SBScratchCache arena;
+    return arena;
+}
+
 
 
 //==============================================================================
@@ -1131,8 +1193,8 @@ realizePositionKinematics(const State& state) const {
     // constraint here and put it in the appropriate slot of qErr.
     // Set generalized coordinates: sweep from base to tips.
     for (int i=0 ; i<(int)rbNodeLevels.size() ; i++) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
-            rbNodeLevels[i][j]->realizePosition(stateDigest); 
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node)
+            {   node.realizePosition(stateDigest); });
 
     // Ask the constraints to calculate ancestor-relative kinematics (still 
     // goes in TreePositionCache).
@@ -1239,8 +1301,8 @@ realizeArticulatedBodyInertias(const State& state) const {
 
     // tip-to-base sweep
     for (int i=rbNodeLevels.size()-1 ; i>=0 ; --i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeArticulatedBodyInertiasInward(ic,tpc,abc);
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node)
+            {   node.realizeArticulatedBodyInertiasInward(ic,tpc,abc); });
 
     markCacheValueRealized(state, abx);
 }
@@ -1375,8 +1437,8 @@ realizeVelocityKinematics(const State& state) const {
 
     // Set generalized speeds: sweep from base to tips.
     for (int i=0 ; i<(int)rbNodeLevels.size() ; ++i) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; ++j)
-            rbNodeLevels[i][j]->realizeVelocity(stateDigest); 
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node)
+            {   node.realizeVelocity(stateDigest); });
 
     // Ask the constraints to calculate ancestor-relative velocity kinematics 
     // (still goes in TreeVelocityCache).
@@ -1454,9 +1516,8 @@ realizeArticulatedBodyVelocity(const State& state) const {
     // Order doesn't matter for this calculation. Ground's entries are
     // precalculated so start at level 1.
     for (int i=1 ; i<(int)rbNodeLevels.size() ; i++) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++)
-            rbNodeLevels[i][j]->realizeArticulatedBodyVelocityCache
-                                                            (tpc,tvc,abc,abvc);
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node)
+            {   node.realizeArticulatedBodyVelocityCache(tpc,tvc,abc,abvc); });
 
     markCacheValueRealized(state, abvx);
 }
@@ -2249,7 +2310,10 @@ calcConstraintForcesFromMultipliers
     mobilityForces.resize(getNU(s));      mobilityForces.setToZero();
 
     // These Arrays are for one constraint at a time.
-    Array_<Real> lambdap, lambdav, lambdaa; // multipliers
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Array_<Real>& lambdap = scratch.array<Real>(0); // multipliers
+    Array_<Real>& lambdav = scratch.array<Real>(0);
+    Array_<Real>& lambdaa = scratch.array<Real>(0);
 
     // Loop over all enabled constraints, ask them to generate forces, and
     // accumulate the results in the global problem return vectors.
@@ -2389,11 +2453,12 @@ multiplyByPVATranspose( const State&     s,
     if (nu==0) return;
     if (m==0) {allfuVector.setToZero(); return;}
 
-    // Allocate a temporary body forces vector here. We'll map these to 
+    // Get a temporary body forces vector here. We'll map these to 
     // generalized forces as the penultimate step, then add those into 
     // the output argument allfuVector which will have already accumulated 
     // all directly-generated mobility forces.
-    Vector_<SpatialVec> allF_GVector(nb);
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Vector_<SpatialVec>& allF_GVector = scratch.spatialVector(nb);
 
     // We'll be accumulating constraint forces into these Vectors so zero 
     // them now. Multiple constraints may contribute to forces on the same 
@@ -2416,13 +2481,16 @@ multiplyByPVATranspose( const State&     s,
     // These Arrays are for one constraint at a time. We need separate 
     // memory for these because constrained bodies and constrained u's are
     // not ordered the same as the global ones, nor are they necessarily
-    // contiguous in the global arrays. We're declaring these arrays
-    // outside the loop to avoid heap allocation -- they will grow to the
+    // contiguous in the global arrays. We're taking these arrays from the
+    // scratch cache to avoid heap allocation -- they will grow to the
     // max size needed by any constraint, then get resized as needed without
     // further heap allocation.
-    Array_<SpatialVec,ConstrainedBodyIndex> oneF_G; // body spatial forces
-    Array_<Real,      ConstrainedUIndex>    onefu;  // u-space generalized forces     
-    Array_<Real,      ConstrainedQIndex>    onefq;  // q-space generalized forces     
+    Array_<SpatialVec,ConstrainedBodyIndex>& oneF_G =   // body spatial forces
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
+    Array_<Real,ConstrainedUIndex>& onefu =     // u-space generalized forces
+        scratch.array<Real,ConstrainedUIndex>(0);
+    Array_<Real,ConstrainedQIndex>& onefq =     // q-space generalized forces
+        scratch.array<Real,ConstrainedQIndex>(0);
 
     // Loop over all enabled constraints, ask them to generate forces, and
     // accumulate the results in the global problem arrays (allF_G,allfu).
@@ -2496,7 +2564,7 @@ multiplyByPVATranspose( const State&     s,
 
     // Map the body forces into u-space generalized forces.
     // 12*nu + 18*nb flops.
-    Vector ftmp(nu);
+    Vector& ftmp = scratch.vector(nu);
     multiplyBySystemJacobianTranspose(s, allF_GVector, ftmp);
     allfuVector += ftmp;
 }
@@ -2822,19 +2890,25 @@ calcBiasForMultiplyByPVA(const State& s,
 
     // This array will be resized and filled with the Ancestor-relative
     // coriolis accelerations for the constrained bodies of each velocity
-    // or acceleration-only Constraint in turn; we're declaring it outside the 
-    // loop to minimize heap allocation (resizing down doesn't normally free 
-    // heap space). This won't be used if we have only holonomic constraints.
-    Array_<SpatialVec,ConstrainedBodyIndex> AC_AB;
+    // or acceleration-only Constraint in turn; we're taking it from the 
+    // scratch cache to avoid heap allocation (resizing down doesn't normally
+    // free heap space). This won't be used if we have only holonomic 
+    // constraints.
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Array_<SpatialVec,ConstrainedBodyIndex>& AC_AB = 
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
 
     // Subarrays of these all-zero arrays will be used to supply zero body
     // velocities and qdots (holonomic) or zero udots (nonholonomic and
-    // acceleration-only) for each Constraint in turn; we're declaring 
-    // them outside the loop to minimize heap allocation. They'll grow until 
-    // they hit the maximum size needed by any Constraint.
-    Array_<SpatialVec,ConstrainedBodyIndex> zeroV_AB;
-    Array_<Real,      ConstrainedQIndex>    zeroQDot;
-    Array_<Real,      ConstrainedUIndex>    zeroUDot;
+    // acceleration-only) for each Constraint in turn; they start out empty
+    // here and are refilled with zeroes as they grow, until they hit the 
+    // maximum size needed by any Constraint.
+    Array_<SpatialVec,ConstrainedBodyIndex>& zeroV_AB = 
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
+    Array_<Real,ConstrainedQIndex>& zeroQDot = 
+        scratch.array<Real,ConstrainedQIndex>(0);
+    Array_<Real,ConstrainedUIndex>& zeroUDot = 
+        scratch.array<Real,ConstrainedUIndex>(0);
 
     // Loop over all enabled constraints, ask them to generate constraint
     // errors, and collect those in the output bias vector.
@@ -3285,7 +3359,8 @@ multiplyByPVA(  const State&     s,
     // body spatial accelerations A=J*udot + Jdot*u, depending on how we're
     // interpreting the ulike argument (as a u for holonomic constraints,
     // and as udot for everything else).
-    Vector_<SpatialVec> Julike(nb);
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Vector_<SpatialVec>& Julike = scratch.spatialVector(nb);
     multiplyBySystemJacobian(s, ulike, Julike); // 12*(nu+nb) flops
 
     // Julike serves as V_GB when we're interpreting ulike as u.
@@ -3294,7 +3369,8 @@ multiplyByPVA(  const State&     s,
 
     // If we're doing any nonholonomic or acceleration-only constraints, we'll 
     // finish calculating body spatial accelerations and put them here.
-    Array_<SpatialVec,MobilizedBodyIndex> allA_GB;
+    Array_<SpatialVec,MobilizedBodyIndex>& allA_GB = 
+        scratch.array<SpatialVec,MobilizedBodyIndex>(0);
     if (mNonholo || mAccOnly) {
         allA_GB.resize(nb);
         const Array_<SpatialVec>& 
@@ -3306,7 +3382,7 @@ multiplyByPVA(  const State&     s,
     // If we're going to be dealing with holonomic (position) constraints,
     // generate a q-like Vector via qlike = N * ulike since the position
     // error derivative routine wants qdots.
-    Vector qlike(nq);
+    Vector& qlike = scratch.vector(nq);
     if (mHolo)
         multiplyByN(s, false, ulike, qlike);   // cheap
 
@@ -3319,20 +3395,24 @@ multiplyByPVA(  const State&     s,
 
     // This array will be resized and filled with the Ancestor-relative
     // velocities for the constrained bodies of each holonomic Constraint in 
-    // turn; we're declaring it outside the loop to minimize heap allocation 
+    // turn; we're taking it from the scratch cache to avoid heap allocation 
     // (resizing down doesn't normally free heap space). This won't be used 
     // if we aren't processing holonomic constraints.
-    Array_<SpatialVec,ConstrainedBodyIndex> V_AB;
+    Array_<SpatialVec,ConstrainedBodyIndex>& V_AB = 
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
     // Same, but for each holonomic constraint's qdot subset.
-    Array_<Real,ConstrainedQIndex> qdot;
+    Array_<Real,ConstrainedQIndex>& qdot = 
+        scratch.array<Real,ConstrainedQIndex>(0);
 
     // This array will be resized and filled with the Ancestor-relative
     // accelerations for the constrained bodies of each velocity
     // or acceleration-only Constraint in turn. This won't be used if we have 
     // only holonomic constraints.
-    Array_<SpatialVec,ConstrainedBodyIndex> A_AB;
+    Array_<SpatialVec,ConstrainedBodyIndex>& A_AB = 
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
     // Same, but for each nonholonomic/acconly constraint's udot subset.
-    Array_<Real,ConstrainedUIndex> udot;
+    Array_<Real,ConstrainedUIndex>& udot = 
+        scratch.array<Real,ConstrainedUIndex>(0);
 
     // Loop over all enabled constraints, ask them to generate constraint
     // errors, and collect those in the output argument PVAu. Remove bias
@@ -3495,11 +3575,10 @@ calcPVA(const State&     s,
 // removing the Gp columns of G in the final operation. Note: the resulting
 // matrix is *not* a submatrix of G*M^-1*~G!
 //
-// Note that we do not require contiguous storage for GMInvGt's columns, 
-// although we'll take advantage of it if they are. If not, we'll work in
-// a contiguous temp and then copy back. This is because we want to allow
-// any matrix at the Simbody API level and we don't want to force the API
-// method to have to allocate a whole new mXm matrix when all we need for
+// Note that we do not require contiguous storage for GMInvGt's columns; we
+// work in a contiguous temp and then copy back. This is because we want to
+// allow any matrix at the Simbody API level and we don't want to force the 
+// API method to have to allocate a whole new mXm matrix when all we need for
 // a temporary here is an m-length temporary.
 //
 // Complexity is O(m^2 + m*n) = O(m*n).
@@ -3525,35 +3604,34 @@ calcGMInvGt(const State&   s,
     GMInvGt.resize(m,m);
     if (m==0) return;
 
-    // If the output matrix doesn't have columns in contiguous memory, we'll
-    // allocate a contiguous-memory temp that we can use to hold one column
-    // at a time as we compute them.
-    const bool columnsAreContiguous = GMInvGt(0).hasContiguousData();
-    Vector GMInvGt_j(columnsAreContiguous ? 0 : m);
+    // Each column is formed in a contiguous temporary and copied out element
+    // by element so that we needn't create column views of GMInvGt, which
+    // may not have contiguous columns anyway.
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Vector& GMInvGt_j = scratch.vector(m);
 
     // These two temporaries are always needed to hold one column of Gt,
     // then one column of M^-1 * Gt.
-    Vector Gtcol(nu), MInvGtcol(nu);
+    Vector& Gtcol     = scratch.vector(nu);
+    Vector& MInvGtcol = scratch.vector(nu);
 
     // Precalculate bias so we can perform multiplication by G efficiently.
-    Vector bias(m);
+    Vector& bias = scratch.vector(m);
     calcBiasForMultiplyByPVA(s,true,true,true,bias);
    
     // Lambda is used to pluck out one column at a time of Gt. Exactly one
     // element at a time of lambda will be 1, the rest are 0.
-    Vector lambda(m, Real(0));
+    Vector& lambda = scratch.vector(m);
+    lambda.setToZero();
 
     for (int j=0; j < m; ++j) {
         lambda[j] = 1;
         multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
         lambda[j] = 0;
         multiplyByMInv(s, Gtcol, MInvGtcol);
-        if (columnsAreContiguous)
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt(j));
-        else {
-            multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
-            GMInvGt(j) = GMInvGt_j;
-        }
+        multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGt_j);
+        for (int i=0; i < m; ++i)
+            GMInvGt(i,j) = GMInvGt_j[i];
     }
 } 
 
@@ -3689,11 +3767,15 @@ calcConstraintAccelerationErrors
     ArrayView_<Real>                    allAerr (&pvaerr[0],  &pvaerr[0]  + m );
 
     // These arrays will be resized and filled with the input needs of each 
-    // Constraint in turn. We're declaring them outside the loop to minimize 
+    // Constraint in turn. We're taking them from the scratch cache to avoid
     // heap allocation (resizing down doesn't normally free heap space). 
-    Array_<SpatialVec,ConstrainedBodyIndex> A_AB;
-    Array_<Real,ConstrainedQIndex> qdd; // holonomic only
-    Array_<Real,ConstrainedUIndex> ud;  // nonholonomic or acc-only
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Array_<SpatialVec,ConstrainedBodyIndex>& A_AB = 
+        scratch.array<SpatialVec,ConstrainedBodyIndex>(0);
+    Array_<Real,ConstrainedQIndex>& qdd =   // holonomic only
+        scratch.array<Real,ConstrainedQIndex>(0);
+    Array_<Real,ConstrainedUIndex>& ud =    // nonholonomic or acc-only
+        scratch.array<Real,ConstrainedUIndex>(0);
 
     // Loop over all enabled constraints, ask them to generate constraint
     // errors, and collect those in the output argument pvaerr.
@@ -4201,7 +4283,7 @@ int SimbodyMatterSubsystemRep::projectQ
     // initialization.
     const bool localOnly = opts.isOptionSet(ProjectOptions::LocalOnly);
     // We are permitted to use an out-of-date Jacobian for projection unless
-    // this is set. TODO: always using full Newton at the moment.
+    // this is set.
     const bool forceFullNewton =
         opts.isOptionSet(ProjectOptions::ForceFullNewton);
 
@@ -4231,9 +4313,11 @@ int SimbodyMatterSubsystemRep::projectQ
     //
     // This is a nonlinear least squares problem. Below is a full Newton 
     // iteration since we recalculate the iteration matrix each time around the
-    // loop. TODO: a solution could be found using the same iteration matrix, 
-    // since we are projecting from (presumably) not too far away. Q1: will it
-    // be the same solution? Q2: if not, does it matter?
+    // loop, unless the reuse limit permits us to start with a factorization
+    // left over from an earlier projection (still with its old weights). Then
+    // it is a modified Newton iteration, and we switch to full Newton as soon
+    // as it fails to converge quickly. The solution isn't quite the weighted
+    // least squares one in that case but it is still within accuracy.
 
     // These will be updated as we go.
     Real perrNormAchieved = perrNormOnEntry;
@@ -4265,21 +4349,34 @@ int SimbodyMatterSubsystemRep::projectQ
     Vector dfq_WLS(nfq), du(nu), dq(nq); // = Wq^+ dq_WLS
     Vector udfq_WLS(hasPrescribedMotion ? nq : 0); // unpacked if needed
     udfq_WLS.setToZero(); // must initialize unwritten elements
-    FactorQTZ Pqwr_qtz;
+    Vector Tp_perr;
+    SBConstraintFactorCache::ReusableFactor& Pqwr = 
+        updConstraintFactorCache(s).positionFactor;
+    bool useOldFactor = !forceFullNewton 
+                        && Pqwr.isReusable(constraintFactorReuseLimit);
+    if (useOldFactor) ++Pqwr.numReuses;
+    const FactorQTZ& Pqwr_qtz = Pqwr.qtz;
     Real prevPerrNormAchieved = perrNormAchieved; // watch for divergence
     bool diverged = false;
     const int MaxIterations  = 20;
     do {
-        calcWeightedPqrTranspose(s, perrWeights, uAbsScale, Pqwrt);//nfq X mp
+        if (!useOldFactor) {
+            calcWeightedPqrTranspose(s, perrWeights, uAbsScale, Pqwrt);//nfq X mp
 
-        // This factorization acts like a pseudoinverse.
-        Pqwr_qtz.factor<Real>(~Pqwrt, conditioningTol); 
-
-        //printf("projectQ %d: m=%d condTol=%g rank=%d rcond=%g\n",
-        //    nItsUsed, Pqwrt.ncol(), conditioningTol, Pqwr_qtz.getRank(),
-        //    Pqwr_qtz.getRCondEstimate());
+            // This factorization acts like a pseudoinverse.
+            Pqwr.qtz.factor<Real>(~Pqwrt, conditioningTol); 
+            Pqwr.rowWeights = perrWeights;
+            Pqwr.colScale   = uAbsScale;
+            Pqwr.valid      = true;
+            Pqwr.numReuses  = 0;
+
+            //printf("projectQ %d: m=%d condTol=%g rank=%d rcond=%g\n",
+            //    nItsUsed, Pqwrt.ncol(), conditioningTol, Pqwr_qtz.getRank(),
+            //    Pqwr_qtz.getRCondEstimate());
+        }
 
-        Pqwr_qtz.solve(scaledPerrs, dfq_WLS); // this is weighted dq_WLS=Wq*dq
+        Tp_perr = pErrs.rowScale(Pqwr.rowWeights);
+        Pqwr_qtz.solve(Tp_perr, dfq_WLS); // this is weighted dq_WLS=Wq*dq
         lastChangeMadeWRMS = dfq_WLS.normRMS(); // change in weighted norm
 
         // switch back to unweighted dq=Wq^+*dq_WLS
@@ -4291,7 +4388,7 @@ int SimbodyMatterSubsystemRep::projectQ
             multiplyByNInv(s,false,dfq_WLS,du);
         }
         // Here du = du_WLS = N^+ * dq_WLS
-        du.rowScaleInPlace(uAbsScale); // Now du = Wu^-1 * du_WLS.
+        du.rowScaleInPlace(Pqwr.colScale); // Now du = Wu^-1 * du_WLS.
         multiplyByN(s,false,du,dq);     // dq = N*du
 
         // This causes quaternions to become unnormalized, but it doesn't
@@ -4308,6 +4405,21 @@ int SimbodyMatterSubsystemRep::projectQ
                                       : scaledPerrs.normRMS();
         ++nItsUsed;
 
+        // An old factorization must reduce the error substantially each time
+        // or we'll switch to a fresh one, undoing this step if it didn't help.
+        if (useOldFactor && perrNormAchieved > consAccuracyToTryFor
+            && perrNormAchieved > Real(0.5)*prevPerrNormAchieved) {
+            if (perrNormAchieved > prevPerrNormAchieved) {
+                updQ(s) += dq;
+                realizeSubsystemPosition(s);
+                scaledPerrs = pErrs.rowScale(perrWeights);
+                perrNormAchieved = prevPerrNormAchieved;
+            }
+            prevPerrNormAchieved = perrNormAchieved;
+            useOldFactor = false;
+            continue;
+        }
+
         if (localOnly && nItsUsed >= 2 
             && perrNormAchieved > prevPerrNormAchieved) {
             // perr norm got worse; restore to end of previous iteration
@@ -4393,18 +4505,18 @@ int SimbodyMatterSubsystemRep::projectQ
             Vector qErrest_0(qErrest);
             zeroKnownQ(s, qErrest_0); // zero out prescribed entries
             multiplyByPq(s, bias_p, qErrest_0, Tp_Pq_qErrest); // (Pq*qErrest)_r
-            Tp_Pq_qErrest.rowScaleInPlace(perrWeights); // now Tp*(Pq*qErrest)_r
+            Tp_Pq_qErrest.rowScaleInPlace(Pqwr.rowWeights); // now Tp*(Pq*qErrest)_r
             Pqwr_qtz.solve(Tp_Pq_qErrest, dfq_WLS); // weighted
             unpackFreeQ(s, dfq_WLS, udfq_WLS); // zeroes in q_p slots
             multiplyByNInv(s,false,udfq_WLS,du);
         } else {
             multiplyByPq(s, bias_p, qErrest, Tp_Pq_qErrest); // Pq*qErrest
-            Tp_Pq_qErrest.rowScaleInPlace(perrWeights); // now Tp*Pq*qErrest
+            Tp_Pq_qErrest.rowScaleInPlace(Pqwr.rowWeights); // now Tp*Pq*qErrest
             Pqwr_qtz.solve(Tp_Pq_qErrest, dfq_WLS); // weighted
             multiplyByNInv(s,false,dfq_WLS,du);
         }
         // Here du = du_WLS = N^+ * dq_WLS
-        du.rowScaleInPlace(uAbsScale); // now du = Wu^-1 * du_WLS
+        du.rowScaleInPlace(Pqwr.colScale); // now du = Wu^-1 * du_WLS
         multiplyByN(s,false,du,dq);     // dq = N*du
         qErrest -= dq; // unweighted
     }
@@ -4744,7 +4856,7 @@ int SimbodyMatterSubsystemRep::projectU
     // initialization.
     const bool localOnly = opts.isOptionSet(ProjectOptions::LocalOnly);
     // We are permitted to use an out-of-date Jacobian for projection unless
-    // this is set. TODO: always using modified Newton at the moment.
+    // this is set.
     const bool forceFullNewton =
         opts.isOptionSet(ProjectOptions::ForceFullNewton);
 
@@ -4803,31 +4915,50 @@ int SimbodyMatterSubsystemRep::projectU
     Vector du(nu); // unpacked into here if necessary
     if (hasPrescribedMotion)
         du.setToZero(); // must initialize unwritten elements
-
-    calcWeightedPVrTranspose(s, pverrWeights, uRelScale, PVwrt);
-    // PVwrt is now Eu^-1 (Pt Vt) Tpv
-
-    // Calculate pseudoinverse (just once)
-    FactorQTZ PVwr_qtz;
-    PVwr_qtz.factor<Real>(~PVwrt, conditioningTol);
-
-    //printf("projectU m=%d condTol=%g rank=%d rcond=%g\n",
-    //    PVwrt.ncol(), conditioningTol, PVwr_qtz.getRank(),
-    //    PVwr_qtz.getRCondEstimate());
+    Vector Tpv_pverr;
+
+    // The reuse limit may let us use the pseudoinverse from an earlier 
+    // projection at a nearby configuration, along with its old weights. If
+    // that doesn't converge quickly we'll switch to a fresh one.
+    SBConstraintFactorCache::ReusableFactor& PVwr = 
+        updConstraintFactorCache(s).velocityFactor;
+    bool useOldFactor = !forceFullNewton 
+                        && PVwr.isReusable(constraintFactorReuseLimit);
+    if (useOldFactor) ++PVwr.numReuses;
+    const FactorQTZ& PVwr_qtz = PVwr.qtz;
+    bool haveNewFactor = false;
 
     Real prevPVerrNormAchieved = pverrNormAchieved; // watch for divergence
     bool diverged = false;
     const int MaxIterations  = 7;
     do {
-        PVwr_qtz.solve(scaledPVerrs, dfu_WLS);
+        if (!useOldFactor && !haveNewFactor) {
+            calcWeightedPVrTranspose(s, pverrWeights, uRelScale, PVwrt);
+            // PVwrt is now Eu^-1 (Pt Vt) Tpv
+
+            // Calculate pseudoinverse (just once per projection)
+            PVwr.qtz.factor<Real>(~PVwrt, conditioningTol);
+            PVwr.rowWeights = pverrWeights;
+            PVwr.colScale   = uRelScale;
+            PVwr.valid      = true;
+            PVwr.numReuses  = 0;
+            haveNewFactor   = true;
+
+            //printf("projectU m=%d condTol=%g rank=%d rcond=%g\n",
+            //    PVwrt.ncol(), conditioningTol, PVwr_qtz.getRank(),
+            //    PVwr_qtz.getRCondEstimate());
+        }
+
+        Tpv_pverr = pvErrs.rowScale(PVwr.rowWeights);
+        PVwr_qtz.solve(Tpv_pverr, dfu_WLS);
         lastChangeMadeWRMS = dfu_WLS.normRMS(); // change in weighted norm
 
         // switch back to unweighted du=Eu^-1*du_WLS
         if (hasPrescribedMotion) {
             unpackFreeU(s, dfu_WLS, du);    // zeroes in u_p slots
-            du.rowScaleInPlace(uRelScale); // du=Eu^-1*unpack(dfu_WLS)
+            du.rowScaleInPlace(PVwr.colScale); // du=Eu^-1*unpack(dfu_WLS)
         } else {
-            du = dfu_WLS.rowScale(uRelScale); // unscale: du=Eu^-1*du_WLS
+            du = dfu_WLS.rowScale(PVwr.colScale); // unscale: du=Eu^-1*du_WLS
         }
         updU(s) -= du;
         results.setAnyChangeMade(true);
@@ -4839,6 +4970,19 @@ int SimbodyMatterSubsystemRep::projectU
                                        : scaledPVerrs.normRMS();
         ++nItsUsed;
 
+        if (useOldFactor && pverrNormAchieved > consAccuracyToTryFor
+            && pverrNormAchieved > Real(0.5)*prevPVerrNormAchieved) {
+            if (pverrNormAchieved > prevPVerrNormAchieved) {
+                updU(s) += du;
+                realizeSubsystemVelocity(s);
+                scaledPVerrs = pvErrs.rowScale(pverrWeights);
+                pverrNormAchieved = prevPVerrNormAchieved;
+            }
+            prevPVerrNormAchieved = pverrNormAchieved;
+            useOldFactor = false;
+            continue;
+        }
+
         if (localOnly && nItsUsed >= 2 
             && pverrNormAchieved > prevPVerrNormAchieved) {
             // Velocity norm worse -- restore to end of previous iteration.
@@ -4920,15 +5064,15 @@ int SimbodyMatterSubsystemRep::projectU
             zeroKnownU(s, uErrest_0); // zero out prescribed entries
             multiplyByPVA(s,true,true,false,bias_pv,
                             uErrest_0,Tpv_PV_uErrest);
-            Tpv_PV_uErrest.rowScaleInPlace(pverrWeights); // = Tpv*PV*uErrest_0
+            Tpv_PV_uErrest.rowScaleInPlace(PVwr.rowWeights); // = Tpv*PV*uErrest_0
             PVwr_qtz.solve(Tpv_PV_uErrest, dfu_WLS);
             unpackFreeU(s, dfu_WLS, du); // still weighted
         } else {
             multiplyByPVA(s,true,true,false,bias_pv,uErrest,Tpv_PV_uErrest);
-            Tpv_PV_uErrest.rowScaleInPlace(pverrWeights); // = Tpv PV uErrEst
+            Tpv_PV_uErrest.rowScaleInPlace(PVwr.rowWeights); // = Tpv PV uErrEst
             PVwr_qtz.solve(Tpv_PV_uErrest, du);
         }
-        du.rowScaleInPlace(uRelScale); // now du=Eu^-1*unpack(dfu_WLS)
+        du.rowScaleInPlace(PVwr.colScale); // now du=Eu^-1*unpack(dfu_WLS)
         uErrest -= du; // this is unweighted now
     }
    
@@ -4986,8 +5130,7 @@ void SimbodyMatterSubsystemRep::calcTreeForwardDynamicsOperator(
     udot.resize(topologyCache.nDOFs);
     qdotdot.resize(topologyCache.maxNQs);
 
-    Vector              totalMobilityForces;
-    Vector_<SpatialVec> totalBodyForces;
+    SBScratchCache::Frame scratch(updThreadScratchCache());
 
     // inputs
 
@@ -4996,12 +5139,17 @@ void SimbodyMatterSubsystemRep::calcTreeForwardDynamicsOperator(
     const Vector_<SpatialVec>* bodyForcesToUse      = &bodyForces;
 
     if (extraMobilityForces) {
-        totalMobilityForces = mobilityForces - *extraMobilityForces; // note sign
+        Vector& totalMobilityForces = scratch.vector(mobilityForces.size());
+        totalMobilityForces = mobilityForces;
+        totalMobilityForces -= *extraMobilityForces; // note sign
         mobilityForcesToUse = &totalMobilityForces;
     }
 
     if (extraBodyForces) {
-        totalBodyForces = bodyForces - *extraBodyForces;    // note sign
+        Vector_<SpatialVec>& totalBodyForces = 
+            scratch.spatialVector(bodyForces.size());
+        totalBodyForces = bodyForces;
+        totalBodyForces -= *extraBodyForces;    // note sign
         bodyForcesToUse = &totalBodyForces;
     }
 
@@ -5070,9 +5218,9 @@ void SimbodyMatterSubsystemRep::realizeTreeForwardDynamics(
 // forces, calculate all acceleration results resulting from those forces AND 
 // enforcement of the acceleration constraints. The results go into the return 
 // arguments here. This routine *does not* affect the State cache -- it is an 
-// operator. In typical usage, the output arguments actually will be part of 
-// the state cache to effect a response, but this method can also be used to 
-// effect an operator.
+// operator, and may be called on the same State from several threads at once.
+// realizeLoopForwardDynamics() does the same calculation but is allowed to 
+// keep the constraint factorization in the State for reuse.
 void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
    (const State& s, 
     const Vector&                   mobilityForces,
@@ -5084,6 +5232,23 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
     Vector&                         qdotdot,
     Vector&                         multipliers,
     Vector&                         udotErr) const
+{
+    calcLoopForwardDynamics(s, mobilityForces, particleForces, bodyForces,
+        tac, cac, udot, qdotdot, multipliers, udotErr, false);
+}
+
+void SimbodyMatterSubsystemRep::calcLoopForwardDynamics
+   (const State& s, 
+    const Vector&                   mobilityForces,
+    const Vector_<Vec3>&            particleForces,
+    const Vector_<SpatialVec>&      bodyForces,
+    SBTreeAccelerationCache&        tac,
+    SBConstrainedAccelerationCache& cac,
+    Vector&                         udot,
+    Vector&                         qdotdot,
+    Vector&                         multipliers,
+    Vector&                         udotErr,
+    bool                            isRealizing) const
 {
     assert(getStage(s) >= Stage::Acceleration-1);
 
@@ -5119,25 +5284,74 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
 
     // Calculate multipliers lambda as
     //     (G M^-1 ~G) lambda = aerr
-    // The method here calculates the mXm matrix G*M^-1*G^T as fast as 
-    // I know how to do, O(m*n) with O(n) temporary memory, using a series
-    // of O(n) operators. Then we'll factor it here in O(m^3) time. 
-    Matrix GMInvGt(m,m);
-    calcGMInvGt(s, GMInvGt);
-    
-    // specify 1/cond at which we declare rank deficiency
-    FactorQTZ qtz(GMInvGt, conditioningTol); 
-
-    //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
-    //    GMInvGt.nrow(), conditioningTol, qtz.getRank(),
-    //    qtz.getRCondEstimate());
+    // While realizing, if we're allowed to reuse an earlier factorization of
+    // G M^-1 ~G, we solve with that and then correct the multipliers by 
+    // iterative refinement, each iteration costing only O(n) operators:
+    //     lambda += (G M^-1 ~G)_old^-1 aerr(lambda)
+    // We give up and refactor if that isn't converging quickly. The operator
+    // doesn't touch the State's factorization unless it was formed at the
+    // current positions, in which case it is exact and can just be read; 
+    // otherwise the operator factors into a local one.
+    SBScratchCache& arena = isRealizing ? updScratchCache(s) 
+                                        : updThreadScratchCache();
+    SBScratchCache::Frame scratch(arena);
+    Vector_<SpatialVec>& bodyForcesInG = scratch.spatialVector(getNumBodies());
+    Vector&              mobilityF     = scratch.vector(nu);
+
+    if (isRealizing) {
+        SBConstraintFactorCache& fc = updConstraintFactorCache(s);
+        SBConstraintFactorCache::ReusableFactor& af = fc.accelerationFactor;
+
+        // The refinement temporaries are taken even when we're about to 
+        // factor so that they are already in the State's arena when we first
+        // reuse.
+        Vector& udotErr0     = scratch.vector(m);
+        Vector& dMultipliers = scratch.vector(m);
+
+        if (af.isReusable(constraintFactorReuseLimit)) {
+            const int MaxRefinements = 10;
+            const Real tol = SqrtEps*std::sqrt(SqrtEps) 
+                             * (1 + udotErr.normInf());
+            udotErr0 = udotErr;
+            multipliers.setToZero();
+            Real prevNorm = Infinity;
+            bool converged = false;
+            for (int i=0; i < MaxRefinements; ++i) {
+                solveConstraintEquations(fc, udotErr, dMultipliers);
+                multipliers += dMultipliers;
+                calcConstraintForcesFromMultipliers(s, multipliers, 
+                    bodyForcesInG, mobilityF, cac.constrainedBodyForcesInG, 
+                    cac.constraintMobilityForces);
+                calcTreeForwardDynamicsOperator
+                   (s, mobilityForces, particleForces, bodyForces,
+                    &mobilityF, &bodyForcesInG, tac, udot, qdotdot, udotErr);
+                const Real norm = udotErr.normInf();
+                if (norm <= tol) {converged = true; break;}
+                if (norm > Real(0.1)*prevNorm) break; // too slow
+                prevNorm = norm;
+            }
+            if (converged) {
+                ++af.numReuses;
+                return;
+            }
+            udotErr = udotErr0; // start over with a fresh factorization
+        }
 
-    qtz.solve(udotErr, multipliers);
+        factorConstraintEquations(s, conditioningTol, arena, fc);
+        markCacheValueRealized(s, 
+            topologyCache.currentAccelerationFactorCacheIndex);
+        solveConstraintEquations(fc, udotErr, multipliers);
+    } else if (isAccelerationFactorCurrent(s)) {
+        solveConstraintEquations(getConstraintFactorCache(s), 
+                                 udotErr, multipliers);
+    } else {
+        SBConstraintFactorCache fc;
+        factorConstraintEquations(s, conditioningTol, arena, fc);
+        solveConstraintEquations(fc, udotErr, multipliers);
+    }
 
     // We have the multipliers, now turn them into forces.
 
-    Vector_<SpatialVec> bodyForcesInG;
-    Vector              mobilityF;
     calcConstraintForcesFromMultipliers(s,multipliers,bodyForcesInG,mobilityF,
         cac.constrainedBodyForcesInG, cac.constraintMobilityForces);
     // Note that constraint forces have the opposite sign from applied forces
@@ -5154,6 +5368,211 @@ void SimbodyMatterSubsystemRep::calcLoopForwardDynamicsOperator
 
 
 
+//==============================================================================
+//                         CONSTRAINT FACTORIZATIONS
+//==============================================================================
+// The dense factor is the better choice unless L would have at most this 
+// fraction of the entries of a full lower triangle.
+static const Real MaxSparseConstraintDensity = Real(0.25);
+
+void SimbodyMatterSubsystemRep::
+setSparseConstraintSolverThreshold(int minNumEquations) {
+    SimTK_APIARGCHECK_ALWAYS(minNumEquations > 0, "SimbodyMatterSubsystemRep",
+        "setSparseConstraintSolverThreshold", 
+        "Minimum number of constraint equations must be positive");
+    sparseConstraintSolverThreshold = minNumEquations;
+}
+
+int SimbodyMatterSubsystemRep::getSparseConstraintSolverThreshold() const {
+    return sparseConstraintSolverThreshold;
+}
+
+void SimbodyMatterSubsystemRep::setConstraintFactorReuseLimit(int maxReuses) {
+    SimTK_APIARGCHECK_ALWAYS(maxReuses >= 0, "SimbodyMatterSubsystemRep",
+        "setConstraintFactorReuseLimit", 
+        "Reuse limit must not be negative");
+    constraintFactorReuseLimit = maxReuses;
+}
+
+int SimbodyMatterSubsystemRep::getConstraintFactorReuseLimit() const {
+    return constraintFactorReuseLimit;
+}
+
+SBConstraintFactorCache& SimbodyMatterSubsystemRep::
+updConstraintFactorCache(const State& s) const {
+    const CacheEntryIndex fcx = topologyCache.constraintFactorCacheIndex;
+    SBConstraintFactorCache& fc = Value<SBConstraintFactorCache>::updDowncast
+        (updCacheEntry(s, fcx));
+    if (!isCacheValueRealized(s, fcx)) {
+        fc.clear();
+        markCacheValueRealized(s, fcx);
+    }
+    return fc;
+}
+
+const SBConstraintFactorCache& SimbodyMatterSubsystemRep::
+getConstraintFactorCache(const State& s) const {
+    return Value<SBConstraintFactorCache>::downcast
+        (getCacheEntry(s, topologyCache.constraintFactorCacheIndex));
+}
+
+bool SimbodyMatterSubsystemRep::
+isAccelerationFactorCurrent(const State& s) const {
+    return isCacheValueRealized(s, topologyCache.constraintFactorCacheIndex)
+        && isCacheValueRealized
+              (s, topologyCache.currentAccelerationFactorCacheIndex)
+        && getConstraintFactorCache(s).accelerationFactor.valid;
+}
+
+// Each constraint equation is tagged with the subtrees (identified by their
+// base bodies) containing its constrained bodies and constrained mobilizers.
+// Constraint forces act only on those bodies and mobilities, and the 
+// constraint equations see only their accelerations, so an equation's column
+// of M^-1 ~G can only couple to equations touching one of the same subtrees.
+// Columns of G M^-1 ~G are formed just as in calcGMInvGt() but several at a
+// time, one pass of the operators per color. Once a factorization has failed
+// we don't try again until the set of constraints changes.
+bool SimbodyMatterSubsystemRep::
+factorSparseConstraintEquations(const State&            s,
+                                Real                    relTol,
+                                SBScratchCache&         arena,
+                                SparseConstraintFactor& sparse) const {
+    const SBInstanceCache& ic = getInstanceCache(s);
+    const int mHolo    = ic.totalNHolonomicConstraintEquationsInUse;
+    const int mNonholo = ic.totalNNonholonomicConstraintEquationsInUse;
+    const int mAccOnly = ic.totalNAccelerationOnlyConstraintEquationsInUse;
+    const int m        = mHolo+mNonholo+mAccOnly;
+
+    if (!sparse.isAnalyzed()) {
+        // The base body of each mobilized body, or Ground for Ground.
+        const int nb = getNumBodies();
+        Array_<int> baseBody(nb);
+        baseBody[0] = 0;
+        for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+            const RigidBodyNode* node = &getRigidBodyNode(mbx);
+            while (node->getLevel() > 1)
+                node = node->getParent();
+            baseBody[mbx] = node->getNodeNum();
+        }
+
+        Array_< Array_<int> > groupsOfEquation(m);
+        Array_<int> groups;
+        for (ConstraintIndex cx(0); cx < getNumConstraints(); ++cx) {
+            const SBInstancePerConstraintInfo& cInfo = 
+                ic.getConstraintInstanceInfo(cx);
+            const ConstraintImpl& crep = getConstraint(cx).getImpl();
+
+            groups.clear();
+            for (ConstrainedBodyIndex cbx(0); 
+                 cbx < crep.getNumConstrainedBodies(); ++cbx)
+                groups.push_back(baseBody
+                    [crep.getMobilizedBodyIndexOfConstrainedBody(cbx)]);
+            for (ConstrainedMobilizerIndex cmx(0); 
+                 cmx < crep.getNumConstrainedMobilizers(); ++cmx)
+                groups.push_back(baseBody
+                    [crep.getMobilizedBodyIndexOfConstrainedMobilizer(cmx)]);
+            std::sort(groups.begin(), groups.end());
+            groups.erase(std::unique(groups.begin(), groups.end()), 
+                         groups.end());
+            if (!groups.empty() && groups.front() == 0) // Ground doesn't move
+                groups.erase(groups.begin());
+
+            const int firstHolo    = cInfo.holoErrSegment.offset;
+            const int firstNonholo = mHolo + cInfo.nonholoErrSegment.offset;
+            const int firstAccOnly = mHolo + mNonholo 
+                                     + cInfo.accOnlyErrSegment.offset;
+            for (int i=0; i < cInfo.holoErrSegment.length; ++i)
+                groupsOfEquation[firstHolo+i] = groups;
+            for (int i=0; i < cInfo.nonholoErrSegment.length; ++i)
+                groupsOfEquation[firstNonholo+i] = groups;
+            for (int i=0; i < cInfo.accOnlyErrSegment.length; ++i)
+                groupsOfEquation[firstAccOnly+i] = groups;
+        }
+
+        sparse.analyze(m, groupsOfEquation, nb, MaxSparseConstraintDensity);
+    }
+
+    if (!sparse.isWorthwhile() || sparse.isRankDeficient())
+        return false;
+
+    const int nu = getNU(s);
+    SBScratchCache::Frame scratch(arena);
+    Vector& bias = scratch.vector(m);
+    calcBiasForMultiplyByPVA(s,true,true,true,bias);
+
+    Vector& lambda     = scratch.vector(m);
+    Vector& Gtcol      = scratch.vector(nu);
+    Vector& MInvGtcol  = scratch.vector(nu);
+    Vector& GMInvGtcol = scratch.vector(m);
+    lambda.setToZero();
+    sparse.beginAssembly();
+    for (int c=0; c < sparse.getNumColors(); ++c) {
+        for (int j : sparse.getColorMembers(c)) lambda[j] = 1;
+        multiplyByPVATranspose(s, true, true, true, lambda, Gtcol);
+        for (int j : sparse.getColorMembers(c)) lambda[j] = 0;
+        multiplyByMInv(s, Gtcol, MInvGtcol);
+        multiplyByPVA(s, true, true, true, bias, MInvGtcol, GMInvGtcol);
+        sparse.assembleColor(c, GMInvGtcol);
+    }
+
+    if (!sparse.factor(relTol)) {
+        sparse.setRankDeficient(true);
+        return false;
+    }
+    return true;
+}
+
+// With many loosely-coupled constraint equations we can exploit the sparsity
+// of G M^-1 ~G; that fails over to the dense method if the constraints turn
+// out to be redundant.
+void SimbodyMatterSubsystemRep::
+factorConstraintEquations(const State&              s,
+                          Real                      conditioningTol,
+                          SBScratchCache&           arena,
+                          SBConstraintFactorCache&  fc) const {
+    SBConstraintFactorCache::ReusableFactor& af = fc.accelerationFactor;
+    const int m = getNumHolonomicConstraintEquationsInUse(s)
+                + getNumNonholonomicConstraintEquationsInUse(s)
+                + getNumAccelerationOnlyConstraintEquationsInUse(s);
+
+    fc.accelerationFactorIsSparse = m >= sparseConstraintSolverThreshold
+        && factorSparseConstraintEquations(s, conditioningTol, arena, 
+                                           fc.sparse);
+
+    if (!fc.accelerationFactorIsSparse) {
+        // The method here calculates the mXm matrix G*M^-1*G^T as fast as 
+        // I know how to do, O(m*n) with O(n) temporary memory, using a series
+        // of O(n) operators. Then we'll factor it here in O(m^3) time. 
+        SBScratchCache::Frame scratch(arena);
+        Matrix& GMInvGt = scratch.matrix(m,m);
+        calcGMInvGt(s, GMInvGt);
+    
+        // specify 1/cond at which we declare rank deficiency
+        af.qtz.factor<Real>(GMInvGt, conditioningTol); 
+
+        //printf("fwdDynamics: m=%d condTol=%g rank=%d rcond=%g\n",
+        //    GMInvGt.nrow(), conditioningTol, af.qtz.getRank(),
+        //    af.qtz.getRCondEstimate());
+    }
+
+    af.valid = true;
+    af.numReuses = 0;
+}
+
+void SimbodyMatterSubsystemRep::
+solveConstraintEquations(const SBConstraintFactorCache&  fc,
+                         const Vector&                   b,
+                         Vector&                         x) const {
+    assert(fc.accelerationFactor.valid);
+    if (fc.accelerationFactorIsSparse)
+        fc.sparse.solve(b, x);
+    else
+        fc.accelerationFactor.qtz.solve(b, x);
+}
+//........................ CONSTRAINT FACTORIZATIONS ..........................
+
+
+
 //==============================================================================
 //                       REALIZE LOOP FORWARD DYNAMICS
 //==============================================================================
@@ -5173,9 +5592,9 @@ void SimbodyMatterSubsystemRep::realizeLoopForwardDynamics(const State& s,
     Vector&                         udotErr     = updUDotErr(s);
     Vector&                         multipliers = updMultipliers(s);
 
-    calcLoopForwardDynamicsOperator
+    calcLoopForwardDynamics
        (s, mobilityForces, particleForces, bodyForces,
-        tac, cac, udot, qdotdot, multipliers, udotErr);
+        tac, cac, udot, qdotdot, multipliers, udotErr, true);
 
     // Since we're realizing, note that we're done with these cache entries.
     markCacheValueRealized(s, topologyCache.treeAccelerationCacheIndex);
@@ -5325,21 +5744,19 @@ void SimbodyMatterSubsystemRep::calcTreeAccelerations(const State& s,
         udotPtr[ic.zeroUDot[i]] = 0;
 
     for (int i=rbNodeLevels.size()-1 ; i>=0 ; i--) 
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node) {
             node.calcUDotPass1Inward(ic,tpc,abc,abvc,
                 mobilityForcePtr, bodyForcePtr, udotPtr, zPtr, zPlusPtr,
                 hingeForcePtr);
-        }
+        });
 
     for (int i=0 ; i<(int)rbNodeLevels.size() ; i++)
-        for (int j=0 ; j<(int)rbNodeLevels[i].size() ; j++) {
-            const RigidBodyNode& node = *rbNodeLevels[i][j];
+        forEachNodeInLevel(i, [&](const RigidBodyNode& node) {
             node.calcUDotPass2Outward(ic,tpc,abc,tvc,dc, 
                 hingeForcePtr, aPtr, udotPtr, tauPtr);
             node.calcQDotDot(sbs, &udotPtr[node.getUIndex()], 
                              &qdotdotPtr[node.getQIndex()]);
-        }
+        });
 }
 //......................... CALC TREE ACCELERATIONS ............................
 
@@ -5377,8 +5794,11 @@ void SimbodyMatterSubsystemRep::multiplyByMInv(const State& s,
     assert(MInvf.hasContiguousData());
 
     // Temporaries
-    Array_<Real>        eps(nu);
-    Array_<SpatialVec>  z(nb), zPlus(nb), A_GB(nb);
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Array_<Real>&       eps   = scratch.array<Real>(nu);
+    Array_<SpatialVec>& z     = scratch.array<SpatialVec>(nb);
+    Array_<SpatialVec>& zPlus = scratch.array<SpatialVec>(nb);
+    Array_<SpatialVec>& A_GB  = scratch.array<SpatialVec>(nb);
 
     // Point to raw data of input arguments.
     const Real* fPtr     = &f[0];       
@@ -6335,7 +6755,9 @@ void SimbodyMatterSubsystemRep::multiplyBySystemJacobianTranspose
 
     const SBTreePositionCache& tpc = getTreePositionCache(s);
 
-    Vector_<SpatialVec> zTemp(getNumBodies()); zTemp.setToZero();
+    SBScratchCache::Frame scratch(updThreadScratchCache());
+    Vector_<SpatialVec>& zTemp = scratch.spatialVector(getNumBodies()); 
+    zTemp.setToZero();
     const SpatialVec* xPtr = X.size() ? &X[0] : NULL;
     Real* jtxPtr = JtX.size() ? &JtX[0] : NULL;
     SpatialVec* zPtr = zTemp.size() ? &zTemp[0] : NULL;
@@ -6428,14 +6850,21 @@ void SBStateDigest::fillThroughStage(const SimbodyMatterSubsystemRep& matter, St
         q = &matter.getQ(state);
         u = &matter.getU(state);
     }
+    // The Model and Instance caches are writable only while their own stage
+    // is being realized. Past that we mustn't ask for write access, since 
+    // that would force a State copy to stop sharing them with its source.
     if (g >= Stage::Model) {
         mv = &matter.getModelVars(state);
-        mc = &matter.updModelCache(state);
+        mc = g == Stage::Model 
+            ? &matter.updModelCache(state)
+            : const_cast<SBModelCache*>(&matter.getModelCache(state));
         iv = &matter.getInstanceVars(state);
     }
     if (g >= Stage::Instance) {
         if (topo.instanceCacheIndex.isValid())
-            ic = &matter.updInstanceCache(state);
+            ic = g == Stage::Instance 
+                ? &matter.updInstanceCache(state)
+                : const_cast<SBInstanceCache*>(&matter.getInstanceCache(state));
         
         // All cache entries, for any stage, can be modified at instance stage 
         // or later.
@@ -35,6 +35,7 @@
 
 #include "SimbodyTreeState.h"
 #include "RigidBodyNode.h"
+#include "OptionalExecutor.h"
 
 #include <set>
 #include <map>
@@ -141,7 +142,10 @@ private:
 class SimbodyMatterSubsystemRep : public SimTK::Subsystem::Guts {
 public:
     SimbodyMatterSubsystemRep() 
-      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1")
+      : Subsystem::Guts("SimbodyMatterSubsystem", "0.7.1"),
+        parallelSweepThreshold(DefaultParallelSweepThreshold),
+        sparseConstraintSolverThreshold(DefaultSparseConstraintSolverThreshold),
+        constraintFactorReuseLimit(0)
     { 
         clearTopologyCache();
     }
@@ -1139,6 +1143,19 @@ public:
             (s.updCacheEntry(getMySubsystemIndex(),topologyCache.constrainedAccelerationCacheIndex)).upd();
     }
 
+    // The State's arena for temporaries; open an SBScratchCache::Frame on it
+    // for the duration of a calculation.
+    SBScratchCache& updScratchCache(const State& s) const { //mutable
+        return Value<SBScratchCache>::updDowncast
+            (s.updCacheEntry(getMySubsystemIndex(),topologyCache.scratchCacheIndex)).upd();
+    }
+
+    // A per-thread arena for the operators that only read the cache, such as
+    // multiplyByMInv(), so that those may be called on the same State from 
+    // several threads at once. The realization sweeps write the cache anyway
+    // and use the State's arena.
+    static SBScratchCache& updThreadScratchCache();
+
 
     const SBModelVars& getModelVars(const State& s) const {
         return Value<SBModelVars>::downcast
@@ -1210,6 +1227,15 @@ public:
     bool getShowDefaultGeometry() const;
     void setShowDefaultGeometry(bool show);
 
+    void setNumberOfThreads(unsigned numThreads);
+    int getNumberOfThreads() const;
+    void setParallelSweepThreshold(int minNodesPerLevel);
+    int getParallelSweepThreshold() const;
+    void setSparseConstraintSolverThreshold(int minNumEquations);
+    int getSparseConstraintSolverThreshold() const;
+    void setConstraintFactorReuseLimit(int maxReuses);
+    int getConstraintFactorReuseLimit() const;
+
     void calcTreeForwardDynamicsOperator(const State&,
         const Vector&                   mobilityForces,
         const Vector_<Vec3>&            particleForces,
@@ -1232,6 +1258,21 @@ public:
         Vector&                         multipliers,
         Vector&                         udotErr) const;
 
+    // The calculation behind calcLoopForwardDynamicsOperator(). Only when
+    // realizing may it reuse, form and keep the State's constraint 
+    // factorization and use the State's scratch arena.
+    void calcLoopForwardDynamics(const State&, 
+        const Vector&                   mobilityForces,
+        const Vector_<Vec3>&            particleForces,
+        const Vector_<SpatialVec>&      bodyForces,
+        SBTreeAccelerationCache&        tac,
+        SBConstrainedAccelerationCache& cac,
+        Vector&                         udot,
+        Vector&                         qdotdot,
+        Vector&                         multipliers,
+        Vector&                         udotErr,
+        bool                            isRealizing) const;
+
     // Given a set of forces, calculate accelerations ignoring
     // constraints, and leave the results in the state cache. 
     // Must have already called realizeDynamics().
@@ -1436,6 +1477,61 @@ private:
     
     // Specifies whether default decorative geometry should be shown.
     bool showDefaultGeometry;
+
+        // Parallel tree sweeps
+
+    // Apply nodeFunc to each RigidBodyNode at the given level. The nodes of a
+    // level are independent of one another during any of the base-to-tip or
+    // tip-to-base sweeps, so when a thread pool has been requested and the
+    // level is wide enough they are processed concurrently. Every node writes
+    // only its own cache slots, so the results are identical to the serial
+    // sweep.
+    template <class NodeFunc>
+    void forEachNodeInLevel(int level, const NodeFunc& nodeFunc) const;
+
+    static const int DefaultParallelSweepThreshold = 16;
+
+    // If two threads are realizing different States of this System, the one
+    // that doesn't get the executor just sweeps serially.
+    OptionalExecutor                    sweepExecutor;
+    int                                 parallelSweepThreshold;
+
+        // Constraint factorizations
+
+    // Return the cached constraint factorizations, first clearing them out
+    // if they belong to an earlier realization of Stage::Instance.
+    SBConstraintFactorCache& updConstraintFactorCache(const State&) const;
+    // Read-only access for the operators; the cache must be valid.
+    const SBConstraintFactorCache& getConstraintFactorCache(const State&) const;
+
+    // True if the State holds an acceleration factorization that was formed
+    // at the current positions rather than being a reused stale one.
+    bool isAccelerationFactorCurrent(const State&) const;
+
+    // Analyze the structure of G M^-1 ~G, then assemble and factor it with
+    // the sparse method. Returns false if the structure isn't sparse enough
+    // or the constraints are redundant, in which case the caller must use the
+    // dense method.
+    bool factorSparseConstraintEquations(const State&               state,
+                                         Real                       relTol,
+                                         SBScratchCache&            arena,
+                                         SparseConstraintFactor&    sparse) const;
+
+    // Factor G M^-1 ~G from scratch into fc, sparse or dense, taking 
+    // temporaries from the given arena.
+    void factorConstraintEquations(const State&                 state,
+                                   Real                         conditioningTol,
+                                   SBScratchCache&              arena,
+                                   SBConstraintFactorCache&     fc) const;
+
+    // Solve G M^-1 ~G x = b with whatever factorization is in fc.
+    void solveConstraintEquations(const SBConstraintFactorCache&    fc,
+                                  const Vector&                     b,
+                                  Vector&                           x) const;
+
+    static const int DefaultSparseConstraintSolverThreshold = 100;
+    int                                 sparseConstraintSolverThreshold;
+    int                                 constraintFactorReuseLimit;
 };
 
 std::ostream& operator<<(std::ostream&, const SimbodyMatterSubsystemRep&);
@@ -65,9 +65,15 @@ allocated if necessary), and then advance to stage Whatever. */
 
 #include "simbody/internal/common.h"
 #include "simbody/internal/Motion.h"
+#include "SimTKmath.h"
+
+#include "SparseConstraintFactor.h"
 
 #include <cassert>
 #include <iostream>
+#include <atomic>
+#include <memory>
+#include <vector>
 using std::cout; using std::endl;
 
 using namespace SimTK;
@@ -92,6 +98,8 @@ class SBConstrainedVelocityCache;
 class SBDynamicsCache;
 class SBTreeAccelerationCache;
 class SBConstrainedAccelerationCache;
+class SBConstraintFactorCache;
+class SBScratchCache;
 
 class SBModelVars;
 class SBInstanceVars;
@@ -156,7 +164,10 @@ public:
                           articulatedBodyVelocityCacheIndex,
                           dynamicsCacheIndex, 
                           treeAccelerationCacheIndex, 
-                          constrainedAccelerationCacheIndex;
+                          constrainedAccelerationCacheIndex,
+                          constraintFactorCacheIndex,
+                          currentAccelerationFactorCacheIndex,
+                          scratchCacheIndex;
 
 
     // These are instance variables that exist regardless of modeling
@@ -1230,6 +1241,183 @@ public:
 
 
 
+// =============================================================================
+//                         CONSTRAINT FACTOR CACHE
+// =============================================================================
+// Factorizations of constraint matrices, kept from one realization or 
+// projection to the next so that they can be reused while the configuration
+// changes only a little, as it does between the stages of an integrator step.
+// This lazy cache entry depends only on Stage::Instance, so everything here may
+// be out of date with respect to q and u. Each factorization counts how often
+// it has been reused so that the reuse limit set with 
+// SimbodyMatterSubsystem::setConstraintFactorReuseLimit() can be enforced.
+
+class SBConstraintFactorCache {
+public:
+    // One factored, weighted constraint matrix together with the row weights
+    // and column scaling it was formed with; a stale factorization must be
+    // used with its original weights.
+    class ReusableFactor {
+    public:
+        ReusableFactor() {invalidate();}
+        void invalidate() {valid = false; numReuses = 0;}
+        bool isReusable(int reuseLimit) const 
+        {   return valid && numReuses < reuseLimit; }
+
+        bool        valid;
+        int         numReuses;
+        FactorQTZ   qtz;
+        Vector      rowWeights, colScale;
+    };
+
+    void clear() {
+        sparse.clear();
+        positionFactor.invalidate();
+        velocityFactor.invalidate();
+        accelerationFactor.invalidate();
+        accelerationFactorIsSparse = false;
+    }
+
+    // Structure and workspace for the sparse factorization of G M^-1 ~G.
+    SparseConstraintFactor  sparse;
+
+    ReusableFactor  positionFactor;     // Tp Pq Wq^+, for projectQ()
+    ReusableFactor  velocityFactor;     // Tpv [P;V] Eu^-1, for projectU()
+    ReusableFactor  accelerationFactor; // G M^-1 ~G for forward dynamics;
+                                        //   qtz unused if the factor is sparse
+    bool            accelerationFactorIsSparse;
+};
+//......................... CONSTRAINT FACTOR CACHE ............................
+
+
+
+// =============================================================================
+//                               SCRATCH CACHE
+// =============================================================================
+// Workspace for the temporary Vectors and Matrices used by the realization 
+// and operator code, so that those don't have to be heap allocated on every
+// call. A calculation opens a Frame on this arena and asks it for objects of
+// the sizes it needs; they are handed back when the Frame is destroyed, so 
+// Frames nest like the calls that open them. Vectors and Matrices are only
+// reused at the shape they already have, Array_s at any size up to their
+// capacity. Since a given calculation asks for the same sizes each time, the
+// pools stop growing after the first realization and no further heap 
+// allocation occurs.
+//
+// This lazy cache entry is never marked valid; the contents of an object 
+// obtained from a Frame are garbage. A copied State gets an empty arena.
+// Like the rest of the cache this is not safe to use from several threads
+// at once on the same State, so the State's arena is used only by the 
+// realization sweeps. Operators that just read the cache take their 
+// temporaries from a per-thread arena of the same type instead.
+class SBScratchCache {
+    class PoolBase;
+    template <class T> class Pool;
+public:
+    SBScratchCache() {}
+    SBScratchCache(const SBScratchCache&) {}
+    SBScratchCache& operator=(const SBScratchCache&) {return *this;}
+
+    class Frame {
+    public:
+        explicit Frame(SBScratchCache& arena) 
+        :   arena(arena), mark((int)arena.inUse.size()) {}
+        ~Frame() {
+            while ((int)arena.inUse.size() > mark) {
+                *arena.inUse.back() = false;
+                arena.inUse.pop_back();
+            }
+        }
+
+        Vector& vector(int n) 
+        {   return arena.acquire<Vector>(n, 1); }
+        Vector_<SpatialVec>& spatialVector(int n) 
+        {   return arena.acquire<Vector_<SpatialVec>>(n, 1); }
+        Matrix& matrix(int m, int n) 
+        {   return arena.acquire<Matrix>(m, n); }
+        template <class T, class X=unsigned> Array_<T,X>& array(int n)
+        {   return arena.acquire<Array_<T,X>>(n, 1); }
+
+    private:
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        SBScratchCache& arena;
+        const int       mark;
+    };
+
+private:
+    class PoolBase {
+    public:
+        virtual ~PoolBase() {}
+    protected:
+        // Each pooled type gets its own small integer to find its pool.
+        static int nextTypeNum() {
+            static std::atomic<int> next(0);
+            return next++;
+        }
+    };
+
+    template <class T> class Pool : public PoolBase {
+    public:
+        static int getTypeNum() {
+            static const int typeNum = nextTypeNum();
+            return typeNum;
+        }
+
+        T& acquire(std::vector<bool*>& inUse, int m, int n) {
+            Slot* pick = nullptr;
+            for (auto& slot : slots)
+                if (!slot->inUse && canReuse(slot->obj, m, n)) 
+                {   pick = slot.get(); break; }
+            if (!pick) {
+                slots.emplace_back(new Slot());
+                pick = slots.back().get();
+            }
+            resizeTo(pick->obj, m, n);
+            pick->inUse = true;
+            inUse.push_back(&pick->inUse);
+            return pick->obj;
+        }
+    private:
+        struct Slot {
+            Slot() : inUse(false) {}
+            T       obj;
+            bool    inUse;
+        };
+
+        // Resizing a Vector or Matrix always reallocates, so we only hand
+        // out one that already has the right shape. An Array_ keeps its 
+        // capacity when it shrinks so any of those will do.
+        template <class E> static bool 
+        canReuse(const Vector_<E>& v, int m, int) {return v.size() == m;}
+        static bool canReuse(const Matrix& a, int m, int n) 
+        {   return a.nrow() == m && a.ncol() == n; }
+        template <class E, class X> static bool 
+        canReuse(const Array_<E,X>&, int, int) {return true;}
+        template <class U> static void 
+        resizeTo(U& v, int m, int) {v.resize(m);}
+        static void resizeTo(Matrix& a, int m, int n) {a.resize(m, n);}
+
+        std::vector<std::unique_ptr<Slot>> slots;
+    };
+
+    template <class T> T& acquire(int m, int n) {
+        const int typeNum = Pool<T>::getTypeNum();
+        if (typeNum >= (int)pools.size())
+            pools.resize(typeNum+1);
+        if (!pools[typeNum])
+            pools[typeNum].reset(new Pool<T>());
+        return static_cast<Pool<T>&>(*pools[typeNum]).acquire(inUse, m, n);
+    }
+
+    std::vector<std::unique_ptr<PoolBase>>  pools;  // indexed by type number
+    std::vector<bool*>                      inUse;  // stack of acquired slots
+};
+//.............................. SCRATCH CACHE ................................
+
+
+
 
 /* 
  * Generalized state variable collection for a SimbodyMatterSubsystem. 
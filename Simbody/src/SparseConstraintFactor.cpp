@@ -0,0 +1,250 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SparseConstraintFactor.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace SimTK;
+
+//==============================================================================
+//                                  ANALYZE
+//==============================================================================
+void SparseConstraintFactor::
+analyze(int nEquations, const Array_< Array_<int> >& groupsOfEquation,
+        int numGroups, Real maxDensity) {
+    clear();
+    m = nEquations;
+    analyzed = true;
+    if (m == 0) return;
+    assert((int)groupsOfEquation.size() == m);
+
+    const double maxEntries = maxDensity * (double(m)*(m+1)/2);
+
+    // Equation i couples with equation j if they touch a common group. Find
+    // the structure of the lower triangle of A from that, giving up early if
+    // A itself is already too dense.
+    Array_< Array_<int> > equationsOfGroup(numGroups);
+    for (int i=0; i < m; ++i)
+        for (int g : groupsOfEquation[i])
+            equationsOfGroup[g].push_back(i);
+
+    std::vector< std::vector<int> > adjacency(m);
+    Array_<int> mark(m, -1);
+    double numEntries = m;
+    for (int i=0; i < m; ++i) {
+        mark[i] = i;
+        for (int g : groupsOfEquation[i])
+            for (int j : equationsOfGroup[g])
+                if (mark[j] != i) {mark[j] = i; adjacency[i].push_back(j);}
+        std::sort(adjacency[i].begin(), adjacency[i].end());
+        numEntries += 0.5*adjacency[i].size();
+        if (numEntries > maxEntries) return;
+    }
+
+    // Minimum degree ordering by explicit elimination. When an equation is
+    // eliminated its remaining neighbors become a clique; those neighbors are
+    // exactly the structure of its column of L. Ties go to the lowest 
+    // numbered equation so the ordering is reproducible.
+    std::vector< std::vector<int> > graph(adjacency);
+    std::vector< std::vector<int> > pattern(m);
+    std::set< std::pair<int,int> > byDegree;
+    for (int i=0; i < m; ++i)
+        byDegree.insert(std::make_pair((int)graph[i].size(), i));
+
+    std::vector<int> merged;
+    numEntries = m;
+    perm.reserve(m);
+    while (!byDegree.empty()) {
+        const int v = byDegree.begin()->second;
+        byDegree.erase(byDegree.begin());
+        const std::vector<int>& neighbors = graph[v];
+        numEntries += neighbors.size();
+        if (numEntries > maxEntries) {perm.clear(); return;}
+        perm.push_back(v);
+        for (int a : neighbors) {
+            std::vector<int>& adj = graph[a];
+            byDegree.erase(std::make_pair((int)adj.size(), a));
+            merged.clear();
+            std::set_union(adj.begin(), adj.end(), 
+                           neighbors.begin(), neighbors.end(),
+                           std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(), merged.end(),
+                            [a,v](int x) {return x==a || x==v;}),
+                         merged.end());
+            adj.swap(merged);
+            byDegree.insert(std::make_pair((int)adj.size(), a));
+        }
+        pattern[v].swap(graph[v]);
+    }
+
+    iperm.resize(m);
+    for (int k=0; k < m; ++k) iperm[perm[k]] = k;
+
+    // Lay out L by columns in elimination order.
+    colStart.resize(m+1);
+    colStart[0] = 0;
+    for (int k=0; k < m; ++k)
+        colStart[k+1] = colStart[k] + 1 + (int)pattern[perm[k]].size();
+    rowIndex.resize(colStart[m]);
+    for (int k=0; k < m; ++k) {
+        int p = colStart[k];
+        rowIndex[p++] = k;
+        for (int i : pattern[perm[k]]) 
+            rowIndex[p++] = iperm[i];
+        std::sort(&rowIndex[colStart[k]+1], &rowIndex[0] + colStart[k+1]);
+    }
+    values.resize(colStart[m]);
+
+    // Where each entry of column j of A goes. Entries above the diagonal in
+    // the permuted ordering are taken from the symmetric column instead.
+    assemblyStart.resize(m+1);
+    assemblyStart[0] = 0;
+    for (int j=0; j < m; ++j) {
+        const int kj = iperm[j];
+        const int* first = &rowIndex[0] + colStart[kj] + 1;
+        const int* last  = &rowIndex[0] + colStart[kj+1];
+        assemblyRow.push_back(j);
+        assemblyDest.push_back(colStart[kj]);
+        for (int i : adjacency[j]) {
+            if (iperm[i] < kj) continue;
+            const int* p = std::lower_bound(first, last, iperm[i]);
+            assert(p != last && *p == iperm[i]);
+            assemblyRow.push_back(i);
+            assemblyDest.push_back(int(p - &rowIndex[0]));
+        }
+        assemblyStart[j+1] = (int)assemblyRow.size();
+    }
+
+    // Greedy distance-2 coloring: equations of one color share no neighbor
+    // and are not neighbors themselves, so no row of A has a structural 
+    // nonzero in more than one of their columns.
+    Array_<int> color(m, -1), usedBy;
+    int numColors = 0;
+    for (int j=0; j < m; ++j) {
+        for (int i : adjacency[j]) {
+            if (color[i] >= 0) usedBy[color[i]] = j;
+            for (int h : adjacency[i])
+                if (color[h] >= 0) usedBy[color[h]] = j;
+        }
+        int c = 0;
+        while (c < numColors && usedBy[c] == j) ++c;
+        if (c == numColors) {usedBy.push_back(-1); ++numColors;}
+        color[j] = c;
+    }
+    colorStart.resize(numColors+1, 0);
+    for (int j=0; j < m; ++j) ++colorStart[color[j]+1];
+    for (int c=0; c < numColors; ++c) colorStart[c+1] += colorStart[c];
+    colorMembers.resize(m);
+    Array_<int> next(colorStart.begin(), colorStart.end()-1);
+    for (int j=0; j < m; ++j) colorMembers[next[color[j]]++] = j;
+
+    worthwhile = true;
+}
+
+
+
+//==============================================================================
+//                              ASSEMBLE COLOR
+//==============================================================================
+void SparseConstraintFactor::
+assembleColor(int color, const Vector& product) {
+    assert(product.size() == m);
+    for (int j : getColorMembers(color))
+        for (int p=assemblyStart[j]; p < assemblyStart[j+1]; ++p)
+            values[assemblyDest[p]] = product[assemblyRow[p]];
+}
+
+
+
+//==============================================================================
+//                                  FACTOR
+//==============================================================================
+// Right-looking LDL' without pivoting, which is fine for the symmetric
+// positive semidefinite matrices we get here as long as we stop at a tiny 
+// pivot. Symbolic elimination guarantees that for every pair of rows j<i in
+// column k, row i is also present in column j, so each update is a merge.
+bool SparseConstraintFactor::factor(Real relTol) {
+    assert(worthwhile);
+    Real maxDiag = 0;
+    for (int k=0; k < m; ++k)
+        maxDiag = std::max(maxDiag, values[colStart[k]]);
+    const Real tol = relTol*maxDiag;
+
+    for (int k=0; k < m; ++k) {
+        const int p0 = colStart[k], pEnd = colStart[k+1];
+        const Real d = values[p0];
+        if (!(d > tol)) return false;
+        for (int p=p0+1; p < pEnd; ++p)
+            values[p] /= d;
+        for (int p=p0+1; p < pEnd; ++p) {
+            const int  j = rowIndex[p];
+            const Real dljk = d*values[p];
+            int q = colStart[j];
+            values[q] -= dljk*values[p]; // diagonal
+            for (int r=p+1; r < pEnd; ++r) {
+                const int i = rowIndex[r];
+                while (rowIndex[++q] != i) {}
+                values[q] -= dljk*values[r];
+            }
+        }
+    }
+    return true;
+}
+
+
+
+//==============================================================================
+//                                   SOLVE
+//==============================================================================
+// The workspace is per thread so that several threads may solve with the
+// same factorization at once.
+void SparseConstraintFactor::solve(const Vector& b, Vector& x) const {
+    assert(b.size() == m);
+    static thread_local Array_<Real> work;
+    work.resize(m);
+    for (int k=0; k < m; ++k)
+        work[k] = b[perm[k]];
+
+    for (int k=0; k < m; ++k) {
+        const Real wk = work[k];
+        if (wk == 0) continue;
+        for (int p=colStart[k]+1; p < colStart[k+1]; ++p)
+            work[rowIndex[p]] -= values[p]*wk;
+    }
+    for (int k=0; k < m; ++k)
+        work[k] /= values[colStart[k]];
+    for (int k=m-1; k >= 0; --k) {
+        Real sum = work[k];
+        for (int p=colStart[k]+1; p < colStart[k+1]; ++p)
+            sum -= values[p]*work[rowIndex[p]];
+        work[k] = sum;
+    }
+
+    x.resize(m);
+    for (int k=0; k < m; ++k)
+        x[perm[k]] = work[k];
+}
@@ -0,0 +1,121 @@
+#ifndef SimTK_SIMBODY_SPARSE_CONSTRAINT_FACTOR_H_
+#define SimTK_SIMBODY_SPARSE_CONSTRAINT_FACTOR_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Sparse LDL' factorization of the constraint-space mass matrix G M^-1 ~G
+used by SimbodyMatterSubsystem to calculate multipliers when there are many
+constraint equations that are only loosely coupled.
+
+M is block diagonal over the subtrees rooted at the base bodies (the bodies
+whose parent is Ground), so two constraint equations can produce a nonzero
+entry in G M^-1 ~G only if they involve a common subtree. The structure is
+therefore known at Instance stage. We analyze it once there: a minimum degree
+ordering with the exact fill pattern from symbolic elimination, and a
+distance-2 coloring of the equations so that several columns of the matrix
+can be produced with a single pass of the O(n) operators. Each numerical
+factorization after that reuses the analysis and its memory. */
+
+#include "SimTKcommon.h"
+
+namespace SimTK {
+
+class SparseConstraintFactor {
+public:
+    SparseConstraintFactor() {clear();}
+
+    void clear() {
+        m = 0; analyzed = worthwhile = rankDeficient = false;
+        perm.clear(); iperm.clear(); colStart.clear(); rowIndex.clear(); 
+        values.clear(); colorStart.clear(); colorMembers.clear();
+        assemblyStart.clear(); assemblyRow.clear(); assemblyDest.clear();
+    }
+
+    /* Determine the structure for m equations, where groupsOfEquation[i]
+    lists the (distinct) subtrees touched by equation i, numbered 0 to
+    numGroups-1. If the factor L would have more than maxDensity times the
+    entries of a dense lower triangle the analysis is abandoned and
+    isWorthwhile() will return false; the dense factorization is then the
+    better choice. */
+    void analyze(int m, const Array_< Array_<int> >& groupsOfEquation,
+                 int numGroups, Real maxDensity);
+
+    bool isAnalyzed()   const {return analyzed;}
+    bool isWorthwhile() const {return worthwhile;}
+
+    /* A failed factorization is recorded here so that the caller can go
+    straight to its rank-revealing fallback on later calls. */
+    bool isRankDeficient() const {return rankDeficient;}
+    void setRankDeficient(bool isDeficient) {rankDeficient = isDeficient;}
+
+    int getNumEquations()     const {return m;}
+    int getNumFactorEntries() const {return (int)values.size();}
+
+    /* Columns of the same color have no structurally nonzero row in common,
+    so the matrix times the sum of their unit vectors yields all of them. */
+    int getNumColors() const {return (int)colorStart.size()-1;}
+    ArrayViewConst_<int> getColorMembers(int color) const {
+        return colorMembers(colorStart[color], 
+                            colorStart[color+1]-colorStart[color]);
+    }
+
+    /* Zero the matrix, then scatter the product of the matrix with the sum of
+    the unit vectors of each color into place. */
+    void beginAssembly() {values.fill(0);}
+    void assembleColor(int color, const Vector& product);
+
+    /* Factor in place. Returns false, leaving the factorization unusable, if
+    a pivot falls below relTol times the largest diagonal entry; that means
+    the constraints are redundant or nearly so. */
+    bool factor(Real relTol);
+
+    /* Solve A x = b with a successful factorization; x and b may be the same
+    Vector. This may be called from several threads at once. */
+    void solve(const Vector& b, Vector& x) const;
+
+private:
+    int                 m;
+    bool                analyzed, worthwhile, rankDeficient;
+
+    // Elimination order: perm[k] is the equation eliminated k'th.
+    Array_<int>         perm, iperm;
+
+    // L in compressed columns over the permuted ordering, diagonal entry
+    // first in each column followed by the strictly lower entries in
+    // increasing row order. After factoring, the diagonal holds D.
+    Array_<int>         colStart;   // m+1
+    Array_<int>         rowIndex;   // row of each entry; unused for diagonal
+    Array_<Real>        values;
+
+    Array_<int>         colorStart, colorMembers;
+
+    // For each equation j, the (row, slot in values) pairs that take entries
+    // of column j of the assembled matrix. Each structural entry of the lower
+    // triangle is taken from exactly one column.
+    Array_<int>         assemblyStart, assemblyRow, assemblyDest;
+};
+
+} // namespace SimTK
+
+#endif // SimTK_SIMBODY_SPARSE_CONSTRAINT_FACTOR_H_
@@ -0,0 +1,302 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "TreeDynamicsDerivatives.h"
+#include "SimbodyMatterSubsystemRep.h"
+#include "RigidBodyNode.h"
+
+TreeDynamicsDerivatives::TreeDynamicsDerivatives
+   (const SimbodyMatterSubsystemRep& matter, const State& s,
+    SBScratchCache::Frame& scratch)
+:   matter(matter),
+    dqContig(scratch.vector(matter.getNQ(s))),
+    dueq(scratch.vector(matter.getNU(s))),
+    dX_GB(scratch.array<SpatialVec,MobilizedBodyIndex>(matter.getNumBodies())),
+    l_PB(scratch.array<Vec3D,MobilizedBodyIndex>(matter.getNumBodies())),
+    V_GB(scratch.array<SpatialVecD,MobilizedBodyIndex>(matter.getNumBodies())),
+    A_GB(scratch.array<SpatialVecD,MobilizedBodyIndex>(matter.getNumBodies())),
+    F(scratch.array<SpatialVecD,MobilizedBodyIndex>(matter.getNumBodies())),
+    H(scratch.array<SpatialVecD>(matter.getNU(s))),
+    noDirection(scratch.vector(0)),
+    eq(scratch.vector(matter.getNQ(s))),
+    eu(scratch.vector(matter.getNU(s))),
+    value(scratch.vector(matter.getNU(s))),
+    dValue(scratch.vector(matter.getNU(s))),
+    MInvdValue(scratch.vector(matter.getNU(s))),
+    eps(scratch.array<Real>(matter.getNU(s))),
+    z(scratch.array<SpatialVec,MobilizedBodyIndex>(matter.getNumBodies())),
+    zPlus(scratch.array<SpatialVec,MobilizedBodyIndex>(matter.getNumBodies())),
+    A_GBReal(scratch.array<SpatialVec,MobilizedBodyIndex>(matter.getNumBodies()))
+{}
+
+void TreeDynamicsDerivatives::checkMobilizers
+   (const SimbodyMatterSubsystemRep& matter, const char* methodName) {
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx) {
+        const RigidBodyNode& node = matter.getRigidBodyNode(mbx);
+        SimTK_ERRCHK1_ALWAYS(node.hasConstantH_FM(), methodName,
+            "Mobilized body %d has a mobilizer whose hinge matrix H_FM "
+            "depends on q, or is reversed. Only Pin, Slider, Cylinder, Screw, "
+            "Planar, Translation, Ball, Free and Weld mobilizers in the "
+            "forward direction are supported.", (int)mbx);
+    }
+}
+
+bool TreeDynamicsDerivatives::hasSupportedMobilizers
+   (const SimbodyMatterSubsystemRep& matter) {
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+        if (!matter.getRigidBodyNode(mbx).hasConstantH_FM())
+            return false;
+    return true;
+}
+
+// The passes below mirror calcBodyAccelerationsFromUdotOutward() and
+// calcInverseDynamicsPass2Inward(), with the velocity-stage quantities
+// (spatial velocity, gyroscopic force and mobilizer coriolis acceleration)
+// recalculated in Dual as in RigidBodyNode::calcJointIndependentKinematicsVel()
+// and calcParentToChildVelocityJacobianInGroundDot() with HDot_FM=0.
+// Mobilized body indices are ordered parents first.
+void TreeDynamicsDerivatives::calcResidualForceDirectionalDerivative
+   (const State&                s,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               knownUdot,
+    const Vector&               dq,
+    const Vector&               du,
+    const Vector&               dudot,
+    Vector&                     residual,
+    Vector&                     dResidual)
+{
+    const SBTreePositionCache& pc = matter.getTreePositionCache(s);
+    const Vector& u = matter.getU(s);
+    const int nb = matter.getNumBodies();
+    const int nu = matter.getNumMobilities();
+
+    dX_GB.resize(nb); l_PB.resize(nb);
+    V_GB.resize(nb); A_GB.resize(nb); F.resize(nb);
+    H.resize(nu);
+    residual.resize(nu); dResidual.resize(nu);
+
+    // Equivalent body-frame variations for dq.
+    if (dq.size()) {
+        const Vector* pdq = &dq;
+        if (!dq.hasContiguousData()) {
+            for (int i=0; i < dq.size(); ++i) // a view would allocate
+                dqContig[i] = dq[i];
+            pdq = &dqContig;
+        }
+        matter.multiplyByNInv(s, false, *pdq, dueq);
+    } else {
+        dueq.resize(nu);
+        dueq = 0;
+    }
+
+    dX_GB[GroundIndex] = SpatialVec(Vec3(0), Vec3(0));
+    V_GB[GroundIndex]  = SpatialVecD(Vec3D(Dual(0)), Vec3D(Dual(0)));
+    A_GB[GroundIndex]  = V_GB[GroundIndex];
+
+    for (MobilizedBodyIndex mbx(1); mbx < nb; ++mbx) {
+        const RigidBodyNode& node = matter.getRigidBodyNode(mbx);
+        const MobilizedBodyIndex px = node.getParent()->getNodeNum();
+        const int ux = node.getUIndex(), dof = node.getDOF();
+
+        const Transform& X_GB = node.getX_GB(pc);
+        const Vec3& l = node.getPhi(pc).l();
+
+        // Body frame variation.
+        const Vec3& dth_P = dX_GB[px][0];
+        Vec3 dth_B = dth_P, dp_B = dX_GB[px][1] + dth_P % l;
+        for (int j=0; j < dof; ++j) {
+            const SpatialVec& Hj = node.getHCol(pc, j);
+            dth_B += Hj[0]*dueq[ux+j];
+            dp_B  += Hj[1]*dueq[ux+j];
+        }
+        dX_GB[mbx] = SpatialVec(dth_B, dp_B);
+        const Vec3D lD = makeDual(l, dp_B - dX_GB[px][1]);
+        l_PB[mbx] = lD;
+
+        // H = R_GF*(H_FM + H_MB_F) with H_MB_F[1] = H_FM[0] % r_MB_F. With
+        // H_FM fixed in F, R_GF*H_FM turns with the parent and r_MB with B.
+        const Vec3 r = X_GB.R()*(~node.getX_MB().R()*node.getX_MB().p());
+        const Vec3D rD = makeDual(r, dth_B % r);
+        for (int j=0; j < dof; ++j) {
+            const SpatialVec& Hj = node.getHCol(pc, j);
+            const Vec3 H_FM1_G = Hj[1] - Hj[0] % r;
+            const Vec3D HwD = makeDual(Hj[0], dth_P % Hj[0]);
+            H[ux+j] = SpatialVecD(HwD,
+                        makeDual(H_FM1_G, dth_P % H_FM1_G) + HwD % rD);
+        }
+
+        // Velocities and the mobilizer's coriolis acceleration.
+        const SpatialVecD& V_GP = V_GB[px];
+        const Vec3D& w_GP = V_GP[0];
+        SpatialVecD V_PB_G(Vec3D(Dual(0)), Vec3D(Dual(0)));
+        for (int j=0; j < dof; ++j) {
+            const Dual uj(u[ux+j], du.size() ? du[ux+j] : Real(0));
+            V_PB_G += H[ux+j]*uj;
+        }
+        const Vec3D& w_PB = V_PB_G[0]; // w_FM in G
+        SpatialVecD& V = V_GB[mbx];
+        V = SpatialVecD(w_GP, V_GP[1] + w_GP % lD) + V_PB_G;
+        const SpatialVecD A(w_GP % w_PB,
+                            w_GP % V_PB_G[1] - (w_PB % rD) % w_PB
+                            + w_GP % (V[1] - V_GP[1]));
+
+        // Body acceleration.
+        const SpatialVecD& A_GP = A_GB[px];
+        SpatialVecD& Acc = A_GB[mbx];
+        Acc = SpatialVecD(A_GP[0], A_GP[1] + A_GP[0] % lD) + A;
+        for (int j=0; j < dof; ++j) {
+            const Dual udotj(knownUdot.size() ? knownUdot[ux+j] : Real(0),
+                             dudot.size() ? dudot[ux+j] : Real(0));
+            Acc += H[ux+j]*udotj;
+        }
+
+        // This body's own force: Mk_G*A_GB + b - F_applied, with the unit
+        // inertia and mass center rotating with B.
+        const Mat33 G = node.getUnitInertia_OB_G(pc).toMat33();
+        const Mat33 dthx = crossMat(dth_B);
+        const Mat<3,3,Dual> GD = makeDual(G, dthx*G - G*dthx);
+        const Vec3& c = node.getCB_G(pc);
+        const Vec3D cD = makeDual(c, dth_B % c);
+        const Dual m(node.getMass(), 0);
+        const Vec3D& w = V[0];
+        F[mbx] = SpatialVecD(m*(GD*Acc[0] + cD % Acc[1] + w % (GD*w)),
+                             m*(Acc[1] - cD % Acc[0] + w % (w % cD)));
+        if (appliedBodyForces.size()) {
+            const SpatialVec& Fapp = appliedBodyForces[mbx];
+            F[mbx][0] -= Fapp[0]; F[mbx][1] -= Fapp[1];
+        }
+    }
+
+    // Inward: shift each body's total force to its parent and project it
+    // onto the mobilities.
+    for (MobilizedBodyIndex mbx(nb-1); mbx >= 1; --mbx) {
+        const RigidBodyNode& node = matter.getRigidBodyNode(mbx);
+        const MobilizedBodyIndex px = node.getParent()->getNodeNum();
+        const int ux = node.getUIndex(), dof = node.getDOF();
+        const SpatialVecD& Fb = F[mbx];
+
+        for (int j=0; j < dof; ++j) {
+            const Dual tau = dot(H[ux+j][0], Fb[0]) + dot(H[ux+j][1], Fb[1])
+                - (appliedMobilityForces.size() ? appliedMobilityForces[ux+j]
+                                                : Real(0));
+            residual[ux+j]  = tau.value();
+            dResidual[ux+j] = tau.derivative();
+        }
+
+        if (px != GroundIndex) {
+            F[px][0] += Fb[0] + l_PB[mbx] % Fb[1];
+            F[px][1] += Fb[1];
+        }
+    }
+}
+
+void TreeDynamicsDerivatives::calcResidualForcePartials
+   (const State&                s,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               knownUdot,
+    Matrix&                     dfdq,
+    Matrix&                     dfdu)
+{
+    calcPartials(s, appliedMobilityForces, appliedBodyForces, knownUdot,
+                 false, dfdq, dfdu);
+}
+
+void TreeDynamicsDerivatives::calcAccelerationPartials
+   (const State&                s,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               udot,
+    Matrix&                     dudotdq,
+    Matrix&                     dudotdu)
+{
+    calcPartials(s, appliedMobilityForces, appliedBodyForces, udot,
+                 true, dudotdq, dudotdu);
+}
+
+// One directional derivative sweep per column, along a unit direction. The
+// results are copied element by element since even a column view of the
+// output would need a heap-allocated helper.
+void TreeDynamicsDerivatives::calcPartials
+   (const State&                s,
+    const Vector&               appliedMobilityForces,
+    const Vector_<SpatialVec>&  appliedBodyForces,
+    const Vector&               udot,
+    bool                        accelerations,
+    Matrix&                     dq_,
+    Matrix&                     du_)
+{
+    const int nq = matter.getNQ(s), nu = matter.getNU(s);
+    dq_.resize(nu, nq); du_.resize(nu, nu);
+    eq.resize(nq); eq = 0;
+    eu.resize(nu); eu = 0;
+
+    for (int k=0; k < nq + nu; ++k) {
+        const bool isQ = k < nq;
+        Vector& e = isQ ? eq : eu;
+        const int j = isQ ? k : k - nq;
+        e[j] = 1;
+        calcResidualForceDirectionalDerivative(s,
+            appliedMobilityForces, appliedBodyForces, udot,
+            isQ ? eq : noDirection, isQ ? noDirection : eu, noDirection,
+            value, dValue);
+        e[j] = 0;
+
+        Matrix& out = isQ ? dq_ : du_;
+        if (accelerations) {
+            multiplyByMInv(s, dValue, MInvdValue);
+            for (int i=0; i < nu; ++i) out(i,j) = -MInvdValue[i];
+        } else
+            for (int i=0; i < nu; ++i) out(i,j) = dValue[i];
+    }
+}
+
+// The passes are those of SimbodyMatterSubsystemRep::multiplyByMInv(), going
+// through the bodies in index order rather than by level.
+void TreeDynamicsDerivatives::multiplyByMInv
+   (const State& s, const Vector& f, Vector& MInvf)
+{
+    const SBInstanceCache&  ic  = matter.getInstanceCache(s);
+    const SBTreePositionCache& tpc = matter.getTreePositionCache(s);
+    matter.realizeArticulatedBodyInertias(s); // (may already have been realized)
+    const SBArticulatedBodyInertiaCache& abc =
+        matter.getArticulatedBodyInertiaCache(s);
+
+    const int nb = matter.getNumBodies();
+    const int nu = matter.getNU(s);
+    MInvf.resize(nu);
+    if (nu==0)
+        return;
+    assert(f.hasContiguousData() && MInvf.hasContiguousData());
+
+    eps.resize(nu); z.resize(nb); zPlus.resize(nb); A_GBReal.resize(nb);
+
+    for (int b=nb-1; b >= 0; --b)
+        matter.getRigidBodyNode(MobilizedBodyIndex(b)).multiplyByMInvPass1Inward(ic, tpc, abc,
+            &f[0], z.begin(), zPlus.begin(), eps.begin());
+
+    for (MobilizedBodyIndex mbx(0); mbx < nb; ++mbx)
+        matter.getRigidBodyNode(mbx).multiplyByMInvPass2Outward(ic, tpc, abc,
+            eps.cbegin(), A_GBReal.begin(), &MInvf[0]);
+}
@@ -0,0 +1,135 @@
+#ifndef SimTK_SIMBODY_TREE_DYNAMICS_DERIVATIVES_H_
+#define SimTK_SIMBODY_TREE_DYNAMICS_DERIVATIVES_H_
+
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "simbody/internal/common.h"
+#include "SimbodyTreeState.h"
+
+class SimbodyMatterSubsystemRep;
+
+/* Directional derivatives of the tree inverse dynamics operator
+    f_residual(q,u,udot) = M(q) udot + f_inertial(q,u) - f_applied
+along a direction (dq,du,dudot), with the applied forces held fixed. This
+is SimbodyMatterSubsystemRep::calcTreeResidualForces() done in forward-mode
+automatic differentiation: the same two recursive passes are made with
+Dual-valued spatial quantities, so the value and the directional derivative
+come out of a single O(n) sweep.
+
+The q dependence of the cached Real kinematics is carried along by first
+mapping dq to the variations of the body frames (dtheta_GB, dp_GB); those
+follow from N^-1 dq exactly as body velocities follow from u. This only
+gives the derivative of H when H_FM is constant, so all mobilizers must
+report RigidBodyNode::hasConstantH_FM().
+
+The partial derivative matrices are built one column at a time from these
+sweeps, and for the forward dynamics a multiplication by M^-1 per column.
+
+The scratch space comes from an SBScratchCache::Frame supplied by the caller,
+normally opened on SimbodyMatterSubsystemRep::updThreadScratchCache(), so
+repeated calls don't allocate heap memory and several threads may use the
+same State at once. An object of this class is meant to live only as long as
+that Frame and is used for a single State. */
+class TreeDynamicsDerivatives {
+public:
+    // Take scratch space sized for this State from the Frame.
+    TreeDynamicsDerivatives(const SimbodyMatterSubsystemRep& matter,
+                            const State& state,
+                            SBScratchCache::Frame& scratch);
+
+    // Throw an exception naming the first mobilized body whose mobilizer is
+    // not supported.
+    static void checkMobilizers(const SimbodyMatterSubsystemRep& matter,
+                                const char* methodName);
+    // The same test without the exception.
+    static bool hasSupportedMobilizers(const SimbodyMatterSubsystemRep& matter);
+
+    // The State must be realized through Velocity stage. Any of the input
+    // Vectors may be zero length meaning all zero; otherwise they must have
+    // the usual lengths. The outputs are resized to nu if necessary.
+    void calcResidualForceDirectionalDerivative
+       (const State&                state,
+        const Vector&               appliedMobilityForces,
+        const Vector_<SpatialVec>&  appliedBodyForces,
+        const Vector&               knownUdot,
+        const Vector&               dq,
+        const Vector&               du,
+        const Vector&               dudot,
+        Vector&                     residual,
+        Vector&                     dResidual);
+
+    // Partial derivatives of the residual forces, column by column: column
+    // k of dfdq is the directional derivative along the k'th unit q
+    // direction, and likewise for dfdu. The matrices are resized to nu X nq
+    // and nu X nu if necessary. This is O(n^2), O(n) per column.
+    void calcResidualForcePartials
+       (const State&                state,
+        const Vector&               appliedMobilityForces,
+        const Vector_<SpatialVec>&  appliedBodyForces,
+        const Vector&               knownUdot,
+        Matrix&                     dfdq,
+        Matrix&                     dfdu);
+
+    // Partial derivatives of the forward dynamics udot(q,u), given the udot
+    // that the applied forces produce. Each column is -M^-1 times the
+    // corresponding column of the residual force partials, with the
+    // derivative of udot held at zero. No prescribed motion is allowed.
+    void calcAccelerationPartials
+       (const State&                state,
+        const Vector&               appliedMobilityForces,
+        const Vector_<SpatialVec>&  appliedBodyForces,
+        const Vector&               udot,
+        Matrix&                     dudotdq,
+        Matrix&                     dudotdu);
+
+    // Same as SimbodyMatterSubsystemRep::multiplyByMInv() but using the
+    // scratch space here. The vectors must be contiguous.
+    void multiplyByMInv(const State& state, const Vector& f, Vector& MInvf);
+
+private:
+    void calcPartials(const State&, const Vector&, const Vector_<SpatialVec>&,
+                      const Vector&, bool accelerations, Matrix&, Matrix&);
+
+    typedef Vec<3,Dual>     Vec3D;
+    typedef Vec<2,Vec3D>    SpatialVecD;
+
+    const SimbodyMatterSubsystemRep&        matter;
+
+    // Scratch, from the caller's Frame.
+    Vector                                  &dqContig, &dueq;
+    Array_<SpatialVec,MobilizedBodyIndex>&  dX_GB;  // (dtheta, dp) in G
+    Array_<Vec3D,MobilizedBodyIndex>&       l_PB;   // p_GB - p_GP
+    Array_<SpatialVecD,MobilizedBodyIndex>  &V_GB, &A_GB, &F;
+    Array_<SpatialVecD>&                    H;      // columns, indexed by u
+
+    // Unit directions and column results for the partials.
+    Vector                                  &noDirection, &eq, &eu;
+    Vector                                  &value, &dValue, &MInvdValue;
+
+    // For multiplyByMInv().
+    Array_<Real>&                           eps;
+    Array_<SpatialVec,MobilizedBodyIndex>   &z, &zPlus, &A_GBReal;
+};
+
+#endif // SimTK_SIMBODY_TREE_DYNAMICS_DERIVATIVES_H_
@@ -0,0 +1,216 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Track a synthetic motion capture trial of marker and orientation sensor
+observations with Assembler::trackTrial(), on one Assembler and split into
+segments over several. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A chain of Ball, Pin and Gimbal joints with markers and orientation sensors
+// on every body.
+class Chain {
+public:
+    Chain() : matter(system) {
+        Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+        const Transform X_BM(Vec3(0, 1, 0));
+        MobilizedBody::Ball b1(matter.Ground(), Transform(), body, X_BM);
+        MobilizedBody::Pin b2(b1, Transform(Vec3(0, -1, 0)), body, X_BM);
+        MobilizedBody::Gimbal b3(b2, Transform(Vec3(0.1, -1, 0)), body, X_BM);
+        MobilizedBody::Pin b4(b3, Transform(Rotation(Pi/2, XAxis),
+                                            Vec3(0, -1, 0)), body, X_BM);
+        bodies.push_back(b1); bodies.push_back(b2);
+        bodies.push_back(b3); bodies.push_back(b4);
+        stations.push_back(Vec3(0.2, 0, 0)); stations.push_back(Vec3(0, 0, 0.3));
+        system.realizeTopology();
+    }
+
+    // The motion to be recovered, using Euler angles.
+    State makeState(Real t) const {
+        State state = system.getDefaultState();
+        matter.setUseEulerAngles(state, true);
+        system.realizeModel(state);
+        state.setTime(t);
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] = 0.3*std::sin(2*t + i) + 0.1*i;
+        system.realize(state, Stage::Position);
+        return state;
+    }
+
+    // Set up an Assembler with marker and orientation sensor goals and 
+    // assemble it to the first frame of the motion.
+    Assembler* makeAssembler(AssemblyConditionIndex& markersIx,
+                             AssemblyConditionIndex& osensorsIx) const {
+        Assembler* assembler = new Assembler(system);
+        assembler->setAccuracy(1e-8);
+        Markers* markers = new Markers();
+        OrientationSensors* osensors = new OrientationSensors();
+        for (unsigned b=0; b < bodies.size(); ++b) {
+            for (unsigned i=0; i < stations.size(); ++i)
+                markers->addMarker(bodies[b], stations[i]);
+            osensors->addOSensor(bodies[b], Rotation());
+        }
+        markersIx = assembler->adoptAssemblyGoal(markers);
+        osensorsIx = assembler->adoptAssemblyGoal(osensors, 0.1);
+        
+        const State start = makeState(0);
+        assembler->initialize(start);
+        Array_<Vec3> markerObs; Array_<Rotation> osensorObs;
+        observe(start, markerObs, osensorObs);
+        markers->moveAllObservations(markerObs);
+        osensors->moveAllObservations(osensorObs);
+        assembler->assemble();
+        return assembler;
+    }
+
+    void observe(const State& state, Array_<Vec3>& markerObs,
+                 Array_<Rotation>& osensorObs) const {
+        for (unsigned b=0; b < bodies.size(); ++b) {
+            for (unsigned i=0; i < stations.size(); ++i)
+                markerObs.push_back(
+                    bodies[b].findStationLocationInGround(state, stations[i]));
+            osensorObs.push_back(bodies[b].getBodyRotation(state));
+        }
+    }
+
+    Assembler::Trial makeTrial(int nFrames, Real dt) const {
+        Assembler::Trial trial;
+        trial.frameTimes.resize(nFrames);
+        for (int f=0; f < nFrames; ++f) {
+            trial.frameTimes[f] = f*dt;
+            observe(makeState(f*dt), trial.markerObservations, 
+                    trial.osensorObservations);
+        }
+        return trial;
+    }
+
+    // Check that the tracked q's put the bodies where they should be.
+    void checkTrajectory(const Assembler::Trial& trial, 
+                         const Matrix& qTrajectory) const {
+        State state = makeState(0);
+        for (int f=0; f < trial.frameTimes.size(); ++f) {
+            const State expected = makeState(trial.frameTimes[f]);
+            state.updQ() = qTrajectory(f);
+            system.realize(state, Stage::Position);
+            for (unsigned b=0; b < bodies.size(); ++b)
+                SimTK_TEST_EQ_TOL(bodies[b].getBodyTransform(state),
+                                  bodies[b].getBodyTransform(expected), 1e-5);
+        }
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    Array_<MobilizedBody>       bodies;
+    Array_<Vec3>                stations;
+};
+
+void testTrackTrial() {
+    Chain chain;
+    AssemblyConditionIndex markersIx, osensorsIx;
+    Assembler* assembler = chain.makeAssembler(markersIx, osensorsIx);
+
+    Assembler::Trial trial = chain.makeTrial(30, 0.01);
+    trial.markers = markersIx;
+    trial.osensors = osensorsIx;
+
+    Matrix qTrajectory;
+    Array_<Assembler::FrameStats> stats;
+    assembler->trackTrial(trial, qTrajectory, &stats);
+    SimTK_TEST(qTrajectory.nrow() == assembler->getInternalState().getNQ());
+    SimTK_TEST(qTrajectory.ncol() == 30);
+    chain.checkTrajectory(trial, qTrajectory);
+
+    SimTK_TEST(stats.size() == 30);
+    for (unsigned f=0; f < stats.size(); ++f) {
+        SimTK_TEST(stats[f].goal >= 0 && stats[f].realTime >= 0);
+        SimTK_TEST(stats[f].nGoalEvals > 0);
+        SimTK_TEST(stats[f].nErrorJacobianEvals == 0); // no errors
+    }
+    SimTK_TEST(assembler->getNumAssemblySteps() == 31);
+
+    // A mismatched number of observations is caught.
+    trial.markerObservations.pop_back();
+    SimTK_TEST_MUST_THROW(assembler->trackTrial(trial, qTrajectory));
+
+    delete assembler;
+}
+
+// Split a trial into independent segments tracked concurrently by several
+// Assemblers; the results match tracking them serially on one Assembler.
+void testTrackSegments() {
+    Chain chain;
+    Assembler::Trial trial = chain.makeTrial(40, 0.01);
+    trial.segmentStarts.push_back(10);
+    trial.segmentStarts.push_back(20);
+    trial.segmentStarts.push_back(30);
+
+    Matrix serial;
+    Assembler* assembler = chain.makeAssembler(trial.markers, trial.osensors);
+    assembler->trackTrial(trial, serial);
+    chain.checkTrajectory(trial, serial);
+    delete assembler;
+
+    for (int n=1; n <= 3; ++n) {
+        Array_<Assembler*> assemblers;
+        for (int i=0; i < n; ++i)
+            assemblers.push_back(chain.makeAssembler(trial.markers, 
+                                                     trial.osensors));
+        Matrix qTrajectory;
+        Assembler::trackTrial(assemblers, trial, qTrajectory);
+        SimTK_TEST_EQ_TOL(qTrajectory, serial, 1e-10);
+        if (n == 3) {
+            // Assembler 0 did segments 0 and 3.
+            SimTK_TEST(assemblers[0]->getNumAssemblySteps() == 21);
+            SimTK_TEST(assemblers[2]->getNumAssemblySteps() == 11);
+        }
+        for (int i=0; i < n; ++i)
+            delete assemblers[i];
+    }
+
+    // The same Assembler can't be used by two threads, even if the repeats
+    // aren't next to each other.
+    Array_<Assembler*> repeated;
+    repeated.push_back(chain.makeAssembler(trial.markers, trial.osensors));
+    repeated.push_back(chain.makeAssembler(trial.markers, trial.osensors));
+    repeated.push_back(repeated[0]);
+    SimTK_TEST_MUST_THROW(Assembler::trackTrial(repeated, trial, serial));
+    delete repeated[0]; delete repeated[1];
+
+    trial.segmentStarts.push_back(25); // out of order
+    Array_<Assembler*> one(1, chain.makeAssembler(trial.markers,
+                                                  trial.osensors));
+    SimTK_TEST_MUST_THROW(Assembler::trackTrial(one, trial, serial));
+    delete one[0];
+}
+
+int main() {
+    SimTK_START_TEST("TestAssemblerTrial");
+        SimTK_SUBTEST(testTrackTrial);
+        SimTK_SUBTEST(testTrackSegments);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,254 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the analytic errors and error Jacobians of the built-in assembly
+conditions against finite differences, and check that using Markers and
+OrientationSensors as assembly error conditions gives the same result with
+analytic and numerical Jacobians. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A chain of Ball, Pin and Gimbal joints.
+class Chain {
+public:
+    Chain() : matter(system) {
+        Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+        const Transform X_BM(Vec3(0, 1, 0));
+        MobilizedBody::Ball b1(matter.Ground(), Transform(), body, X_BM);
+        MobilizedBody::Pin b2(b1, Transform(Vec3(0, -1, 0)), body, X_BM);
+        MobilizedBody::Gimbal b3(b2, Transform(Vec3(0.1, -1, 0)), body, X_BM);
+        MobilizedBody::Pin b4(b3, Transform(Rotation(Pi/2, XAxis),
+                                            Vec3(0, -1, 0)), body, X_BM);
+        bodies.push_back(b1); bodies.push_back(b2);
+        bodies.push_back(b3); bodies.push_back(b4);
+        system.realizeTopology();
+    }
+
+    // A configuration to be recovered by the assembler. We use Euler angles
+    // so that any q's are valid.
+    State makeTarget() const {
+        State state = system.getDefaultState();
+        matter.setUseEulerAngles(state, true);
+        system.realizeModel(state);
+        Random::Uniform rand(-1, 1); rand.setSeed(17);
+        for (int i=0; i < state.getNQ(); ++i)
+            state.updQ()[i] = rand.getValue();
+        system.realize(state, Stage::Position);
+        return state;
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    Array_<MobilizedBody>       bodies;
+};
+
+// Compare cond.calcErrorJacobian() with a central difference of 
+// cond.calcErrors() at the assembler's current internal state.
+void checkJacobian(const Assembler& assembler, const AssemblyCondition& cond) {
+    const System& system = assembler.getMultibodySystem();
+    State state = assembler.getInternalState();
+    system.realize(state, Stage::Position);
+    const int m = cond.getNumErrors(state);
+    const int np = assembler.getNumFreeQs();
+
+    Vector err;
+    SimTK_TEST(cond.calcErrors(state, err) == 0);
+    SimTK_TEST(err.size() == m);
+
+    // The goal is consistent with the errors.
+    Real goal;
+    SimTK_TEST(cond.calcGoal(state, goal) == 0);
+    SimTK_TEST_EQ(goal, err.normSqr()/2);
+
+    Matrix J;
+    SimTK_TEST(cond.calcErrorJacobian(state, J) == 0);
+    SimTK_TEST(J.nrow() == m && J.ncol() == np);
+
+    const Real h = 1e-6;
+    Matrix numJ(m, np);
+    Vector errp, errm;
+    for (Assembler::FreeQIndex fx(0); fx < np; ++fx) {
+        const QIndex qx = assembler.getQIndexOfFreeQ(fx);
+        State sp = state, sm = state;
+        sp.updQ()[qx] += h; system.realize(sp, Stage::Position);
+        sm.updQ()[qx] -= h; system.realize(sm, Stage::Position);
+        cond.calcErrors(sp, errp);
+        cond.calcErrors(sm, errm);
+        numJ(fx) = (errp - errm) / (2*h);
+    }
+    SimTK_TEST_EQ_TOL(J, numJ, 1e-7);
+}
+
+Array_<Vec3> markerStations() {
+    Array_<Vec3> stations;
+    stations.push_back(Vec3(0.2, 0, 0));   stations.push_back(Vec3(0, 0, 0.3));
+    stations.push_back(Vec3(-0.1, 0.5, 0));
+    return stations;
+}
+
+void addMarkers(const Chain& chain, Markers& markers) {
+    const Array_<Vec3> stations = markerStations();
+    for (unsigned b=0; b < chain.bodies.size(); ++b)
+        for (unsigned i=0; i < stations.size(); ++i)
+            markers.addMarker(chain.bodies[b], stations[i], 1 + 0.5*i);
+}
+
+Array_<Vec3> observeMarkers(const Chain& chain, const State& target) {
+    const Array_<Vec3> stations = markerStations();
+    Array_<Vec3> observations;
+    for (unsigned b=0; b < chain.bodies.size(); ++b)
+        for (unsigned i=0; i < stations.size(); ++i)
+            observations.push_back(
+                chain.bodies[b].findStationLocationInGround(target, 
+                                                            stations[i]));
+    return observations;
+}
+
+const Rotation SensorInB(0.3, UnitVec3(1, 2, 3));
+
+void addOSensors(const Chain& chain, OrientationSensors& osensors) {
+    for (unsigned b=0; b < chain.bodies.size(); ++b)
+        osensors.addOSensor(chain.bodies[b], SensorInB, 1 + b);
+}
+
+Array_<Rotation> observeOSensors(const Chain& chain, const State& target) {
+    Array_<Rotation> observations;
+    for (unsigned b=0; b < chain.bodies.size(); ++b)
+        observations.push_back(chain.bodies[b].getBodyRotation(target) 
+                               * SensorInB);
+    return observations;
+}
+
+void testMarkersJacobian() {
+    Chain chain;
+    const State target = chain.makeTarget();
+    Assembler assembler(chain.system);
+    Markers* markers = new Markers();
+    addMarkers(chain, *markers);
+    assembler.adoptAssemblyGoal(markers);
+    assembler.lockMobilizer(chain.bodies[1]);
+    assembler.initialize(chain.system.getDefaultState());
+
+    Array_<Vec3> observations = observeMarkers(chain, target);
+    observations[4] = Vec3(NaN); // missing from this frame
+    markers->moveAllObservations(observations);
+
+    SimTK_TEST(markers->getNumErrors(assembler.getInternalState()) 
+               == 3*(int)observations.size());
+    checkJacobian(assembler, *markers);
+}
+
+void testOrientationSensorsJacobian() {
+    Chain chain;
+    const State target = chain.makeTarget();
+    Assembler assembler(chain.system);
+    OrientationSensors* osensors = new OrientationSensors();
+    addOSensors(chain, *osensors);
+    assembler.adoptAssemblyGoal(osensors);
+    assembler.initialize(chain.system.getDefaultState());
+
+    Array_<Rotation> observations = observeOSensors(chain, target);
+    osensors->moveAllObservations(observations);
+    checkJacobian(assembler, *osensors);
+
+    // Small errors are handled without dividing by a zero angle.
+    assembler.initialize(target);
+    observations[2] = observations[2] * Rotation(1e-6, ZAxis);
+    osensors->moveAllObservations(observations);
+    checkJacobian(assembler, *osensors);
+}
+
+void testQValueJacobian() {
+    Chain chain;
+    Assembler assembler(chain.system);
+    QValue* qvalue = new QValue(chain.bodies[2], MobilizerQIndex(1), 0.25);
+    assembler.adoptAssemblyGoal(qvalue);
+    assembler.initialize(chain.system.getDefaultState());
+    checkJacobian(assembler, *qvalue);
+}
+
+// Require that one marker and one osensor match their observations exactly,
+// leaving the rest of the markers as a goal, and solve with analytic and with
+// numerical Jacobians; the results should be the same. The optimizer needs
+// there to be no more assembly errors than free q's.
+void assembleWithSensors(const Chain& chain, bool numerical, State& result, 
+                         int& nErrorEvals) {
+    const State target = chain.makeTarget();
+    Assembler assembler(chain.system);
+    assembler.setForceNumericalJacobian(numerical);
+    assembler.setErrorTolerance(1e-8);
+    Markers* markers = new Markers();
+    addMarkers(chain, *markers);
+    Markers* tip = new Markers();
+    tip->addMarker(chain.bodies[3], markerStations()[0]);
+    OrientationSensors* osensors = new OrientationSensors();
+    osensors->addOSensor(chain.bodies[2], SensorInB);
+    assembler.adoptAssemblyGoal(markers);
+    assembler.adoptAssemblyError(tip);
+    assembler.adoptAssemblyError(osensors);
+
+    State state = target;
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] += 0.05*(i%3);
+    assembler.initialize(state);
+    markers->moveAllObservations(observeMarkers(chain, target));
+    tip->moveOneObservation(Markers::ObservationIx(0),
+        chain.bodies[3].findStationLocationInGround(target, 
+                                                    markerStations()[0]));
+    osensors->moveOneObservation(OrientationSensors::ObservationIx(0),
+        observeOSensors(chain, target)[2]);
+
+    assembler.assemble(state);
+    chain.system.realize(state, Stage::Position);
+    result = state;
+    nErrorEvals = assembler.getNumErrorEvals();
+
+    for (unsigned b=0; b < chain.bodies.size(); ++b)
+        SimTK_TEST_EQ_TOL(chain.bodies[b].getBodyTransform(state),
+                          chain.bodies[b].getBodyTransform(target), 1e-6);
+}
+
+void testAssembleWithSensorErrors() {
+    Chain chain;
+    State analytic, numerical;
+    int nAnalytic, nNumerical;
+    assembleWithSensors(chain, false, analytic, nAnalytic);
+    assembleWithSensors(chain, true, numerical, nNumerical);
+    SimTK_TEST_EQ_TOL(analytic.getQ(), numerical.getQ(), 1e-6);
+    // Numerical Jacobians cost extra error evaluations.
+    SimTK_TEST(nAnalytic < nNumerical);
+}
+
+int main() {
+    SimTK_START_TEST("TestAssemblyConditions");
+        SimTK_SUBTEST(testMarkersJacobian);
+        SimTK_SUBTEST(testOrientationSensorsJacobian);
+        SimTK_SUBTEST(testQValueJacobian);
+        SimTK_SUBTEST(testAssembleWithSensorErrors);
+    SimTK_END_TEST();
+}
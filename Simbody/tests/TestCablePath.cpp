@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check cable path solutions against a case with a known answer, and check
+that solving the paths of many cables on several threads gives exactly the
+same results as a single thread. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A cable wrapping over a sphere in the plane containing its end points and
+// the sphere center consists of two tangent lines and an arc of a great
+// circle. Here the end points are below the center and the cable goes over
+// the top.
+void testWrapOverSphere() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    CableTrackerSubsystem cables(system);
+
+    const Real R = 0.5;
+    const Vec3 A(-2, -0.2, 0), B(1.5, -0.3, 0);
+    CablePath path(cables, matter.Ground(), A, matter.Ground(), B);
+    CableObstacle::Surface sphere(path, matter.Ground(), Transform(),
+                                  ContactGeometry::Sphere(R));
+    sphere.setContactPointHints(R*UnitVec3(-0.5, 1, 0.01),
+                                R*UnitVec3( 0.5, 1, 0.01));
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Position);
+
+    const Real a = A.norm(), b = B.norm();
+    const Real arc = 2*Pi - std::acos(dot(A,B)/(a*b))
+                     - std::acos(R/a) - std::acos(R/b);
+    const Real expected = std::sqrt(a*a-R*R) + std::sqrt(b*b-R*R) + R*arc;
+    SimTK_TEST_EQ_TOL(path.getCableLength(state), expected, 1e-6);
+}
+
+// Several cables, each wrapping over two adjacent spheres and passing through
+// a via point, on a swinging chain.
+class Scene {
+public:
+    Scene() : matter(system), cables(system), forces(system) {
+        Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0));
+        const Real Rad = .25, BiggerRad = .5;
+        Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+
+        for (int c=0; c < NumCables; ++c) {
+            const Transform X_GF(Rotation(2*Pi*c/NumCables, YAxis),
+                                 Vec3(3*c, 0, 0));
+            MobilizedBody::Ball body1(matter.Ground(), X_GF,
+                                      body, Transform(Vec3(0, 1, 0)));
+            MobilizedBody::Ball body2(body1, Transform(Vec3(0)),
+                                      body, Transform(Vec3(0, 1, 0)));
+            MobilizedBody::Ball body3(body2, Transform(Vec3(0)),
+                                      body, Transform(Vec3(0, 1, 0)));
+            MobilizedBody::Ball body4(body3, Transform(Vec3(0)),
+                                      body, Transform(Vec3(0, 1, 0)));
+            MobilizedBody::Ball body5(body4, Transform(Vec3(0)),
+                                      body, Transform(Vec3(0, 1, 0)));
+
+            CablePath path(cables, body1, Vec3(Rad,0,0), body5, Vec3(0,0,Rad));
+            CableObstacle::ViaPoint(path, body2, Rad*UnitVec3(1,1,0));
+            CableObstacle::Surface obs1(path, body3, Transform(),
+                                        ContactGeometry::Sphere(Rad));
+            obs1.setContactPointHints(Rad*UnitVec3(-.25,.04,0.08),
+                                      Rad*UnitVec3(-.05,-.25,-.04));
+            CableObstacle::Surface obs2(path, body4, Transform(),
+                                        ContactGeometry::Sphere(BiggerRad));
+            obs2.setContactPointHints(Rad*UnitVec3(.1,.125,-.2),
+                                      Rad*UnitVec3(0.1,-.1,-.2));
+        }
+        system.realizeTopology();
+    }
+
+    State makeState() const {
+        State state = system.getDefaultState();
+        for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx) {
+            const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+            mobod.setOneU(state, 0, 0.1*(mbx % 3));
+            mobod.setOneU(state, 2, -0.2*(mbx % 2));
+        }
+        return state;
+    }
+
+    static const int NumCables = 6;
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    CableTrackerSubsystem       cables;
+    GeneralForceSubsystem       forces;
+};
+
+// Simulate for a short time, recording cable lengths and rates. The initial
+// paths are found when the TimeStepper is initialized.
+void simulate(const Scene& scene, Array_<Real>& lengthChanges, 
+              Array_<Real>& rates, Array_<Real>& integratedRates) {
+    State state = scene.makeState();
+    RungeKuttaMersonIntegrator integ(scene.system);
+    integ.setAccuracy(1e-6);
+    TimeStepper ts(scene.system, integ);
+    ts.initialize(state);
+
+    const int n = scene.cables.getNumCablePaths();
+    lengthChanges.resize(n); rates.resize(n); integratedRates.resize(n);
+    for (CablePathIndex ix(0); ix < n; ++ix)
+        lengthChanges[ix] = 
+            -scene.cables.getCablePath(ix).getCableLength(integ.getState());
+
+    ts.stepTo(0.2);
+
+    const State& final = integ.getState();
+    scene.system.realize(final, Stage::Velocity);
+    for (CablePathIndex ix(0); ix < n; ++ix) {
+        const CablePath& path = scene.cables.getCablePath(ix);
+        lengthChanges[ix] += path.getCableLength(final);
+        rates[ix] = path.getCableLengthDot(final);
+        integratedRates[ix] = path.getIntegratedCableLengthDot(final);
+    }
+}
+
+void testThreadsGiveSameResults() {
+    Scene scene;
+
+    Array_<Real> changes1, rates1, integ1;
+    simulate(scene, changes1, rates1, integ1);
+
+    // The cable length rates are consistent with the length changes.
+    for (int i=0; i < Scene::NumCables; ++i) {
+        SimTK_TEST(std::abs(changes1[i]) > 1e-3); // something happened
+        SimTK_TEST_EQ_TOL(changes1[i], integ1[i], 1e-5);
+    }
+
+    scene.cables.setNumberOfThreads(4);
+    SimTK_TEST(scene.cables.getNumberOfThreads() == 4);
+    Array_<Real> changes4, rates4, integ4;
+    simulate(scene, changes4, rates4, integ4);
+
+    for (int i=0; i < Scene::NumCables; ++i) {
+        SimTK_TEST(changes4[i] == changes1[i]);
+        SimTK_TEST(rates4[i] == rates1[i]);
+        SimTK_TEST(integ4[i] == integ1[i]);
+    }
+}
+
+void testBadNumberOfThreads() {
+    MultibodySystem system;
+    CableTrackerSubsystem cables(system);
+    SimTK_TEST_MUST_THROW(cables.setNumberOfThreads(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestCablePath");
+        SimTK_SUBTEST(testWrapOverSphere);
+        SimTK_SUBTEST(testThreadsGiveSameResults);
+        SimTK_SUBTEST(testBadNumberOfThreads);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,147 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that reusing stale constraint factorizations, in forward dynamics and
+in projection, still produces results that satisfy the constraints. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Two four-bar linkages, each a crank and a rocker pinned to Ground and 
+// joined by a rod. One of them is driven at constant crank speed.
+void testReusedDynamicsFactor() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    const Body::Rigid crankBody(MassProperties(.5, Vec3(0), 
+                                UnitInertia::cylinderAlongY(.02,.1)));
+    const Body::Rigid rockerBody(MassProperties(.8, Vec3(0,.02,0), 
+                                 UnitInertia::cylinderAlongY(.02,.2)));
+    for (int i=0; i < 2; ++i) {
+        const Vec3 pivot(i,0,0);
+        MobilizedBody::Pin crank(matter.Ground(), pivot, 
+                                 crankBody, Vec3(0,.1,0));
+        MobilizedBody::Pin rocker(matter.Ground(), pivot + Vec3(.4,0,0), 
+                                  rockerBody, Vec3(0,.2,0));
+        Constraint::Rod(crank, Vec3(0,-.1,0), rocker, Vec3(0,-.2,0), .45);
+        if (i == 1)
+            Constraint::ConstantSpeed(crank, MobilizerUIndex(0), 2);
+    }
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    Random::Uniform rand(-0.5,0.5);
+    rand.setSeed(3);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+
+    SimTK_TEST(matter.getConstraintFactorReuseLimit() == 0);
+    matter.setConstraintFactorReuseLimit(3);
+    SimTK_TEST(matter.getConstraintFactorReuseLimit() == 3);
+    system.realize(state, Stage::Acceleration); // fresh factorization
+
+    // Small changes in configuration, as between integrator stages. Compare
+    // against a State that hasn't seen a factorization yet.
+    for (int step=0; step < 6; ++step) {
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += 1e-4;
+        State fresh = system.getDefaultState();
+        fresh.updQ() = state.getQ(); fresh.updU() = state.getU();
+        system.realize(state, Stage::Acceleration);
+        system.realize(fresh, Stage::Acceleration);
+        SimTK_TEST_EQ_TOL(state.getUDot(), fresh.getUDot(), 1e-8);
+        SimTK_TEST_EQ_TOL(state.getMultipliers(), fresh.getMultipliers(), 1e-8);
+        SimTK_TEST_EQ_TOL(state.getUDotErr(), Vector(state.getNUDotErr(), 0.),
+                          1e-10);
+    }
+
+    // A large change can't be handled by refinement; must refactor.
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += 0.3;
+    State fresh = system.getDefaultState();
+    fresh.updQ() = state.getQ(); fresh.updU() = state.getU();
+    system.realize(state, Stage::Acceleration);
+    system.realize(fresh, Stage::Acceleration);
+    SimTK_TEST_EQ_TOL(state.getUDot(), fresh.getUDot(), 1e-8);
+
+    SimTK_TEST_MUST_THROW(matter.setConstraintFactorReuseLimit(-1));
+}
+
+// A three-cylinder radial engine: three connecting rods share the crank pin
+// of a flywheel, and each rod's wrist pin is kept on its cylinder's line.
+// Integrate with and without reuse; both must satisfy the constraints and 
+// agree to within the integration accuracy.
+void testReuseDuringIntegration() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    const Body::Rigid flywheelBody(MassProperties(2, Vec3(0), 
+                                   UnitInertia::cylinderAlongZ(.15,.02)));
+    const Body::Rigid rodBody(MassProperties(.3, Vec3(0), 
+                              UnitInertia::cylinderAlongY(.01,.2)));
+    MobilizedBody::Pin flywheel(matter.Ground(), Vec3(0), 
+                                flywheelBody, Vec3(0));
+    Force::MobilityLinearSpring(forces, flywheel, 0, 5, 1);
+    for (int k=0; k < 3; ++k) {
+        const Real angle = k*2*Pi/3; // of the cylinder from vertical
+        MobilizedBody::Pin rod(flywheel, Vec3(.1,0,0), rodBody, Vec3(0,-.2,0));
+        rod.setDefaultAngle(angle);
+        Constraint::PointInPlane(matter.Ground(), 
+            UnitVec3(std::cos(angle), std::sin(angle), 0), 0,
+            rod, Vec3(0,.2,0));
+    }
+    system.realizeTopology();
+
+    State initState = system.getDefaultState();
+    Assembler(system).setAccuracy(1e-10).assemble(initState);
+
+    const Real Accuracy = 1e-6;
+    Vector finalQ[2];
+    for (int reuse=0; reuse < 2; ++reuse) {
+        matter.setConstraintFactorReuseLimit(reuse ? 10 : 0);
+        RungeKuttaMersonIntegrator integ(system);
+        integ.setAccuracy(Accuracy);
+        integ.setConstraintTolerance(1e-8);
+        TimeStepper ts(system, integ);
+        ts.initialize(initState);
+        ts.stepTo(1.0);
+
+        const State& state = integ.getState();
+        system.realize(state, Stage::Acceleration);
+        SimTK_TEST(state.getQErr().normRMS() <= 1e-7);
+        SimTK_TEST(state.getUErr().normRMS() <= 1e-7);
+        finalQ[reuse] = state.getQ();
+    }
+    SimTK_TEST_EQ_TOL(finalQ[0], finalQ[1], 100*Accuracy);
+}
+
+int main() {
+    SimTK_START_TEST("TestConstraintFactorReuse");
+        SimTK_SUBTEST(testReusedDynamicsFactor);
+        SimTK_SUBTEST(testReuseDuringIntegration);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,267 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that all the ContactTrackerSubsystem broad phase methods find the
+same contacts as a brute force check, while the surfaces move around. */
+
+#include "SimTKsimbody.h"
+
+#include <set>
+#include <utility>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+typedef set< pair<ContactSurfaceIndex,ContactSurfaceIndex> > SurfacePairs;
+
+static SurfacePairs getContactPairs(const ContactTrackerSubsystem& tracker,
+                                    const State& state) {
+    SurfacePairs found;
+    const ContactSnapshot& contacts = tracker.getActiveContacts(state);
+    for (int i=0; i < contacts.getNumContacts(); ++i) {
+        const Contact& contact = contacts.getContact(i);
+        ContactSurfaceIndex s1 = contact.getSurface1(), 
+                            s2 = contact.getSurface2();
+        if (s1 > s2) std::swap(s1, s2);
+        found.insert(make_pair(s1,s2));
+    }
+    return found;
+}
+
+void testBroadPhaseMethodsAgree() {
+    const int NumSpheres = 200;
+    const Real Radius = 0.1;
+
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    ContactTrackerSubsystem tracker(system);
+    SimTK_TEST(tracker.getBroadPhaseMethod() 
+               == ContactTrackerSubsystem::IncrementalSweepAndPrune);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    body.addContactSurface(Transform(), 
+        ContactSurface(ContactGeometry::Sphere(Radius), 
+                       ContactMaterial(1e6,0,0,0,0)));
+    for (int i=0; i < NumSpheres; ++i)
+        MobilizedBody::Translation(matter.Ground(), body);
+    system.realizeTopology();
+
+    // A crowded layer of spheres so that nearly all of them overlap along
+    // the vertical axis.
+    Random::Uniform rand(0, 3);
+    rand.setSeed(1234);
+    State state = system.getDefaultState();
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+        matter.getMobilizedBody(mbx).setQToFitTranslation(state,
+            Vec3(rand.getValue(), rand.getValue()/20, rand.getValue()));
+
+    const ContactTrackerSubsystem::BroadPhaseMethod methods[] = {
+        ContactTrackerSubsystem::SingleAxisSweep,
+        ContactTrackerSubsystem::IncrementalSweepAndPrune,
+        ContactTrackerSubsystem::DynamicAABBTree };
+    // Each method keeps its own State so the incremental ones carry their
+    // history from step to step.
+    Array_<State> states(3, state);
+
+    Random::Gaussian jiggle(0, Radius/5);
+    jiggle.setSeed(99);
+    int numFound = 0;
+    for (int step=0; step < 30; ++step) {
+        Vector q = state.getQ();
+        for (int i=0; i < q.size(); ++i)
+            q[i] += jiggle.getValue();
+        state.updQ() = q;
+        system.realize(state, Stage::Position);
+
+        // Brute force.
+        SurfacePairs expected;
+        for (MobilizedBodyIndex b1(1); b1 < matter.getNumBodies(); ++b1)
+            for (MobilizedBodyIndex b2(b1+1); b2 < matter.getNumBodies(); ++b2) {
+                const Vec3 p1 = matter.getMobilizedBody(b1)
+                                    .getBodyOriginLocation(state);
+                const Vec3 p2 = matter.getMobilizedBody(b2)
+                                    .getBodyOriginLocation(state);
+                if ((p1-p2).norm() < 2*Radius)
+                    expected.insert(make_pair(
+                        tracker.getContactSurfaceIndex(b1,0),
+                        tracker.getContactSurfaceIndex(b2,0)));
+            }
+        numFound += (int)expected.size();
+
+        for (int m=0; m < 3; ++m) {
+            tracker.setBroadPhaseMethod(methods[m]);
+            SimTK_TEST(tracker.getBroadPhaseMethod() == methods[m]);
+            states[m].updQ() = q;
+            system.realize(states[m], Stage::Position);
+            SimTK_TEST(getContactPairs(tracker, states[m]) == expected);
+        }
+    }
+    SimTK_TEST(numFound > 0);
+}
+
+// Move one ellipsoid through another and out again. A tracker that keeps its
+// PairCache from step to step must give the same contacts as one starting
+// with an empty cache, given the same prior contact, and the same as one
+// that starts from scratch each time.
+void testConvexPairCache() {
+    const ContactGeometry::Ellipsoid shapeA(Vec3(1, 0.5, 0.3));
+    const ContactGeometry::Ellipsoid shapeB(Vec3(0.4, 0.8, 0.6));
+    const ContactTracker::ConvexImplicitPair tracker
+       (ContactGeometry::Ellipsoid::classTypeId(),
+        ContactGeometry::Ellipsoid::classTypeId());
+    const ContactSurfaceIndex surfA(0), surfB(1);
+    const UntrackedContact untracked(surfA, surfB);
+
+    ContactTracker::PairCache cache;
+    SimTK_TEST(!cache.hasSeparatingDirection);
+
+    const Transform X_GA(Rotation(0.3, YAxis), Vec3(0.1, 0.2, 0.3));
+    const int NumSteps = 200;
+    int numContacts = 0, numSeparated = 0;
+    Contact prior = untracked;
+    for (int step=0; step <= NumSteps; ++step) {
+        const Real s = Real(step)/NumSteps;
+        const Transform X_GB(Rotation(BodyRotationSequence, 2*s, XAxis, 
+                                      s, ZAxis, 0, XAxis),
+                             X_GA.p() + Vec3(-3 + 6*s, 1.1, 0.1));
+        Contact cached, uncached, fresh;
+        SimTK_TEST(tracker.trackContactUsingCache(prior, X_GA, shapeA,
+                                                  X_GB, shapeB, 0, cache, 
+                                                  cached));
+        SimTK_TEST(tracker.trackContact(prior, X_GA, shapeA,
+                                        X_GB, shapeB, 0, uncached));
+        SimTK_TEST(tracker.trackContact(untracked, X_GA, shapeA, 
+                                        X_GB, shapeB, 0, fresh));
+        SimTK_TEST(cached.isEmpty() == uncached.isEmpty());
+        SimTK_TEST(cached.isEmpty() == fresh.isEmpty());
+        prior = cached.isEmpty() ? Contact(untracked) : cached;
+        if (fresh.isEmpty()) {
+            ++numSeparated;
+            continue;
+        }
+        ++numContacts;
+        const EllipticalPointContact& c1 = 
+            EllipticalPointContact::getAs(cached);
+        const EllipticalPointContact& c2 = 
+            EllipticalPointContact::getAs(uncached);
+        const EllipticalPointContact& c3 =
+            EllipticalPointContact::getAs(fresh);
+        // The cache can't make any difference.
+        SimTK_TEST(c1.getDepth() == c2.getDepth());
+        SimTK_TEST(c1.getContactFrame().p() == c2.getContactFrame().p());
+        // Starting from the prior contact finds the same solution.
+        SimTK_TEST_EQ_TOL(c1.getDepth(), c3.getDepth(), 1e-10);
+        SimTK_TEST_EQ_TOL(c1.getContactFrame().p(), 
+                          c3.getContactFrame().p(), 1e-10);
+        SimTK_TEST_EQ_TOL(c1.getContactFrame().z(), 
+                          c3.getContactFrame().z(), 1e-8);
+    }
+    SimTK_TEST(numContacts > 10 && numSeparated > 10);
+    // The last step is well clear.
+    SimTK_TEST(cache.hasSeparatingDirection);
+
+    cache.clear();
+    SimTK_TEST(!cache.hasSeparatingDirection);
+}
+
+// A State carries its per-pair history from one realization to the next. 
+// Ellipsoids whose contacts are found that way must match a State
+// that starts fresh each time, including when the configuration doesn't 
+// change at all.
+void testPairHistoryMatchesFresh() {
+    const int NumBodies = 30;
+
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    ContactTrackerSubsystem tracker(system);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    body.addContactSurface(Transform(), 
+        ContactSurface(ContactGeometry::Ellipsoid(Vec3(0.3, 0.2, 0.15)), 
+                       ContactMaterial(1e6,0,0,0,0)));
+    for (int i=0; i < NumBodies; ++i)
+        MobilizedBody::Free(matter.Ground(), body);
+    system.realizeTopology();
+
+    // Rows of slightly tilted ellipsoids, each barely touching its 
+    // neighbors. The contact points are unique only for shallow penetration.
+    Random::Uniform tilt(-0.1, 0.1);
+    tilt.setSeed(42);
+    State state = system.getDefaultState();
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+        const int i = (mbx-1) % 10, j = (mbx-1) / 10;
+        mobod.setQToFitTransform(state, Transform(
+            Rotation(BodyRotationSequence, tilt.getValue(), XAxis,
+                     tilt.getValue(), YAxis, tilt.getValue(), ZAxis),
+            Vec3(0.59*i, 0, 0.29*j)));
+    }
+
+    Random::Gaussian jiggle(0, 0.002);
+    jiggle.setSeed(7);
+    int numFound = 0;
+    for (int step=0; step < 20; ++step) {
+        // Every few steps leave the configuration alone.
+        if (step % 4 != 3) {
+            Vector q = state.getQ();
+            for (int i=0; i < q.size(); ++i)
+                q[i] += jiggle.getValue();
+            state.updQ() = q;
+        } else
+            state.invalidateAllCacheAtOrAbove(Stage::Position);
+        system.realize(state, Stage::Dynamics);
+
+        State fresh = system.getDefaultState();
+        fresh.updQ() = state.getQ();
+        system.realize(fresh, Stage::Dynamics);
+
+        const ContactSnapshot& contacts = tracker.getActiveContacts(state);
+        const ContactSnapshot& expected = tracker.getActiveContacts(fresh);
+        SimTK_TEST(getContactPairs(tracker, state) 
+                   == getContactPairs(tracker, fresh));
+        for (int i=0; i < contacts.getNumContacts(); ++i) {
+            const Contact& contact = contacts.getContact(i);
+            const Contact& other = expected.getContactById
+               (expected.getContactIdForSurfacePair(contact.getSurface1(), 
+                                                    contact.getSurface2()));
+                SimTK_TEST_EQ_TOL(EllipticalPointContact::getAs(contact)
+                                .getDepth(),
+                              EllipticalPointContact::getAs(other)
+                                .getDepth(), 1e-10);
+        }
+        numFound += contacts.getNumContacts();
+
+        // Advance the contact state variables the way a time stepper would.
+        state.autoUpdateDiscreteVariables();
+    }
+    SimTK_TEST(numFound > 0);
+}
+
+int main() {
+    SimTK_START_TEST("TestContactBroadPhase");
+        SimTK_SUBTEST(testBroadPhaseMethodsAgree);
+        SimTK_SUBTEST(testConvexPairCache);
+        SimTK_SUBTEST(testPairHistoryMatchesFresh);
+    SimTK_END_TEST();
+}
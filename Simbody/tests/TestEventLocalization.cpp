@@ -0,0 +1,136 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that event localization realizes the interpolated trial States only
+through the stage the event triggers need, and that it doesn't change where
+the events are found. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Count the number of times forces are calculated, which is once per 
+// realization through Dynamics stage.
+class CountingForce : public Force::Custom::Implementation {
+public:
+    explicit CountingForce(int& nCalls) : nCalls(nCalls) {}
+    void calcForce(const State&, Vector_<SpatialVec>&, Vector_<Vec3>&, 
+                   Vector&) const override 
+    {   ++nCalls; }
+    Real calcPotentialEnergy(const State&) const override {return 0;}
+private:
+    int& nCalls;
+};
+
+// Trigger whenever the pendulum passes through the vertical. The trigger only
+// depends on q but we can say it needs a later stage.
+class CrossingHandler : public TriggeredEventHandler {
+public:
+    CrossingHandler(Stage stage, Array_<Real>& times) 
+    :   TriggeredEventHandler(stage), times(times) {}
+    Real getValue(const State& state) const override {
+        return state.getQ()[0];
+    }
+    void handleEvent(State& state, Real accuracy, 
+                     bool& shouldTerminate) const override {
+        times.push_back(state.getTime());
+    }
+private:
+    Array_<Real>& times;
+};
+
+struct Run {
+    Array_<Real> times;
+    int nForceCalls = 0;
+    int nRealizations = 0;
+    int nLocalizations = 0;
+    int nLocalizationIterations = 0;
+};
+
+// Simulate a pendulum swinging through the vertical several times.
+static void simulate(Stage triggerStage, Run& run) {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::UniformGravity gravity(forces, matter, Vec3(0, -9.8, 0));
+    Force::Custom counter(forces, new CountingForce(run.nForceCalls));
+    Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pendulum(matter.updGround(), Transform(), 
+                                body, Transform(Vec3(0, 1, 0)));
+    system.addEventHandler(new CrossingHandler(triggerStage, run.times));
+
+    State state = system.realizeTopology();
+    pendulum.setOneQ(state, 0, 0.5);
+
+    RungeKuttaMersonIntegrator integ(system);
+    integ.setAccuracy(1e-6);
+    TimeStepper ts(system, integ);
+    ts.initialize(state);
+    integ.resetAllStatistics();
+    run.nForceCalls = 0;
+    ts.stepTo(4);
+
+    run.nRealizations = integ.getNumRealizations();
+    run.nLocalizations = integ.getNumEventLocalizations();
+    run.nLocalizationIterations = integ.getNumEventLocalizationIterations();
+}
+
+void testStageLimitedLocalization() {
+    Run pos, acc;
+    simulate(Stage::Position, pos);
+    simulate(Stage::Acceleration, acc);
+
+    // The pendulum has a period of about 2.9s, so crosses 3 times in 4s.
+    SimTK_TEST(pos.times.size() == 3);
+    SimTK_TEST(acc.times.size() == pos.times.size());
+    for (unsigned i = 0; i < pos.times.size(); ++i)
+        SimTK_TEST_EQ(acc.times[i], pos.times[i]);
+
+    // Each event was localized, which took some trial states.
+    SimTK_TEST(pos.nLocalizations == (int)pos.times.size());
+    SimTK_TEST(pos.nLocalizationIterations > 0);
+    SimTK_TEST(acc.nLocalizations == pos.nLocalizations);
+    SimTK_TEST(acc.nLocalizationIterations == pos.nLocalizationIterations);
+
+    // With Position-stage triggers, no trial state was realized any further
+    // than it had to be interpolated; with Acceleration-stage triggers each 
+    // one was realized through Acceleration.
+    SimTK_TEST(acc.nRealizations - pos.nRealizations 
+               == pos.nLocalizationIterations);
+    SimTK_TEST(acc.nForceCalls - pos.nForceCalls 
+               == pos.nLocalizationIterations);
+
+    cout << "  " << pos.nLocalizations << " localizations took " 
+         << pos.nLocalizationIterations << " trial states; " 
+         << pos.nForceCalls << " force evaluations (" << acc.nForceCalls 
+         << " with Acceleration-stage triggers)\n";
+}
+
+int main() {
+    SimTK_START_TEST("TestEventLocalization");
+        SimTK_SUBTEST(testStageLimitedLocalization);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,180 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that calculating compliant contact forces on several threads, both
+across contacts and across the faces of one large elastic foundation mesh, 
+gives exactly the same results as a single thread. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Balls resting on the ground, alternately triangle meshes (elastic 
+// foundation) and spheres (Hertz), or a single finely-meshed ball that 
+// produces a contact with many faces.
+class Scene {
+public:
+    explicit Scene(bool oneBigMesh) 
+    :   matter(system), tracker(system), contact(system, tracker) {
+        const ContactMaterial material(1e6, 0.1, 0.8, 0.5, 0.2);
+        matter.Ground().updBody().addContactSurface(
+            Rotation(-Pi/2, ZAxis), 
+            ContactSurface(ContactGeometry::HalfSpace(), material));
+
+        Body::Rigid meshBody(MassProperties(1, Vec3(0), UnitInertia(1)));
+        meshBody.addContactSurface(Transform(), ContactSurface(
+            ContactGeometry::TriangleMesh(
+                PolygonalMesh::createSphereMesh(0.5, oneBigMesh ? 4 : 2)), 
+            material, 0.1));
+        Body::Rigid sphereBody(MassProperties(1, Vec3(0), UnitInertia(1)));
+        sphereBody.addContactSurface(Transform(), ContactSurface(
+            ContactGeometry::Sphere(0.5), material));
+
+        const int nBodies = oneBigMesh ? 1 : 8;
+        for (int i=0; i < nBodies; ++i)
+            MobilizedBody::Free(matter.Ground(), i%2 ? sphereBody : meshBody);
+        system.realizeTopology();
+    }
+
+    State makeState() const {
+        State state = system.getDefaultState();
+        for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx) {
+            const int i = mbx - 1;
+            const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+            mobod.setQToFitTransform(state, 
+                Transform(Rotation(0.3*i, UnitVec3(1,1,i)),
+                          Vec3(1.5*i, 0.4 - 0.01*i, 0)));
+            mobod.setUToFitVelocity(state,
+                SpatialVec(Vec3(0.1, -0.2, 0.3*i), Vec3(0.2*i, -0.1, 0.05)));
+        }
+        return state;
+    }
+
+    MultibodySystem             system;
+    SimbodyMatterSubsystem      matter;
+    ContactTrackerSubsystem     tracker;
+    CompliantContactSubsystem   contact;
+};
+
+// Everything but the ContactIds must match; those come from a global counter.
+static void testSameForce(const ContactForce& a, const ContactForce& b) {
+    SimTK_TEST(a.getContactPoint() == b.getContactPoint());
+    SimTK_TEST(a.getForceOnSurface2() == b.getForceOnSurface2());
+    SimTK_TEST(a.getPotentialEnergy() == b.getPotentialEnergy());
+    SimTK_TEST(a.getPowerDissipation() == b.getPowerDissipation());
+}
+
+// Realize a copy of the state with one thread and then with four, and 
+// check that the results are identical.
+static void testScene(bool oneBigMesh) {
+    Scene scene(oneBigMesh);
+    SimTK_TEST(scene.contact.getNumberOfThreads() == 1);
+    State serial = scene.makeState();
+    State parallel = serial;
+
+    scene.contact.setNumberOfThreads(1);
+    scene.system.realize(serial, Stage::Position);
+    const Real pePosSerial = scene.system.calcPotentialEnergy(serial);
+    scene.system.realize(serial, Stage::Dynamics);
+
+    scene.contact.setNumberOfThreads(4);
+    SimTK_TEST(scene.contact.getNumberOfThreads() == 4);
+    scene.system.realize(parallel, Stage::Position);
+    const Real pePosParallel = scene.system.calcPotentialEnergy(parallel);
+    scene.system.realize(parallel, Stage::Dynamics);
+    SimTK_TEST(pePosSerial == pePosParallel);
+    SimTK_TEST(pePosSerial > 0);
+
+    const int nForces = scene.contact.getNumContactForces(serial);
+    cout << nForces << " contact forces\n";
+    SimTK_TEST(nForces == (oneBigMesh ? 1 : scene.matter.getNumBodies()-1));
+    SimTK_TEST(scene.contact.getNumContactForces(parallel) == nForces);
+    for (int i=0; i < nForces; ++i)
+        testSameForce(scene.contact.getContactForce(serial, i),
+                      scene.contact.getContactForce(parallel, i));
+    const Vector_<SpatialVec>& bodyForcesSerial = 
+        scene.system.getRigidBodyForces(serial, Stage::Dynamics);
+    const Vector_<SpatialVec>& bodyForcesParallel = 
+        scene.system.getRigidBodyForces(parallel, Stage::Dynamics);
+    for (int b=0; b < bodyForcesSerial.size(); ++b)
+        SimTK_TEST(bodyForcesSerial[b] == bodyForcesParallel[b]);
+
+    // Patch details for the mesh contacts, including the one with many faces.
+    const ContactSnapshot& active = scene.tracker.getActiveContacts(serial);
+    int maxFaces = 0;
+    for (int i=0; i < active.getNumContacts(); ++i) {
+        if (!TriangleMeshContact::isInstance(active.getContact(i)))
+            continue;
+        const TriangleMeshContact& mesh = 
+            TriangleMeshContact::getAs(active.getContact(i));
+        const Array_<int>& faces = mesh.getSurface2FaceArray();
+        SimTK_TEST(faces.size() == mesh.getSurface2Faces().size());
+        SimTK_TEST(std::equal(faces.begin(), faces.end(), 
+                              mesh.getSurface2Faces().begin()));
+        maxFaces = std::max(maxFaces, (int)faces.size());
+
+        const ContactId id = mesh.getContactId();
+        const ContactId parallelId = scene.tracker.getActiveContacts(parallel)
+                                        .getContact(i).getContactId();
+        ContactPatch patchSerial, patchParallel;
+        scene.contact.setNumberOfThreads(1);
+        SimTK_TEST(scene.contact.calcContactPatchDetailsById
+                                            (serial, id, patchSerial));
+        scene.contact.setNumberOfThreads(4);
+        SimTK_TEST(scene.contact.calcContactPatchDetailsById
+                                        (parallel, parallelId, patchParallel));
+        testSameForce(patchSerial.getContactForce(), 
+                      patchParallel.getContactForce());
+        SimTK_TEST(patchSerial.getNumDetails() == patchParallel.getNumDetails());
+        for (int k=0; k < patchSerial.getNumDetails(); ++k) {
+            const ContactDetail& a = patchSerial.getContactDetail(k);
+            const ContactDetail& b = patchParallel.getContactDetail(k);
+            SimTK_TEST(a.getContactPoint() == b.getContactPoint());
+            SimTK_TEST(a.getForceOnSurface2() == b.getForceOnSurface2());
+        }
+        SimTK_TEST_EQ(patchSerial.getContactForce().getForceOnSurface2(),
+            scene.contact.getContactForceById(serial, id).getForceOnSurface2());
+    }
+    cout << "largest mesh contact has " << maxFaces << " faces\n";
+    if (oneBigMesh)
+        SimTK_TEST(maxFaces > 200); // several batches
+}
+
+void testManyContacts() {testScene(false);}
+void testOneBigMeshContact() {testScene(true);}
+
+void testBadNumberOfThreads() {
+    Scene scene(false);
+    SimTK_TEST_MUST_THROW(scene.contact.setNumberOfThreads(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelContactForces");
+        SimTK_SUBTEST(testManyContacts);
+        SimTK_SUBTEST(testOneBigMeshContact);
+        SimTK_SUBTEST(testBadNumberOfThreads);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,166 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+/* Check that running the ContactTrackerSubsystem narrow phase on several 
+threads produces exactly the same ContactSnapshot as a single thread. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A pile of triangle mesh balls and spheres on the ground, overlapping one
+// another so that there are mesh-mesh, mesh-sphere, sphere-sphere and 
+// halfspace pairs to track.
+class Pile {
+public:
+    Pile() : matter(system), tracker(system) {
+        const ContactMaterial material(1e6, 0, 0, 0, 0);
+        matter.Ground().updBody().addContactSurface(
+            Rotation(-Pi/2, ZAxis), 
+            ContactSurface(ContactGeometry::HalfSpace(), material));
+
+        Body::Rigid meshBody(MassProperties(1, Vec3(0), UnitInertia(1)));
+        meshBody.addContactSurface(Transform(), ContactSurface(
+            ContactGeometry::TriangleMesh(
+                PolygonalMesh::createSphereMesh(0.5, 2)), material));
+        Body::Rigid sphereBody(MassProperties(1, Vec3(0), UnitInertia(1)));
+        sphereBody.addContactSurface(Transform(), ContactSurface(
+            ContactGeometry::Sphere(0.3), material));
+
+        for (int i=0; i < 12; ++i) {
+            MobilizedBody::Free(matter.Ground(), 
+                                i%2 ? meshBody : sphereBody);
+        }
+        system.realizeTopology();
+    }
+
+    State makeState() const {
+        State state = system.getDefaultState();
+        for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx) {
+            const int i = mbx - 1;
+            matter.getMobilizedBody(mbx).setQToFitTransform(state,
+                Transform(Rotation(0.3*i, UnitVec3(1,1,i)),
+                          Vec3(0.6*(i%4), 0.25 + 0.6*(i/4), 0.3*(i%3))));
+        }
+        return state;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    ContactTrackerSubsystem tracker;
+};
+
+// Everything but the ContactIds must match; those come from a global counter.
+static void testSameContacts(const ContactSnapshot& a, 
+                             const ContactSnapshot& b) {
+    SimTK_TEST(a.getNumContacts() == b.getNumContacts());
+    for (int i=0; i < a.getNumContacts(); ++i) {
+        const Contact& ca = a.getContact(i);
+        const Contact& cb = b.getContact(i);
+        SimTK_TEST(ca.getSurface1() == cb.getSurface1());
+        SimTK_TEST(ca.getSurface2() == cb.getSurface2());
+        SimTK_TEST(ca.getCondition() == cb.getCondition());
+        SimTK_TEST(ca.getTypeId() == cb.getTypeId());
+        SimTK_TEST(ca.getTransform().T() == cb.getTransform().T());
+        if (TriangleMeshContact::isInstance(ca)) {
+            const TriangleMeshContact& ta = TriangleMeshContact::getAs(ca);
+            const TriangleMeshContact& tb = TriangleMeshContact::getAs(cb);
+            SimTK_TEST(ta.getSurface1Faces() == tb.getSurface1Faces());
+            SimTK_TEST(ta.getSurface2Faces() == tb.getSurface2Faces());
+        }
+        if (CircularPointContact::isInstance(ca)) {
+            const CircularPointContact& pa = CircularPointContact::getAs(ca);
+            const CircularPointContact& pb = CircularPointContact::getAs(cb);
+            SimTK_TEST(pa.getDepth() == pb.getDepth());
+            SimTK_TEST(pa.getOrigin() == pb.getOrigin());
+        }
+    }
+}
+
+// New contacts get consecutive ids in snapshot order, and continuing ones 
+// keep the id they had before.
+static void testContactIds(const ContactSnapshot& prev, 
+                           const ContactSnapshot& next) {
+    int lastNewId = -1;
+    for (int i=0; i < next.getNumContacts(); ++i) {
+        const Contact& contact = next.getContact(i);
+        const int id = contact.getContactId();
+        if (contact.getCondition() == Contact::NewContact) {
+            if (lastNewId >= 0) SimTK_TEST(id == lastNewId + 1);
+            lastNewId = id;
+        } else {
+            SimTK_TEST(prev.hasContact(contact.getContactId()));
+        }
+    }
+}
+
+void testParallelMatchesSerial() {
+    Pile pile;
+    SimTK_TEST(pile.tracker.getNumberOfThreads() == 1);
+    State serial = pile.makeState();
+    State parallel = serial;
+
+    ContactSnapshot prevSerial, prevParallel;
+    for (int step=0; step < 3; ++step) {
+        pile.tracker.setNumberOfThreads(1);
+        pile.system.realize(serial, Stage::Dynamics);
+        pile.tracker.setNumberOfThreads(4);
+        SimTK_TEST(pile.tracker.getNumberOfThreads() == 4);
+        pile.system.realize(parallel, Stage::Dynamics);
+
+        const ContactSnapshot& s = pile.tracker.getActiveContacts(serial);
+        const ContactSnapshot& p = pile.tracker.getActiveContacts(parallel);
+        int nMesh = 0, nOngoing = 0;
+        for (int i=0; i < s.getNumContacts(); ++i) {
+            nMesh += TriangleMeshContact::isInstance(s.getContact(i));
+            nOngoing += s.getContact(i).getCondition() == Contact::Ongoing;
+        }
+        cout << "step " << step << ": " << s.getNumContacts() 
+             << " contacts, " << nMesh << " mesh, " << nOngoing 
+             << " ongoing\n";
+        SimTK_TEST(s.getNumContacts() > 10);
+        testSameContacts(s, p);
+        testContactIds(prevSerial, s);
+        testContactIds(prevParallel, p);
+        prevSerial = s; prevParallel = p;
+
+        // Move everything a little so that next time the contacts are
+        // ongoing.
+        for (State* state : {&serial, &parallel}) {
+            state->autoUpdateDiscreteVariables();
+            state->updQ() *= 1.01;
+        }
+    }
+
+    SimTK_TEST_MUST_THROW(pile.tracker.setNumberOfThreads(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelNarrowPhase");
+        SimTK_SUBTEST(testParallelMatchesSerial);
+    SimTK_END_TEST();
+}
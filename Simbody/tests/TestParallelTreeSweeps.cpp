@@ -0,0 +1,140 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that running the nodes of each tree level concurrently produces
+exactly the same results as the serial sweeps. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+static void realizeAll(const MultibodySystem& system, State& state) {
+    system.realize(state, Stage::Acceleration);
+    // Exercise the operator forms too.
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    Vector udot;
+    matter.multiplyByMInv(state, Vector(state.getNU(), 1.), udot);
+}
+
+// A humanoid with 40 loose objects around it. The objects and the limbs are
+// independent subtrees, so most levels are several nodes wide.
+void testParallelMatchesSerial() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+
+    const Body::Rigid torsoBody(MassProperties(30, Vec3(0,0.05,0), 
+                                               UnitInertia::brick(.15,.3,.1)));
+    const Body::Rigid headBody(MassProperties(5, Vec3(0), 
+                                              UnitInertia::sphere(.1)));
+    const Body::Rigid upperArmBody(MassProperties(2.5, Vec3(0), 
+                                   UnitInertia::cylinderAlongY(.04,.15)));
+    const Body::Rigid forearmBody(MassProperties(1.5, Vec3(0,.01,0), 
+                                  UnitInertia::cylinderAlongY(.03,.13)));
+    const Body::Rigid handBody(MassProperties(.5, Vec3(.01,0,0), 
+                               UnitInertia::brick(.04,.05,.015)));
+    const Body::Rigid fingerBody(MassProperties(.03, Vec3(0), 
+                                 UnitInertia::cylinderAlongY(.008,.02)));
+    const Body::Rigid thighBody(MassProperties(8, Vec3(0,.02,0), 
+                                UnitInertia::cylinderAlongY(.07,.2)));
+    const Body::Rigid shankBody(MassProperties(4, Vec3(0), 
+                                UnitInertia::cylinderAlongY(.05,.2)));
+    const Body::Rigid footBody(MassProperties(1, Vec3(.03,0,0), 
+                               UnitInertia::brick(.1,.03,.04)));
+
+    MobilizedBody::Free torso(matter.Ground(), Vec3(0,1,0), 
+                              torsoBody, Vec3(0));
+    MobilizedBody::Ball neck(torso, Vec3(0,.3,0), headBody, Vec3(0,-.1,0));
+    for (int side=-1; side <= 1; side += 2) {
+        MobilizedBody::Ball shoulder(torso, Vec3(side*.2,.25,0), 
+                                     upperArmBody, Vec3(0,.15,0));
+        MobilizedBody::Pin elbow(shoulder, Vec3(0,-.15,0), 
+                                 forearmBody, Vec3(0,.13,0));
+        MobilizedBody::Universal wrist(elbow, Vec3(0,-.13,0), 
+                                       handBody, Vec3(0,.05,0));
+        for (int k=0; k < 4; ++k)
+            MobilizedBody::Pin(wrist, Vec3(.025*k-.04,-.05,0), 
+                               fingerBody, Vec3(0,.02,0));
+
+        MobilizedBody::Gimbal hip(torso, Vec3(side*.1,-.3,0), 
+                                  thighBody, Vec3(0,.2,0));
+        MobilizedBody::Pin knee(hip, Vec3(0,-.2,0), shankBody, Vec3(0,.2,0));
+        MobilizedBody::Universal(knee, Vec3(0,-.2,0), 
+                                 footBody, Vec3(-.03,.03,0));
+    }
+
+    for (int i=0; i < 40; ++i) {
+        const Vec3 halfLengths(.02+.002*i, .03, .05-.001*i);
+        const Body::Rigid objectBody(MassProperties(.1+.01*i, Vec3(0), 
+                                     UnitInertia::brick(halfLengths)));
+        MobilizedBody::Free(matter.Ground(), Vec3(.1*(i%8)-.4, .8, .1*(i/8)+.3),
+                            objectBody, Vec3(0));
+    }
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    Random::Uniform rand(-1,1);
+    rand.setSeed(42);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+
+    SimTK_TEST(matter.getNumberOfThreads() == 1);
+    State serial = state;
+    realizeAll(system, serial);
+
+    matter.setNumberOfThreads(3);
+    matter.setParallelSweepThreshold(2);
+    SimTK_TEST(matter.getNumberOfThreads() == 3);
+    SimTK_TEST(matter.getParallelSweepThreshold() == 2);
+    for (int rep=0; rep < 5; ++rep) {
+        State parallel = state;
+        realizeAll(system, parallel);
+
+        SimTK_TEST((parallel.getQErr() - serial.getQErr()).normInf() == 0);
+        SimTK_TEST((parallel.getQDot() - serial.getQDot()).normInf() == 0);
+        SimTK_TEST((parallel.getUDot() - serial.getUDot()).normInf() == 0);
+        for (MobilizedBodyIndex mbx(0); mbx < matter.getNumBodies(); ++mbx) {
+            const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+            SimTK_TEST(mobod.getBodyTransform(parallel).T() 
+                       == mobod.getBodyTransform(serial).T());
+            SimTK_TEST(mobod.getBodyVelocity(parallel) 
+                       == mobod.getBodyVelocity(serial));
+            SimTK_TEST(mobod.getBodyAcceleration(parallel) 
+                       == mobod.getBodyAcceleration(serial));
+        }
+    }
+
+    matter.setNumberOfThreads(1);
+    SimTK_TEST(matter.getNumberOfThreads() == 1);
+    SimTK_TEST_MUST_THROW(matter.setParallelSweepThreshold(0));
+}
+
+int main() {
+    SimTK_START_TEST("TestParallelTreeSweeps");
+        SimTK_SUBTEST(testParallelMatchesSerial);
+    SimTK_END_TEST();
+}
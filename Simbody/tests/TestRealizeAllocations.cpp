@@ -0,0 +1,322 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that once a State has been realized, realizing it again after its
+state variables change doesn't allocate heap memory: the temporaries come from
+the scratch space kept in the State's cache. We count allocations by replacing
+the global operator new; where that doesn't reach into the libraries (Windows
+DLLs) the counts are simply zero. The operators don't use that scratch space,
+so they can be applied to one realized State from several threads at once. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+using namespace SimTK;
+using namespace std;
+
+static bool countAllocations = false;
+static int  numAllocations = 0;
+
+void* operator new(std::size_t n) {
+    if (countAllocations) ++numAllocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {return operator new(n);}
+void operator delete(void* p) noexcept {std::free(p);}
+void operator delete[](void* p) noexcept {std::free(p);}
+
+// Realize the State through Acceleration stage and return how many heap 
+// allocations that took.
+static int countRealizeAllocations(const MultibodySystem& system, 
+                                   const State& state) {
+    numAllocations = 0;
+    countAllocations = true;
+    system.realize(state, Stage::Acceleration);
+    countAllocations = false;
+    return numAllocations;
+}
+
+// Make sure the counting works at all.
+void testCounting() {
+    numAllocations = 0;
+    countAllocations = true;
+    int* p = new int(3);
+    countAllocations = false;
+    delete p;
+    SimTK_TEST(numAllocations == 1);
+}
+
+// A six-axis arm on a mobile base with a two-finger gripper, its joints held
+// by springs and dampers the way a servo controller would. This is the kind
+// of model that gets realized on every tick of a control loop.
+static void addArm(SimbodyMatterSubsystem& matter, 
+                   GeneralForceSubsystem& forces) {
+    const Body::Rigid baseBody(MassProperties(20, Vec3(0), 
+                               UnitInertia::brick(.3,.1,.2)));
+    const Body::Rigid linkBody(MassProperties(2, Vec3(0,.01,.005), 
+                               UnitInertia::cylinderAlongY(.04,.15)));
+    const Body::Rigid fingerBody(MassProperties(.05, Vec3(0), 
+                                 UnitInertia::brick(.01,.03,.01)));
+
+    MobilizedBody::Free base(matter.Ground(), Vec3(0,.1,0), baseBody, Vec3(0));
+    MobilizedBody parent = base;
+    Vec3 mount(0,.1,0);
+    for (int j=0; j < 6; ++j) {
+        // Alternately bend the arm and twist it about the link's axis.
+        const Rotation R = j % 2 ? Rotation(Pi/2, XAxis) : Rotation();
+        MobilizedBody::Pin joint(parent, Transform(R, mount), 
+                                 linkBody, Transform(R, Vec3(0,-.15,0)));
+        Force::MobilityLinearSpring(forces, joint, 0, 50, .1*j);
+        Force::MobilityLinearDamper(forces, joint, 0, 2);
+        parent = joint;
+        mount = Vec3(0,.15,0);
+    }
+
+    MobilizedBody::Slider left(parent, Vec3(-.03,.15,0), 
+                               fingerBody, Vec3(0,-.03,0));
+    MobilizedBody::Slider right(parent, Vec3(.03,.15,0), 
+                                fingerBody, Vec3(0,-.03,0));
+    Force::TwoPointLinearSpring(forces, left, Vec3(0), right, Vec3(0), 
+                                20, .04);
+}
+
+// A delta robot: three upper arms on pins around a fixed base, each with a
+// forearm on a ball joint. The moving platform hangs from the first forearm
+// and the other two are tied to it by ball constraints.
+static void addDeltaRobot(SimbodyMatterSubsystem& matter) {
+    const Body::Rigid upperArmBody(MassProperties(.4, Vec3(0), 
+                                   UnitInertia::cylinderAlongY(.02,.1)));
+    const Body::Rigid forearmBody(MassProperties(.2, Vec3(0), 
+                                  UnitInertia::cylinderAlongY(.01,.2)));
+    const Body::Rigid platformBody(MassProperties(.5, Vec3(0), 
+                                   UnitInertia::cylinderAlongY(.08,.01)));
+
+    MobilizedBody forearms[3];
+    for (int k=0; k < 3; ++k) {
+        const Rotation R(k*2*Pi/3, YAxis);
+        MobilizedBody::Pin upper(matter.Ground(), 
+                                 Transform(R, R*Vec3(.15,0,0)),
+                                 upperArmBody, Vec3(0,.1,0));
+        forearms[k] = MobilizedBody::Ball(upper, Vec3(0,-.1,0), 
+                                          forearmBody, Vec3(0,.2,0));
+    }
+    MobilizedBody::Ball platform(forearms[0], Vec3(0,-.2,0), 
+                                 platformBody, Vec3(.08,0,0));
+    for (int k=1; k < 3; ++k)
+        Constraint::Ball(platform, Rotation(k*2*Pi/3, YAxis)*Vec3(.08,0,0),
+                         forearms[k], Vec3(0,-.2,0));
+}
+
+// The arm is an unconstrained tree with a variety of mobilizers and forces.
+void testTree() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    addArm(matter, forces);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    Random::Uniform rand(-0.5,0.5);
+    rand.setSeed(7);
+    system.realize(state, Stage::Acceleration); // first realization may allocate
+
+    for (int step=0; step < 5; ++step) {
+        state.updTime() += 0.01;
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+        SimTK_TEST(countRealizeAllocations(system, state) == 0);
+    }
+
+    // A copy of the State gets its own scratch space.
+    State copy = state;
+    system.realize(copy, Stage::Acceleration);
+    copy.updU()[0] += 0.1;
+    SimTK_TEST(countRealizeAllocations(system, copy) == 0);
+    state.updU()[0] += 0.1;
+    SimTK_TEST(countRealizeAllocations(system, state) == 0);
+    SimTK_TEST_EQ(copy.getUDot(), state.getUDot());
+}
+
+// The delta robot has closed loops. As long as the constraint factorization
+// can be reused, forward dynamics solves with it and refines the multipliers
+// without allocating; a fresh factorization may allocate.
+void testLoops() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    addDeltaRobot(matter);
+    matter.setConstraintFactorReuseLimit(100);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    Random::Uniform rand(-0.5,0.5);
+    rand.setSeed(3);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+    system.realize(state, Stage::Acceleration); // fresh factorization
+
+    for (int step=0; step < 5; ++step) {
+        state.updTime() += 0.01;
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] += 1e-5;
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] += 1e-3;
+        SimTK_TEST(countRealizeAllocations(system, state) == 0);
+        SimTK_TEST_EQ_TOL(state.getUDotErr(), 
+                          Vector(state.getNUDotErr(), 0.), 1e-10);
+    }
+}
+
+template <class T>
+static bool isIdentical(const Vector_<T>& a, const Vector_<T>& b) {
+    if (a.size() != b.size()) return false;
+    for (int i=0; i < a.size(); ++i)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+// Several threads apply the operators to one realized State at once; each
+// must get exactly what a lone caller gets. With the default reuse limit the
+// State's constraint factorization is current and calcAcceleration() reads 
+// it; with reuse allowed it may be stale and calcAcceleration() factors 
+// privately. Either way the State is left alone.
+void testConcurrentOperators() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    addDeltaRobot(matter);
+    system.realizeTopology();
+
+    for (int reuseLimit : {0, 100}) {
+        matter.setConstraintFactorReuseLimit(reuseLimit);
+        State state = system.getDefaultState();
+        Random::Uniform rand(-0.5,0.5);
+        rand.setSeed(5);
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i]=rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i]=rand.getValue();
+        system.realize(state, Stage::Acceleration);
+        state.updQ()[0] += 1e-4; // may reuse the factorization now
+        system.realize(state, Stage::Acceleration);
+
+        const int nu = state.getNU();
+        Vector v(nu);
+        for (int i=0; i < nu; ++i) v[i] = rand.getValue();
+        const Vector& f = system.getMobilityForces(state, Stage::Dynamics);
+        const Vector_<SpatialVec>& F = 
+            system.getRigidBodyForces(state, Stage::Dynamics);
+
+        Vector MInvV, udot;
+        Vector_<SpatialVec> Jv, A_GB, A_GBc;
+        matter.multiplyByMInv(state, v, MInvV);
+        matter.multiplyBySystemJacobian(state, v, Jv);
+        matter.calcBodyAccelerationFromUDot(state, v, A_GB);
+        matter.calcAcceleration(state, f, F, udot, A_GBc);
+        SimTK_TEST_EQ_TOL(udot, state.getUDot(), 1e-10);
+
+        const int nThreads = 4;
+        Array_<int> nWrong(nThreads, 0);
+        Array_<std::thread> threads;
+        for (int t=0; t < nThreads; ++t)
+            threads.emplace_back([&, t]() {
+                Vector x; Vector_<SpatialVec> X;
+                for (int rep=0; rep < 100; ++rep) {
+                    matter.multiplyByMInv(state, v, x);
+                    if (!isIdentical(x, MInvV)) ++nWrong[t];
+                    matter.multiplyBySystemJacobian(state, v, X);
+                    if (!isIdentical(X, Jv)) ++nWrong[t];
+                    matter.calcBodyAccelerationFromUDot(state, v, X);
+                    if (!isIdentical(X, A_GB)) ++nWrong[t];
+                    matter.calcAcceleration(state, f, F, x, X);
+                    if (!isIdentical(x, udot) || !isIdentical(X, A_GBc)) 
+                        ++nWrong[t];
+                }
+            });
+        for (auto& thread : threads)
+            thread.join();
+        for (int t=0; t < nThreads; ++t)
+            SimTK_TEST(nWrong[t] == 0);
+    }
+}
+
+// The dynamics derivative operators take their temporaries from the calling
+// thread's scratch space, so once that has grown and the outputs have the
+// right sizes, further calls don't allocate.
+void testDerivativeOperators() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    addArm(matter, forces);
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    Random::Uniform rand(-0.5,0.5);
+    rand.setSeed(11);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+    system.realize(state, Stage::Acceleration);
+
+    const int nq = state.getNQ(), nu = state.getNU();
+    Vector dq(nq), du(nu), dudot(nu);
+    for (int i=0; i < nq; ++i) dq[i] = rand.getValue();
+    for (int i=0; i < nu; ++i) du[i] = dudot[i] = rand.getValue();
+    const Vector& f = system.getMobilityForces(state, Stage::Dynamics);
+    const Vector_<SpatialVec>& F =
+        system.getRigidBodyForces(state, Stage::Dynamics);
+    const Vector& udot = state.getUDot();
+
+    Vector r, dr, a, da;
+    Matrix dfdq, dfdu, dadq, dadu;
+    for (int pass=0; pass < 2; ++pass) { // the first pass may allocate
+        numAllocations = 0;
+        countAllocations = true;
+        matter.calcResidualForceIgnoringConstraintsDirectionalDerivative
+           (state, f, F, udot, dq, du, dudot, r, dr);
+        matter.calcAccelerationIgnoringConstraintsDirectionalDerivative
+           (state, f, F, dq, du, a, da);
+        matter.calcResidualForceIgnoringConstraintsPartials
+           (state, f, F, udot, dfdq, dfdu);
+        matter.calcAccelerationIgnoringConstraintsPartials
+           (state, f, F, a, dadq, dadu);
+        countAllocations = false;
+        if (pass == 1)
+            SimTK_TEST(numAllocations == 0);
+    }
+    SimTK_TEST_EQ_TOL(a, udot, 1e-10);
+}
+
+int main() {
+    SimTK_START_TEST("TestRealizeAllocations");
+        SimTK_SUBTEST(testCounting);
+        SimTK_SUBTEST(testTree);
+        SimTK_SUBTEST(testLoops);
+        SimTK_SUBTEST(testConcurrentOperators);
+        SimTK_SUBTEST(testDerivativeOperators);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,204 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that System::realizeBatch() gives the same answers as realizing each
+State by itself, however many threads it uses. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+#include <memory>
+
+using namespace SimTK;
+using namespace std;
+
+// A force that asks to be run in parallel with the others, so that the
+// GeneralForceSubsystem's shared executor is involved.
+class SpringToOriginImpl : public Force::Custom::Implementation {
+public:
+    SpringToOriginImpl(const MobilizedBody& body, Real k)
+    :   body(body), k(k) {}
+    bool shouldBeParallelIfPossible() const override {return true;}
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces, Vector& mobilityForces)
+                   const override {
+        const Vec3 p = body.getBodyOriginLocation(state);
+        body.applyForceToBodyPoint(state, Vec3(0), -k*p, bodyForces);
+    }
+    Real calcPotentialEnergy(const State& state) const override {
+        return k*body.getBodyOriginLocation(state).normSqr()/2;
+    }
+private:
+    MobilizedBody   body;
+    Real            k;
+};
+
+// A chain of pins with a loop closure, a coordinate coupler, prescribed
+// motion, gravity and some springs.
+class BatchModel {
+public:
+    BatchModel() : matter(system), forces(system) {
+        Force::Gravity(forces, matter, -YAxis, 9.8);
+        Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(0.1)));
+        MobilizedBody parent = matter.Ground();
+        for (int i=0; i < 8; ++i) {
+            MobilizedBody::Pin pin(parent, Vec3(0,-0.5,0), body, Vec3(0,0.5,0));
+            bodies.push_back(pin);
+            Force::Custom(forces, new SpringToOriginImpl(bodies.back(), 2));
+            parent = pin;
+        }
+        Constraint::Ball(matter.Ground(), Vec3(1,-6,0), bodies.back(), Vec3(0));
+
+        Array_<MobilizedBodyIndex> coordBody(2);
+        Array_<MobilizerQIndex>    coordIndex(2, MobilizerQIndex(0));
+        coordBody[0] = bodies[1].getMobilizedBodyIndex();
+        coordBody[1] = bodies[2].getMobilizedBodyIndex();
+        Constraint::CoordinateCoupler(matter,
+            new Function::Linear(Vector(Vec3(1,-1,0))), coordBody, coordIndex);
+        Constraint::PrescribedMotion(matter,
+            new Function::Sinusoid(0.2, 3, 0),
+            bodies[0].getMobilizedBodyIndex(), MobilizerQIndex(0));
+
+        system.realizeTopology();
+    }
+
+    // A State with random q, u and time.
+    State makeState(Random::Uniform& rand) const {
+        State state = system.getDefaultState();
+        state.setTime(rand.getValue());
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+        return state;
+    }
+
+    MultibodySystem              system;
+    SimbodyMatterSubsystem       matter;
+    GeneralForceSubsystem        forces;
+    Array_<MobilizedBody::Pin>   bodies;
+};
+
+void testBatchMatchesSerial(int numThreads) {
+    BatchModel model;
+    model.system.setNumBatchRealizeThreads(numThreads);
+    SimTK_TEST(model.system.getNumBatchRealizeThreads() == numThreads);
+
+    Random::Uniform rand(-1, 1);
+    rand.setSeed(17);
+    const int nStates = 64;
+    Array_<State> states, serial;
+    for (int i=0; i < nStates; ++i) {
+        states.push_back(model.makeState(rand));
+        serial.push_back(states.back());
+    }
+    // Start some of them from a stage past Model.
+    for (int i=0; i < nStates; i += 5)
+        model.system.realize(states[i], Stage::Position);
+
+    Array_<State*> batch;
+    for (auto& s : states) batch.push_back(&s);
+    RealizeResults results;
+    model.system.realizeBatch(batch, Stage::Acceleration, results);
+    SimTK_TEST(results.getNumStates() == nStates);
+    SimTK_TEST(results.getNumThreads() == std::min(numThreads, nStates));
+    SimTK_TEST(results.getElapsedTime() >= 0);
+    SimTK_TEST(results.getRealizationsPerSecond() >= 0);
+    cout << numThreads << " threads: " << results.getRealizationsPerSecond()
+         << " realizations/s\n";
+
+    for (int i=0; i < nStates; ++i) {
+        model.system.realize(serial[i], Stage::Acceleration);
+        SimTK_TEST(states[i].getSystemStage() == Stage::Acceleration);
+        const State& batched = states[i];
+        SimTK_TEST((batched.getUDot() - serial[i].getUDot()).normInf() == 0);
+        SimTK_TEST((batched.getMultipliers() 
+                    - serial[i].getMultipliers()).normInf() == 0);
+        SimTK_TEST((batched.getQErr() - serial[i].getQErr()).normInf() == 0);
+    }
+
+    // Already realized; nothing should change.
+    model.system.realizeBatch(batch, Stage::Dynamics);
+    SimTK_TEST(states[0].getSystemStage() == Stage::Acceleration);
+}
+
+void testBadBatches() {
+    BatchModel model;
+    Random::Uniform rand(-1, 1);
+    State s1 = model.makeState(rand);
+
+    Array_<State*> batch;
+    model.system.realizeBatch(batch); // empty is fine
+
+    batch.push_back(&s1); batch.push_back(nullptr);
+    SimTK_TEST_MUST_THROW(model.system.realizeBatch(batch));
+
+    batch[1] = &s1;
+    SimTK_TEST_MUST_THROW(model.system.realizeBatch(batch));
+
+    State empty;
+    batch[1] = &empty;
+    SimTK_TEST_MUST_THROW(model.system.realizeBatch(batch));
+
+    SimTK_TEST_MUST_THROW(model.system.setNumBatchRealizeThreads(0));
+}
+
+// An exception thrown while realizing one State must come back to the caller
+// after the others have been realized.
+class ThrowingForceImpl : public Force::Custom::Implementation {
+public:
+    void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,
+                   Vector_<Vec3>& particleForces, Vector& mobilityForces)
+                   const override {
+        if (state.getTime() > 100)
+            SimTK_THROW1(Exception::Cant, "time is too late");
+    }
+    Real calcPotentialEnergy(const State& state) const override {return 0;}
+};
+
+void testExceptionInBatch() {
+    BatchModel model;
+    Force::Custom(model.forces, new ThrowingForceImpl());
+    model.system.realizeTopology();
+    model.system.setNumBatchRealizeThreads(4);
+
+    Random::Uniform rand(-1, 1);
+    Array_<State> states;
+    for (int i=0; i < 16; ++i) states.push_back(model.makeState(rand));
+    states[7].setTime(200);
+    Array_<State*> batch;
+    for (auto& s : states) batch.push_back(&s);
+
+    SimTK_TEST_MUST_THROW(model.system.realizeBatch(batch, Stage::Dynamics));
+    for (int i=0; i < 16; ++i)
+        if (i != 7) SimTK_TEST(states[i].getSystemStage() == Stage::Dynamics);
+    SimTK_TEST(states[7].getSystemStage() < Stage::Dynamics);
+}
+
+int main() {
+    SimTK_START_TEST("TestRealizeBatch");
+        SimTK_SUBTEST1(testBatchMatchesSerial, 1);
+        SimTK_SUBTEST1(testBatchMatchesSerial, 2);
+        SimTK_SUBTEST1(testBatchMatchesSerial, 4);
+        SimTK_SUBTEST(testBadBatches);
+        SimTK_SUBTEST(testExceptionInBatch);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,212 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the SDIRK implicit integrator on a stiff multibody system, and the
+MultibodySystem Jacobian it uses in place of numerical differentiation. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A slow double pendulum and, separately, a block held by a stiff, heavily
+// damped spring whose fast mode decays at a rate of about 1e4/s.
+struct Model {
+    explicit Model(bool withGravity=true) : matter(system), forces(system) {
+        if (withGravity)
+            Force::UniformGravity(forces, matter, Vec3(0, -9.8, 0));
+        Body::Rigid body(MassProperties(1.0, Vec3(0), Inertia(.1)));
+        pendulum1 = MobilizedBody::Pin(matter.updGround(), Transform(),
+                                       body, Transform(Vec3(0, 1, 0)));
+        pendulum2 = MobilizedBody::Pin(pendulum1, Transform(),
+                                       body, Transform(Vec3(0, 1, 0)));
+        block = MobilizedBody::Slider(matter.updGround(), Vec3(5, 0, 0),
+                                      body, Transform());
+        Force::MobilityLinearSpring(forces, block, MobilizerQIndex(0), 
+                                    1e6, 0);
+        Force::MobilityLinearDamper(forces, block, MobilizerUIndex(0), 1e4);
+        Force::MobilityLinearSpring(forces, pendulum2, MobilizerQIndex(0), 
+                                    10, 0);
+        Force::GlobalDamper(forces, matter, 0.1);
+        state = system.realizeTopology();
+        pendulum1.setOneQ(state, 0, 0.5);
+        pendulum2.setOneQ(state, 0, -0.3);
+        pendulum1.setOneU(state, 0, 1);
+        block.setOneQ(state, 0, 0.01);
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    GeneralForceSubsystem   forces;
+    MobilizedBody::Pin      pendulum1, pendulum2;
+    MobilizedBody::Slider   block;
+    State                   state;
+};
+
+static const Real FinalTime = 2;
+
+static Vector simulate(const System& system, const State& state,
+                       Integrator& integ, Real accuracy) {
+    integ.setAccuracy(accuracy);
+    TimeStepper ts(system, integ);
+    ts.initialize(state);
+    ts.stepTo(FinalTime);
+    SimTK_TEST_EQ(integ.getTime(), FinalTime);
+    return integ.getState().getY();
+}
+
+// With no gravity and only Pin and Slider mobilizers (N=I), the only terms
+// the System's Jacobian leaves out are none at all, so it should match 
+// numerical differentiation.
+void testSystemJacobian() {
+    Model model(false);
+    State s = model.state;
+    model.system.realize(s, Stage::Acceleration);
+
+    Matrix J;
+    SimTK_TEST(model.system.calcYDotJacobian(s, J));
+    const int ny = s.getNY();
+    SimTK_TEST(J.nrow() == ny && J.ncol() == ny);
+
+    Matrix Jnum(ny, ny);
+    const Vector y0 = s.getY();
+    for (int j=0; j < ny; ++j) {
+        const Real h = 1e-6;
+        State sp = s;
+        sp.updY() = y0; sp.updY()[j] += h;
+        model.system.realize(sp, Stage::Acceleration);
+        State sm = s;
+        sm.updY() = y0; sm.updY()[j] -= h;
+        model.system.realize(sm, Stage::Acceleration);
+        Jnum(j) = (sp.getYDot() - sm.getYDot()) / (2*h);
+    }
+    for (int i=0; i < ny; ++i)
+        for (int j=0; j < ny; ++j)
+            SimTK_TEST_EQ_TOL(J(i,j), Jnum(i,j), 1e-5*(1+std::abs(Jnum(i,j))));
+
+    // The System's Jacobian needs Acceleration stage.
+    State s2 = model.state;
+    model.system.realize(s2, Stage::Dynamics);
+    SimTK_TEST_MUST_THROW(model.system.calcYDotJacobian(s2, J));
+}
+
+void testStiffSystem() {
+    Model model;
+
+    Vector yRef;
+    {   RungeKuttaMersonIntegrator rkm(model.system);
+        yRef = simulate(model.system, model.state, rkm, 1e-10); }
+
+    SDIRKIntegrator sdirk(model.system);
+    SimTK_TEST(sdirk.getMethodName() == std::string("SDIRK"));
+    SimTK_TEST(sdirk.getUseSystemJacobian());
+    const Vector y = simulate(model.system, model.state, sdirk, 1e-5);
+    SimTK_TEST_EQ_TOL(y, yRef, 1e-3);
+
+    // The Jacobian came from the System every time, and was reused.
+    SimTK_TEST(sdirk.getNumJacobianEvaluations() > 0);
+    SimTK_TEST(sdirk.getNumNumericalJacobianEvaluations() == 0);
+    SimTK_TEST(sdirk.getNumJacobianEvaluations() < sdirk.getNumStepsTaken());
+    SimTK_TEST(sdirk.getNumIterationMatrixFactorizations() 
+               < sdirk.getNumStepsAttempted());
+
+    // An explicit integrator needs many more steps at the same accuracy, 
+    // since the fast mode limits its step size.
+    RungeKuttaMersonIntegrator rkm(model.system);
+    simulate(model.system, model.state, rkm, 1e-5);
+    SimTK_TEST(sdirk.getNumStepsTaken() < rkm.getNumStepsTaken()/10);
+
+    // Same answer by numerical differentiation, but that costs more 
+    // realizations.
+    SDIRKIntegrator sdirkNum(model.system);
+    sdirkNum.setUseSystemJacobian(false);
+    SimTK_TEST(!sdirkNum.getUseSystemJacobian());
+    const Vector yNum = simulate(model.system, model.state, sdirkNum, 1e-5);
+    SimTK_TEST_EQ_TOL(yNum, yRef, 1e-3);
+    SimTK_TEST(sdirkNum.getNumNumericalJacobianEvaluations() 
+               == sdirkNum.getNumJacobianEvaluations());
+    SimTK_TEST(sdirk.getNumRealizations() < sdirkNum.getNumRealizations());
+
+    cout << "  SDIRK: " << sdirk.getNumStepsTaken() << " steps, " 
+         << sdirk.getNumRealizations() << " realizations, " 
+         << sdirk.getNumJacobianEvaluations() << " Jacobians, "
+         << sdirk.getNumIterationMatrixFactorizations() << " factorizations;"
+         << " numerical Jacobian: " << sdirkNum.getNumRealizations() 
+         << " realizations; Merson: " << rkm.getNumStepsTaken() << " steps, "
+         << rkm.getNumRealizations() << " realizations\n";
+}
+
+// A stiff stop that engages during a step makes the Newton iteration fail 
+// even with a fresh Jacobian from the System, since that was evaluated 
+// before the stop engaged. Such a step is retried with a numerical Jacobian
+// and then a smaller step, but the System is still asked for later 
+// Jacobians rather than differencing from then on.
+void testSystemJacobianFailure() {
+    Model model;
+    Force::MobilityLinearStop(model.forces, model.pendulum1, 
+        MobilizerQIndex(0), 1e6, 0.5, -0.6, 0.6);
+    model.state = model.system.realizeTopology();
+    model.pendulum1.setOneQ(model.state, 0, 0.5);
+    model.pendulum1.setOneU(model.state, 0, 1);
+    model.block.setOneQ(model.state, 0, 0.01);
+
+    SDIRKIntegrator sdirk(model.system);
+    simulate(model.system, model.state, sdirk, 1e-5);
+
+    const int nJac = sdirk.getNumJacobianEvaluations();
+    const int nNum = sdirk.getNumNumericalJacobianEvaluations();
+    SimTK_TEST(nNum > 0);
+    SimTK_TEST(nNum <= nJac - nNum);
+}
+
+// With a constraint the System can't supply a Jacobian so the integrator
+// falls back to numerical differentiation, and the constraint is still
+// satisfied thanks to projection.
+void testConstrainedSystem() {
+    Model model;
+    Constraint::ConstantSpeed(model.pendulum1, 1);
+    model.state = model.system.realizeTopology();
+    model.pendulum1.setOneQ(model.state, 0, 0.5);
+    model.pendulum1.setOneU(model.state, 0, 1);
+    model.block.setOneQ(model.state, 0, 0.01);
+
+    SDIRKIntegrator sdirk(model.system);
+    simulate(model.system, model.state, sdirk, 1e-5);
+    SimTK_TEST(sdirk.getNumJacobianEvaluations() > 0);
+    SimTK_TEST(sdirk.getNumNumericalJacobianEvaluations() 
+               == sdirk.getNumJacobianEvaluations());
+    SimTK_TEST_EQ_TOL(model.pendulum1.getOneU(sdirk.getState(), 0), 1, 1e-6);
+    SimTK_TEST_EQ_TOL(model.pendulum1.getOneQ(sdirk.getState(), 0), 
+                      0.5 + FinalTime, 1e-4);
+}
+
+int main() {
+    SimTK_START_TEST("TestSDIRKIntegrator");
+        SimTK_SUBTEST(testSystemJacobian);
+        SimTK_SUBTEST(testStiffSystem);
+        SimTK_SUBTEST(testSystemJacobianFailure);
+        SimTK_SUBTEST(testConstrainedSystem);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,162 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that the sparse factorization of the constraint-space mass matrix
+gives the same forward dynamics as the dense method, and that redundant
+constraints are handed over to the dense method. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+const int NumCables = 40;
+const int LinksPerCable = 3;
+
+// A cable made of slender links on ball joints, hung from one Ground anchor
+// with its last link tied to another. Returns the middle link.
+static MobilizedBody addCable(SimbodyMatterSubsystem& matter, 
+                              const Vec3& anchor) {
+    const Real halfLength = .25;
+    const Body::Rigid link(MassProperties(.2, Vec3(0), 
+                           UnitInertia::cylinderAlongY(.01, halfLength)));
+    MobilizedBody parent = matter.Ground(), middle;
+    Vec3 inboard = anchor;
+    for (int k=0; k < LinksPerCable; ++k) {
+        parent = MobilizedBody::Ball(parent, inboard, 
+                                     link, Vec3(0,halfLength,0));
+        inboard = Vec3(0,-halfLength,0);
+        if (k == LinksPerCable/2) middle = parent;
+    }
+    Constraint::Ball(matter.Ground(), anchor + Vec3(1,-.5,0), 
+                     parent, Vec3(0,-halfLength,0));
+    return middle;
+}
+
+static void setRandomState(State& state) {
+    Random::Uniform rand(-0.5,0.5);
+    rand.setSeed(17);
+    for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+    for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+}
+
+// Many cables, each an independent subtree closed by a constraint to Ground.
+// Every fifth one is tied to its neighbor by a rod, so that some equations
+// couple two subtrees.
+void testSparseMatchesDense() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    MobilizedBody previous;
+    for (int i=0; i < NumCables; ++i) {
+        MobilizedBody middle = addCable(matter, Vec3(0,0,.3*i));
+        if (i % 5 == 1)
+            Constraint::Rod(previous, Vec3(0), middle, Vec3(0), .3);
+        previous = middle;
+    }
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomState(state);
+    system.realize(state, Stage::Instance);
+    const int m = state.getNMultipliers();
+    SimTK_TEST(m == 3*NumCables + NumCables/5);
+
+    matter.setSparseConstraintSolverThreshold(m+1);
+    State dense = state;
+    system.realize(dense, Stage::Acceleration);
+
+    matter.setSparseConstraintSolverThreshold(m);
+    SimTK_TEST(matter.getSparseConstraintSolverThreshold() == m);
+    State sparse = state;
+    system.realize(sparse, Stage::Acceleration);
+    SimTK_TEST_EQ_TOL(sparse.getUDot(), dense.getUDot(), 1e-10);
+    SimTK_TEST_EQ_TOL(sparse.getMultipliers(), dense.getMultipliers(), 1e-10);
+    SimTK_TEST_EQ_TOL(sparse.getUDotErr(), dense.getUDotErr(), 1e-10);
+
+    // Reuse the analysis with a different configuration.
+    for (int i=0; i < sparse.getNQ(); ++i) {
+        sparse.updQ()[i] *= 0.5;
+        dense.updQ()[i]  *= 0.5;
+    }
+    system.realize(sparse, Stage::Acceleration);
+    matter.setSparseConstraintSolverThreshold(m+1);
+    system.realize(dense, Stage::Acceleration);
+    SimTK_TEST_EQ_TOL(sparse.getUDot(), dense.getUDot(), 1e-10);
+    SimTK_TEST_EQ_TOL(sparse.getMultipliers(), dense.getMultipliers(), 1e-10);
+
+    // Disabling a constraint changes the structure.
+    matter.setSparseConstraintSolverThreshold(1);
+    matter.updConstraint(ConstraintIndex(3)).disable(sparse);
+    matter.updConstraint(ConstraintIndex(3)).disable(dense);
+    system.realize(sparse, Stage::Acceleration);
+    matter.setSparseConstraintSolverThreshold(m+1);
+    system.realize(dense, Stage::Acceleration);
+    SimTK_TEST(sparse.getNMultipliers() == m-3);
+    SimTK_TEST_EQ_TOL(sparse.getUDot(), dense.getUDot(), 1e-10);
+    SimTK_TEST_EQ_TOL(sparse.getMultipliers(), dense.getMultipliers(), 1e-10);
+
+    SimTK_TEST_MUST_THROW(matter.setSparseConstraintSolverThreshold(0));
+}
+
+// A cable tied to Ground twice at the same point makes G M^-1 ~G singular.
+// The sparse method must give up and leave the answer to the rank-revealing
+// dense method.
+void testRedundantConstraints() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    for (int i=0; i < 4; ++i)
+        addCable(matter, Vec3(0,0,.3*i));
+    Constraint::Ball(matter.Ground(), Vec3(1,-.5,0), 
+                     matter.updMobilizedBody(MobilizedBodyIndex(LinksPerCable)),
+                     Vec3(0,-.25,0));
+    system.realizeTopology();
+
+    State state = system.getDefaultState();
+    setRandomState(state);
+    system.realize(state, Stage::Instance);
+    const int m = state.getNMultipliers();
+
+    matter.setSparseConstraintSolverThreshold(m+1);
+    State dense = state;
+    system.realize(dense, Stage::Acceleration);
+
+    matter.setSparseConstraintSolverThreshold(1);
+    State sparse = state;
+    system.realize(sparse, Stage::Acceleration);
+    SimTK_TEST((sparse.getUDot() - dense.getUDot()).normInf() == 0);
+    SimTK_TEST((sparse.getMultipliers() - dense.getMultipliers()).normInf() 
+               == 0);
+}
+
+int main() {
+    SimTK_START_TEST("TestSparseConstraintSolver");
+        SimTK_SUBTEST(testSparseMatchesDense);
+        SimTK_SUBTEST(testRedundantConstraints);
+    SimTK_END_TEST();
+}
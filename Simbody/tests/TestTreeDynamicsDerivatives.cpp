@@ -0,0 +1,273 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check the directional derivatives and partial derivative matrices of the
+tree inverse and forward dynamics operators against central differences of
+the operators themselves. */
+
+#include "SimTKsimbody.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// A branched tree with one of each supported mobilizer, with offset frames
+// and off-center, non-principal mass properties throughout.
+class Tree {
+public:
+    Tree() : matter(system) {
+        const Body::Rigid body(MassProperties(1.5, Vec3(.1, -.2, .05),
+                               Inertia(1, 2, 1.5, .1, -.2, .05)));
+        const Transform X_PF(Rotation(0.3, XAxis), Vec3(0.1, 0.5, 0));
+        const Transform X_BM(Rotation(-0.2, ZAxis), Vec3(0, 0.7, 0.1));
+
+        MobilizedBody::Free free(matter.Ground(), X_PF, body, X_BM);
+        MobilizedBody::Pin pin(free, X_PF, body, X_BM);
+        MobilizedBody::Ball ball(pin, X_PF, body, X_BM);
+        MobilizedBody::Slider slider(ball, X_PF, body, X_BM);
+        MobilizedBody::Weld weld(pin, X_PF, body, X_BM);
+        MobilizedBody::Cylinder cylinder(weld, X_PF, body, X_BM);
+        MobilizedBody::Planar planar(free, X_PF, body, X_BM);
+        MobilizedBody::Screw screw(planar, X_PF, body, X_BM, 0.3);
+        MobilizedBody::Translation translation(screw, X_PF, body, X_BM);
+        system.realizeTopology();
+
+        state = system.getDefaultState();
+        Random::Uniform rand(-1, 1); rand.setSeed(42);
+        for (int i=0; i < state.getNQ(); ++i) state.updQ()[i] = rand.getValue();
+        for (int i=0; i < state.getNU(); ++i) state.updU()[i] = rand.getValue();
+        system.realize(state, Stage::Position);
+        matter.normalizeQuaternions(state);
+        system.realize(state, Stage::Dynamics);
+
+        const int nb = matter.getNumBodies(), nu = state.getNU();
+        bodyForces.resize(nb); mobForces.resize(nu);
+        for (int b=0; b < nb; ++b)
+            bodyForces[b] = SpatialVec(Vec3(rand.getValue(), .5, 0),
+                                       Vec3(0, -9.8, rand.getValue()));
+        for (int i=0; i < nu; ++i) mobForces[i] = rand.getValue();
+    }
+
+    // Random direction; dq is tangent to the quaternion constraints.
+    void makeDirection(int seed, Vector& dq, Vector& du, Vector& dudot) const {
+        Random::Uniform rand(-1, 1); rand.setSeed(seed);
+        Vector w(state.getNU());
+        du.resize(state.getNU()); dudot.resize(state.getNU());
+        for (int i=0; i < state.getNU(); ++i) {
+            w[i] = rand.getValue(); du[i] = rand.getValue();
+            dudot[i] = rand.getValue();
+        }
+        matter.multiplyByN(state, false, w, dq);
+    }
+
+    State perturbed(const Vector& dq, const Vector& du, Real h) const {
+        State s = state;
+        if (dq.size()) s.updQ() += h*dq;
+        if (du.size()) s.updU() += h*du;
+        system.realize(s, Stage::Dynamics);
+        return s;
+    }
+
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter;
+    State                   state;
+    Vector_<SpatialVec>     bodyForces;
+    Vector                  mobForces;
+};
+
+void testResidualForceDerivative() {
+    Tree tree;
+    const SimbodyMatterSubsystem& matter = tree.matter;
+    Vector dq, du, dudot, udot(tree.state.getNU());
+    tree.makeDirection(7, dq, du, dudot);
+    for (int i=0; i < udot.size(); ++i) udot[i] = std::sin(Real(i));
+
+    Vector f, df;
+    matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+        tree.state, tree.mobForces, tree.bodyForces, udot, dq, du, dudot,
+        f, df);
+
+    Vector f0;
+    matter.calcResidualForceIgnoringConstraints(tree.state,
+        tree.mobForces, tree.bodyForces, udot, f0);
+    SimTK_TEST_EQ(f, f0);
+
+    const Real h = 1e-6;
+    Vector fp, fm;
+    matter.calcResidualForceIgnoringConstraints(tree.perturbed(dq, du, h),
+        tree.mobForces, tree.bodyForces, Vector(udot + h*dudot), fp);
+    matter.calcResidualForceIgnoringConstraints(tree.perturbed(dq, du, -h),
+        tree.mobForces, tree.bodyForces, Vector(udot - h*dudot), fm);
+    const Vector fd = (fp - fm)/(2*h);
+    SimTK_TEST_EQ_TOL(df, fd, 1e-6);
+
+    // Each part of the direction separately, with zero-length inputs.
+    Vector dfq, dfu, dfudot;
+    matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+        tree.state, tree.mobForces, tree.bodyForces, udot, dq, Vector(),
+        Vector(), f, dfq);
+    matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+        tree.state, tree.mobForces, tree.bodyForces, udot, Vector(), du,
+        Vector(), f, dfu);
+    matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+        tree.state, tree.mobForces, tree.bodyForces, udot, Vector(),
+        Vector(), dudot, f, dfudot);
+    SimTK_TEST_EQ(dfq + dfu + dfudot, df);
+
+    Vector Mdudot;
+    matter.multiplyByM(tree.state, dudot, Mdudot);
+    SimTK_TEST_EQ(dfudot, Mdudot);
+}
+
+void testAccelerationDerivative() {
+    Tree tree;
+    const SimbodyMatterSubsystem& matter = tree.matter;
+    Vector dq, du, dudot;
+    tree.makeDirection(11, dq, du, dudot);
+
+    Vector udot, dudot_dir;
+    matter.calcAccelerationIgnoringConstraintsDirectionalDerivative(
+        tree.state, tree.mobForces, tree.bodyForces, dq, du, udot, dudot_dir);
+
+    Vector udot0; Vector_<SpatialVec> A_GB;
+    matter.calcAccelerationIgnoringConstraints(tree.state,
+        tree.mobForces, tree.bodyForces, udot0, A_GB);
+    SimTK_TEST_EQ(udot, udot0);
+
+    const Real h = 1e-6;
+    Vector up, um;
+    matter.calcAccelerationIgnoringConstraints(tree.perturbed(dq, du, h),
+        tree.mobForces, tree.bodyForces, up, A_GB);
+    matter.calcAccelerationIgnoringConstraints(tree.perturbed(dq, du, -h),
+        tree.mobForces, tree.bodyForces, um, A_GB);
+    const Vector fd = (up - um)/(2*h);
+    SimTK_TEST_EQ_TOL(dudot_dir, fd, 1e-5);
+}
+
+// Whole Jacobians, column by column against central differences.
+void testPartials() {
+    Tree tree;
+    const SimbodyMatterSubsystem& matter = tree.matter;
+    const int nq = tree.state.getNQ(), nu = tree.state.getNU();
+    Vector udot(nu);
+    for (int i=0; i < nu; ++i) udot[i] = std::cos(Real(i));
+
+    // Supplied at the right size, the outputs are written in place.
+    Matrix dfdq(nu, nq), dfdu(nu, nu);
+    const Real* dfdqData = &dfdq(0,0);
+    matter.calcResidualForceIgnoringConstraintsPartials(tree.state,
+        tree.mobForces, tree.bodyForces, udot, dfdq, dfdu);
+    SimTK_TEST(&dfdq(0,0) == dfdqData);
+
+    Matrix dudotdq, dudotdu; Vector udot0;
+    matter.calcAccelerationIgnoringConstraintsPartials(tree.state,
+        tree.mobForces, tree.bodyForces, udot0, dudotdq, dudotdu);
+    SimTK_TEST(dudotdq.nrow() == nu && dudotdq.ncol() == nq);
+    SimTK_TEST(dudotdu.nrow() == nu && dudotdu.ncol() == nu);
+
+    const Real h = 1e-6;
+    Vector_<SpatialVec> A_GB;
+    for (int k=0; k < nq + nu; ++k) {
+        Vector dq(nq, Real(0)), du(nu, Real(0));
+        if (k < nq) dq[k] = 1; else du[k-nq] = 1;
+        const State sp = tree.perturbed(dq, du, h);
+        const State sm = tree.perturbed(dq, du, -h);
+
+        Vector fp, fm, up, um;
+        matter.calcResidualForceIgnoringConstraints(sp,
+            tree.mobForces, tree.bodyForces, udot, fp);
+        matter.calcResidualForceIgnoringConstraints(sm,
+            tree.mobForces, tree.bodyForces, udot, fm);
+        matter.calcAccelerationIgnoringConstraints(sp,
+            tree.mobForces, tree.bodyForces, up, A_GB);
+        matter.calcAccelerationIgnoringConstraints(sm,
+            tree.mobForces, tree.bodyForces, um, A_GB);
+
+        const Vector dfFD = (fp - fm)/(2*h), dudotFD = (up - um)/(2*h);
+        if (k < nq) {
+            SimTK_TEST_EQ_TOL(dfdq(k), dfFD, 1e-6);
+            SimTK_TEST_EQ_TOL(dudotdq(k), dudotFD, 1e-5);
+        } else {
+            SimTK_TEST_EQ_TOL(dfdu(k-nq), dfFD, 1e-6);
+            SimTK_TEST_EQ_TOL(dudotdu(k-nq), dudotFD, 1e-5);
+        }
+    }
+}
+
+void testUnsupported() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    const Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pin(matter.Ground(), body);
+    MobilizedBody::Universal universal(pin, Transform(Vec3(1, 0, 0)), body,
+                                       Transform());
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+
+    Vector f, df, udot, dudot;
+    const Vector_<SpatialVec> noBodyForces;
+    SimTK_TEST_MUST_THROW(
+        matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+            state, Vector(), noBodyForces, Vector(), Vector(), Vector(),
+            Vector(), f, df));
+    SimTK_TEST_MUST_THROW(
+        matter.calcAccelerationIgnoringConstraintsDirectionalDerivative(
+            state, Vector(state.getNU(), 0.),
+            Vector_<SpatialVec>(matter.getNumBodies(), SpatialVec(Vec3(0), Vec3(0))),
+            Vector(), Vector(), udot, dudot));
+
+    // Wrong length direction.
+    Tree tree;
+    SimTK_TEST_MUST_THROW(
+        tree.matter.calcResidualForceIgnoringConstraintsDirectionalDerivative(
+            tree.state, Vector(), noBodyForces, Vector(), Vector(2, 1.),
+            Vector(), Vector(), f, df));
+}
+
+void testPrescribedMotion() {
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    const Body::Rigid body(MassProperties(1, Vec3(0), Inertia(1)));
+    MobilizedBody::Pin pin(matter.Ground(), body);
+    Motion::Steady(pin, 1);
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+
+    Vector udot, dudot;
+    SimTK_TEST_MUST_THROW(
+        matter.calcAccelerationIgnoringConstraintsDirectionalDerivative(
+            state, Vector(1, 0.),
+            Vector_<SpatialVec>(2, SpatialVec(Vec3(0), Vec3(0))),
+            Vector(), Vector(), udot, dudot));
+}
+
+int main() {
+    SimTK_START_TEST("TestTreeDynamicsDerivatives");
+        SimTK_SUBTEST(testResidualForceDerivative);
+        SimTK_SUBTEST(testAccelerationDerivative);
+        SimTK_SUBTEST(testPartials);
+        SimTK_SUBTEST(testUnsupported);
+        SimTK_SUBTEST(testPrescribedMotion);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,244 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Test the parts of the Visualizer that don't need the GUI: the RealTime
+frame queue and the encoding of scenes as full scenes or pose updates. */
+
+#include "SimTKsimbody.h"
+
+#include "../Visualizer/src/VisualizerProtocol.h"
+#include "../Visualizer/src/VisualizerFrameQueue.h"
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace SimTK;
+using namespace std;
+
+void testFrameQueueEmptyAndFull() {
+    VisualizerFrameQueue<int> queue;
+    SimTK_TEST(queue.capacity() == 0);
+    queue.resize(3);
+    SimTK_TEST(queue.capacity() == 3);
+    SimTK_TEST(queue.isEmpty() && !queue.isFull() && queue.size() == 0);
+
+    for (int i=1; i <= 3; ++i) {
+        queue.updNewest() = 10*i;
+        SimTK_TEST(queue.push() == i);
+        SimTK_TEST(!queue.isEmpty());
+    }
+    SimTK_TEST(queue.isFull() && queue.size() == 3);
+
+    SimTK_TEST(queue.getOldest() == 10);
+    SimTK_TEST(queue.pop() == 2);
+    SimTK_TEST(!queue.isFull());
+    SimTK_TEST(queue.getOldest() == 20);
+    SimTK_TEST(queue.pop() == 1);
+    SimTK_TEST(queue.getOldest() == 30);
+    SimTK_TEST(queue.pop() == 0);
+    SimTK_TEST(queue.isEmpty());
+
+    // Resizing throws away whatever was queued.
+    queue.updNewest() = 1; queue.push();
+    queue.resize(2);
+    SimTK_TEST(queue.isEmpty() && queue.capacity() == 2);
+}
+
+// Frames must come out in order however the pushes and pops interleave
+// with the ends of the ring.
+void testFrameQueueWraparound() {
+    VisualizerFrameQueue<int> queue;
+    queue.resize(3);
+    int next = 0, expected = 0;
+    for (int round=0; round < 20; ++round) {
+        const int nPush = 1 + round % 3;
+        for (int i=0; i < nPush && !queue.isFull(); ++i) {
+            queue.updNewest() = next++;
+            queue.push();
+        }
+        const int nPop = 1 + (round/2) % 3;
+        for (int i=0; i < nPop && !queue.isEmpty(); ++i) {
+            SimTK_TEST(queue.getOldest() == expected++);
+            queue.pop();
+        }
+    }
+    while (!queue.isEmpty()) {
+        SimTK_TEST(queue.getOldest() == expected++);
+        queue.pop();
+    }
+    SimTK_TEST(expected == next && next > 3*queue.capacity());
+}
+
+// One producer and one consumer, as for the simulation and drawing threads,
+// spinning rather than blocking when the queue is full or empty.
+void testFrameQueueTwoThreads() {
+    const int NumFrames = 20000;
+    VisualizerFrameQueue<int> queue;
+    queue.resize(4);
+
+    std::thread producer([&] {
+        for (int i=0; i < NumFrames; ++i) {
+            while (queue.isFull()) std::this_thread::yield();
+            queue.updNewest() = i;
+            queue.push();
+        }
+    });
+
+    int numOutOfOrder = 0;
+    for (int i=0; i < NumFrames; ++i) {
+        while (queue.isEmpty()) std::this_thread::yield();
+        if (queue.getOldest() != i) ++numOutOfOrder;
+        queue.pop();
+    }
+    producer.join();
+    SimTK_TEST(numOutOfOrder == 0);
+    SimTK_TEST(queue.isEmpty());
+}
+
+// A fake scene element: a command byte, the pose floats, and a color.
+static void addElement(vector<char>& scene, vector<int>& poseOffsets,
+                       float pose, float color) {
+    scene.push_back(AddSolidMesh);
+    poseOffsets.push_back((int)scene.size());
+    for (int i=0; i < NumPoseFloats; ++i) {
+        const float x = pose + i;
+        scene.insert(scene.end(), (const char*)&x, (const char*)&x + 4);
+    }
+    scene.insert(scene.end(), (const char*)&color, (const char*)&color + 4);
+}
+
+static void makeScene(const vector<float>& poses, float color,
+                      vector<char>& scene, vector<int>& poseOffsets) {
+    scene.clear(); poseOffsets.clear();
+    for (float pose : poses)
+        addElement(scene, poseOffsets, pose, color);
+    scene.push_back(EndOfScene);
+}
+
+// Decode a message the way the GUI does, starting from the scene data it
+// kept last time, and return the scene data it now has.
+static vector<unsigned char> decode(const vector<char>& message,
+                                    const vector<unsigned char>& lastScene,
+                                    float& time) {
+    const unsigned char* p = (const unsigned char*)&message[1];
+    auto readData = [&](unsigned char* buffer, int bytes)
+    {   memcpy(buffer, p, bytes); p += bytes; };
+    readData((unsigned char*)&time, sizeof(float));
+
+    vector<unsigned char> scene;
+    if (message[0] == StartOfScene) {
+        scene.assign(p, (const unsigned char*)&message[0] + message.size());
+    } else {
+        SimTK_TEST(message[0] == UpdateScene);
+        scene = lastScene;
+        applySceneUpdate(readData, &scene[0], (int)scene.size());
+        SimTK_TEST(p == (const unsigned char*)&message[0] + message.size());
+    }
+    return scene;
+}
+
+static bool isSame(const vector<unsigned char>& a, const vector<char>& b) {
+    return a.size() == b.size()
+        && std::equal(a.begin(), a.end(), (const unsigned char*)&b[0]);
+}
+
+void testSceneEncoding() {
+    vector<char> scene, prevScene, message;
+    vector<int>  poses, prevPoses;
+    vector<unsigned char> gui; // what the GUI has
+    float time;
+    const int poseBytes = NumPoseFloats*sizeof(float);
+
+    // The first scene has nothing to update, so is sent in full.
+    makeScene({1, 2, 3}, 0.5f, scene, poses);
+    SimTK_TEST(!encodeScene(0.25f, scene, poses, prevScene, prevPoses,
+                            message));
+    SimTK_TEST(message.size() == 1 + sizeof(float) + scene.size());
+    gui = decode(message, gui, time);
+    SimTK_TEST(time == 0.25f && isSame(gui, scene));
+    scene.swap(prevScene); poses.swap(prevPoses);
+
+    // Move one element; only its pose is sent.
+    makeScene({1, 7, 3}, 0.5f, scene, poses);
+    SimTK_TEST(encodeScene(0.5f, scene, poses, prevScene, prevPoses,
+                           message));
+    SimTK_TEST(message.size() == 1 + sizeof(float) + sizeof(int)
+                                 + sizeof(int) + poseBytes);
+    gui = decode(message, gui, time);
+    SimTK_TEST(time == 0.5f && isSame(gui, scene));
+    scene.swap(prevScene); poses.swap(prevPoses);
+
+    // Move them all.
+    makeScene({4, 5, 6}, 0.5f, scene, poses);
+    SimTK_TEST(encodeScene(0.75f, scene, poses, prevScene, prevPoses,
+                           message));
+    SimTK_TEST(message.size() == 1 + sizeof(float) + sizeof(int)
+                                 + 3*(sizeof(int) + poseBytes));
+    gui = decode(message, gui, time);
+    SimTK_TEST(isSame(gui, scene));
+    scene.swap(prevScene); poses.swap(prevPoses);
+
+    // Nothing changed; an empty update.
+    makeScene({4, 5, 6}, 0.5f, scene, poses);
+    SimTK_TEST(encodeScene(1.f, scene, poses, prevScene, prevPoses, message));
+    SimTK_TEST(message.size() == 1 + sizeof(float) + sizeof(int));
+    gui = decode(message, gui, time);
+    SimTK_TEST(time == 1.f && isSame(gui, scene));
+    scene.swap(prevScene); poses.swap(prevPoses);
+
+    // Anything but a pose changed (here a color); the whole scene is sent.
+    makeScene({4, 5, 6}, 0.75f, scene, poses);
+    SimTK_TEST(!encodeScene(1.25f, scene, poses, prevScene, prevPoses,
+                            message));
+    gui = decode(message, gui, time);
+    SimTK_TEST(isSame(gui, scene));
+    scene.swap(prevScene); poses.swap(prevPoses);
+
+    // A different number of elements; also sent in full.
+    makeScene({4, 5}, 0.75f, scene, poses);
+    SimTK_TEST(!encodeScene(1.5f, scene, poses, prevScene, prevPoses,
+                            message));
+    gui = decode(message, gui, time);
+    SimTK_TEST(isSame(gui, scene));
+
+    // The GUI refuses an update that points outside its scene.
+    vector<char> bad(1, UpdateScene);
+    const float t = 2; const int one = 1, offset = (int)gui.size();
+    bad.insert(bad.end(), (const char*)&t, (const char*)&t + sizeof(float));
+    bad.insert(bad.end(), (const char*)&one, (const char*)&one + sizeof(int));
+    bad.insert(bad.end(), (const char*)&offset,
+                          (const char*)&offset + sizeof(int));
+    bad.resize(bad.size() + poseBytes);
+    SimTK_TEST_MUST_THROW(decode(bad, gui, time));
+}
+
+int main() {
+    SimTK_START_TEST("TestVisualizerProtocol");
+        SimTK_SUBTEST(testFrameQueueEmptyAndFull);
+        SimTK_SUBTEST(testFrameQueueWraparound);
+        SimTK_SUBTEST(testFrameQueueTwoThreads);
+        SimTK_SUBTEST(testSceneEncoding);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,109 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Scaling benchmark for the ContactTrackerSubsystem broad phase methods. A
+layer of spheres is packed into a bin as if piled on a floor, then jiggled
+slightly between evaluations the way they would be during a simulation of
+mostly resting objects. For each broad phase method and each problem size
+we report the average real time per contact evaluation, with the time to
+realize positions alone given for reference. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace SimTK;
+using std::cout; using std::endl;
+
+static double timeContactEvaluation
+   (int numSpheres, ContactTrackerSubsystem::BroadPhaseMethod method,
+    bool positionsOnly, int& numContacts)
+{
+    const Real Radius = 0.05;
+    const int  NumEvaluations = 20;
+
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    ContactTrackerSubsystem tracker(system);
+    tracker.setBroadPhaseMethod(method);
+
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(1)));
+    body.addContactSurface(Transform(), 
+        ContactSurface(ContactGeometry::Sphere(Radius), 
+                       ContactMaterial(1e6,0,0,0,0)));
+    for (int i=0; i < numSpheres; ++i)
+        MobilizedBody::Translation(matter.Ground(), body);
+    system.realizeTopology();
+
+    // Roughly one sphere diameter of floor space per sphere, two layers deep.
+    const Real side = 2*Radius*std::sqrt(Real(numSpheres)/2);
+    Random::Uniform rand(0, 1);
+    rand.setSeed(1);
+    State state = system.getDefaultState();
+    for (MobilizedBodyIndex mbx(1); mbx < matter.getNumBodies(); ++mbx)
+        matter.getMobilizedBody(mbx).setQToFitTranslation(state,
+            Vec3(side*rand.getValue(), 4*Radius*rand.getValue(), 
+                 side*rand.getValue()));
+
+    Random::Gaussian jiggle(0, Radius/100);
+    jiggle.setSeed(2);
+    // Warm up once so the incremental methods start from a sorted state.
+    system.realize(state, Stage::Position);
+    numContacts = tracker.getActiveContacts(state).getNumContacts();
+
+    const double start = realTime();
+    for (int n=0; n < NumEvaluations; ++n) {
+        Vector& q = state.updQ();
+        for (int i=0; i < q.size(); ++i)
+            q[i] += jiggle.getValue();
+        system.realize(state, Stage::Position);
+        if (!positionsOnly)
+            numContacts = tracker.getActiveContacts(state).getNumContacts();
+    }
+    return 1000*(realTime() - start)/NumEvaluations;
+}
+
+int main() {
+    const int sizes[] = {100, 300, 1000, 3000, 10000};
+    const ContactTrackerSubsystem::BroadPhaseMethod methods[] = {
+        ContactTrackerSubsystem::SingleAxisSweep,
+        ContactTrackerSubsystem::IncrementalSweepAndPrune,
+        ContactTrackerSubsystem::DynamicAABBTree };
+
+    printf("Real time per evaluation in ms\n");
+    printf("%8s %10s %12s %12s %12s %10s\n", "spheres", "positions",
+           "1-axis SAP", "3-axis SAP", "AABB tree", "contacts");
+    for (int numSpheres : sizes) {
+        int numContacts = 0;
+        const double positionsOnly = timeContactEvaluation
+            (numSpheres, ContactTrackerSubsystem::SingleAxisSweep, true,
+             numContacts);
+        printf("%8d %10.3f", numSpheres, positionsOnly);
+        for (ContactTrackerSubsystem::BroadPhaseMethod method : methods)
+            printf(" %12.3f", timeContactEvaluation(numSpheres, method, 
+                                                    false, numContacts));
+        printf(" %10d\n", numContacts);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+/* -------------------------------------------------------------------------- *
+ *                               Simbody(tm)                                  *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org/home/simbody.  *
+ *                                                                            *
+ * Portions copyright (c) 2020 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Throughput of System::realizeBatch() for an ensemble of States of a
+branched chain, as might be used for Monte Carlo sampling. For each thread
+count we report the number of realizations per second through Acceleration
+stage, with a serial loop of realize() calls given for reference. */
+
+#include "SimTKsimbody.h"
+
+#include <cstdio>
+
+using namespace SimTK;
+
+int main() {
+    const int NumBodies = 60, NumStates = 2000;
+
+    MultibodySystem system;
+    SimbodyMatterSubsystem matter(system);
+    GeneralForceSubsystem forces(system);
+    Force::Gravity(forces, matter, -YAxis, 9.8);
+    Body::Rigid body(MassProperties(1, Vec3(0), UnitInertia(0.1)));
+    MobilizedBody parent = matter.Ground();
+    for (int i=0; i < NumBodies; ++i) {
+        MobilizedBody::Ball ball(i%3 ? parent : matter.Ground(),
+                                 Vec3(0,-0.5,0), body, Vec3(0,0.5,0));
+        Force::MobilityLinearDamper(forces, ball, MobilizerUIndex(0), 0.1);
+        parent = ball;
+    }
+    system.realizeTopology();
+
+    Random::Uniform rand(-1, 1);
+    Array_<State> states(NumStates, system.getDefaultState());
+    for (auto& s : states) {
+        for (int i=0; i < s.getNQ(); ++i) s.updQ()[i] = rand.getValue();
+        for (int i=0; i < s.getNU(); ++i) s.updU()[i] = rand.getValue();
+    }
+    Array_<State*> batch;
+    for (auto& s : states) batch.push_back(&s);
+
+    // Realize once to get all the lazily-allocated cache entries in place,
+    // then time everything from Instance stage on.
+    for (auto& s : states) system.realize(s, Stage::Acceleration);
+
+    // Reference: one at a time with realize().
+    for (auto& s : states) s.invalidateAllCacheAtOrAbove(Stage::Instance);
+    const double start = realTime();
+    for (auto& s : states) system.realize(s, Stage::Acceleration);
+    const double serialTime = realTime() - start;
+    printf("%d states, %d bodies, %d processors\n", NumStates, NumBodies,
+           ParallelExecutor::getNumProcessors());
+    printf("realize() loop:           %10.0f realizations/s\n",
+           NumStates/serialTime);
+
+    for (int nThreads=1; nThreads <= 2*ParallelExecutor::getNumProcessors();
+         nThreads *= 2)
+    {
+        for (auto& s : states) s.invalidateAllCacheAtOrAbove(Stage::Instance);
+        system.setNumBatchRealizeThreads(nThreads);
+        RealizeResults results;
+        system.realizeBatch(batch, Stage::Acceleration, results);
+        printf("realizeBatch(), %2d threads: %10.0f realizations/s\n",
+               results.getNumThreads(), results.getRealizationsPerSecond());
+    }
+    return 0;
+}